@@ -51,6 +51,8 @@
 //  Build 5.2.1:
 //  - A refactoring bug from 5.2.0 causing duplicate actions to be added
 //    to the list of control actions to take was fixed.
+//  Build 5.2.4:
+//  - Node & link indexes in rules can be remapped after renumbering.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -187,6 +189,7 @@ struct  TExpression* Expression;       // array of math expressions
 //     controls_addVariable
 //     controls_addExpression
 //     controls_addRuleClause
+//     controls_remapObjects
 //     controls_evaluate
 
 //-----------------------------------------------------------------------------
@@ -205,6 +208,7 @@ int    compareValues(double lhsValue, int relation, double rhsValue);
 
 void   updateActionList(struct TAction* a);
 int    executeActionList(DateTime currentTime);
+void   remapVariable(struct TVariable* v, int newNode[], int newLink[]);
 void   clearActionList(void);
 void   deleteActionList(void);
 void   deleteRules(void);
@@ -492,6 +496,54 @@ int  controls_addRuleClause(int r, int keyword, char* tok[], int nToks)
 
 //=============================================================================
 
+void controls_remapObjects(int newNode[], int newLink[])
+//
+//  Input:   newNode = new index of each node
+//           newLink = new index of each link
+//  Output:  none
+//  Purpose: updates the node and link indexes used in rule premises,
+//           named variables and actions after the project's nodes and
+//           links have been renumbered.
+//
+{
+    int r, i;
+    struct TPremise* p;
+    struct TAction*  a;
+
+    for (i = 0; i < VariableCount; i++)
+        remapVariable(&NamedVariable[i].variable, newNode, newLink);
+    for (r = 0; r < RuleCount; r++)
+    {
+        for (p = Rules[r].firstPremise; p != NULL; p = p->next)
+        {
+            remapVariable(&p->lhsVar, newNode, newLink);
+            remapVariable(&p->rhsVar, newNode, newLink);
+        }
+        for (a = Rules[r].thenActions; a != NULL; a = a->next)
+            a->link = newLink[a->link];
+        for (a = Rules[r].elseActions; a != NULL; a = a->next)
+            a->link = newLink[a->link];
+    }
+}
+
+//=============================================================================
+
+void remapVariable(struct TVariable* v, int newNode[], int newLink[])
+//
+//  Input:   v = a rule premise variable
+//           newNode = new index of each node
+//           newLink = new index of each link
+//  Output:  none
+//  Purpose: updates the object index of a rule premise variable.
+//
+{
+    if ( v->index < 0 ) return;
+    if ( v->object == r_NODE ) v->index = newNode[v->index];
+    else if ( v->object == r_LINK ) v->index = newLink[v->index];
+}
+
+//=============================================================================
+
 int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 //
 //  Input:   currentTime = current simulation date/time
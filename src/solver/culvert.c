@@ -15,9 +15,15 @@
 //   ==============
 //   Build 5.1.013:
 //   - C parameter corrected for Arch, Corrugated Metal, Mitered culvert. 
+//   Build 5.2.4:
+//   - Unsubmerged Form 1 flows can be found from precomputed curves.
+//   - Form 1 flow evaluated at the critical depth found (to a tolerance
+//     relative to inlet depth) rather than at the last depth tried, so
+//     that flows found with and without curves solve the same equation.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>
 #include <math.h>
 #include "findroot.h"
 #include "headers.h"
@@ -27,6 +33,17 @@
 //-----------------------------------------------------------------------------
 enum CulvertParam {FORM, K, M, C, Y};
 static const int    MAX_CULVERT_CODE = 57;
+
+// --- inlet control curves are tabulated at depths yMax * 2^-e * (1 + i/STEPS)
+//     for octaves e = CULVERT_CURVE_OCTAVES down to 1 so that an interval is
+//     located without taking a logarithm
+#define CULVERT_CURVE_STEPS   16       // intervals per octave of depth
+#define CULVERT_CURVE_OCTAVES 14       // octaves of depth below yMax
+#define CULVERT_CURVE_ITEMS   (CULVERT_CURVE_OCTAVES * CULVERT_CURVE_STEPS + 1)
+static const double CULVERT_CURVE_TOL = 0.001; // max. curve error as fraction
+                                               // of flow
+static const double CULVERT_ROOT_TOL = 1.0e-6; // critical depth tolerance as
+                                               // fraction of inlet depth
 static const double Params[58][5] = {
 
 //   FORM   K       M     C        Y
@@ -148,12 +165,15 @@ typedef struct
     double  ad;
 	double  hPlus;                  // Intermediate terms
     TXsect* xsect;                  // Pointer to culvert cross section
+    TCulvertCurve* curve;           // Inlet control curve (or NULL)
 } TCulvert;
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //  double culvert_getInflow
+//  int    culvert_createCurve  (called by conduit_validate in link.c)
+//  void   culvert_deleteCurve  (called by deleteObjects in project.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -163,6 +183,8 @@ static double getSubmergedFlow(int code, double h, TCulvert* culvert);
 static double getTransitionFlow(int code, double h, double h1, double h2,
 	          TCulvert* culvert);
 static double getForm1Flow(double h, TCulvert* culvert);
+static int    getCurveFlow(double h, TCulvert* culvert, double* q);
+static void   initCulvert(int j, int code, TCulvert* culvert);
 static double form1Eqn(double yc, void* p);
 /*
 static void report_CulvertControl(int j, double q0, double q, int condition,
@@ -182,7 +204,6 @@ double culvert_getInflow(int j, double q0, double h)
 //
 {
     int      code,                      //culvert type code number
-             k,                         //conduit index
              condition;                 //flow condition
     double   y,                         //current depth (ft)
              y1,                        //unsubmerged depth limit (ft)
@@ -192,23 +213,11 @@ double culvert_getInflow(int j, double q0, double h)
 
     // --- check that we have a culvert conduit
     if ( Link[j].type != CONDUIT ) return q0;
-    culvert.xsect = &Link[j].xsect;
-    code = culvert.xsect->culvertCode;
+    code = Link[j].xsect.culvertCode;
     if ( code <= 0 || code > MAX_CULVERT_CODE ) return q0;
 
     // --- compute often-used variables
-    k = Link[j].subIndex;
-    culvert.yFull = culvert.xsect->yFull;
-    culvert.ad = culvert.xsect->aFull * sqrt(culvert.yFull);
-
-    // --- slope correction factor (-7 for mitered inlets, 0.5 for others)
-    switch (code)
-    {
-    case 5:
-    case 37:
-    case 46: culvert.scf = -7.0 * Conduit[k].slope; break;
-    default: culvert.scf = 0.5 * Conduit[k].slope;
-    }
+    initCulvert(j, code, &culvert);
 
     // --- find head relative to culvert's upstream invert
     //     (can be greater than yFull when inlet is submerged)
@@ -254,6 +263,97 @@ double culvert_getInflow(int j, double q0, double h)
 
 //=============================================================================
 
+int culvert_createCurve(int j, int k)
+//
+//  Input:   j = link index
+//           k = conduit index
+//  Output:  returns FALSE if memory could not be allocated, TRUE otherwise
+//  Purpose: tabulates the unsubmerged inlet controlled flow of a culvert
+//           whose flow is found from FHWA Equation Form 1.
+//
+//  The curve spans depths up to the unsubmerged limit of 0.95 yFull. Its
+//  flows solve Equation Form 1 to a tight tolerance, and any interval whose
+//  error at its quarter points exceeds CULVERT_CURVE_TOL (as well as any
+//  depth outside the curve) uses getForm1Flow(), so that flows found on
+//  and off the curve solve the same equation.
+//
+{
+    int      code = Link[j].xsect.culvertCode;
+    int      e, i, m, n = 0;
+    double   y, qMid;
+    TCulvert culvert;
+    TCulvertCurve* curve;
+
+    culvert_deleteCurve(j);
+    if ( RouteModel != DW || code <= 0 || code > MAX_CULVERT_CODE ||
+         Params[code][FORM] != 1.0 ) return TRUE;
+
+    // --- allocate the curve and its arrays
+    curve = (TCulvertCurve *) calloc(1, sizeof(TCulvertCurve));
+    if ( curve == NULL ) return FALSE;
+    curve->q = (double *) calloc(CULVERT_CURVE_ITEMS, sizeof(double));
+    curve->exact = (char *) calloc(CULVERT_CURVE_ITEMS - 1, sizeof(char));
+    Conduit[k].culvertCurve = curve;
+    if ( curve->q == NULL || curve->exact == NULL ) return FALSE;
+
+    // --- evaluate Equation Form 1 at each curve point
+    initCulvert(j, code, &culvert);
+    culvert.kk = Params[code][K];
+    culvert.mm = Params[code][M];
+    curve->yMax = 0.95 * culvert.yFull;
+    for (e = CULVERT_CURVE_OCTAVES; e > 0; e--)
+    {
+        for (i = 0; i < CULVERT_CURVE_STEPS; i++)
+        {
+            y = ldexp(curve->yMax * (1.0 + (double)i / CULVERT_CURVE_STEPS),
+                      -e);
+            curve->q[n++] = getForm1Flow(y, &culvert);
+        }
+    }
+    curve->q[n] = getForm1Flow(curve->yMax, &culvert);
+
+    // --- flag intervals where interpolation is not accurate enough
+    //     at their quarter, mid and three-quarter points
+    for (i = 0; i < n; i++)
+    {
+        e = CULVERT_CURVE_OCTAVES - i / CULVERT_CURVE_STEPS;
+        for (m = 1; m <= 3; m++)
+        {
+            y = ldexp(curve->yMax * (1.0 + (i % CULVERT_CURVE_STEPS +
+                      0.25 * m) / CULVERT_CURVE_STEPS), -e);
+            qMid = getForm1Flow(y, &culvert);
+            if ( fabs(curve->q[i] + 0.25 * m * (curve->q[i+1] - curve->q[i])
+                      - qMid) > CULVERT_CURVE_TOL * qMid )
+                curve->exact[i] = TRUE;
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void culvert_deleteCurve(int j)
+//
+//  Input:   j = link index
+//  Output:  none
+//  Purpose: frees the inlet control curve of a culvert conduit.
+//
+{
+    int k;
+    TCulvertCurve* curve;
+
+    if ( Conduit == NULL || Link[j].type != CONDUIT ) return;
+    k = Link[j].subIndex;
+    curve = Conduit[k].culvertCurve;
+    if ( curve == NULL ) return;
+    free(curve->q);
+    free(curve->exact);
+    free(curve);
+    Conduit[k].culvertCurve = NULL;
+}
+
+//=============================================================================
+
 double getUnsubmergedFlow(int code, double h, TCulvert* culvert)
 //
 //  Input:   code  = culvert type code number
@@ -274,9 +374,11 @@ double getUnsubmergedFlow(int code, double h, TCulvert* culvert)
     arg = h / culvert->yFull / culvert->kk;
 
     // --- evaluate correct equation form
+    //     (using the culvert's inlet control curve if it has one)
     if ( Params[code][FORM] == 1.0)
     {
-        q = getForm1Flow(h, culvert);
+        if ( culvert->curve == NULL || !getCurveFlow(h, culvert, &q) )
+            q = getForm1Flow(h, culvert);
     }
     else q = culvert->ad * pow(arg, 1.0/culvert->mm);
     culvert->dQdH = q / h / culvert->mm;
@@ -347,19 +449,87 @@ double getForm1Flow(double h, TCulvert* culvert)
 //  See pages 195-196 of FHWA HEC-5 (2001) for details.
 //
 {
+    double yc;
+
     // --- save re-used terms in culvert structure
     culvert->hPlus = h / culvert->yFull + culvert->scf;
 
     // --- use Ridder's method to solve Equation Form 1 for critical depth
     //     between a range of 0.01h and h
-    findroot_Ridder(0.01*h, h, 0.001, form1Eqn, culvert);
+    yc = findroot_Ridder(0.01*h, h, CULVERT_ROOT_TOL * h,
+                         form1Eqn, culvert);
 
-    // --- return the flow value used in evaluating Equation Form 1
+    // --- return the flow value at the critical depth found
+    //     (not at the last depth tried by findroot_Ridder)
+    if ( yc > 0.0 ) form1Eqn(yc, culvert);
     return culvert->qc;
 }
 
 //=============================================================================
 
+int getCurveFlow(double h, TCulvert* culvert, double* q)
+//
+//  Input:   h       = inlet water depth above culvert invert (ft)
+//           culvert = pointer to a culvert data structure
+//  Output:  q = inlet controlled flow rate (cfs);
+//           returns TRUE if q was interpolated from the culvert's curve
+//  Purpose: interpolates an unsubmerged Form 1 flow from a culvert's
+//           inlet control curve.
+//
+{
+    int    e, i;
+    double x;
+    TCulvertCurve* curve = culvert->curve;
+
+    if ( curve == NULL || h <= 0.0 ) return FALSE;
+    x = h / curve->yMax;
+    if ( x >= 1.0 )
+    {
+        if ( x > 1.0 ) return FALSE;
+        *q = curve->q[CULVERT_CURVE_ITEMS-1];
+        return TRUE;
+    }
+    x = 2.0 * frexp(x, &e) - 1.0;          // h/yMax = (1 + x) * 2^(e-1)
+    if ( e <= -CULVERT_CURVE_OCTAVES ) return FALSE;
+    x *= CULVERT_CURVE_STEPS;
+    i = (int)x;
+    x -= i;
+    i += (e - 1 + CULVERT_CURVE_OCTAVES) * CULVERT_CURVE_STEPS;
+    if ( curve->exact[i] ) return FALSE;
+    *q = curve->q[i] + x * (curve->q[i+1] - curve->q[i]);
+    return TRUE;
+}
+
+//=============================================================================
+
+void initCulvert(int j, int code, TCulvert* culvert)
+//
+//  Input:   j       = link index
+//           code    = culvert type code number
+//           culvert = pointer to a culvert data structure
+//  Output:  none
+//  Purpose: assigns the often-used properties of a culvert conduit.
+//
+{
+    int k = Link[j].subIndex;
+
+    culvert->xsect = &Link[j].xsect;
+    culvert->yFull = culvert->xsect->yFull;
+    culvert->ad = culvert->xsect->aFull * sqrt(culvert->yFull);
+    culvert->curve = Conduit[k].culvertCurve;
+
+    // --- slope correction factor (-7 for mitered inlets, 0.5 for others)
+    switch (code)
+    {
+    case 5:
+    case 37:
+    case 46: culvert->scf = -7.0 * Conduit[k].slope; break;
+    default: culvert->scf = 0.5 * Conduit[k].slope;
+    }
+}
+
+//=============================================================================
+
 double form1Eqn(double yc, void* p)
 //
 //  Input:   yc = critical depth
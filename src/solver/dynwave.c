@@ -47,23 +47,63 @@
 //   Build 5.2.4:
 //   - Conduit evap+seepage outflow split evenly between outflow from
 //     conduit's upstream and non-outfall downstream nodes.
+//   - Option added to gather conduit flows into nodes in parallel using
+//     a node-to-conduit incidence list.
+//   - Critical link & node time steps found with parallel min-reductions.
+//   - SOLVER_METHOD option added to solve for node depths with a coupled
+//     Newton step in place of Picard iterations.
+//   - RELAXATION option added to update the Picard under-relaxation
+//     factor with Aitken's method.
+//   - STEP_CLASSES option added to let conduits with short Courant time
+//     steps take power-of-two sub-steps within the routing time step.
+//   - SKIP_DORMANT option added to skip the flow and depth updates of
+//     parts of the network that have remained dry or steady.
+//   - DETERMINISTIC option added to make inner products with fixed-order
+//     reductions that give the same results for any number of threads.
+//   - LOAD_BALANCING option added to split conduit flow updates among
+//     threads by their estimated or measured cost.
+//   - Culverts with inlet control curves costed like other conduits when
+//     balancing loads.
+//   - Flows through orifices, weirs & outlets found in parallel when more
+//     than one thread is used.
+//   - Newton trials whose Jacobian solve fails to converge fall back to
+//     a Picard update of node depths.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdlib.h>
 #include <math.h>
 #include "headers.h"
+#include "reduce.h"
+
+// Protect against lack of compiler support for OpenMP
+#if defined(_OPENMP)
+  #include <omp.h>
+#else
+  #include <time.h>
+  static int    omp_get_thread_num(void) { return 0; }
+  static int    omp_get_num_threads(void) { return 1; }
+  static double omp_get_wtime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+#endif
 
 //-----------------------------------------------------------------------------
 //     Constants 
 //-----------------------------------------------------------------------------
 static const double MINTIMESTEP         = 0.001;  // min. time step (sec)
 static const double OMEGA               = 0.5;    // under-relaxation parameter
+static const double OMEGA_MIN           = 0.1;    // min. Aitken relaxation
+static const double OMEGA_MAX           = 0.8;    // max. Aitken relaxation
 static const double DEFAULT_SURFAREA    = 12.566; // Min. nodal surface area (~4 ft diam.)
 static const double DEFAULT_HEADTOL     = 0.005;  // Default head tolerance (ft)
 static const double EXTRAN_CROWN_CUTOFF = 0.96;   // crown cutoff for EXTRAN
 static const double SLOT_CROWN_CUTOFF   = 0.985257; // crown cutoff for SLOT
 static const int    DEFAULT_MAXTRIALS   = 8;      // Max. trials per time step
+static const double CG_TOL              = 1.0e-6; // rel. tol. of Jacobian solve
+static const int    MAX_STEP_CLASSES    = 5;      // Max. conduit time step classes
+static const double DORMANT_FLOW_TOL    = 1.0e-6; // flow change for dormancy (cfs)
+static const double DORMANT_DEPTH_TOL   = 1.0e-6; // depth change for dormancy (ft)
+static const int    BALANCE_SAMPLES     = 20;     // steps timed before re-balancing
+static const int    BALANCE_INTERVAL    = 1000;   // steps between re-balancing
 
 
 //-----------------------------------------------------------------------------
@@ -76,41 +116,125 @@ typedef struct
     double  oldSurfArea;               // previous surface area (ft2)
     double  sumdqdh;                   // sum of dqdh from adjoining links
     double  dYdT;                      // change in depth w.r.t. time (ft/sec)
+    char    steady;                    // TRUE if unchanged over last step
+    char    dormant;                   // TRUE if depth update is skipped
 } TXnode;
 
+typedef struct                         // extended link information
+{
+    int     subSteps;                  // sub-steps taken per time step
+    double  meanFlow;                  // mean flow over sub-steps (cfs)
+    char    steady;                    // TRUE if unchanged over last step
+    char    dormant;                   // TRUE if flow update is skipped
+    double  setting;                   // setting used over last step
+} TXlink;
+
+typedef struct                         // node Jacobian used in Newton iterations
+{
+    double* diag;                      // diagonal term of each node (ft2/sec)
+    double* offDiag;                   // off-diagonal term of each conduit
+    double* resid;                     // continuity residual at each node (cfs)
+    double* dy;                        // depth correction at each node (ft)
+    double* r;                         // conjugate gradient residual
+    double* z;                         // preconditioned residual
+    double* p;                         // search direction
+    double* q;                         // Jacobian times search direction
+} TJacobian;
+
+typedef struct                         // conduit load balancing among threads
+{
+    int     chunks;                    // number of chunks (one per thread)
+    int     steps;                     // routing steps since last re-balance
+    int*    start;                     // first link of each chunk
+    double* cost;                      // cost of each link's flow update
+    double* sample;                    // time spent on each link (sec)
+    double* callTime;                  // time of each thread in current call
+    double* busyTime;                  // total time of each thread (sec)
+    double* idleTime;                  // total wait of each thread (sec)
+} TBalance;
+
 //-----------------------------------------------------------------------------
 //  Shared Variables
 //-----------------------------------------------------------------------------
 static double  VariableStep;           // size of variable time step (sec)
 static TXnode* Xnode;                  // extended nodal information
+static TXlink* Xlink;                  // extended link information
+static double* DyLast;                 // last unrelaxed depth change (ft)
+static double* DyDiff;                 // change in unrelaxed depth change (ft)
+static double* SubStepFlows;           // last iterate of each sub-step's flow
 
-static double  Omega;                  // actual under-relaxation parameter
+static double  Omega;                  // under-relaxation of node depths
 static int     Steps;                  // number of Picard iterations
+static int     MaxSubSteps;            // max. sub-steps taken by a conduit
+
+static int*    NodeLinkStart;          // start of each node's conduit list
+static int*    NodeLinkList;           // conduit ends (2*link + end) at nodes
+static TJacobian Jac;                  // node Jacobian for Newton iterations
+static int*    WakeList;               // nodes woken from dormancy
+static TBalance Balance;               // conduit chunks assigned to threads
+static int*    RegulatorList;          // orifices, weirs & outlets by type
+static int     NumRegulators;          // number of links in RegulatorList
+static double* BlockSums;              // work array for fixed-order sums
 
 //-----------------------------------------------------------------------------
 //  Function declarations
 //-----------------------------------------------------------------------------
+static int    createXarrays(void);
+static void   deleteXarrays(void);
 static void   initRoutingStep(void);
 static void   initNodeStates(void);
 static void   findBypassedLinks();
+static void   findSteadyStates(void);
+static void   findDormantRegions(void);
+static int    isDryBoundary(int link, int end, int node);
 static void   findLimitedLinks();
 
 static void   findLinkFlows(double dt);
+static void   findBalancedConduitFlows(double dt);
+static void   findConduitSubStepFlow(int link, double dt);
 static int    isTrueConduit(int link);
 static void   findNonConduitFlow(int link, double dt);
+static int    isRegulator(int link);
+static int    createRegulatorList(void);
 static void   findNonConduitSurfArea(int link);
 static double getModPumpFlow(int link, double q, double dt);
+static int    getBarrels(int link);
+static double getLossRate(int link, int node);
 static void   updateNodeFlows(int link);
+static int    createNodeLinkLists(void);
+static void   gatherNodeFlows(int node);
 static void   updateConvergenceStats();
 
 static int    findNodeDepths(double dt);
+static void   findAitkenOmega(double dt);
 static void   setNodeDepth(int node, double dt);
+static int    isSurchargedNode(int node, double yLast, int isPonded);
+static void   saveNodeDepth(int node, double yNew, double yOld, double dV,
+              int canPond, double dt);
+
+static int    createJacobian(void);
+static void   deleteJacobian(void);
+static int    findNodeDepthsNewton(double dt);
+static void   assembleJacobian(double dt);
+static int    solveJacobian(void);
+static void   multiplyJacobian(double x[], double y[]);
+static double dotProduct(double x[], double y[], int n);
+static void   setNodeDepthNewton(int node, double dy, double dt);
 static double getFloodedDepth(int node, int canPond, double dV, double yNew,
               double yMax, double dt);
 
 static double getVariableStep(double maxStep);
 static double getLinkStep(double tMin, int *minLink);
+static void   setLinkStepClasses(double tStep);
 static double getNodeStep(double tMin, int *minNode);
+static double getConduitStep(int link);
+static double getNodeDepthStep(int node);
+
+static int    createBalance(void);
+static void   deleteBalance(void);
+static double getLinkCost(int link);
+static void   updateBalance(void);
+static void   setBalancedChunks(void);
 
 //=============================================================================
 
@@ -125,8 +249,7 @@ void dynwave_init()
     double z;
 
     VariableStep = 0.0;
-    Xnode = (TXnode *) calloc(Nobjects[NODE], sizeof(TXnode));
-    if ( Xnode == NULL )
+    if ( !createXarrays() )
     {
         report_writeErrorMsg(ERR_MEMORY,
             " Not enough memory for dynamic wave routing.");
@@ -153,11 +276,68 @@ void dynwave_init()
         Node[j].crownElev = MAX(Node[j].crownElev, z);
         Link[i].flowClass = DRY;
         Link[i].dqdh = 0.0;
+        Xlink[i].subSteps = 1;
+    }
+
+    // --- find largest number of sub-steps a conduit can take
+    MaxSubSteps = 1 << (MIN(StepClasses, MAX_STEP_CLASSES) - 1);
+    if ( CourantFactor == 0.0 ) MaxSubSteps = 1;
+    SubStepFlows = NULL;
+    if ( MaxSubSteps > 1 )
+    {
+        SubStepFlows = (double *) calloc(Nobjects[LINK] * MaxSubSteps + 1,
+                                         sizeof(double));
+        if ( SubStepFlows == NULL ) report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
     }
 
     // --- set crown cutoff for finding top width of closed conduits
     if ( SurchargeMethod == SLOT ) CrownCutoff = SLOT_CROWN_CUTOFF;
     else                           CrownCutoff = EXTRAN_CROWN_CUTOFF;
+
+    // --- build node-to-conduit incidence lists for parallel flow updates
+    //     and for the node Jacobian used by Newton iterations
+    NodeLinkStart = NULL;
+    NodeLinkList = NULL;
+    if ( (ParallelNodeFlows || SolverMethod == NEWTON || SkipDormant) &&
+         !createNodeLinkLists() )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
+    WakeList = NULL;
+    if ( SkipDormant )
+    {
+        WakeList = (int *) calloc(Nobjects[NODE]+1, sizeof(int));
+        if ( WakeList == NULL ) report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
+    if ( SolverMethod == NEWTON && !createJacobian() )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
+    if ( LoadBalancing && NumThreads > 1 && !createBalance() )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
+    RegulatorList = NULL;
+    NumRegulators = 0;
+    if ( NumThreads > 1 && !createRegulatorList() )
+    {
+        report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
+    BlockSums = NULL;
+    if ( Deterministic && NumThreads > 1 &&
+         reduce_getBlockCount(Nobjects[NODE]) > 1 )
+    {
+        BlockSums = (double *) calloc(reduce_getBlockCount(Nobjects[NODE]),
+                                      sizeof(double));
+        if ( BlockSums == NULL ) report_writeErrorMsg(ERR_MEMORY,
+            " Not enough memory for dynamic wave routing.");
+    }
 }
 
 //=============================================================================
@@ -168,8 +348,53 @@ void  dynwave_close()
 //  Output:  none
 //  Purpose: frees memory allocated for dynamic wave routing method.
 //
+{
+    deleteXarrays();
+    deleteJacobian();
+    FREE(NodeLinkStart);
+    FREE(NodeLinkList);
+    FREE(WakeList);
+    FREE(RegulatorList);
+    FREE(BlockSums);
+    deleteBalance();
+}
+
+//=============================================================================
+
+int createXarrays()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: allocates the arrays that hold extended node & link data.
+//
+{
+    int nn = Nobjects[NODE];
+    int nl = Nobjects[LINK];
+
+    Xnode = (TXnode *) calloc(nn, sizeof(TXnode));
+    Xlink = (TXlink *) calloc(nl, sizeof(TXlink));
+    DyLast = (double *) calloc(nn, sizeof(double));
+    DyDiff = (double *) calloc(nn, sizeof(double));
+    if ( nn > 0 && (Xnode == NULL || DyLast == NULL || DyDiff == NULL) )
+        return FALSE;
+    if ( nl > 0 && Xlink == NULL ) return FALSE;
+    return TRUE;
+}
+
+//=============================================================================
+
+void deleteXarrays()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the arrays that hold extended node & link data.
+//
 {
     FREE(Xnode);
+    FREE(Xlink);
+    FREE(DyLast);
+    FREE(DyDiff);
+    FREE(SubStepFlows);
 }
 
 //=============================================================================
@@ -216,11 +441,32 @@ double dynwave_getRoutingStep(double fixedStep)
 
     // --- adjust step to be a multiple of a millisecond
     VariableStep = floor(1000.0 * VariableStep) / 1000.0;
+
+    // --- assign conduits to sub-step classes for the new step
+    if ( MaxSubSteps > 1 ) setLinkStepClasses(VariableStep);
     return VariableStep;
 }
 
 //=============================================================================
 
+int dynwave_getThreadTimes(int k, double* busyTime, double* idleTime)
+//
+//  Input:   k = thread index
+//  Output:  busyTime = time thread spent finding conduit flows (sec)
+//           idleTime = time thread waited on other threads (sec)
+//           returns TRUE if conduit loads were balanced among threads
+//  Purpose: retrieves the time a thread spent busy & idle while finding
+//           conduit flows with the LOAD_BALANCING option.
+//
+{
+    if ( k < 0 || k >= Balance.chunks ) return FALSE;
+    *busyTime = Balance.busyTime[k];
+    *idleTime = Balance.idleTime[k];
+    return TRUE;
+}
+
+//=============================================================================
+
 int dynwave_execute(double tStep)
 //
 //  Input:   links = array of topo sorted links indexes
@@ -244,7 +490,8 @@ int dynwave_execute(double tStep)
         // --- execute a routing step & check for nodal convergence
         initNodeStates();
         findLinkFlows(tStep);
-        converged = findNodeDepths(tStep);
+        if ( SolverMethod == NEWTON ) converged = findNodeDepthsNewton(tStep);
+        else                          converged = findNodeDepths(tStep);
         Steps++;
         if ( Steps > 1 )
         {
@@ -258,6 +505,9 @@ int dynwave_execute(double tStep)
 
     //  --- identify any capacity-limited conduits
     findLimitedLinks();
+
+    // --- find nodes & links that could go dormant over next step
+    if ( SkipDormant ) findSteadyStates();
     return Steps;
 }
 
@@ -281,15 +531,22 @@ void   initRoutingStep()
         Xnode[i].converged = FALSE;
         Xnode[i].dYdT = 0.0;
     }
+
+    // --- dormant links keep their flows & surface areas from last step
+    if ( SkipDormant ) findDormantRegions();
     for (i = 0; i < Nobjects[LINK]; i++)
     {
-        Link[i].bypassed = FALSE;
+        Link[i].bypassed = Xlink[i].dormant;
+        if ( Xlink[i].dormant ) continue;
         Link[i].surfArea1 = 0.0;
         Link[i].surfArea2 = 0.0;
     }
 
     // --- a2 preserves conduit area from solution at last time step
     for ( i = 0; i < Nlinks[CONDUIT]; i++) Conduit[i].a2 = Conduit[i].a1;
+
+    // --- periodically re-balance conduit chunks among threads
+    if ( Balance.chunks > 0 ) updateBalance();
 }
 
 //=============================================================================
@@ -337,11 +594,111 @@ void   findBypassedLinks()
     int i;
     for (i = 0; i < Nobjects[LINK]; i++)
     {
-        if ( Xnode[Link[i].node1].converged &&
-             Xnode[Link[i].node2].converged )
-             Link[i].bypassed = TRUE;
-        else Link[i].bypassed = FALSE;
+        Link[i].bypassed = ( Xlink[i].dormant ||
+                           ( Xnode[Link[i].node1].converged &&
+                             Xnode[Link[i].node2].converged ) );
+    }
+}
+
+//=============================================================================
+
+void findSteadyStates()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: identifies the junctions and conduits whose state did not
+//           change over the current time step.
+//
+{
+    int i;
+
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        Xnode[i].steady = ( Node[i].type == JUNCTION &&
+            Xnode[i].converged && Node[i].overflow == 0.0 &&
+            fabs(Node[i].newDepth - Node[i].oldDepth) <= DORMANT_DEPTH_TOL &&
+            fabs(Node[i].inflow - Node[i].outflow) <= DORMANT_FLOW_TOL );
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        Xlink[i].steady = ( isTrueConduit(i) &&
+            fabs(Link[i].newFlow - Link[i].oldFlow) <= DORMANT_FLOW_TOL );
+        Xlink[i].setting = Link[i].setting;
+    }
+}
+
+//=============================================================================
+
+void findDormantRegions()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: finds the junctions and conduits whose updates can be skipped
+//           over the current time step.
+//
+//  A steady junction with unchanged lateral inflow starts out dormant, as
+//  does a steady conduit whose setting was not changed by a control. Any
+//  node that is awake wakes its attached conduits, which in turn wake the
+//  nodes at their other ends, so that a region stays dormant only if it
+//  is not connected to any change. The exception is a dry conduit whose
+//  invert lies above the water level at an awake node; it does not pass
+//  on the wake until backwater from that node reaches it.
+{
+    int i, j, e, n, m;
+    int first = 0, last = 0;
+
+    // --- initial dormant status of nodes & links
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        Xnode[i].dormant = ( Xnode[i].steady &&
+            fabs(Node[i].newLatFlow - Node[i].oldLatFlow) <= DORMANT_FLOW_TOL );
+        if ( !Xnode[i].dormant ) WakeList[last++] = i;
+    }
+    for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        Xlink[j].dormant = ( Xlink[j].steady &&
+                             Xlink[j].setting == Link[j].setting );
+        if ( Xlink[j].dormant ) continue;
+        n = Link[j].node1;
+        m = Link[j].node2;
+        if ( Xnode[n].dormant ) { Xnode[n].dormant = FALSE; WakeList[last++] = n; }
+        if ( Xnode[m].dormant ) { Xnode[m].dormant = FALSE; WakeList[last++] = m; }
     }
+
+    // --- spread wake from each awake node through its conduits
+    while ( first < last )
+    {
+        n = WakeList[first++];
+        for (e = NodeLinkStart[n]; e < NodeLinkStart[n+1]; e++)
+        {
+            j = NodeLinkList[e] / 2;
+            if ( !Xlink[j].dormant || isDryBoundary(j, e % 2, n) ) continue;
+            Xlink[j].dormant = FALSE;
+            if ( e % 2 == 0 ) m = Link[j].node2;
+            else              m = Link[j].node1;
+            if ( Xnode[m].dormant )
+            {
+                Xnode[m].dormant = FALSE;
+                WakeList[last++] = m;
+            }
+        }
+    }
+}
+
+//=============================================================================
+
+int isDryBoundary(int j, int end, int n)
+//
+//  Input:   j   = link index
+//           end = 0 for link's upstream end, 1 for downstream end
+//           n   = index of node at that end
+//  Output:  returns TRUE if link can stay dormant while node n is awake
+//  Purpose: checks if a link carries no flow and has its invert at node n
+//           above the node's water level.
+//
+{
+    double offset = (end == 0) ? Link[j].offset1 : Link[j].offset2;
+    return ( fabs(Link[j].newFlow) <= FUDGE && Node[n].newDepth < offset );
 }
 
 //=============================================================================
@@ -381,31 +738,72 @@ void  findLimitedLinks()
 
 void findLinkFlows(double dt)
 {
-    int i;
+    int i, k;
 
     // --- find new flow in each non-dummy conduit
+    if ( Balance.chunks > 0 ) findBalancedConduitFlows(dt);
+    else
 #pragma omp parallel num_threads(NumThreads)
 {
     #pragma omp for
     for ( i = 0; i < Nobjects[LINK]; i++)
     {
-        if ( isTrueConduit(i) && !Link[i].bypassed )
-            dwflow_findConduitFlow(i, Steps, Omega, dt);
+        if ( isTrueConduit(i) )
+        {
+            if ( !Link[i].bypassed )
+            {
+                if ( Xlink[i].subSteps > 1 ) findConduitSubStepFlow(i, dt);
+                else dwflow_findConduitFlow(i, Steps, OMEGA, dt);
+            }
+        }
     }
 }
 
     // --- update inflow/outflows for nodes attached to non-dummy conduits
-    for ( i = 0; i < Nobjects[LINK]; i++)
+    //     (gathering over each node's conduits in link order reproduces
+    //     the serial summation exactly)
+    if ( NodeLinkList )
+    {
+#pragma omp parallel num_threads(NumThreads)
+{
+        #pragma omp for
+        for ( i = 0; i < Nobjects[NODE]; i++) gatherNodeFlows(i);
+}
+    }
+    else for ( i = 0; i < Nobjects[LINK]; i++)
     {
         if ( isTrueConduit(i) ) updateNodeFlows(i);
     }
 
-    // --- find new flows for all dummy conduits, pumps & regulators
+    // --- find new flows for orifices, weirs & outlets in parallel
+    //     (their flows depend only on node heads)
+    if ( RegulatorList )
+    {
+#pragma omp parallel num_threads(NumThreads) private(i)
+{
+        #pragma omp for
+        for ( k = 0; k < NumRegulators; k++ )
+        {
+            i = RegulatorList[k];
+            if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);
+        }
+}
+    }
+
+    // --- pumps & dummy conduits remain serial since modified pump flows
+    //     and the flow into a dummy conduit depend on the inflows
+    //     accumulated so far at their inlet node
+
+    // --- find new flows for the remaining non-conduit links and update
+    //     the nodes of all non-conduit links in link order
     for ( i = 0; i < Nobjects[LINK]; i++)
     {
         if ( !isTrueConduit(i) )
         {
-            if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);
+            if ( RegulatorList == NULL || !isRegulator(i) )
+            {
+                if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);
+            }
             updateNodeFlows(i);
         }
     }
@@ -413,6 +811,97 @@ void findLinkFlows(double dt)
 
 //=============================================================================
 
+void findBalancedConduitFlows(double dt)
+//
+//  Input:   dt = routing time step (sec)
+//  Output:  none
+//  Purpose: finds new flows in non-dummy conduits with each thread working
+//           on its own contiguous chunk of links of about equal cost.
+//
+{
+    int    i, c, k;
+    int    sampling = (Balance.steps <= BALANCE_SAMPLES);
+    double t0, t, tMax;
+
+    for ( k = 0; k < Balance.chunks; k++ ) Balance.callTime[k] = 0.0;
+
+#pragma omp parallel num_threads(NumThreads) private(i, c, k, t0, t)
+{
+    k = omp_get_thread_num();
+    t0 = omp_get_wtime();
+    for ( c = k; c < Balance.chunks; c += omp_get_num_threads() )
+    {
+        for ( i = Balance.start[c]; i < Balance.start[c+1]; i++ )
+        {
+            if ( !isTrueConduit(i) ) continue;
+            if ( !Link[i].bypassed )
+            {
+                if ( sampling ) t = omp_get_wtime();
+                if ( Xlink[i].subSteps > 1 ) findConduitSubStepFlow(i, dt);
+                else dwflow_findConduitFlow(i, Steps, OMEGA, dt);
+                if ( sampling ) Balance.sample[i] += omp_get_wtime() - t;
+            }
+        }
+    }
+    if ( k < Balance.chunks ) Balance.callTime[k] = omp_get_wtime() - t0;
+}
+
+    // --- threads that finish early wait on the slowest one
+    tMax = 0.0;
+    for ( k = 0; k < Balance.chunks; k++ )
+        tMax = MAX(tMax, Balance.callTime[k]);
+    for ( k = 0; k < Balance.chunks; k++ )
+    {
+        Balance.busyTime[k] += Balance.callTime[k];
+        Balance.idleTime[k] += tMax - Balance.callTime[k];
+    }
+}
+
+//=============================================================================
+
+void findConduitSubStepFlow(int i, double dt)
+//
+//  Input:   i  = link index
+//           dt = routing time step (sec)
+//  Output:  none
+//  Purpose: finds the flow in a conduit that takes several equal sub-steps
+//           within the routing time step.
+//
+//  Note: the momentum equation is advanced over each sub-step using the
+//        current estimate of the end node heads, as a single-rate step
+//        does. Each sub-step's flow is under-relaxed against its value
+//        from the previous iteration. Both end nodes receive the mean of
+//        the sub-step flows, so the volume they exchange is the one the
+//        conduit carried over the routing step.
+{
+    int    m;
+    int    k = Link[i].subIndex;
+    int    n = Xlink[i].subSteps;
+    double qOld = Link[i].oldFlow;
+    double aOld = Conduit[k].a2;
+    double qSum = 0.0;
+    double* qLast = &SubStepFlows[i * MaxSubSteps];
+
+    for ( m = 0; m < n; m++ )
+    {
+        if ( Steps > 0 ) Conduit[k].q1 = qLast[m];
+        dwflow_findConduitFlow(i, Steps, OMEGA, dt / n);
+        qLast[m] = Conduit[k].q1;
+        qSum += Link[i].newFlow;
+        Link[i].oldFlow = Link[i].newFlow;
+        Conduit[k].a2 = Conduit[k].a1;
+    }
+
+    // --- restore start of step state for the next iteration and
+    //     make dqdh apply over the full routing step
+    Link[i].oldFlow = qOld;
+    Conduit[k].a2 = aOld;
+    Link[i].dqdh *= n;
+    Xlink[i].meanFlow = qSum / n;
+}
+
+//=============================================================================
+
 int isTrueConduit(int j)
 {
     return ( Link[j].type == CONDUIT && Link[j].xsect.type != DUMMY );
@@ -420,6 +909,44 @@ int isTrueConduit(int j)
 
 //=============================================================================
 
+int isRegulator(int i)
+{
+    return ( Link[i].type == ORIFICE || Link[i].type == WEIR ||
+             Link[i].type == OUTLET );
+}
+
+//=============================================================================
+
+int createRegulatorList()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: lists the orifices, weirs & outlets whose flows are found in
+//           parallel, grouped by link type.
+//
+{
+    int types[] = {ORIFICE, WEIR, OUTLET};
+    int i, t, n = 0;
+
+    for ( i = 0; i < Nobjects[LINK]; i++ )
+    {
+        if ( isRegulator(i) ) n++;
+    }
+    if ( n == 0 ) return TRUE;
+    RegulatorList = (int *) calloc(n, sizeof(int));
+    if ( RegulatorList == NULL ) return FALSE;
+    for ( t = 0; t < 3; t++ )
+    {
+        for ( i = 0; i < Nobjects[LINK]; i++ )
+        {
+            if ( Link[i].type == types[t] ) RegulatorList[NumRegulators++] = i;
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
 void findNonConduitFlow(int i, double dt)
 //
 //  Input:   i = link index
@@ -447,7 +974,7 @@ void findNonConduitFlow(int i, double dt)
     // --- do not allow flow to change direction without first being 0
     if ( Steps > 0 && Link[i].type != PUMP ) 
     {
-        qNew = (1.0 - Omega) * qLast + Omega * qNew;
+        qNew = (1.0 - OMEGA) * qLast + OMEGA * qNew;
         if ( qNew * qLast < 0.0 ) qNew = 0.001 * SGN(qNew);
     }
     Link[i].newFlow = qNew;
@@ -525,20 +1052,59 @@ void  findNonConduitSurfArea(int i)
 
 //=============================================================================
 
+int getBarrels(int i)
+//
+//  Input:   i = link index
+//  Output:  returns number of barrels in link
+//  Purpose: finds the number of barrels whose flow a link carries.
+//
+{
+    if ( Link[i].type == CONDUIT ) return Conduit[Link[i].subIndex].barrels;
+    return 1;
+}
+
+//=============================================================================
+
+double getLossRate(int i, int n)
+//
+//  Input:   i = link index
+//           n = index of one of the link's end nodes
+//  Output:  returns evap & seepage loss rate assigned to node n (cfs)
+//  Purpose: finds the share of a conduit's uniform evap & seepage losses
+//           that is removed at one of its end nodes.
+//
+{
+    int    k;
+    double conduitLossRate;
+
+    if ( Link[i].type != CONDUIT || Node[n].type == OUTFALL ) return 0.0;
+    k = Link[i].subIndex;
+    conduitLossRate = (Conduit[k].evapLossRate + Conduit[k].seepLossRate) *
+                      Conduit[k].barrels;
+    if ( conduitLossRate <= 0.0 ) return 0.0;
+
+    // --- outfall nodes do not share evap & seepage losses
+    if ( Node[Link[i].node1].type != OUTFALL &&
+         Node[Link[i].node2].type != OUTFALL ) conduitLossRate /= 2.0;
+    return conduitLossRate;
+}
+
+//=============================================================================
+
 void updateNodeFlows(int i)
 //
 //  Input:   i = link index
-//           q = link flow rate (cfs)
 //  Output:  none
 //  Purpose: updates cumulative inflow & outflow at link's end nodes.
 //
 {
-    int    k;
-    int    barrels = 1;
+    int    barrels = getBarrels(i);
     int    n1 = Link[i].node1;
     int    n2 = Link[i].node2;
     double q = Link[i].newFlow;
-    double conduitLossRate = 0.0;
+
+    // --- a conduit taking sub-steps passes on its mean flow
+    if ( Xlink[i].subSteps > 1 ) q = Xlink[i].meanFlow;
 
     // --- update total inflow & outflow at upstream/downstream nodes
     if ( q >= 0.0 )
@@ -553,39 +1119,116 @@ void updateNodeFlows(int i)
     }
  
     // --- add any uniform evap & seepage loss from conduit link
-    if ( Link[i].type == CONDUIT )
-    {
-        k = Link[i].subIndex;
-        barrels = Conduit[k].barrels;
-        conduitLossRate = (Conduit[k].evapLossRate + Conduit[k].seepLossRate) *
-                          barrels;
-        if (conduitLossRate > 0.0)
-        {
-            // --- outfall nodes do not share evap & seepage losses
-            if (Node[n1].type != OUTFALL && Node[n2].type != OUTFALL)
-                conduitLossRate /= 2.0;
-            if (Node[n1].type != OUTFALL)
-                Node[n1].outflow += conduitLossRate;
-            if (Node[n2].type != OUTFALL)
-                Node[n2].outflow += conduitLossRate;
-        }
-    }
+    Node[n1].outflow += getLossRate(i, n1);
+    Node[n2].outflow += getLossRate(i, n2);
     
     // --- add surf. area contributions to upstream/downstream nodes
-    Xnode[Link[i].node1].newSurfArea += Link[i].surfArea1 * barrels;
-    Xnode[Link[i].node2].newSurfArea += Link[i].surfArea2 * barrels;
+    Xnode[n1].newSurfArea += Link[i].surfArea1 * barrels;
+    Xnode[n2].newSurfArea += Link[i].surfArea2 * barrels;
 
     // --- update summed value of dqdh at each end node
-    Xnode[Link[i].node1].sumdqdh += Link[i].dqdh;
-    if ( Link[i].type == PUMP )
+    //     (Type 4 pump's flow does not depend on its outlet node's head)
+    Xnode[n1].sumdqdh += Link[i].dqdh;
+    if ( Link[i].type != PUMP || Pump[Link[i].subIndex].type != TYPE4_PUMP )
+        Xnode[n2].sumdqdh += Link[i].dqdh;
+}
+
+//=============================================================================
+
+int createNodeLinkLists()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: lists the ends of non-dummy conduits attached to each node,
+//           in order of increasing link index.
+//
+{
+    int i, n;
+    int* count;
+
+    NodeLinkStart = (int *) calloc(Nobjects[NODE]+1, sizeof(int));
+    if ( NodeLinkStart == NULL ) return FALSE;
+
+    // --- count conduit ends at each node (a conduit that loops back
+    //     onto the same node is listed just once)
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( !isTrueConduit(i) ) continue;
+        NodeLinkStart[Link[i].node1+1]++;
+        if ( Link[i].node2 != Link[i].node1 ) NodeLinkStart[Link[i].node2+1]++;
+    }
+    for (n = 0; n < Nobjects[NODE]; n++)
+        NodeLinkStart[n+1] += NodeLinkStart[n];
+
+    // --- fill in each node's list of conduit ends
+    NodeLinkList = (int *) calloc(NodeLinkStart[Nobjects[NODE]]+1, sizeof(int));
+    count = (int *) calloc(Nobjects[NODE], sizeof(int));
+    if ( NodeLinkList == NULL || count == NULL )
+    {
+        FREE(NodeLinkList);
+        FREE(count);
+        return FALSE;
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( !isTrueConduit(i) ) continue;
+        n = Link[i].node1;
+        NodeLinkList[NodeLinkStart[n] + count[n]++] = 2*i;
+        n = Link[i].node2;
+        if ( n != Link[i].node1 )
+            NodeLinkList[NodeLinkStart[n] + count[n]++] = 2*i + 1;
+    }
+    FREE(count);
+    return TRUE;
+}
+
+//=============================================================================
+
+void gatherNodeFlows(int n)
+//
+//  Input:   n = node index
+//  Output:  none
+//  Purpose: adds the flow, losses, surface area and dqdh of each non-dummy
+//           conduit attached to a node to the node's cumulative totals.
+//
+//  Note: contributions are added in the same order as updateNodeFlows()
+//        makes them so that results are identical to a serial update.
+{
+    int    e, i;
+    double q;
+
+    for (e = NodeLinkStart[n]; e < NodeLinkStart[n+1]; e++)
     {
-        k = Link[i].subIndex;
-        if ( Pump[k].type != TYPE4_PUMP )
+        i = NodeLinkList[e] / 2;
+
+        // --- a conduit connected at both ends to this node
+        if ( Link[i].node1 == Link[i].node2 )
+        {
+            updateNodeFlows(i);
+            continue;
+        }
+        q = Link[i].newFlow;
+        if ( Xlink[i].subSteps > 1 ) q = Xlink[i].meanFlow;
+
+        // --- node is conduit's upstream end
+        if ( NodeLinkList[e] % 2 == 0 )
+        {
+            if ( q >= 0.0 ) Node[n].outflow += q;
+            else            Node[n].inflow  -= q;
+            Node[n].outflow += getLossRate(i, n);
+            Xnode[n].newSurfArea += Link[i].surfArea1 * getBarrels(i);
+        }
+
+        // --- node is conduit's downstream end
+        else
         {
-            Xnode[n2].sumdqdh += Link[i].dqdh;
+            if ( q >= 0.0 ) Node[n].inflow  += q;
+            else            Node[n].outflow -= q;
+            Node[n].outflow += getLossRate(i, n);
+            Xnode[n].newSurfArea += Link[i].surfArea2 * getBarrels(i);
         }
+        Xnode[n].sumdqdh += Link[i].dqdh;
     }
-    else Xnode[n2].sumdqdh += Link[i].dqdh;
 }
 
 //=============================================================================
@@ -604,6 +1247,9 @@ int findNodeDepths(double dt)
     // --- compute outfall depths based on flow in connecting link
     for ( i = 0; i < Nobjects[LINK]; i++ ) link_setOutfallDepth(i);
 
+    // --- update under-relaxation factor from successive depth changes
+    if ( Relaxation == AITKEN_RELAXATION ) findAitkenOmega(dt);
+
     // --- compute new depth for all non-outfall nodes and determine if
     //     depth change from previous iteration is below tolerance
 #pragma omp parallel num_threads(NumThreads)
@@ -612,6 +1258,11 @@ int findNodeDepths(double dt)
     for ( i = 0; i < Nobjects[NODE]; i++ )
     {
         if ( Node[i].type == OUTFALL ) continue;
+        if ( Xnode[i].dormant )
+        {
+            Xnode[i].converged = TRUE;
+            continue;
+        }
         yOld = Node[i].newDepth;
         setNodeDepth(i, dt);
         Xnode[i].converged = TRUE;
@@ -633,10 +1284,70 @@ int findNodeDepths(double dt)
 
 //=============================================================================
 
-void setNodeDepth(int i, double dt)
+void findAitkenOmega(double dt)
 //
-//  Input:   i  = node index
-//           dt = time step (sec)
+//  Input:   dt = time step (sec)
+//  Output:  none
+//  Purpose: updates the under-relaxation factor applied to node depths
+//           using Aitken's delta-squared method.
+//
+//  The unrelaxed depth change r at each non-surcharged node is compared
+//  with the one from the previous iteration. The new factor is
+//  Omega = -Omega * (rLast . (r - rLast)) / |r - rLast|^2, where Omega is
+//  taken as 1 for the first iteration since it is not under-relaxed.
+//  Link flows continue to use the fixed factor OMEGA.
+{
+    int    i;
+    int    nn = Nobjects[NODE];
+    int    isPonded;
+    double surfArea, dV, r;
+    double num, den;
+
+    // --- find change in unrelaxed depth change at non-surcharged nodes
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(isPonded, surfArea, dV, r)
+    for ( i = 0; i < nn; i++ )
+    {
+        r = 0.0;
+        isPonded = (AllowPonding && Node[i].pondedArea > 0.0 &&
+                    Node[i].newDepth > Node[i].fullDepth);
+        if ( Node[i].type != OUTFALL &&
+             !isSurchargedNode(i, Node[i].newDepth, isPonded) )
+        {
+            surfArea = MAX(Xnode[i].newSurfArea, MinSurfArea);
+            dV = 0.5 * (Node[i].oldNetInflow + Node[i].inflow -
+                        Node[i].outflow) * dt;
+            r = Node[i].oldDepth + dV / surfArea - Node[i].newDepth;
+        }
+        DyDiff[i] = r - DyLast[i];
+    }
+}
+
+    // --- form products with change from last iteration
+    num = 0.0;
+    den = 0.0;
+    if ( Steps > 0 )
+    {
+        num = dotProduct(DyLast, DyDiff, nn);
+        den = dotProduct(DyDiff, DyDiff, nn);
+    }
+    for ( i = 0; i < nn; i++ ) DyLast[i] += DyDiff[i];
+
+    // --- update the relaxation factor within its limits
+    if ( Steps == 0 || den <= 0.0 ) return;
+    if ( Steps == 1 ) Omega = -num / den;
+    else              Omega = -Omega * num / den;
+    Omega = MAX(Omega, OMEGA_MIN);
+    Omega = MIN(Omega, OMEGA_MAX);
+}
+
+//=============================================================================
+
+void setNodeDepth(int i, double dt)
+//
+//  Input:   i  = node index
+//           dt = time step (sec)
 //  Output:  none
 //  Purpose: sets depth at non-outfall node after current time step.
 //
@@ -647,7 +1358,6 @@ void setNodeDepth(int i, double dt)
     double  dQ;                        // inflow minus outflow at node (cfs)
     double  dV;                        // change in node volume (ft3)
     double  dy;                        // change in node depth (ft)
-    double  yMax;                      // max. depth at node (ft)
     double  yOld;                      // node depth at previous time step (ft)
     double  yLast;                     // previous node depth (ft)
     double  yNew;                      // new node depth (ft)
@@ -674,21 +1384,7 @@ void setNodeDepth(int i, double dt)
     dV = 0.5 * (Node[i].oldNetInflow + dQ) * dt;
 
     // --- determine if node is EXTRAN surcharged
-    if (SurchargeMethod == EXTRAN)
-    {
-        // --- ponded nodes don't surcharge
-        if (isPonded) isSurcharged = FALSE;
-
-        // --- closed storage units that are full are in surcharge
-        else if (Node[i].type == STORAGE)
-        {
-            isSurcharged = (Node[i].surDepth > 0.0 &&
-                            yLast > Node[i].fullDepth);
-        }
-
-        // --- surcharge occurs when node depth exceeds top of its highest link
-        else isSurcharged = (yCrown > 0.0 && yLast > yCrown);
-    }
+    isSurcharged = isSurchargedNode(i, yLast, isPonded);
 
     // --- if node not surcharged, base depth change on surface area        
     if (!isSurcharged)
@@ -739,6 +1435,53 @@ void setNodeDepth(int i, double dt)
         if ( canPond && yNew > Node[i].fullDepth )
             yNew = Node[i].fullDepth + FUDGE;
     }
+    saveNodeDepth(i, yNew, yOld, dV, canPond, dt);
+}
+
+//=============================================================================
+
+int isSurchargedNode(int i, double yLast, int isPonded)
+//
+//  Input:   i = node index
+//           yLast = node depth from previous iteration (ft)
+//           isPonded = TRUE if node is currently ponded
+//  Output:  returns TRUE if node is EXTRAN surcharged
+//  Purpose: determines if a node's depth should be found from the
+//           EXTRAN surcharge algorithm.
+//
+{
+    double yCrown = Node[i].crownElev - Node[i].invertElev;
+
+    if ( SurchargeMethod != EXTRAN ) return FALSE;
+
+    // --- ponded nodes don't surcharge
+    if ( isPonded ) return FALSE;
+
+    // --- closed storage units that are full are in surcharge
+    if ( Node[i].type == STORAGE )
+        return (Node[i].surDepth > 0.0 && yLast > Node[i].fullDepth);
+
+    // --- surcharge occurs when node depth exceeds top of its highest link
+    return (yCrown > 0.0 && yLast > yCrown);
+}
+
+//=============================================================================
+
+void saveNodeDepth(int i, double yNew, double yOld, double dV, int canPond,
+                   double dt)
+//
+//  Input:   i = node index
+//           yNew = new estimate of node depth (ft)
+//           yOld = node depth at previous time step (ft)
+//           dV = change in node volume over time step (ft3)
+//           canPond = TRUE if node can pond overflows
+//           dt = time step (sec)
+//  Output:  none
+//  Purpose: checks a node's new depth for flooding and saves it along with
+//           the node's new volume.
+//
+{
+    double yMax;                       // max. depth at node (ft)
 
     // --- depth cannot be negative
     if ( yNew < 0 ) yNew = 0.0;
@@ -796,6 +1539,355 @@ double getFloodedDepth(int i, int canPond, double dV, double yNew,
 
 //=============================================================================
 
+int createJacobian()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: allocates the arrays used to form and solve the node Jacobian.
+//
+{
+    int nn = Nobjects[NODE];
+    int nl = Nobjects[LINK];
+
+    Jac.diag    = (double *) calloc(nn, sizeof(double));
+    Jac.offDiag = (double *) calloc(nl, sizeof(double));
+    Jac.resid   = (double *) calloc(nn, sizeof(double));
+    Jac.dy      = (double *) calloc(nn, sizeof(double));
+    Jac.r       = (double *) calloc(nn, sizeof(double));
+    Jac.z       = (double *) calloc(nn, sizeof(double));
+    Jac.p       = (double *) calloc(nn, sizeof(double));
+    Jac.q       = (double *) calloc(nn, sizeof(double));
+    if ( nn > 0 && (Jac.diag == NULL || Jac.resid == NULL ||
+         Jac.dy == NULL || Jac.r == NULL || Jac.z == NULL ||
+         Jac.p == NULL || Jac.q == NULL) ) return FALSE;
+    if ( nl > 0 && Jac.offDiag == NULL ) return FALSE;
+    return TRUE;
+}
+
+//=============================================================================
+
+void deleteJacobian()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the arrays used to form and solve the node Jacobian.
+//
+{
+    FREE(Jac.diag);
+    FREE(Jac.offDiag);
+    FREE(Jac.resid);
+    FREE(Jac.dy);
+    FREE(Jac.r);
+    FREE(Jac.z);
+    FREE(Jac.p);
+    FREE(Jac.q);
+}
+
+//=============================================================================
+
+int findNodeDepthsNewton(double dt)
+//
+//  Input:   dt = time step (sec)
+//  Output:  returns TRUE if depth change at all non-Outfall nodes is
+//           within the convergence tolerance and FALSE otherwise
+//  Purpose: finds new depth at all nodes from a Newton step on the coupled
+//           node continuity equations.
+//
+//  The continuity residual at each node is linearized with respect to the
+//  heads at the node and its neighbors using the dq/dh of the connecting
+//  conduits, which were found from the link momentum equations. The
+//  resulting sparse Jacobian is symmetric and diagonally dominant and is
+//  solved by a Jacobi preconditioned conjugate gradient method. If that
+//  solve fails to converge the trial updates node depths the Picard way.
+{
+    int i;
+    double yOld = 0.0;       // previous node depth (ft)
+
+    // --- compute outfall depths based on flow in connecting link
+    for ( i = 0; i < Nobjects[LINK]; i++ ) link_setOutfallDepth(i);
+
+    // --- solve for the change in depth at all nodes
+    //     (or use a Picard update if the solve fails)
+    assembleJacobian(dt);
+    if ( !solveJacobian() )
+    {
+        PicardFallbackCount++;
+        return findNodeDepths(dt);
+    }
+
+    // --- update depth at all non-outfall nodes and determine if
+    //     depth change from previous iteration is below tolerance
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(yOld)
+    for ( i = 0; i < Nobjects[NODE]; i++ )
+    {
+        if ( Node[i].type == OUTFALL ) continue;
+        if ( Xnode[i].dormant )
+        {
+            Xnode[i].converged = TRUE;
+            continue;
+        }
+        yOld = Node[i].newDepth;
+        setNodeDepthNewton(i, Jac.dy[i], dt);
+        Xnode[i].converged = TRUE;
+        if ( fabs(yOld - Node[i].newDepth) > HeadTol )
+        {
+            Xnode[i].converged = FALSE;
+        }
+    }
+}
+
+   // --- return FALSE if any non-Outfall node failed to converge
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        if ( Node[i].type == OUTFALL ) continue;
+        if (Xnode[i].converged == FALSE) return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void assembleJacobian(double dt)
+//
+//  Input:   dt = time step (sec)
+//  Output:  none
+//  Purpose: forms the continuity residual and Jacobian at each node.
+//
+//  Rows of surcharged nodes (whose volume is fixed) are scaled by 1/2 so
+//  that every conduit contributes the same -dqdh/2 term to both of its
+//  end nodes' rows. Outfalls and nodes with no head dependence keep their
+//  current depth and are given a zero diagonal.
+{
+    int    i, n1, n2;
+    int    isPonded;
+    double yCrown, yLast, f;
+    double surfArea, dQ, denom;
+
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(isPonded, yCrown, yLast, f, surfArea, dQ, denom)
+    for ( i = 0; i < Nobjects[NODE]; i++ )
+    {
+        Jac.diag[i] = 0.0;
+        Jac.resid[i] = 0.0;
+        if ( Node[i].type == OUTFALL || Xnode[i].dormant ) continue;
+
+        isPonded = (AllowPonding && Node[i].pondedArea > 0.0 &&
+                    Node[i].newDepth > Node[i].fullDepth);
+        yCrown = Node[i].crownElev - Node[i].invertElev;
+        yLast = Node[i].newDepth;
+        surfArea = MAX(Xnode[i].newSurfArea, MinSurfArea);
+        dQ = Node[i].inflow - Node[i].outflow;
+
+        // --- surcharged node: net inflow must vanish
+        if ( isSurchargedNode(i, yLast, isPonded) )
+        {
+            denom = Xnode[i].sumdqdh;
+            if ( yLast < 1.25 * yCrown )
+            {
+                f = (yLast - yCrown) / yCrown;
+                denom += (Xnode[i].oldSurfArea/dt -
+                          Xnode[i].sumdqdh) * exp(-15.0 * f);
+            }
+            Jac.diag[i] = 0.5 * MAX(denom, Xnode[i].sumdqdh);
+            Jac.resid[i] = -0.5 * dQ;
+        }
+
+        // --- otherwise volume change balances average net inflow
+        else
+        {
+            Jac.diag[i] = surfArea / dt + 0.5 * Xnode[i].sumdqdh;
+            Jac.resid[i] = surfArea * (yLast - Node[i].oldDepth) / dt -
+                           0.5 * (Node[i].oldNetInflow + dQ);
+        }
+        if ( Jac.diag[i] <= 0.0 )
+        {
+            Jac.diag[i] = 0.0;
+            Jac.resid[i] = 0.0;
+        }
+    }
+
+    // --- off-diagonal term of each conduit joining two active nodes
+    #pragma omp for private(n1, n2)
+    for ( i = 0; i < Nobjects[LINK]; i++ )
+    {
+        Jac.offDiag[i] = 0.0;
+        if ( !isTrueConduit(i) ) continue;
+        n1 = Link[i].node1;
+        n2 = Link[i].node2;
+        if ( n1 == n2 || Jac.diag[n1] == 0.0 || Jac.diag[n2] == 0.0 ) continue;
+        Jac.offDiag[i] = -0.5 * Link[i].dqdh;
+    }
+}
+}
+
+//=============================================================================
+
+int solveJacobian()
+//
+//  Input:   none
+//  Output:  returns TRUE if the solution converged, FALSE otherwise
+//  Purpose: solves the node Jacobian system J*dy = -resid for the depth
+//           corrections dy using Jacobi preconditioned conjugate gradients.
+//
+{
+    int    i, k;
+    int    nn = Nobjects[NODE];
+    double rz, rzNew, pq, rr, rr0, alpha, beta;
+
+    // --- initial residual, preconditioned residual & search direction
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for
+    for ( i = 0; i < nn; i++ )
+    {
+        Jac.dy[i] = 0.0;
+        Jac.r[i] = -Jac.resid[i];
+        if ( Jac.diag[i] > 0.0 ) Jac.z[i] = Jac.r[i] / Jac.diag[i];
+        else                     Jac.z[i] = 0.0;
+        Jac.p[i] = Jac.z[i];
+    }
+}
+    rz = dotProduct(Jac.r, Jac.z, nn);
+    rr0 = dotProduct(Jac.r, Jac.r, nn);
+    if ( rr0 == 0.0 ) return TRUE;
+
+    // --- conjugate gradient iterations
+    for ( k = 0; k < nn; k++ )
+    {
+        multiplyJacobian(Jac.p, Jac.q);
+        pq = dotProduct(Jac.p, Jac.q, nn);
+        if ( !(pq > 0.0) ) return FALSE;
+        alpha = rz / pq;
+
+#pragma omp parallel num_threads(NumThreads)
+{
+        #pragma omp for
+        for ( i = 0; i < nn; i++ )
+        {
+            Jac.dy[i] += alpha * Jac.p[i];
+            Jac.r[i] -= alpha * Jac.q[i];
+            if ( Jac.diag[i] > 0.0 ) Jac.z[i] = Jac.r[i] / Jac.diag[i];
+        }
+}
+        rr = dotProduct(Jac.r, Jac.r, nn);
+        if ( rr <= CG_TOL * CG_TOL * rr0 ) return TRUE;
+        rzNew = dotProduct(Jac.r, Jac.z, nn);
+
+        beta = rzNew / rz;
+        rz = rzNew;
+#pragma omp parallel num_threads(NumThreads)
+{
+        #pragma omp for
+        for ( i = 0; i < nn; i++ ) Jac.p[i] = Jac.z[i] + beta * Jac.p[i];
+}
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+double dotProduct(double x[], double y[], int n)
+//
+//  Input:   x, y = arrays of node values
+//           n    = number of values
+//  Output:  returns dot product of x and y
+//  Purpose: finds a dot product over all nodes.
+//
+//  Note: in DETERMINISTIC mode a parallel fixed-order reduction is used;
+//        otherwise the terms are summed serially. Either way the result
+//        is the same for any number of threads.
+{
+    int    i;
+    double s = 0.0;
+
+    if ( Deterministic ) return reduce_dot(x, y, n, BlockSums, NumThreads);
+    for ( i = 0; i < n; i++ ) s += x[i] * y[i];
+    return s;
+}
+
+//=============================================================================
+
+void multiplyJacobian(double x[], double y[])
+//
+//  Input:   x = vector of node values
+//  Output:  y = node Jacobian times x
+//  Purpose: multiplies a vector by the node Jacobian using each node's
+//           list of attached conduits.
+//
+{
+    int    i, e, j, k;
+    double sum;
+
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(e, j, k, sum)
+    for ( i = 0; i < Nobjects[NODE]; i++ )
+    {
+        sum = Jac.diag[i] * x[i];
+        for ( e = NodeLinkStart[i]; e < NodeLinkStart[i+1]; e++ )
+        {
+            j = NodeLinkList[e] / 2;
+            if ( NodeLinkList[e] % 2 == 0 ) k = Link[j].node2;
+            else                            k = Link[j].node1;
+            sum += Jac.offDiag[j] * x[k];
+        }
+        y[i] = sum;
+    }
+}
+}
+
+//=============================================================================
+
+void setNodeDepthNewton(int i, double dy, double dt)
+//
+//  Input:   i  = node index
+//           dy = Newton correction to node's current depth (ft)
+//           dt = time step (sec)
+//  Output:  none
+//  Purpose: sets depth at non-outfall node from a Newton depth correction.
+//
+{
+    int     canPond;                   // TRUE if node can pond overflows
+    int     isPonded;                  // TRUE if node is currently ponded
+    double  dV;                        // change in node volume (ft3)
+    double  yLast;                     // previous node depth (ft)
+    double  yNew;                      // new node depth (ft)
+    double  yCrown;                    // depth to node crown (ft)
+
+    // --- see if node can pond water above it
+    canPond = (AllowPonding && Node[i].pondedArea > 0.0);
+    isPonded = (canPond && Node[i].newDepth > Node[i].fullDepth);
+
+    // --- initialize values
+    yCrown = Node[i].crownElev - Node[i].invertElev;
+    yLast = Node[i].newDepth;
+    Node[i].overflow = 0.0;
+    dV = 0.5 * (Node[i].oldNetInflow + Node[i].inflow - Node[i].outflow) * dt;
+    if ( Steps > 0 ) dy *= Omega;
+    yNew = yLast + dy;
+
+    // --- apply the same depth limits used by the Picard method
+    if ( !isSurchargedNode(i, yLast, isPonded) )
+    {
+        if ( !isPonded )
+            Xnode[i].oldSurfArea = MAX(Xnode[i].newSurfArea, MinSurfArea);
+        if ( isPonded && yNew < Node[i].fullDepth )
+            yNew = Node[i].fullDepth - FUDGE;
+    }
+    else
+    {
+        if ( yNew < yCrown ) yNew = yCrown - FUDGE;
+        if ( canPond && yNew > Node[i].fullDepth )
+            yNew = Node[i].fullDepth + FUDGE;
+    }
+    saveNodeDepth(i, yNew, Node[i].oldDepth, dV, canPond, dt);
+}
+
+//=============================================================================
+
 double getVariableStep(double maxStep)
 //
 //  Input:   maxStep = user-supplied max. time step (sec)
@@ -813,6 +1905,21 @@ double getVariableStep(double maxStep)
     // --- find stable time step for links & then nodes
     tMin = maxStep;
     tMinLink = getLinkStep(tMin, &minLink);
+
+    // --- conduits with the shortest steps can sub-step within the
+    //     routing step when multiple step classes are used, but the
+    //     step may at most double from the last one since sub-step
+    //     classes are set from that step's flows (no link is critical
+    //     if this makes the max. time step govern)
+    if ( MaxSubSteps > 1 )
+    {
+        tMinLink = MIN(tMinLink * MaxSubSteps, 2.0 * VariableStep);
+        if ( tMinLink > maxStep )
+        {
+            tMinLink = maxStep;
+            minLink = -1;
+        }
+    }
     tMinNode = getNodeStep(tMinLink, &minNode);
 
     // --- use smaller of the link and node time step
@@ -840,44 +1947,111 @@ double getLinkStep(double tMin, int *minLink)
 //           returns critical time step (sec)
 //  Purpose: finds critical time step for conduits based on Courant criterion.
 //
+//  Note: each thread finds the smallest time step over its share of links
+//        and the results are combined so that the lowest link index wins
+//        any ties, as with a serial search.
 {
     int    i;                           // link index
-    int    k;                           // conduit index
-    double q;                           // conduit flow (cfs)
-    double t;                           // time step (sec)
     double tLink = tMin;                // critical link time step (sec)
 
-    // --- examine each conduit link
+#pragma omp parallel num_threads(NumThreads)
+{
+    int    iLocal = -1;                 // thread's critical link
+    double tLocal = tMin;               // thread's critical time step (sec)
+    double t;                           // time step (sec)
+
+    #pragma omp for
     for ( i = 0; i < Nobjects[LINK]; i++ )
     {
-        if ( Link[i].type == CONDUIT )
+        t = getConduitStep(i);
+        if ( t < tLocal )
         {
-            // --- skip conduits with negligible flow, area or Fr
-            k = Link[i].subIndex;
-            q = fabs(Link[i].newFlow) / Conduit[k].barrels;
-            if ( q <= FUDGE 
-            ||   Conduit[k].a1 <= FUDGE
-            ||   Link[i].froude <= 0.01 
-               ) continue;
-
-            // --- compute time step to satisfy Courant condition
-            t = Link[i].newVolume / Conduit[k].barrels / q;
-            t = t * Conduit[k].modLength / link_getLength(i);
-            t = t * Link[i].froude / (1.0 + Link[i].froude) * CourantFactor;
+            tLocal = t;
+            iLocal = i;
+        }
+    }
 
-            // --- update critical link time step
-            if ( t < tLink )
-            {
-                tLink = t;
-                *minLink = i;
-            }
+    // --- update critical link time step
+    #pragma omp critical
+    {
+        if ( iLocal >= 0 &&
+             (tLocal < tLink || (tLocal == tLink && iLocal < *minLink)) )
+        {
+            tLink = tLocal;
+            *minLink = iLocal;
         }
     }
+}
     return tLink;
 }
 
 //=============================================================================
 
+void setLinkStepClasses(double tStep)
+//
+//  Input:   tStep = routing time step (sec)
+//  Output:  none
+//  Purpose: assigns each conduit the smallest power-of-two number of
+//           sub-steps that satisfies its Courant condition.
+//
+{
+    int    i, m, n;
+    double t;
+
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for private(m, n, t)
+    for ( i = 0; i < Nobjects[LINK]; i++ )
+    {
+        n = 1;
+        t = getConduitStep(i);
+        while ( n < MaxSubSteps && t * n < tStep ) n *= 2;
+        Xlink[i].subSteps = n;
+
+        // --- sub-steps start from the flow at the end of the last step
+        if ( n > 1 )
+        {
+            for ( m = 0; m < n; m++ ) SubStepFlows[i * MaxSubSteps + m] =
+                Conduit[Link[i].subIndex].q1;
+            Xlink[i].meanFlow = Link[i].newFlow;
+        }
+    }
+}
+}
+
+//=============================================================================
+
+double getConduitStep(int i)
+//
+//  Input:   i = link index
+//  Output:  returns time step satisfying the Courant condition for a
+//           conduit link, or BIG if the link places no limit on it (sec)
+//  Purpose: finds the critical time step for a single link.
+//
+{
+    int    k;                           // conduit index
+    double q;                           // conduit flow (cfs)
+    double t;                           // time step (sec)
+
+    if ( Link[i].type != CONDUIT ) return BIG;
+
+    // --- skip conduits with negligible flow, area or Fr
+    k = Link[i].subIndex;
+    q = fabs(Link[i].newFlow) / Conduit[k].barrels;
+    if ( q <= FUDGE
+    ||   Conduit[k].a1 <= FUDGE
+    ||   Link[i].froude <= 0.01
+       ) return BIG;
+
+    // --- compute time step to satisfy Courant condition
+    t = Link[i].newVolume / Conduit[k].barrels / q;
+    t = t * Conduit[k].modLength / link_getLength(i);
+    t = t * Link[i].froude / (1.0 + Link[i].froude) * CourantFactor;
+    return t;
+}
+
+//=============================================================================
+
 double getNodeStep(double tMin, int *minNode)
 //
 //  Input:   tMin = critical time step found so far (sec)
@@ -888,34 +2062,233 @@ double getNodeStep(double tMin, int *minNode)
 //
 {
     int    i;                           // node index
-    double maxDepth;                    // max. depth allowed at node (ft)
-    double dYdT;                        // change in depth per unit time (ft/sec)
-    double t1;                          // time needed to reach depth limit (sec)
     double tNode = tMin;                // critical node time step (sec)
 
     // --- find smallest time so that estimated change in nodal depth
     //     does not exceed safety factor * maxdepth
+#pragma omp parallel num_threads(NumThreads)
+{
+    int    iLocal = -1;                 // thread's critical node
+    double tLocal = tMin;               // thread's critical time step (sec)
+    double t1;                          // time needed to reach depth limit (sec)
+
+    #pragma omp for
     for ( i = 0; i < Nobjects[NODE]; i++ )
     {
-        // --- see if node can be skipped
-        if ( Node[i].type == OUTFALL ) continue;
-        if ( Node[i].newDepth <= FUDGE) continue;
-        if ( Node[i].newDepth  + FUDGE >=
-             Node[i].crownElev - Node[i].invertElev ) continue;
-
-        // --- define max. allowable depth change using crown elevation
-        maxDepth = (Node[i].crownElev - Node[i].invertElev) * 0.25;
-        if ( maxDepth < FUDGE ) continue;
-        dYdT = Xnode[i].dYdT;
-        if (dYdT < FUDGE ) continue;
+        t1 = getNodeDepthStep(i);
+        if ( t1 < tLocal )
+        {
+            tLocal = t1;
+            iLocal = i;
+        }
+    }
 
-        // --- compute time to reach max. depth & compare with critical time
-        t1 = maxDepth / dYdT;
-        if ( t1 < tNode )
+    // --- compare with critical time found by other threads
+    #pragma omp critical
+    {
+        if ( iLocal >= 0 &&
+             (tLocal < tNode || (tLocal == tNode && iLocal < *minNode)) )
         {
-            tNode = t1;
-            *minNode = i;
+            tNode = tLocal;
+            *minNode = iLocal;
         }
     }
+}
     return tNode;
 }
+
+//=============================================================================
+
+double getNodeDepthStep(int i)
+//
+//  Input:   i = node index
+//  Output:  returns time for node's depth to change by its max. allowable
+//           amount, or BIG if the node places no limit on it (sec)
+//  Purpose: finds the critical time step for a single node.
+//
+{
+    double maxDepth;                    // max. depth allowed at node (ft)
+    double dYdT;                        // change in depth per unit time (ft/sec)
+
+    // --- see if node can be skipped
+    if ( Node[i].type == OUTFALL ) return BIG;
+    if ( Node[i].newDepth <= FUDGE) return BIG;
+    if ( Node[i].newDepth  + FUDGE >=
+         Node[i].crownElev - Node[i].invertElev ) return BIG;
+
+    // --- define max. allowable depth change using crown elevation
+    maxDepth = (Node[i].crownElev - Node[i].invertElev) * 0.25;
+    if ( maxDepth < FUDGE ) return BIG;
+    dYdT = Xnode[i].dYdT;
+    if (dYdT < FUDGE ) return BIG;
+
+    // --- compute time to reach max. depth
+    return maxDepth / dYdT;
+}
+
+//=============================================================================
+
+int createBalance()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: allocates the arrays used to balance conduit flow updates among
+//           threads and forms the initial chunks from estimated link costs.
+//
+{
+    int i;
+    int nl = Nobjects[LINK];
+    int nc = NumThreads;
+
+    Balance.start    = (int *) calloc(nc+1, sizeof(int));
+    Balance.cost     = (double *) calloc(nl, sizeof(double));
+    Balance.sample   = (double *) calloc(nl, sizeof(double));
+    Balance.callTime = (double *) calloc(nc, sizeof(double));
+    Balance.busyTime = (double *) calloc(nc, sizeof(double));
+    Balance.idleTime = (double *) calloc(nc, sizeof(double));
+    if ( Balance.start == NULL || Balance.callTime == NULL ||
+         Balance.busyTime == NULL || Balance.idleTime == NULL ||
+         (nl > 0 && (Balance.cost == NULL || Balance.sample == NULL)) )
+    {
+        deleteBalance();
+        return FALSE;
+    }
+    Balance.chunks = nc;
+    Balance.steps = 0;
+    for ( i = 0; i < nl; i++ ) Balance.cost[i] = getLinkCost(i);
+    setBalancedChunks();
+    return TRUE;
+}
+
+//=============================================================================
+
+void deleteBalance()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the arrays used to balance conduit flow updates.
+//
+{
+    Balance.chunks = 0;
+    FREE(Balance.start);
+    FREE(Balance.cost);
+    FREE(Balance.sample);
+    FREE(Balance.callTime);
+    FREE(Balance.busyTime);
+    FREE(Balance.idleTime);
+}
+
+//=============================================================================
+
+double getLinkCost(int i)
+//
+//  Input:   i = link index
+//  Output:  returns relative cost of updating a link's flow
+//  Purpose: estimates the cost of a conduit's flow update from its shape.
+//
+//  Note: tabulated shapes need table lookups for every geometric property,
+//        Darcy-Weisbach force mains solve for a friction factor and culverts
+//        check for inlet control, all of which cost more than the closed
+//        form geometry of a circular pipe. Culverts with inlet control
+//        curves (CULVERT_CURVES option) cost no more than other conduits.
+{
+    double cost = 1.0;
+
+    if ( !isTrueConduit(i) ) return 0.0;
+    switch ( Link[i].xsect.type )
+    {
+      case IRREGULAR:
+      case CUSTOM:
+      case STREET_XSECT:
+        cost = 3.0;
+        break;
+      case FORCE_MAIN:
+        if ( ForceMainEqn == D_W ) cost = 3.0;
+        else                       cost = 2.0;
+        break;
+      default: break;
+    }
+    if ( Link[i].xsect.culvertCode > 0 && !CulvertCurves ) cost += 1.0;
+    return cost;
+}
+
+//=============================================================================
+
+void updateBalance()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: re-balances conduit chunks among threads using the times
+//           measured over the first few routing steps of each interval.
+//
+//  Note: links not updated while being timed (e.g. ones that stayed dormant)
+//        keep their previous cost scaled to the units of the measured times.
+{
+    int    i;
+    double measured = 0.0;
+    double previous = 0.0;
+    double scale;
+
+    // --- replace link costs with measured times once sampling is done
+    //     (steps is numbered from 1 while its step is routed, so this
+    //     comes after BALANCE_SAMPLES steps have been timed)
+    if ( Balance.steps == BALANCE_SAMPLES )
+    {
+        for ( i = 0; i < Nobjects[LINK]; i++ )
+        {
+            if ( Balance.sample[i] <= 0.0 ) continue;
+            measured += Balance.sample[i];
+            previous += Balance.cost[i];
+        }
+        if ( measured > 0.0 && previous > 0.0 )
+        {
+            scale = measured / previous;
+            for ( i = 0; i < Nobjects[LINK]; i++ )
+            {
+                if ( Balance.sample[i] > 0.0 )
+                    Balance.cost[i] = Balance.sample[i];
+                else Balance.cost[i] *= scale;
+            }
+            setBalancedChunks();
+        }
+    }
+
+    // --- start a new sampling interval
+    if ( Balance.steps == BALANCE_INTERVAL )
+    {
+        Balance.steps = 0;
+        for ( i = 0; i < Nobjects[LINK]; i++ ) Balance.sample[i] = 0.0;
+    }
+    Balance.steps++;
+}
+
+//=============================================================================
+
+void setBalancedChunks()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: splits the links into contiguous chunks of about equal cost,
+//           one for each thread.
+//
+{
+    int    i, c;
+    int    nl = Nobjects[LINK];
+    double total = 0.0;
+    double sum = 0.0;
+    double target;
+
+    for ( i = 0; i < nl; i++ ) total += Balance.cost[i];
+    i = 0;
+    for ( c = 0; c < Balance.chunks; c++ )
+    {
+        Balance.start[c] = i;
+        target = total * (c + 1) / Balance.chunks;
+        while ( i < nl && sum + 0.5 * Balance.cost[i] < target )
+        {
+            sum += Balance.cost[i];
+            i++;
+        }
+    }
+    Balance.start[Balance.chunks] = nl;
+}
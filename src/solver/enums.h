@@ -370,6 +370,18 @@ enum  CompatibilityType {
       EXTRAN,                          // original EXTRAN method
       SLOT};                           // Preissmann slot method
 
+ enum  SolverMethodType {
+      PICARD,                          // node-by-node Picard iterations
+      NEWTON};                         // coupled Newton iterations
+
+ enum  RelaxationType {
+      FIXED_RELAXATION,                // constant under-relaxation factor
+      AITKEN_RELAXATION};              // Aitken's dynamic relaxation factor
+
+ enum NetworkOrderType {
+      INPUT_ORDER,                     // nodes & links kept in input order
+      RCM_ORDER};                      // reverse Cuthill-McKee from outfalls
+
  enum InflowType {
       EXTERNAL_INFLOW,                 // user-supplied external inflow
       DRY_WEATHER_INFLOW,              // user-supplied dry weather inflow
@@ -485,7 +497,11 @@ enum  CompatibilityType {
     IGNORE_SNOWMELT, IGNORE_GWATER, IGNORE_ROUTING,
     IGNORE_QUALITY, MAX_TRIALS, HEAD_TOL,
     SYS_FLOW_TOL, LAT_FLOW_TOL, IGNORE_RDII,
-    MIN_ROUTE_STEP, NUM_THREADS, SURCHARGE_METHOD};
+    MIN_ROUTE_STEP, NUM_THREADS, SURCHARGE_METHOD,
+    PARALLEL_NODE_FLOWS, NETWORK_ORDER, SOLVER_METHOD,
+    RELAXATION, STEP_CLASSES, SKIP_DORMANT, DETERMINISTIC,
+    LOAD_BALANCING, GEOMETRY_TOL, DEPTH_CURVES, TRANSECT_TOL,
+    INLET_CURVES, FRICTION_CURVES, CULVERT_CURVES, SKIP_DRY_SUBCATCH};
 
 enum  NoYesType {
       NO,
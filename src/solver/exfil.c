@@ -18,6 +18,8 @@
 //   - Fixed units conversion error for storage units with surface area curves.
 //   Build 5.2.0:
 //   - Support added for analytical storage shapes.
+//   Build 5.2.4:
+//   - Global conductivity adjustment factor passed to grnampt_getInfil().
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -174,7 +176,7 @@ double exfil_getLoss(TExfil* exfil, double tStep, double depth, double area)
         exfilRate = exfil->btmExfil->Ks * Adjust.hydconFactor;
     }
     else exfilRate = grnampt_getInfil(exfil->btmExfil, tStep, 0.0, depth,
-                                      MOD_GREEN_AMPT);
+                                      MOD_GREEN_AMPT, Adjust.hydconFactor);
     exfilRate *= exfil->btmArea;
 
     // --- find infiltration through sloped banks
@@ -206,7 +208,8 @@ double exfil_getLoss(TExfil* exfil, double tStep, double depth, double area)
 
                 // --- use Green-Ampt function for bank infiltration
                 exfilRate += area * grnampt_getInfil(exfil->bankExfil,
-                                    tStep, 0.0, depth, MOD_GREEN_AMPT);
+                                    tStep, 0.0, depth, MOD_GREEN_AMPT,
+                                    Adjust.hydconFactor);
             }
         }
     }
@@ -7,9 +7,15 @@
 //   Author:   L. Rossman
 //
 //   Special Non-Manning Force Main functions
+//
+//   Update History
+//   ==============
+//   Build 5.2.4:
+//   - Darcy-Weisbach friction factors can be found from precomputed curves.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>
 #include <math.h>
 #include "headers.h"
 
@@ -19,18 +25,33 @@
 static const double VISCOS = 1.1E-5;   // Kinematic viscosity of water
                                        // @ 20 deg C (sq ft/sec)
 
+// --- friction factor curves are tabulated at Reynolds numbers
+//     2^e * (1 + i/FRIC_CURVE_STEPS) for octaves e = FRIC_CURVE_EMIN to
+//     FRIC_CURVE_EMAX - 1 so that an interval is located without taking
+//     a logarithm; linear interpolation on this grid stays within 0.025%
+//     of the Swamee and Jain formula for any relative roughness.
+#define FRIC_CURVE_STEPS 16            // intervals per octave of Re
+#define FRIC_CURVE_EMIN  11            // first octave (Re = 2048)
+#define FRIC_CURVE_EMAX  30            // end of last octave (Re ~ 1.07e9)
+#define FRIC_CURVE_ITEMS ((FRIC_CURVE_EMAX - FRIC_CURVE_EMIN) * \
+                          FRIC_CURVE_STEPS + 1)
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 // forcemain_getEquivN
 // forcemain_getRoughFactor
 // forcemain_getFricSlope
+// forcemain_createFricCurve  (called by conduit_validate in link.c)
+// forcemain_deleteFricCurve  (called by deleteObjects in project.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static double forcemain_getFricFactor(double e, double hrad, double re);
+static double forcemain_getTurbFricFactor(double e, double hrad, double re);
 static double forcemain_getReynolds(double v, double hrad);
+static double forcemain_getCurveFricFactor(double* curve, double re);
 
 //=============================================================================
 
@@ -98,6 +119,7 @@ double forcemain_getFricSlope(int j, double v, double hrad)
 //           conduit_validate() in LINK.C.
 //
 {
+    int    k;
     double re, f;
     TXsect xsect = Link[j].xsect;
     switch ( ForceMainEqn )
@@ -106,7 +128,12 @@ double forcemain_getFricSlope(int j, double v, double hrad)
         return xsect.sBot * pow(v, 0.852) / pow(hrad, 1.1667);
       case D_W:
         re = forcemain_getReynolds(v, hrad);
-        f = forcemain_getFricFactor(xsect.rBot, hrad, re);
+        k = Link[j].subIndex;
+        if ( Conduit[k].fricCurve && hrad == xsect.rFull &&
+             re >= 4000.0 && re < ldexp(1.0, FRIC_CURVE_EMAX) )
+            f = forcemain_getCurveFricFactor(Conduit[k].fricCurve, re);
+        else
+            f = forcemain_getFricFactor(xsect.rBot, hrad, re);
         return f * xsect.sBot * v / hrad;
     }
     return 0.0;
@@ -146,12 +173,97 @@ double forcemain_getFricFactor(double e, double hrad, double re)
         f = forcemain_getFricFactor(e, hrad, 4000.0);
         f = 0.032 + (f - 0.032) * ( re - 2000.0) / 2000.0;
     }
-    else
+    else f = forcemain_getTurbFricFactor(e, hrad, re);
+    return f;
+}
+
+//=============================================================================
+
+double forcemain_getTurbFricFactor(double e, double hrad, double re)
+//
+//  Input:   e = roughness height (ft)
+//           hrad = hydraulic radius (ft)
+//           re = Reynolds number
+//  Output:  returns a Darcy-Weisbach friction factor
+//  Purpose: evaluates the Swamee and Jain formula for turbulent flow.
+//
+{
+    double f = e/3.7/(4.0*hrad);
+    if ( re < 1.0e10 ) f += 5.74/pow(re, 0.9);
+    f = log10(f);
+    return 0.25 / f / f;
+}
+
+//=============================================================================
+
+int forcemain_createFricCurve(int j, int k)
+//
+//  Input:   j = link index
+//           k = conduit index
+//  Output:  returns FALSE if memory could not be allocated, TRUE otherwise
+//  Purpose: tabulates the Darcy-Weisbach friction factor of a force main
+//           flowing full against Reynolds number.
+//
+{
+    int    e, i, n = 0;
+    double hrad = Link[j].xsect.rFull;
+    double* curve;
+
+    forcemain_deleteFricCurve(j);
+    if ( ForceMainEqn != D_W || Link[j].xsect.type != FORCE_MAIN ||
+         Link[j].xsect.rBot <= 0.0 || hrad <= 0.0 ) return TRUE;
+
+    curve = (double *) malloc(FRIC_CURVE_ITEMS * sizeof(double));
+    if ( curve == NULL ) return FALSE;
+
+    // --- evaluate the turbulent-flow formula at each grid point
+    //     (points below Re = 4000 only bracket the start of its range)
+    for (e = FRIC_CURVE_EMIN; e < FRIC_CURVE_EMAX; e++)
     {
-        f = e/3.7/(4.0*hrad);
-        if ( re < 1.0e10 ) f += 5.74/pow(re, 0.9);
-        f = log10(f);
-        f = 0.25 / f / f;
+        for (i = 0; i < FRIC_CURVE_STEPS; i++)
+        {
+            curve[n++] = forcemain_getTurbFricFactor(Link[j].xsect.rBot, hrad,
+                ldexp(1.0 + (double)i / FRIC_CURVE_STEPS, e));
+        }
     }
-    return f;
+    curve[n] = forcemain_getTurbFricFactor(Link[j].xsect.rBot, hrad,
+                                           ldexp(1.0, FRIC_CURVE_EMAX));
+    Conduit[k].fricCurve = curve;
+    return TRUE;
+}
+
+//=============================================================================
+
+void forcemain_deleteFricCurve(int j)
+//
+//  Input:   j = link index
+//  Output:  none
+//  Purpose: frees the friction factor curve of a force main.
+//
+{
+    int k;
+    if ( Conduit == NULL || Link[j].type != CONDUIT ) return;
+    k = Link[j].subIndex;
+    free(Conduit[k].fricCurve);
+    Conduit[k].fricCurve = NULL;
+}
+
+//=============================================================================
+
+double forcemain_getCurveFricFactor(double* curve, double re)
+//
+//  Input:   curve = tabulated friction factors
+//           re = Reynolds number (4000 <= re < 2^FRIC_CURVE_EMAX)
+//  Output:  returns a Darcy-Weisbach friction factor
+//  Purpose: interpolates a friction factor from a force main's curve.
+//
+{
+    int    e, i;
+    double x = 2.0 * frexp(re, &e) - 1.0;  // re = (1 + x) * 2^(e-1)
+
+    x *= FRIC_CURVE_STEPS;
+    i = (int)x;
+    x -= i;
+    i += (e - 1 - FRIC_CURVE_EMIN) * FRIC_CURVE_STEPS;
+    return curve[i] + x * (curve[i+1] - curve[i]);
 }
@@ -31,6 +31,17 @@
 //   - Refactored external inflow code.
 //   Build 5.2.4:
 //   - Additional arguments added to function link_getLossRate.
+//   - Function link_deleteDepthCurves added.
+//   - Function table_createVolumes added.
+//   - Functions forcemain_createFricCurve and forcemain_deleteFricCurve added.
+//   - Functions culvert_createCurve and culvert_deleteCurve added.
+//   - Runoff context argument added to subcatch_getRunoff and
+//     surfqual_getWashoff.
+//   - Functions massbal_beginRunoffLogs and massbal_endRunoffLogs added.
+//   - Functions subcatch_createRunonSchedule and
+//     subcatch_deleteRunonSchedule added.
+//   - Functions subcatch_isDry, subcatch_addDryTime, subcatch_endDryTime
+//     and surfqual_isSweepDue added.
 //-----------------------------------------------------------------------------
 
 #ifndef FUNCS_H
@@ -48,6 +59,7 @@ void     project_validate(void);
 int      project_init(void);
 
 int      project_addObject(int type, char* id, int n);
+int      project_reindexObjects(int type);
 int      project_findObject(int type, const char* id);
 char*    project_findID(int type, char* id);
 
@@ -91,6 +103,8 @@ void    report_writeMaxFlowTurns(TMaxStats flowTurns[], int nMaxStats);
 void    report_writeNonconvergedStats(TMaxStats maxNonconverged[],
         int nMaxStats);
 void    report_writeTimeStepStats(TTimeStepStats* timeStepStats);
+void    report_writeThreadTimes(void);
+void    report_writeGeometryTables(void);
 
 void    report_writeErrorMsg(int code, char* msg);
 void    report_writeErrorCode(void);
@@ -182,7 +196,7 @@ void    gwater_getState(int subcatch, double x[]);
 void    gwater_setState(int subcatch, double x[]);
 
 void    gwater_getGroundwater(int subcatch, double evap, double infil,
-        double tStep);
+        double tStep, TRunoffCtx* ctx);
 double  gwater_getVolume(int subcatch);
 
 //-----------------------------------------------------------------------------
@@ -224,6 +238,12 @@ double  flowrout_getRoutingStep(int routingModel, double fixedStep);
 int     flowrout_execute(int links[], int routingModel, double tStep);
 
 void    toposort_sortLinks(int links[]);
+
+void    reorder_network(void);
+void    reorder_delete(void);
+int     reorder_getIndex(int type, int i);
+int     reorder_getInputIndex(int type, int j);
+
 int     kinwave_execute(int link, double* qin, double* qout, double tStep);
 
 void    dynwave_validate(void);
@@ -231,6 +251,7 @@ void    dynwave_init(void);
 void    dynwave_close(void);
 double  dynwave_getRoutingStep(double fixedStep);
 int     dynwave_execute(double tStep);
+int     dynwave_getThreadTimes(int k, double* busyTime, double* idleTime);
 void    dwflow_findConduitFlow(int j, int steps, double omega, double dt);
 
 void    qualrout_init(void);
@@ -258,6 +279,8 @@ void    massbal_updateLoadingTotals(int type, int pollut, double w);
 void    massbal_updateGwaterTotals(double vInfil, double vUpperEvap,
         double vLowerEvap, double vLowerPerc, double vGwater);
 void    massbal_updateRoutingTotals(double tStep);
+int     massbal_beginRunoffLogs(int nThreads);
+void    massbal_endRunoffLogs(void);
 
 
 void    massbal_initTimeStepTotals(void);
@@ -318,6 +341,8 @@ int     subcatch_readLanduseParams(char* tok[], int ntoks);
 int     subcatch_readInitBuildup(char* tok[], int ntoks);
 
 void    subcatch_validate(int subcatch);
+int     subcatch_createRunonSchedule(void);
+void    subcatch_deleteRunonSchedule(void);
 void    subcatch_initState(int subcatch);
 void    subcatch_setOldState(int subcatch);
 
@@ -326,8 +351,11 @@ double  subcatch_getStorage(int subcatch);
 double  subcatch_getDepth(int subcatch);
 
 void    subcatch_getRunon(int subcatch);
+int     subcatch_isDry(int subcatch);
+void    subcatch_addDryTime(int subcatch, double tStep);
+double  subcatch_endDryTime(int subcatch);
 void    subcatch_addRunonFlow(int subcatch, double flow);
-double  subcatch_getRunoff(int subcatch, double tStep);
+double  subcatch_getRunoff(int subcatch, double tStep, TRunoffCtx* ctx);
 
 double  subcatch_getWtdOutflow(int subcatch, double wt);
 void    subcatch_getResults(int subcatch, double wt, float x[]);
@@ -336,9 +364,11 @@ void    subcatch_getResults(int subcatch, double wt, float x[]);
 //  Surface Pollutant Buildup/Washoff Methods
 //-----------------------------------------------------------------------------
 void    surfqual_initState(int subcatch);
-void    surfqual_getWashoff(int subcatch, double runoff, double tStep);
+void    surfqual_getWashoff(int subcatch, double runoff, double tStep,
+                            TRunoffCtx* ctx);
 void    surfqual_getBuildup(int subcatch, double tStep);
 void    surfqual_sweepBuildup(int subcatch, DateTime aDate);
+int     surfqual_isSweepDue(int subcatch, DateTime aDate);
 double  surfqual_getWtdWashoff(int subcatch, int pollut, double wt);
 
 //-----------------------------------------------------------------------------
@@ -421,6 +451,7 @@ void    link_setOutfallDepth(int link);
 double  link_getLength(int link);
 double  link_getYcrit(int link, double q);
 double  link_getYnorm(int link, double q);
+void    link_deleteDepthCurves(int link);
 double  link_getVelocity(int link, double q, double y);
 double  link_getFroude(int link, double v, double y);
 double  link_getPower(int link);
@@ -449,10 +480,17 @@ double  xsect_getRofY(TXsect* xsect, double y);
 double  xsect_getWofY(TXsect* xsect, double y);
 double  xsect_getYcrit(TXsect* xsect, double q);
 
+int     xsect_createTables(TXsect* xsect, double tol);
+void    xsect_deleteTables(void);
+int     xsect_getTableStats(int nItems[], double maxError[],
+        double exactFrac[]);
+
 //-----------------------------------------------------------------------------
 //   Culvert/Roadway Methods
 //-----------------------------------------------------------------------------
 double  culvert_getInflow(int link, double q, double h);
+int     culvert_createCurve(int link, int k);
+void    culvert_deleteCurve(int link);
 double  roadway_getInflow(int link, double dir, double hcrest, double h1,
         double h2);
 
@@ -462,6 +500,8 @@ double  roadway_getInflow(int link, double dir, double hcrest, double h1,
 double  forcemain_getEquivN(int j, int k);
 double  forcemain_getRoughFactor(int j, double lengthFactor);
 double  forcemain_getFricSlope(int j, double v, double hrad);
+int     forcemain_createFricCurve(int j, int k);
+void    forcemain_deleteFricCurve(int j);
 
 //-----------------------------------------------------------------------------
 //   Cross-Section Transect Methods
@@ -495,6 +535,7 @@ void    controls_addToCount(char* s);
 int     controls_addVariable(char* tok[], int ntoks);
 int     controls_addExpression(char* tok[], int ntoks);
 int     controls_addRuleClause(int rule, int keyword, char* Tok[], int nTokens);
+void    controls_remapObjects(int newNode[], int newLink[]);
 int     controls_evaluate(DateTime currentTime, DateTime elapsedTime, 
         double tStep);
 
@@ -519,6 +560,7 @@ double  table_inverseLookup(TTable* table, double y);
 
 double  table_getSlope(TTable *table, double x);
 double  table_getMaxY(TTable *table, double x);
+int     table_createVolumes(TTable* table);
 double  table_getStorageVolume(TTable* table, double x);
 double  table_getStorageDepth(TTable* table, double v);
 
@@ -53,7 +53,8 @@ EXTERN long
                   Nperiods,                 // Number of reporting periods
                   TotalStepCount,           // Total routing steps used 
                   ReportStepCount,          // Reporting routing steps used
-                  NonConvergeCount;         // Number of non-converging steps
+                  NonConvergeCount,         // Number of non-converging steps
+                  PicardFallbackCount;      // Newton trials solved by Picard
 
 EXTERN char
                   Msg[MAXMSG+1],            // Text of output message
@@ -98,6 +99,19 @@ EXTERN int
                   SweepEnd,                 // Day of year when sweeping ends
                   MaxTrials,                // Max. trials for DW routing
                   NumThreads,               // Number of parallel threads used
+                  ParallelNodeFlows,        // Gather node flows in parallel
+                  SkipDormant,              // Skip dormant parts of network
+                  Deterministic,            // Same results for any thread count
+                  LoadBalancing,            // Balance conduit work among threads
+                  DepthCurves,              // Tabulate normal & critical depths
+                  InletCurves,              // Tabulate inlet capture
+                  FrictionCurves,           // Tabulate force main friction
+                  CulvertCurves,            // Tabulate culvert inlet control
+                  SkipDrySubcatch,          // Defer updates of dry subcatchments
+                  NetworkOrder,             // Internal node & link ordering
+                  SolverMethod,             // PICARD or NEWTON method
+                  Relaxation,               // FIXED or AITKEN relaxation
+                  StepClasses,              // Number of DW link step classes
                   NumEvents;                // Number of detailed events
 
 EXTERN double
@@ -115,6 +129,8 @@ EXTERN double
                   HeadTol,                  // DW routing head tolerance (ft)
                   SysFlowTol,               // Tolerance for steady system flow
                   LatFlowTol,               // Tolerance for steady nodal inflow
+                  GeometryTol,              // Error tolerance of geometry tables
+                  TransectTol,              // Error tolerance of transect tables
                   CrownCutoff;              // Fractional pipe crown cutoff
 
 EXTERN DateTime
@@ -20,6 +20,14 @@
 //   - Support for collecting GW statistics added.
 //   Build 5.1.010:
 //   - Unsaturated hydraulic conductivity added to GW flow equation variables.
+//   Build 5.2.4:
+//   - Shared variables moved into a groundwater context structure so that
+//     subcatchments can be analyzed concurrently.
+//   - Unsaturated hydraulic conductivity saved with each subcatchment's
+//     groundwater instead of being carried over from a previously
+//     analyzed subcatchment.
+//   - Groundwater context passed to the ODE solver and the GW flow expression
+//     evaluator so that groundwater is found in parallel.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -57,33 +65,36 @@ static char* GWVarWords[] = {"HGW", "HSW", "HCB", "HGS", "KS", "K",
                              "THETA", "PHI", "FI", "FU", "A", NULL};
 
 //-----------------------------------------------------------------------------
-//  Shared variables
+//  Local data types
 //-----------------------------------------------------------------------------
 //  NOTE: all flux rates are in ft/sec, all depths are in ft.
-static double    Area;            // subcatchment area (ft2)
-static double    Infil;           // infiltration rate from surface
-static double    MaxEvap;         // max. evaporation rate
-static double    AvailEvap;       // available evaporation rate
-static double    UpperEvap;       // evaporation rate from upper GW zone
-static double    LowerEvap;       // evaporation rate from lower GW zone
-static double    UpperPerc;       // percolation rate from upper to lower zone
-static double    LowerLoss;       // loss rate from lower GW zone
-static double    GWFlow;          // flow rate from lower zone to conveyance node
-static double    MaxUpperPerc;    // upper limit on UpperPerc
-static double    MaxGWFlowPos;    // upper limit on GWFlow when its positve
-static double    MaxGWFlowNeg;    // upper limit on GWFlow when its negative
-static double    FracPerv;        // fraction of surface that is pervious
-static double    TotalDepth;      // total depth of GW aquifer
-static double    Theta;           // moisture content of upper zone
-static double    HydCon;          // unsaturated hydraulic conductivity (ft/s)
-static double    Hgw;             // ht. of saturated zone
-static double    Hstar;           // ht. from aquifer bottom to node invert
-static double    Hsw;             // ht. from aquifer bottom to water surface
-static double    Tstep;           // current time step (sec)
-static TAquifer  A;               // aquifer being analyzed
-static TGroundwater* GW;          // groundwater object being analyzed
-static MathExpr* LatFlowExpr;     // user-supplied lateral GW flow expression
-static MathExpr* DeepFlowExpr;    // user-supplied deep GW flow expression
+typedef struct
+{
+    double    area;               // subcatchment area (ft2)
+    double    infil;              // infiltration rate from surface
+    double    maxEvap;            // max. evaporation rate
+    double    availEvap;          // available evaporation rate
+    double    upperEvap;          // evaporation rate from upper GW zone
+    double    lowerEvap;          // evaporation rate from lower GW zone
+    double    upperPerc;          // percolation rate from upper to lower zone
+    double    lowerLoss;          // loss rate from lower GW zone
+    double    gwFlow;             // flow rate from lower zone to conveyance node
+    double    maxUpperPerc;       // upper limit on upperPerc
+    double    maxGWFlowPos;       // upper limit on gwFlow when its positve
+    double    maxGWFlowNeg;       // upper limit on gwFlow when its negative
+    double    fracPerv;           // fraction of surface that is pervious
+    double    totalDepth;         // total depth of GW aquifer
+    double    theta;              // moisture content of upper zone
+    double    hydCon;             // unsaturated hydraulic conductivity (ft/s)
+    double    hgw;                // ht. of saturated zone
+    double    hstar;              // ht. from aquifer bottom to node invert
+    double    hsw;                // ht. from aquifer bottom to water surface
+    double    tStep;              // current time step (sec)
+    TAquifer* a;                  // aquifer being analyzed
+    TGroundwater* gw;             // groundwater object being analyzed
+    MathExpr* latFlowExpr;        // user-supplied lateral GW flow expression
+    MathExpr* deepFlowExpr;       // user-supplied deep GW flow expression
+}   TGwaterCtx;
 
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
@@ -103,16 +114,16 @@ static MathExpr* DeepFlowExpr;    // user-supplied deep GW flow expression
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
-static void   getDxDt(double t, double* x, double* dxdt);
-static void   getFluxes(double upperVolume, double lowerDepth);
-static void   getEvapRates(double theta, double upperDepth);
-static double getUpperPerc(double theta, double upperDepth);
-static double getGWFlow(double lowerDepth);
-static void   updateMassBal(double area,  double tStep);
+static void   getDxDt(double t, double* x, double* dxdt, void* p);
+static void   getFluxes(TGwaterCtx* g, double upperVolume, double lowerDepth);
+static void   getEvapRates(TGwaterCtx* g, double theta, double upperDepth);
+static double getUpperPerc(TGwaterCtx* g, double theta, double upperDepth);
+static double getGWFlow(TGwaterCtx* g, double lowerDepth);
+static void   updateMassBal(TGwaterCtx* g, double area,  double tStep);
 
 // Used to process custom GW outflow equations
 static int    getVariableIndex(char* s);
-static double getVariableValue(int varIndex);
+static double getVariableValue(int varIndex, void* p);
 
 //=============================================================================
 
@@ -412,6 +423,7 @@ void  gwater_initState(int j)
         gw->oldFlow = 0.0;
         gw->newFlow = 0.0;
         gw->evapLoss = 0.0;
+        gw->hydCon = 0.0;
 
         // ... initial available infiltration volume into upper zone
         gw->maxInfilVol = (gw->surfElev - gw->waterTableElev) *
@@ -474,13 +486,15 @@ double gwater_getVolume(int j)
 
 //=============================================================================
 
-void gwater_getGroundwater(int j, double evap, double infil, double tStep)
+void gwater_getGroundwater(int j, double evap, double infil, double tStep,
+                           TRunoffCtx* ctx)
 //
 //  Purpose: computes groundwater flow from subcatchment during current time step.
 //  Input:   j     = subcatchment index
 //           evap  = pervious surface evaporation volume consumed (ft3)
 //           infil = surface infiltration volume (ft3)
 //           tStep = time step (sec)
+//           ctx   = runoff context of the current thread
 //  Output:  none
 //
 {
@@ -488,123 +502,133 @@ void gwater_getGroundwater(int j, double evap, double infil, double tStep)
     double x[2];                       // upper moisture content & lower depth 
     double vUpper;                     // upper vol. available for percolation
     double nodeFlow;                   // max. possible GW flow from node
+    TGwaterCtx gc;                     // work context for the GW object
+    TGwaterCtx* g = &gc;
 
     // --- save subcatchment's groundwater and aquifer objects to 
-    //     shared variables
-    GW = Subcatch[j].groundwater;
-    if ( GW == NULL ) return;
-    LatFlowExpr = Subcatch[j].gwLatFlowExpr;
-    DeepFlowExpr = Subcatch[j].gwDeepFlowExpr;
-    A = Aquifer[GW->aquifer];
+    //     the work context
+    g->gw = Subcatch[j].groundwater;
+    if ( g->gw == NULL ) return;
+    g->latFlowExpr = Subcatch[j].gwLatFlowExpr;
+    g->deepFlowExpr = Subcatch[j].gwDeepFlowExpr;
+    g->a = &Aquifer[g->gw->aquifer];
+
+    // --- unsat. hyd. conductivity used in GW flow expressions starts
+    //     from the last value found for this subcatchment
+    g->hydCon = g->gw->hydCon;
 
     // --- get fraction of total area that is pervious
-    FracPerv = subcatch_getFracPerv(j);
-    if ( FracPerv <= 0.0 ) return;
-    Area = Subcatch[j].area;
+    g->fracPerv = subcatch_getFracPerv(j);
+    if ( g->fracPerv <= 0.0 ) return;
+    g->area = Subcatch[j].area;
 
     // --- convert infiltration volume (ft3) to equivalent rate
     //     over entire GW (subcatchment) area
-    infil = infil / Area / tStep;
-    Infil = infil;
-    Tstep = tStep;
+    infil = infil / g->area / tStep;
+    g->infil = infil;
+    g->tStep = tStep;
 
     // --- convert pervious surface evaporation already exerted (ft3)
     //     to equivalent rate over entire GW (subcatchment) area
-    evap = evap / Area / tStep;
+    evap = evap / g->area / tStep;
 
     // --- convert max. surface evap rate (ft/sec) to a rate
     //     that applies to GW evap (GW evap can only occur
     //     through the pervious land surface area)
-    MaxEvap = Evap.rate * FracPerv;
+    g->maxEvap = Evap.rate * g->fracPerv;
 
     // --- available subsurface evaporation is difference between max.
     //     rate and pervious surface evap already exerted
-    AvailEvap = MAX((MaxEvap - evap), 0.0);
+    g->availEvap = MAX((g->maxEvap - evap), 0.0);
 
-    // --- save total depth & outlet node properties to shared variables
-    TotalDepth = GW->surfElev - GW->bottomElev;
-    if ( TotalDepth <= 0.0 ) return;
-    n = GW->node;
+    // --- save total depth & outlet node properties to the work context
+    g->totalDepth = g->gw->surfElev - g->gw->bottomElev;
+    if ( g->totalDepth <= 0.0 ) return;
+    n = g->gw->node;
 
     // --- establish min. water table height above aquifer bottom at which
     //     GW flow can occur (override node's invert if a value was provided
     //     in the GW object)
-    if ( GW->nodeElev != MISSING ) Hstar = GW->nodeElev - GW->bottomElev;
-    else Hstar = Node[n].invertElev - GW->bottomElev;
+    if ( g->gw->nodeElev != MISSING )
+        g->hstar = g->gw->nodeElev - g->gw->bottomElev;
+    else g->hstar = Node[n].invertElev - g->gw->bottomElev;
     
     // --- establish surface water height (relative to aquifer bottom)
     //     for drainage system node connected to the GW aquifer
-    if ( GW->fixedDepth > 0.0 )
+    if ( g->gw->fixedDepth > 0.0 )
     {
-        Hsw = GW->fixedDepth + Node[n].invertElev - GW->bottomElev;
+        g->hsw = g->gw->fixedDepth + Node[n].invertElev - g->gw->bottomElev;
     }
-    else Hsw = Node[n].newDepth + Node[n].invertElev - GW->bottomElev;
+    else g->hsw = Node[n].newDepth + Node[n].invertElev - g->gw->bottomElev;
 
     // --- store state variables (upper zone moisture content, lower zone
     //     depth) in work vector x
-    x[THETA] = GW->theta;
-    x[LOWERDEPTH] = GW->lowerDepth;
+    x[THETA] = g->gw->theta;
+    x[LOWERDEPTH] = g->gw->lowerDepth;
 
     // --- set limit on percolation rate from upper to lower GW zone
-    vUpper = (TotalDepth - x[LOWERDEPTH]) * (x[THETA] - A.fieldCapacity);
+    vUpper = (g->totalDepth - x[LOWERDEPTH]) * (x[THETA] - g->a->fieldCapacity);
     vUpper = MAX(0.0, vUpper); 
-    MaxUpperPerc = vUpper / tStep;
+    g->maxUpperPerc = vUpper / tStep;
 
     // --- set limit on GW flow out of aquifer based on volume of lower zone
-    MaxGWFlowPos = x[LOWERDEPTH]*A.porosity / tStep;
+    g->maxGWFlowPos = x[LOWERDEPTH]*g->a->porosity / tStep;
 
     // --- set limit on GW flow into aquifer from drainage system node
     //     based on min. of capacity of upper zone and drainage system
     //     inflow to the node
-    MaxGWFlowNeg = (TotalDepth - x[LOWERDEPTH]) * (A.porosity - x[THETA])
-                   / tStep;
-    nodeFlow = (Node[n].inflow + Node[n].newVolume/tStep) / Area;
-    MaxGWFlowNeg = -MIN(MaxGWFlowNeg, nodeFlow);
+    g->maxGWFlowNeg = (g->totalDepth - x[LOWERDEPTH]) *
+                      (g->a->porosity - x[THETA]) / tStep;
+    nodeFlow = (Node[n].inflow + Node[n].newVolume/tStep) / g->area;
+    g->maxGWFlowNeg = -MIN(g->maxGWFlowNeg, nodeFlow);
     
     // --- integrate eqns. for d(Theta)/dt and d(LowerDepth)/dt
-    //     NOTE: ODE solver must have been initialized previously
-    odesolve_integrate(x, 2, 0, tStep, GWTOL, tStep, getDxDt);
-    
+    //     NOTE: the thread's ODE solver must have been opened previously
+    odesolve_integrate(&ctx->odeSolver, x, 2, 0, tStep, GWTOL, tStep,
+                       getDxDt, g);
+
     // --- keep state variables within allowable bounds
-    x[THETA] = MAX(x[THETA], A.wiltingPoint);
-    if ( x[THETA] >= A.porosity )
+    x[THETA] = MAX(x[THETA], g->a->wiltingPoint);
+    if ( x[THETA] >= g->a->porosity )
     {
-        x[THETA] = A.porosity - XTOL;
-        x[LOWERDEPTH] = TotalDepth - XTOL;
+        x[THETA] = g->a->porosity - XTOL;
+        x[LOWERDEPTH] = g->totalDepth - XTOL;
     }
     x[LOWERDEPTH] = MAX(x[LOWERDEPTH],  0.0);
-    if ( x[LOWERDEPTH] >= TotalDepth )
+    if ( x[LOWERDEPTH] >= g->totalDepth )
     {
-        x[LOWERDEPTH] = TotalDepth - XTOL;
+        x[LOWERDEPTH] = g->totalDepth - XTOL;
     }
 
     // --- save new values of state values
-    GW->theta = x[THETA];
-    GW->lowerDepth  = x[LOWERDEPTH];
-    getFluxes(GW->theta, GW->lowerDepth);
-    GW->oldFlow = GW->newFlow;
-    GW->newFlow = GWFlow;
-    GW->evapLoss = UpperEvap + LowerEvap;
+    g->gw->theta = x[THETA];
+    g->gw->lowerDepth  = x[LOWERDEPTH];
+    getFluxes(g, g->gw->theta, g->gw->lowerDepth);
+    g->gw->hydCon = g->hydCon;
+    g->gw->oldFlow = g->gw->newFlow;
+    g->gw->newFlow = g->gwFlow;
+    g->gw->evapLoss = g->upperEvap + g->lowerEvap;
 
     //--- find max. infiltration volume (as depth over
     //    the pervious portion of the subcatchment)
     //    that upper zone can support in next time step
-    GW->maxInfilVol = (TotalDepth - x[LOWERDEPTH]) *
-                      (A.porosity - x[THETA]) / FracPerv;
+    g->gw->maxInfilVol = (g->totalDepth - x[LOWERDEPTH]) *
+                      (g->a->porosity - x[THETA]) / g->fracPerv;
 
     // --- update GW mass balance
-    updateMassBal(Area, tStep);
+    updateMassBal(g, g->area, tStep);
 
     // --- update GW statistics 
-    stats_updateGwaterStats(j, infil, GW->evapLoss, GWFlow, LowerLoss,
-        GW->theta, GW->lowerDepth + GW->bottomElev, tStep);
+    stats_updateGwaterStats(j, infil, g->gw->evapLoss, g->gwFlow, g->lowerLoss,
+        g->gw->theta, g->gw->lowerDepth + g->gw->bottomElev, tStep);
 }
 
 //=============================================================================
 
-void updateMassBal(double area, double tStep)
+void updateMassBal(TGwaterCtx* g, double area, double tStep)
 //
-//  Input:   area  = subcatchment area (ft2)
+//  Input:   g     = groundwater work context
+//           area  = subcatchment area (ft2)
 //           tStep = time step (sec)
 //  Output:  none
 //  Purpose: updates GW mass balance with volumes of water fluxes.
@@ -617,20 +641,21 @@ void updateMassBal(double area, double tStep)
     double vGwater;                    // volume of exchanged groundwater
     double ft2sec = area * tStep;
 
-    vInfil     = Infil * ft2sec;
-    vUpperEvap = UpperEvap * ft2sec;
-    vLowerEvap = LowerEvap * ft2sec;
-    vLowerPerc = LowerLoss * ft2sec;
-    vGwater    = 0.5 * (GW->oldFlow + GW->newFlow) * ft2sec;
+    vInfil     = g->infil * ft2sec;
+    vUpperEvap = g->upperEvap * ft2sec;
+    vLowerEvap = g->lowerEvap * ft2sec;
+    vLowerPerc = g->lowerLoss * ft2sec;
+    vGwater    = 0.5 * (g->gw->oldFlow + g->gw->newFlow) * ft2sec;
     massbal_updateGwaterTotals(vInfil, vUpperEvap, vLowerEvap, vLowerPerc,
                                vGwater);
 }
 
 //=============================================================================
 
-void  getFluxes(double theta, double lowerDepth)
+void  getFluxes(TGwaterCtx* g, double theta, double lowerDepth)
 //
-//  Input:   upperVolume = vol. depth of upper zone (ft)
+//  Input:   g           = groundwater work context
+//           upperVolume = vol. depth of upper zone (ft)
 //           upperDepth  = depth of upper zone (ft)
 //  Output:  none
 //  Purpose: computes water fluxes into/out of upper/lower GW zones.
@@ -640,44 +665,46 @@ void  getFluxes(double theta, double lowerDepth)
 
     // --- find upper zone depth
     lowerDepth = MAX(lowerDepth, 0.0);
-    lowerDepth = MIN(lowerDepth, TotalDepth);
-    upperDepth = TotalDepth - lowerDepth;
+    lowerDepth = MIN(lowerDepth, g->totalDepth);
+    upperDepth = g->totalDepth - lowerDepth;
 
-    // --- save lower depth and theta to global variables
-    Hgw = lowerDepth;
-    Theta = theta;
+    // --- save lower depth and theta to the work context
+    g->hgw = lowerDepth;
+    g->theta = theta;
 
     // --- find evaporation rate from both zones
-    getEvapRates(theta, upperDepth);
+    getEvapRates(g, theta, upperDepth);
 
     // --- find percolation rate from upper to lower zone
-    UpperPerc = getUpperPerc(theta, upperDepth);
-    UpperPerc = MIN(UpperPerc, MaxUpperPerc);
+    g->upperPerc = getUpperPerc(g, theta, upperDepth);
+    g->upperPerc = MIN(g->upperPerc, g->maxUpperPerc);
 
     // --- find loss rate to deep GW
-    if ( DeepFlowExpr != NULL )
-        LowerLoss = mathexpr_eval(DeepFlowExpr, getVariableValue) /
+    if ( g->deepFlowExpr != NULL )
+        g->lowerLoss = mathexpr_evalCtx(g->deepFlowExpr, getVariableValue, g) /
                     UCF(RAINFALL);
     else
-        LowerLoss = A.lowerLossCoeff * lowerDepth / TotalDepth;
-    LowerLoss = MIN(LowerLoss, lowerDepth/Tstep);
+        g->lowerLoss = g->a->lowerLossCoeff * lowerDepth / g->totalDepth;
+    g->lowerLoss = MIN(g->lowerLoss, lowerDepth/g->tStep);
 
     // --- find GW flow rate from lower zone to drainage system node
-    GWFlow = getGWFlow(lowerDepth);
-    if ( LatFlowExpr != NULL )
+    g->gwFlow = getGWFlow(g, lowerDepth);
+    if ( g->latFlowExpr != NULL )
     {
-        GWFlow += mathexpr_eval(LatFlowExpr, getVariableValue) / UCF(GWFLOW);
+        g->gwFlow += mathexpr_evalCtx(g->latFlowExpr, getVariableValue, g) /
+                     UCF(GWFLOW);
     }
-    if ( GWFlow >= 0.0 ) GWFlow = MIN(GWFlow, MaxGWFlowPos);
-    else GWFlow = MAX(GWFlow, MaxGWFlowNeg);
+    if ( g->gwFlow >= 0.0 ) g->gwFlow = MIN(g->gwFlow, g->maxGWFlowPos);
+    else g->gwFlow = MAX(g->gwFlow, g->maxGWFlowNeg);
 }
 
 //=============================================================================
 
-void  getDxDt(double t, double* x, double* dxdt)
+void  getDxDt(double t, double* x, double* dxdt, void* p)
 //
 //  Input:   t    = current time (not used)
 //           x    = array of state variables
+//           p    = groundwater work context
 //  Output:  dxdt = array of time derivatives of state variables
 //  Purpose: computes time derivatives of upper moisture content 
 //           and lower depth.
@@ -686,14 +713,15 @@ void  getDxDt(double t, double* x, double* dxdt)
     double qUpper;    // inflow - outflow for upper zone (ft/sec)
     double qLower;    // inflow - outflow for lower zone (ft/sec)
     double denom;
+    TGwaterCtx* g = (TGwaterCtx *)p;
 
-    getFluxes(x[THETA], x[LOWERDEPTH]);
-    qUpper = Infil - UpperEvap - UpperPerc;
-    qLower = UpperPerc - LowerLoss - LowerEvap - GWFlow;
+    getFluxes(g, x[THETA], x[LOWERDEPTH]);
+    qUpper = g->infil - g->upperEvap - g->upperPerc;
+    qLower = g->upperPerc - g->lowerLoss - g->lowerEvap - g->gwFlow;
 
     // --- d(upper zone moisture)/dt = (net upper zone flow) /
     //                                 (upper zone depth)
-    denom = TotalDepth - x[LOWERDEPTH];
+    denom = g->totalDepth - x[LOWERDEPTH];
     if (denom > 0.0)
         dxdt[THETA] = qUpper / denom;
     else
@@ -701,7 +729,7 @@ void  getDxDt(double t, double* x, double* dxdt)
 
     // --- d(lower zone depth)/dt = (net lower zone flow) /
     //                              (upper zone moisture deficit)
-    denom = A.porosity - x[THETA];
+    denom = g->a->porosity - x[THETA];
     if (denom > 0.0)
         dxdt[LOWERDEPTH] = qLower / denom;
     else
@@ -710,9 +738,10 @@ void  getDxDt(double t, double* x, double* dxdt)
 
 //=============================================================================
 
-void getEvapRates(double theta, double upperDepth)
+void getEvapRates(TGwaterCtx* g, double theta, double upperDepth)
 //
-//  Input:   theta      = moisture content of upper zone
+//  Input:   g          = groundwater work context
+//           theta      = moisture content of upper zone
 //           upperDepth = depth of upper zone (ft)
 //  Output:  none
 //  Purpose: computes evapotranspiration out of upper & lower zones.
@@ -723,14 +752,14 @@ void getEvapRates(double theta, double upperDepth)
     double lowerFrac, upperFrac;
 
     // --- no GW evaporation when infiltration is occurring
-    UpperEvap = 0.0;
-    LowerEvap = 0.0;
-    if ( Infil > 0.0 ) return;
+    g->upperEvap = 0.0;
+    g->lowerEvap = 0.0;
+    if ( g->infil > 0.0 ) return;
 
     // --- get monthly-adjusted upper zone evap fraction
-    upperFrac = A.upperEvapFrac;
+    upperFrac = g->a->upperEvapFrac;
     f = 1.0;
-    p = A.upperEvapPat;
+    p = g->a->upperEvapPat;
     if ( p >= 0 )
     {
         month = datetime_monthOfYear(getDateTime(NewRunoffTime));
@@ -740,35 +769,36 @@ void getEvapRates(double theta, double upperDepth)
 
     // --- upper zone evaporation requires that soil moisture
     //     be above the wilting point
-    if ( theta > A.wiltingPoint )
+    if ( theta > g->a->wiltingPoint )
     {
         // --- actual evap is upper zone fraction applied to max. potential
         //     rate, limited by the available rate after any surface evap 
-        UpperEvap = upperFrac * MaxEvap;
-        UpperEvap = MIN(UpperEvap, AvailEvap);
+        g->upperEvap = upperFrac * g->maxEvap;
+        g->upperEvap = MIN(g->upperEvap, g->availEvap);
     }
 
     // --- check if lower zone evaporation is possible
-    if ( A.lowerEvapDepth > 0.0 )
+    if ( g->a->lowerEvapDepth > 0.0 )
     {
         // --- find the fraction of the lower evaporation depth that
         //     extends into the saturated lower zone
-        lowerFrac = (A.lowerEvapDepth - upperDepth) / A.lowerEvapDepth;
+        lowerFrac = (g->a->lowerEvapDepth - upperDepth) / g->a->lowerEvapDepth;
         lowerFrac = MAX(0.0, lowerFrac);
         lowerFrac = MIN(lowerFrac, 1.0);
 
         // --- make the lower zone evap rate proportional to this fraction
         //     and the evap not used in the upper zone
-        LowerEvap = lowerFrac * (1.0 - upperFrac) * MaxEvap;
-        LowerEvap = MIN(LowerEvap, (AvailEvap - UpperEvap));
+        g->lowerEvap = lowerFrac * (1.0 - upperFrac) * g->maxEvap;
+        g->lowerEvap = MIN(g->lowerEvap, (g->availEvap - g->upperEvap));
     }
 }
 
 //=============================================================================
 
-double getUpperPerc(double theta, double upperDepth)
+double getUpperPerc(TGwaterCtx* g, double theta, double upperDepth)
 //
-//  Input:   theta      = moisture content of upper zone
+//  Input:   g          = groundwater work context
+//           theta      = moisture content of upper zone
 //           upperDepth = depth of upper zone (ft)
 //  Output:  returns percolation rate (ft/sec)
 //  Purpose: finds percolation rate from upper to lower zone.
@@ -779,26 +809,27 @@ double getUpperPerc(double theta, double upperDepth)
     double hydcon;                      // unsaturated hydraulic conductivity
 
     // --- no perc. from upper zone if no depth or moisture content too low    
-    if ( upperDepth <= 0.0 || theta <= A.fieldCapacity ) return 0.0;
+    if ( upperDepth <= 0.0 || theta <= g->a->fieldCapacity ) return 0.0;
 
     // --- compute hyd. conductivity as function of moisture content
-    delta = theta - A.porosity;
-    hydcon = A.conductivity * exp(delta * A.conductSlope);
+    delta = theta - g->a->porosity;
+    hydcon = g->a->conductivity * exp(delta * g->a->conductSlope);
 
     // --- compute integral of dh/dz term
-    delta = theta - A.fieldCapacity;
-    dhdz = 1.0 + A.tensionSlope * 2.0 * delta / upperDepth;
+    delta = theta - g->a->fieldCapacity;
+    dhdz = 1.0 + g->a->tensionSlope * 2.0 * delta / upperDepth;
 
     // --- compute upper zone percolation rate
-    HydCon = hydcon;
+    g->hydCon = hydcon;
     return hydcon * dhdz;
 }
 
 //=============================================================================
 
-double getGWFlow(double lowerDepth)
+double getGWFlow(TGwaterCtx* g, double lowerDepth)
 //
-//  Input:   lowerDepth = depth of lower zone (ft)
+//  Input:   g          = groundwater work context
+//           lowerDepth = depth of lower zone (ft)
 //  Output:  returns groundwater flow rate (ft/sec)
 //  Purpose: finds groundwater outflow from lower saturated zone.
 //
@@ -806,26 +837,26 @@ double getGWFlow(double lowerDepth)
     double q, t1, t2, t3;
 
     // --- water table must be above Hstar for flow to occur
-    if ( lowerDepth <= Hstar ) return 0.0;
+    if ( lowerDepth <= g->hstar ) return 0.0;
 
     // --- compute groundwater component of flow
-    if ( GW->b1 == 0.0 ) t1 = GW->a1;
-    else t1 = GW->a1 * pow( (lowerDepth - Hstar)*UCF(LENGTH), GW->b1);
+    if ( g->gw->b1 == 0.0 ) t1 = g->gw->a1;
+    else t1 = g->gw->a1 * pow( (lowerDepth - g->hstar)*UCF(LENGTH), g->gw->b1);
 
     // --- compute surface water component of flow
-    if ( GW->b2 == 0.0 ) t2 = GW->a2;
-    else if (Hsw > Hstar)
+    if ( g->gw->b2 == 0.0 ) t2 = g->gw->a2;
+    else if (g->hsw > g->hstar)
     {
-        t2 = GW->a2 * pow( (Hsw - Hstar)*UCF(LENGTH), GW->b2);
+        t2 = g->gw->a2 * pow( (g->hsw - g->hstar)*UCF(LENGTH), g->gw->b2);
     }
     else t2 = 0.0;
 
     // --- compute groundwater/surface water interaction term
-    t3 = GW->a3 * lowerDepth * Hsw * UCF(LENGTH) * UCF(LENGTH);
+    t3 = g->gw->a3 * lowerDepth * g->hsw * UCF(LENGTH) * UCF(LENGTH);
 
     // --- compute total groundwater flow
     q = (t1 - t2 + t3) / UCF(GWFLOW); 
-    if ( q < 0.0 && GW->a3 != 0.0 ) q = 0.0;
+    if ( q < 0.0 && g->gw->a3 != 0.0 ) q = 0.0;
     return q;
 }
 
@@ -847,26 +878,29 @@ int  getVariableIndex(char* s)
 
 //=============================================================================
 
-double getVariableValue(int varIndex)
+double getVariableValue(int varIndex, void* p)
 //
 //  Input:   varIndex = index of a GW variable
+//           p        = groundwater work context
 //  Output:  returns current value of GW variable
 //  Purpose: finds current value of a GW variable.
 //
 {
+    TGwaterCtx* g = (TGwaterCtx *)p;
+
     switch (varIndex)
     {
-    case gwvHGW:  return Hgw * UCF(LENGTH);
-    case gwvHSW:  return Hsw * UCF(LENGTH);
-    case gwvHCB:  return Hstar * UCF(LENGTH);
-    case gwvHGS:  return TotalDepth * UCF(LENGTH);
-    case gwvKS:   return A.conductivity * UCF(RAINFALL);
-    case gwvK:    return HydCon * UCF(RAINFALL);
-    case gwvTHETA:return Theta;
-    case gwvPHI:  return A.porosity;
-    case gwvFI:   return Infil * UCF(RAINFALL); 
-    case gwvFU:   return UpperPerc * UCF(RAINFALL);
-    case gwvA:    return Area * UCF(LANDAREA);
+    case gwvHGW:  return g->hgw * UCF(LENGTH);
+    case gwvHSW:  return g->hsw * UCF(LENGTH);
+    case gwvHCB:  return g->hstar * UCF(LENGTH);
+    case gwvHGS:  return g->totalDepth * UCF(LENGTH);
+    case gwvKS:   return g->a->conductivity * UCF(RAINFALL);
+    case gwvK:    return g->hydCon * UCF(RAINFALL);
+    case gwvTHETA:return g->theta;
+    case gwvPHI:  return g->a->porosity;
+    case gwvFI:   return g->infil * UCF(RAINFALL); 
+    case gwvFU:   return g->upperPerc * UCF(RAINFALL);
+    case gwvA:    return g->area * UCF(LANDAREA);
     default:      return 0.0;
     }
 }
@@ -228,11 +228,12 @@ void  saveRouting()
 //  Purpose: saves current state of all nodes and links to hotstart file.
 //
 {
-    int   i, j;
+    int   i, j, n;
     float x[3];
 
-    for (i = 0; i < Nobjects[NODE]; i++)
+    for (n = 0; n < Nobjects[NODE]; n++)
     {
+        i = reorder_getIndex(NODE, n);
         x[0] = (float)Node[i].newDepth;
         x[1] = (float)Node[i].newLatFlow;
         fwrite(x, sizeof(float), 2, Fhotstart2.file);
@@ -250,8 +251,9 @@ void  saveRouting()
             fwrite(&x[0], sizeof(float), 1, Fhotstart2.file);
         }
     }
-    for (i = 0; i < Nobjects[LINK]; i++)
+    for (n = 0; n < Nobjects[LINK]; n++)
     {
+        i = reorder_getIndex(LINK, n);
         x[0] = (float)Link[i].newFlow;
         x[1] = (float)Link[i].newDepth;
         x[2] = (float)Link[i].setting;
@@ -274,7 +276,7 @@ void readRouting()
 //           from hotstart file.
 //
 {
-    int   i, j;
+    int   i, j, n;
     float x;
     double xgw[4];
     FILE* f = Fhotstart1.file;
@@ -299,8 +301,9 @@ void readRouting()
     }
 
     // --- read node states
-    for (i = 0; i < Nobjects[NODE]; i++)
+    for (n = 0; n < Nobjects[NODE]; n++)
     {
+        i = reorder_getIndex(NODE, n);
         if ( !readFloat(&x, f) ) return;
         Node[i].newDepth = x;
         if ( !readFloat(&x, f) ) return;
@@ -330,8 +333,9 @@ void readRouting()
     }
 
     // --- read link states
-    for (i = 0; i < Nobjects[LINK]; i++)
+    for (n = 0; n < Nobjects[LINK]; n++)
     {
+        i = reorder_getIndex(LINK, n);
         if ( !readFloat(&x, f) ) return;
         Link[i].newFlow = x;
         if ( !readFloat(&x, f) ) return;
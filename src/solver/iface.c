@@ -286,14 +286,15 @@ void iface_saveOutletResults(DateTime reportDate, FILE* file)
 //  Purpose: saves system outflows to routing interface file.
 //
 {
-    int i, p, yr, mon, day, hr, min, sec;
+    int i, j, p, yr, mon, day, hr, min, sec;
     char theDate[26];
     datetime_decodeDate(reportDate, &yr, &mon, &day);
     datetime_decodeTime(reportDate, &hr, &min, &sec);
     snprintf(theDate, 26, " %04d %02d  %02d  %02d  %02d  %02d ",
             yr, mon, day, hr, min, sec);
-    for (i=0; i<Nobjects[NODE]; i++)
+    for (j=0; j<Nobjects[NODE]; j++)
     {
+        i = reorder_getIndex(NODE, j);
         // --- check that node is an outlet node
         if ( !isOutletNode(i) ) continue;
 
@@ -317,7 +318,7 @@ void openFileForOutput()
 //  Purpose: opens a routing interface file for writing.
 //
 {
-    int i, n;
+    int i, j, n;
 
     // --- open the routing file for writing text
     Foutflows.file = fopen(Foutflows.name, "wt");
@@ -351,8 +352,9 @@ void openFileForOutput()
 
     // --- write number and names of outlet nodes to file
     fprintf(Foutflows.file, "\n%-4d - number of nodes as listed below:", n);
-    for (i=0; i<Nobjects[NODE]; i++)
+    for (j=0; j<Nobjects[NODE]; j++)
     {
+        i = reorder_getIndex(NODE, j);
           if ( isOutletNode(i) )
             fprintf(Foutflows.file, "\n%s", Node[i].ID);
     }
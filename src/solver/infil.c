@@ -32,6 +32,9 @@
 //   - Additional validity check for G-A initial deficit added.
 //   - New error message 235 added for invalid infiltration parameters.
 //   - Conversion of runon to ponded depth fixed for Curve Number infiltration.
+//   Build 5.2.4:
+//   - Infiltration adjustment factor passed as an argument instead of being
+//     held in a shared variable so that runoff can be computed in parallel.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -50,9 +53,6 @@ typedef union TInfil {
 } TInfil;
 TInfil *Infil;
 
-static double Fumax;   // saturated water volume in upper soil zone (ft)
-static double InfilFactor;
-
 //-----------------------------------------------------------------------------
 //  External Functions (declared in infil.h)
 //-----------------------------------------------------------------------------
@@ -77,16 +77,16 @@ static void   horton_initState(THorton *infil);
 static void   horton_getState(THorton *infil, double x[]);
 static void   horton_setState(THorton *infil, double x[]);
 static double horton_getInfil(THorton *infil, double tstep, double irate,
-              double depth);
+              double depth, double factor);
 static double modHorton_getInfil(THorton *infil, double tstep, double irate,
-              double depth);
+              double depth, double factor);
 
 static void   grnampt_getState(TGrnAmpt *infil, double x[]);
 static void   grnampt_setState(TGrnAmpt *infil, double x[]);
 static double grnampt_getUnsatInfil(TGrnAmpt *infil, double tstep,
-              double irate, double depth, int modelType);
+              double irate, double depth, int modelType, double factor);
 static double grnampt_getSatInfil(TGrnAmpt *infil, double tstep,
-              double irate, double depth);
+              double irate, double depth, double factor);
 static double grnampt_getF2(double f1, double c1, double ks, double ts);
 
 static int    curvenum_setParams(TCurveNum *infil, double p[]);
@@ -107,7 +107,6 @@ void infil_create(int n)
 {
     Infil = (TInfil *) calloc(n, sizeof(TInfil));
     if (Infil == NULL) ErrorCode = ERR_MEMORY;
-    InfilFactor = 1.0;
     return;
 }
 
@@ -259,17 +258,18 @@ void infil_setState(int j, double x[])
 
 //=============================================================================
 
-void infil_setInfilFactor(int j)
+double infil_getInfilFactor(int j)
 //
 //  Input:   j = subcatchment index
-//  Output:  none
-//  Purpose: assigns a value to the infiltration adjustment factor.
+//  Output:  returns the infiltration adjustment factor
+//  Purpose: finds the infiltration adjustment factor for a subcatchment.
 {
     int m;
     int p;
+    double factor;
 
-    // ... set factor to the global conductivity adjustment factor
-    InfilFactor = Adjust.hydconFactor;
+    // ... start with the global conductivity adjustment factor
+    factor = Adjust.hydconFactor;
 
     // ... override global factor with subcatchment's adjustment if assigned 
     if (j >= 0)
@@ -278,21 +278,23 @@ void infil_setInfilFactor(int j)
         if (p >= 0 && Pattern[p].type == MONTHLY_PATTERN)
         {
             m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
-            InfilFactor = Pattern[p].factor[m];
+            factor = Pattern[p].factor[m];
         }
     }
+    return factor;
 }
 
 //=============================================================================
 
 double infil_getInfil(int j, double tstep, double rainfall,
-                      double runon, double depth)
+                      double runon, double depth, double factor)
 //
 //  Input:   j = subcatchment index
 //           tstep = runoff time step (sec)
 //           rainfall = rainfall rate (ft/sec)
 //           runon = runon rate from other sub-areas or subcatchments (ft/sec)
 //           depth = depth of surface water on subcatchment (ft)
+//           factor = infiltration adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes infiltration rate depending on infiltration method.
 //
@@ -300,16 +302,17 @@ double infil_getInfil(int j, double tstep, double rainfall,
     switch (Subcatch[j].infilModel)
     {
       case HORTON:
-          return horton_getInfil(&Infil[j].horton, tstep, rainfall+runon, depth);
+          return horton_getInfil(&Infil[j].horton, tstep, rainfall+runon, depth,
+                                 factor);
 
       case MOD_HORTON:
           return modHorton_getInfil(&Infil[j].horton, tstep, rainfall+runon,
-                                    depth);
+                                    depth, factor);
 
       case GREEN_AMPT:
       case MOD_GREEN_AMPT:
         return grnampt_getInfil(&Infil[j].grnAmpt, tstep, rainfall+runon, depth,
-            Subcatch[j].infilModel);
+            Subcatch[j].infilModel, factor);
 
       case CURVE_NUMBER:
         depth += runon * tstep;
@@ -381,13 +384,15 @@ void horton_setState(THorton *infil, double x[])
 
 //=============================================================================
 
-double horton_getInfil(THorton *infil, double tstep, double irate, double depth)
+double horton_getInfil(THorton *infil, double tstep, double irate, double depth,
+                       double factor)
 //
 //  Input:   infil = ptr. to Horton infiltration object
 //           tstep =  runoff time step (sec),
 //           irate = net "rainfall" rate (ft/sec),
 //                 = rainfall + snowmelt + runon - evaporation
 //           depth = depth of ponded water (ft).
+//           factor = infiltration adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes Horton infiltration for a subcatchment.
 //
@@ -397,8 +402,8 @@ double horton_getInfil(THorton *infil, double tstep, double irate, double depth)
     double fa, fp = 0.0;
     double Fp, F1, t1, tlim, ex, kt;
     double FF, FF1, r;
-    double f0   = infil->f0 * InfilFactor;
-    double fmin = infil->fmin * InfilFactor;
+    double f0   = infil->f0 * factor;
+    double fmin = infil->fmin * factor;
     double Fmax = infil->Fmax;
     double tp   = infil->tp;
     double df   = f0 - fmin;
@@ -494,13 +499,14 @@ double horton_getInfil(THorton *infil, double tstep, double irate, double depth)
 //=============================================================================
 
 double modHorton_getInfil(THorton *infil, double tstep, double irate,
-                          double depth)
+                          double depth, double factor)
 //
 //  Input:   infil = ptr. to Horton infiltration object
 //           tstep =  runoff time step (sec),
 //           irate = net "rainfall" rate (ft/sec),
 //                 = rainfall + snowmelt + runon
 //           depth = depth of ponded water (ft).
+//           factor = infiltration adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes modified Horton infiltration for a subcatchment.
 //
@@ -508,8 +514,8 @@ double modHorton_getInfil(THorton *infil, double tstep, double irate,
     // --- assign local variables
     double f  = 0.0;
     double fp, fa;
-    double f0 = infil->f0 * InfilFactor;
-    double fmin = infil->fmin * InfilFactor;
+    double f0 = infil->f0 * factor;
+    double fmin = infil->fmin * factor;
     double df = f0 - fmin;
     double kd = infil->decay;
     double kr = infil->regen * Evap.recoveryFactor;
@@ -630,7 +636,7 @@ void grnampt_setState(TGrnAmpt *infil, double x[])
 //=============================================================================
 
 double grnampt_getInfil(TGrnAmpt *infil, double tstep, double irate,
-    double depth, int modelType) 
+    double depth, int modelType, double factor) 
 //
 //  Input:   infil = ptr. to Green-Ampt infiltration object
 //           tstep =  time step (sec),
@@ -639,26 +645,26 @@ double grnampt_getInfil(TGrnAmpt *infil, double tstep, double irate,
 //                   does not include ponded water (added on below)
 //           depth = depth of ponded water (ft)
 //           modelType = either GREEN_AMPT or MOD_GREEN_AMPT 
+//           factor = hydraulic conductivity adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes Green-Ampt infiltration for a subcatchment
 //           or a storage node.
 //
 {
-    // --- find saturated upper soil zone water volume
-    Fumax = infil->IMDmax * infil->Lu * sqrt(InfilFactor);
-
     // --- reduce time until next event
     infil->T -= tstep;
 
     // --- use different procedures depending on upper soil zone saturation
-    if ( infil->Sat ) return grnampt_getSatInfil(infil, tstep, irate, depth);
-    else return grnampt_getUnsatInfil(infil, tstep, irate, depth, modelType);
+    if ( infil->Sat )
+        return grnampt_getSatInfil(infil, tstep, irate, depth, factor);
+    else return grnampt_getUnsatInfil(infil, tstep, irate, depth, modelType,
+                                      factor);
 }
 
 //=============================================================================
 
 double grnampt_getUnsatInfil(TGrnAmpt *infil, double tstep, double irate,
-    double depth, int modelType)
+    double depth, int modelType, double factor)
 //
 //  Input:   infil = ptr. to Green-Ampt infiltration object
 //           tstep =  runoff time step (sec),
@@ -667,14 +673,16 @@ double grnampt_getUnsatInfil(TGrnAmpt *infil, double tstep, double irate,
 //                   does not include ponded water (added on below)
 //           depth = depth of ponded water (ft)
 //           modelType = either GREEN_AMPT or MOD_GREEN_AMPT
+//           factor = hydraulic conductivity adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes Green-Ampt infiltration when upper soil zone is
 //           unsaturated.
 //
 {
     double ia, c1, F2, dF, Fs, kr, ts;
-    double ks = infil->Ks * InfilFactor;
-    double lu = infil->Lu * sqrt(InfilFactor);
+    double ks = infil->Ks * factor;
+    double lu = infil->Lu * sqrt(factor);
+    double Fumax = infil->IMDmax * infil->Lu * sqrt(factor);
 
     // --- get available infiltration rate (rainfall + ponded water)
     ia = irate + depth / tstep;
@@ -730,7 +738,7 @@ double grnampt_getUnsatInfil(TGrnAmpt *infil, double tstep, double irate,
     if ( infil->F > Fs )
     {
         infil->Sat = TRUE;
-        return grnampt_getSatInfil(infil, tstep, irate, depth);
+        return grnampt_getSatInfil(infil, tstep, irate, depth, factor);
     }
 
     // --- surface layer remains unsaturated
@@ -765,7 +773,7 @@ double grnampt_getUnsatInfil(TGrnAmpt *infil, double tstep, double irate,
 //=============================================================================
 
 double grnampt_getSatInfil(TGrnAmpt *infil, double tstep, double irate,
-    double depth)
+    double depth, double factor)
 //
 //  Input:   infil = ptr. to Green-Ampt infiltration object
 //           tstep =  runoff time step (sec),
@@ -773,14 +781,16 @@ double grnampt_getSatInfil(TGrnAmpt *infil, double tstep, double irate,
 //                 = rainfall + snowmelt + runon,
 //                   does not include ponded water (added on below)
 //           depth = depth of ponded water (ft).
+//           factor = hydraulic conductivity adjustment factor
 //  Output:  returns infiltration rate (ft/sec)
 //  Purpose: computes Green-Ampt infiltration when upper soil zone is
 //           saturated.
 //
 {
     double ia, c1, dF, F2;
-    double ks = infil->Ks * InfilFactor;
-    double lu = infil->Lu * sqrt(InfilFactor);
+    double ks = infil->Ks * factor;
+    double lu = infil->Lu * sqrt(factor);
+    double Fumax = infil->IMDmax * infil->Lu * sqrt(factor);
 
     // --- get available infiltration rate (rainfall + ponded water)
     ia = irate + depth / tstep;
@@ -16,6 +16,9 @@
 //   - New function infil_setInfilFactor() added.
 //   Build 5.1.015:
 //   - Support added for multiple infiltration methods within a project.
+//   Build 5.2.4:
+//   - infil_setInfilFactor() replaced with infil_getInfilFactor() and the
+//     adjustment factor passed to infil_getInfil() & grnampt_getInfil().
 //-----------------------------------------------------------------------------
 
 #ifndef INFIL_H
@@ -99,14 +102,14 @@ int     infil_readParams(int m, char* tok[], int ntoks);
 void    infil_initState(int j);
 void    infil_getState(int j, double x[]);
 void    infil_setState(int j, double x[]);
-void    infil_setInfilFactor(int j);
+double  infil_getInfilFactor(int j);
 double  infil_getInfil(int area, double tstep, double rainfall, double runon,
-        double depth);
+        double depth, double factor);
 
 void    grnampt_getParams(int j, double p[]);
 int     grnampt_setParams(TGrnAmpt *infil, double p[]);
 void    grnampt_initState(TGrnAmpt *infil);
 double  grnampt_getInfil(TGrnAmpt *infil, double tstep, double irate,
-        double depth, int modelType);
+        double depth, int modelType, double factor);
 
 #endif
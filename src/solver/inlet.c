@@ -22,6 +22,9 @@
 //   - Fixed expression for equivalent gutter slope in getCurbInletCapture.
 //   - Corrected sign in equation for effective head in a curb inlet
 //     with an inclined throat opening in getCurbOrificeFlow.
+//   - Optional capture curves added that tabulate an inlet's capture
+//     against approach flow (on-grade) or water depth (on-sag).
+//   - Number of street sides set before being used in getOnSagCapturedFlow.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -86,6 +89,17 @@ typedef struct
     double    bypassFreq;         // frequency of bypass flow
 } TInletStats;
 
+// Tabulated inlet capture
+typedef struct
+{
+    int       placement;          // placement (ON_GRADE or ON_SAG) tabulated
+    int       nItems;             // number of curve points (0 if no curve)
+    double    xMax;               // flow (cfs) or depth (ft) at last point
+    double*   capture;            // capture efficiency (on-grade) or
+                                  // captured flow (cfs) (on-sag) at each point
+    char*     exact;              // TRUE if interval uses exact capture
+} TCaptureCurve;
+
 // Inlet list object
 struct TInlet
 {
@@ -104,6 +118,7 @@ struct TInlet
     double      backflow;         // backflow from capture node (cfs)
     double      backflowRatio;    // inlet backflow / capture node overflow
     TInletStats stats;            // inlet performance statistics
+    TCaptureCurve* curve;         // tabulated capture (or NULL)
     TInlet *    nextInlet;        // next inlet in list
 };
 
@@ -146,6 +161,12 @@ static char* ThroatAngleWords[] =
 static char *PlacementTypeWords[] =
     {"AUTOMATIC", "ON_GRADE", "ON_SAG"};
 
+static const int    CAPTURE_CURVE_ITEMS = 65;    // points per capture curve
+static const double CAPTURE_CURVE_TOL = 0.001;   // max. curve error as
+                                                 // fraction of flow
+static const double CAPTURE_CURVE_MEMORY = 64.e6;// max. bytes used by all
+                                                 // capture curves
+
 // Coefficients for cubic polynomials fitted to Splash Over Velocity v.
 // Grate Length curves in Chart 5B of HEC-22 manual taken from Denver
 // UDFCD manual.
@@ -195,6 +216,8 @@ static double  Qfactor;      // factor f in Izzard's eqn. Q = f*T^2.67
 static TXsect* xsect;        // cross-section data of inlet's conduit
 static double* InletFlow;    // captured inlet flow received by each node
 static TInlet* FirstInlet;   // head of list of deployed inlets
+static double  CurveMemory;  // bytes used by inlet capture curves
+static TCaptureCurve NoCurve;// placeholder for inlets without curves
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in inlet.h)
@@ -204,6 +227,7 @@ static TInlet* FirstInlet;   // head of list of deployed inlets
 // inlet_readDesignParams    called by parseLine in input.c
 // inlet_readUsageParams     called by parseLine in input.c
 // inlet_validate            called by project_validate
+// inlet_remapObjects        called by reorder_network
 // inlet_findCapturedFlows   called by routing_execute
 // inlet_adjustQualInflows   called by routing_execute
 // inlet_adjustQualOutflows  called by routing execute
@@ -252,6 +276,12 @@ static double getCurbOrificeFlow(double flowDepth, double openingHeight,
               double openingLength, int throatAngle);
 static double getOnSagSlottedFlow(int inletIndex, double depth);
 
+static int    getCurveCapture(TInlet* inlet, int placement, double x,
+              double *flow);
+static TCaptureCurve* createCaptureCurve(TInlet* inlet, int placement);
+static double getExactCapture(TInlet* inlet, int placement, double x);
+static void   deleteCaptureCurve(TInlet* inlet);
+
 //=============================================================================
 
 int  inlet_create(int numInlets)
@@ -300,10 +330,12 @@ void inlet_delete()
     while (inlet)
     {
         nextInlet = inlet->nextInlet;
+        deleteCaptureCurve(inlet);
         free(inlet);
         inlet = nextInlet;
     }
     FirstInlet = NULL;
+    CurveMemory = 0.0;
     FREE(InletFlow);
     FREE(InletDesigns);
 }
@@ -437,6 +469,7 @@ int inlet_readUsageParams(char* tok[], int ntoks)
     {
         inlet = (TInlet *)malloc(sizeof(TInlet));
         if (!inlet) return error_setInpError(ERR_MEMORY, "");
+        inlet->curve = NULL;
         Link[linkIndex].inlet = inlet;
         inlet->nextInlet = FirstInlet;
         FirstInlet = inlet;
@@ -552,6 +585,26 @@ void inlet_validate()
 
 //=============================================================================
 
+void inlet_remapObjects(int newNode[], int newLink[])
+//
+//  Input:   newNode = new index of each node
+//           newLink = new index of each link
+//  Output:  none
+//  Purpose: updates the conduit and capture node of each inlet after the
+//           project's nodes and links have been renumbered.
+//
+{
+    TInlet* inlet;
+
+    for (inlet = FirstInlet; inlet != NULL; inlet = inlet->nextInlet)
+    {
+        inlet->linkIndex = newLink[inlet->linkIndex];
+        inlet->nodeIndex = newNode[inlet->nodeIndex];
+    }
+}
+
+//=============================================================================
+
 void inlet_findCapturedFlows(double tStep)
 //
 //  Input:   tStep = current flow routing time step (sec)
@@ -597,17 +650,23 @@ void inlet_findCapturedFlows(double tStep)
         }
 
         // --- find flow captured by on-grade inlet
+        //     (from its capture curve if possible)
         else if (placement == ON_GRADE)
         {
             q = fabs(Link[i].newFlow);
-            inlet->flowCapture = getOnGradeCapturedFlow(inlet, q, Node[j].newDepth);
+            if (!getCurveCapture(inlet, placement, q, &inlet->flowCapture))
+                inlet->flowCapture =
+                    getOnGradeCapturedFlow(inlet, q, Node[j].newDepth);
         }
 
         // --- find flow captured by on-sag inlet
         else
         {
             q = Node[j].inflow;
-            inlet->flowCapture = getOnSagCapturedFlow(inlet, q, Node[j].newDepth);
+            if (!getCurveCapture(inlet, placement, Node[j].newDepth,
+                &inlet->flowCapture))
+                inlet->flowCapture =
+                    getOnSagCapturedFlow(inlet, q, Node[j].newDepth);
         }
         if (fabs(inlet->flowCapture) < FUDGE) inlet->flowCapture = 0.0;
 
@@ -778,11 +837,12 @@ void inlet_writeStatsReport()
 //  Purpose: writes table of street & inlet flow statistics to SWMM's report file.
 //
 {
-    int j, header = FALSE;
+    int i, j, header = FALSE;
 
     if (Nobjects[STREET] == 0) return;
-    for (j = 0; j < Nobjects[LINK]; j++)
+    for (i = 0; i < Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
         if (Link[j].xsect.type == STREET_XSECT)
         {
             if (!header)
@@ -1584,12 +1644,13 @@ double getOnSagCapturedFlow(TInlet* inlet, double q, double d)
     double qCaptured = 0.0, qMax = BIG;
 
     if (inlet->numInlets == 0) return 0.0;
-    totalInlets = Nsides * inlet->numInlets;
     linkIndex = inlet->linkIndex;
     designIndex = inlet->designIndex;
 
-    // --- store conduit geometry in shared variables
+    // --- store conduit geometry (including number of street sides)
+    //     in shared variables
     getConduitGeometry(inlet);
+    totalInlets = Nsides * inlet->numInlets;
 
     // --- set flow limit per inlet
     if (inlet->flowLimit > 0.0)
@@ -1957,3 +2018,156 @@ double getCustomCapturedFlow(TInlet* inlet, double q, double d)
     }
     return qCaptured;
 }
+
+//=============================================================================
+
+int getCurveCapture(TInlet* inlet, int placement, double x, double *flow)
+//
+//  Input:   inlet = an inlet object placed in a conduit link
+//           placement = inlet's placement (ON_GRADE or ON_SAG)
+//           x = approach flow (cfs) for on-grade or water depth (ft) for
+//               on-sag placement
+//  Output:  flow = flow captured by the inlet (cfs);
+//           returns TRUE if the flow was found from the inlet's capture curve
+//  Purpose: interpolates an inlet's captured flow from its capture curve.
+//
+{
+    int    i, n;
+    double u, e;
+    TCaptureCurve* curve;
+
+    if (!InletCurves) return FALSE;
+    if (placement == ON_GRADE && x < MIN_RUNOFF_FLOW) return FALSE;
+
+    // --- build inlet's capture curve the first time it is needed
+    curve = inlet->curve;
+    if (curve == NULL || curve->placement != placement)
+    {
+        deleteCaptureCurve(inlet);
+        inlet->curve = createCaptureCurve(inlet, placement);
+        curve = inlet->curve;
+    }
+
+    // --- check that x lies within an interpolated interval of the curve
+    n = curve->nItems;
+    if (n == 0 || x <= 0.0 || x > curve->xMax) return FALSE;
+    u = (n - 1) * sqrt(x / curve->xMax);
+    i = MIN((int)u, n - 2);
+    if (curve->exact[i]) return FALSE;
+
+    // --- interpolate capture efficiency (on-grade) or captured flow (on-sag)
+    e = curve->capture[i] + (u - i) * (curve->capture[i+1] - curve->capture[i]);
+    if (placement == ON_GRADE) *flow = e * x;
+    else *flow = e;
+    return TRUE;
+}
+
+//=============================================================================
+
+TCaptureCurve* createCaptureCurve(TInlet* inlet, int placement)
+//
+//  Input:   inlet = an inlet object placed in a conduit link
+//           placement = inlet's placement (ON_GRADE or ON_SAG)
+//  Output:  returns the inlet's capture curve
+//  Purpose: tabulates an inlet's capture efficiency against approach flow
+//           (up to its conduit's full flow) for on-grade placement or its
+//           captured flow against water depth (up to its conduit's full
+//           depth) for on-sag placement.
+//
+//  Curve points are spaced uniformly in sqrt(x). The first interval and any
+//  interval whose mid-point error exceeds CAPTURE_CURVE_TOL (e.g., where an
+//  on-sag inlet switches from weir to orifice flow) are flagged to use exact
+//  capture instead. A placeholder without any points is returned for inlets
+//  whose on-grade capture also depends on water depth or once the memory
+//  used by all curves would exceed CAPTURE_CURVE_MEMORY.
+//
+{
+    int    i, n = CAPTURE_CURVE_ITEMS;
+    double bytes, xMax, x, u, e, tol;
+    TCaptureCurve* curve;
+
+    if (placement == ON_GRADE &&
+        InletDesigns[inlet->designIndex].type == DROP_CURB_INLET)
+        return &NoCurve;
+    if (placement == ON_GRADE) xMax = Link[inlet->linkIndex].qFull;
+    else xMax = Link[inlet->linkIndex].xsect.yFull;
+    bytes = sizeof(TCaptureCurve) + n * sizeof(double) + n - 1;
+    if (xMax <= 0.0 || CurveMemory + bytes > CAPTURE_CURVE_MEMORY)
+        return &NoCurve;
+
+    curve = (TCaptureCurve *)calloc(1, sizeof(TCaptureCurve));
+    if (curve == NULL) return &NoCurve;
+    curve->capture = (double *)calloc(n, sizeof(double));
+    curve->exact = (char *)calloc(n - 1, sizeof(char));
+    if (curve->capture == NULL || curve->exact == NULL)
+    {
+        FREE(curve->capture);
+        FREE(curve->exact);
+        free(curve);
+        return &NoCurve;
+    }
+    curve->placement = placement;
+    curve->nItems = n;
+    curve->xMax = xMax;
+    CurveMemory += bytes;
+
+    // --- capture at each curve point
+    for (i = 1; i < n; i++)
+    {
+        u = (double)i / (double)(n - 1);
+        curve->capture[i] = getExactCapture(inlet, placement, xMax * u * u);
+    }
+    if (placement == ON_GRADE) curve->capture[0] = curve->capture[1];
+
+    // --- flag intervals where interpolation is not accurate enough
+    //     (tolerance applies to efficiency for on-grade placement)
+    curve->exact[0] = TRUE;
+    for (i = 1; i < n - 1; i++)
+    {
+        u = ((double)i + 0.5) / (double)(n - 1);
+        x = xMax * u * u;
+        e = getExactCapture(inlet, placement, x);
+        tol = CAPTURE_CURVE_TOL;
+        if (placement == ON_SAG) tol *= e;
+        if (fabs(0.5 * (curve->capture[i] + curve->capture[i+1]) - e) > tol)
+            curve->exact[i] = TRUE;
+    }
+    return curve;
+}
+
+//=============================================================================
+
+double getExactCapture(TInlet* inlet, int placement, double x)
+//
+//  Input:   inlet = an inlet object placed in a conduit link
+//           placement = inlet's placement (ON_GRADE or ON_SAG)
+//           x = approach flow (cfs) for on-grade or water depth (ft) for
+//               on-sag placement
+//  Output:  returns capture efficiency (on-grade) or captured flow (on-sag)
+//  Purpose: computes the quantity tabulated in an inlet's capture curve.
+//
+{
+    if (placement == ON_GRADE)
+        return getOnGradeCapturedFlow(inlet, x, 0.0) / x;
+    return getOnSagCapturedFlow(inlet, 0.0, x);
+}
+
+//=============================================================================
+
+void deleteCaptureCurve(TInlet* inlet)
+//
+//  Input:   inlet = an inlet object placed in a conduit link
+//  Output:  none
+//  Purpose: frees the memory used by an inlet's capture curve.
+//
+{
+    TCaptureCurve* curve = inlet->curve;
+
+    inlet->curve = NULL;
+    if (curve == NULL || curve == &NoCurve) return;
+    CurveMemory -= sizeof(TCaptureCurve) + curve->nItems * sizeof(double) +
+                   curve->nItems - 1;
+    FREE(curve->capture);
+    FREE(curve->exact);
+    free(curve);
+}
@@ -19,6 +19,7 @@ void   inlet_delete();
 int    inlet_readDesignParams(char* tok[], int ntoks);
 int    inlet_readUsageParams(char* tok[], int ntoks);
 void   inlet_validate();
+void   inlet_remapObjects(int newNode[], int newLink[]);
 
 void   inlet_findCapturedFlows(double tStep);
 void   inlet_adjustQualInflows();
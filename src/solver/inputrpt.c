@@ -12,6 +12,8 @@
 //   ==============
 //   Build 5.2.0:
 //   - Support added for reporting Street geometry tables.
+//   Build 5.2.4:
+//   - Depth entries of adaptive transect geometry tables reported.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -32,7 +34,7 @@ void inputrpt_writeInput()
 //
 {
     int m;
-    int i, k;
+    int i, j, k;
     int lidCount = 0;
     if ( ErrorCode ) return;
 
@@ -163,8 +165,9 @@ void inputrpt_writeInput()
 "\n  Name                 Type                 Elev.     Depth      Area    Inflow  ");
         fprintf(Frpt.file,
 "\n  -------------------------------------------------------------------------------");
-        for (i = 0; i < Nobjects[NODE]; i++)
+        for (j = 0; j < Nobjects[NODE]; j++)
         {
+            i = reorder_getIndex(NODE, j);
             fprintf(Frpt.file, "\n  %-20s %-16s%10.2f%10.2f%10.1f", Node[i].ID,
                 NodeTypeWords[Node[i].type-JUNCTION],
                 Node[i].invertElev*UCF(LENGTH),
@@ -188,8 +191,9 @@ void inputrpt_writeInput()
 "\n  Name             From Node        To Node          Type            Length    %%Slope Roughness");
         fprintf(Frpt.file,
 "\n  ---------------------------------------------------------------------------------------------");
-        for (i = 0; i < Nobjects[LINK]; i++)
+        for (j = 0; j < Nobjects[LINK]; j++)
         {
+            i = reorder_getIndex(LINK, j);
             // --- list end nodes in their original orientation
             if ( Link[i].direction == 1 )
                 fprintf(Frpt.file, "\n  %-16s %-16s %-16s ",
@@ -230,8 +234,9 @@ void inputrpt_writeInput()
 "\n  Conduit          Shape               Depth     Area     Rad.    Width  Barrels     Flow");
         fprintf(Frpt.file,
 "\n  ---------------------------------------------------------------------------------------");
-        for (i = 0; i < Nobjects[LINK]; i++)
+        for (j = 0; j < Nobjects[LINK]; j++)
         {
+            i = reorder_getIndex(LINK, j);
             if (Link[i].type == CONDUIT)
             {
                 k = Link[i].subIndex;
@@ -299,20 +304,29 @@ void inputrpt_writeInput()
         for (i = 0; i < Nobjects[TRANSECT]; i++)
         {
             fprintf(Frpt.file, "\n\n  Transect %s", Transect[i].ID);
+            if ( Transect[i].depthTbl )
+            {
+                fprintf(Frpt.file, "\n  Depth: ");
+                for ( m = 1; m < Transect[i].nTbl; m++)
+                {
+                     if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
+                     fprintf(Frpt.file, "%10.4f ", Transect[i].depthTbl[m]);
+                }
+            }
             fprintf(Frpt.file, "\n  Area:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].areaTbl[m]);
             }
             fprintf(Frpt.file, "\n  Hrad:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].hradTbl[m]);
             }
             fprintf(Frpt.file, "\n  Width: ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].widthTbl[m]);
@@ -330,6 +344,15 @@ void inputrpt_writeInput()
         for (i = 0; i < Nobjects[STREET]; i++)
         {
             fprintf(Frpt.file, "\n\n  Street %s", Street[i].ID);
+            if (Street[i].transect.depthTbl)
+            {
+                fprintf(Frpt.file, "\n  Depth: ");
+                for (m = 1; m < Street[i].transect.nTbl; m++)
+                {
+                    if (m % 5 == 1) fprintf(Frpt.file, "\n          ");
+                    fprintf(Frpt.file, "%10.4f ", Street[i].transect.depthTbl[m]);
+                }
+            }
             fprintf(Frpt.file, "\n  Area:  ");
             for (m = 1; m < Street[i].transect.nTbl; m++)
             {
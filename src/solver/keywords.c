@@ -67,6 +67,7 @@ char* LoadUnitsWords[]     = { w_LBS, w_KG, w_LOGN };
 char* NodeTypeWords[]      = { w_JUNCTION, w_OUTFALL,
                                w_STORAGE, w_DIVIDER };
 char* NoneAllWords[]       = { w_NONE, w_ALL, NULL};
+char* NetworkOrderWords[]  = { w_INPUT, w_RCM, NULL};
 char* NormalFlowWords[]    = { w_SLOPE, w_FROUDE, w_BOTH, w_NONE, NULL};
 char* NormalizerWords[]    = { w_PER_AREA, w_PER_CURB, NULL};
 char* NoYesWords[]         = { w_NO, w_YES, NULL};
@@ -94,7 +95,14 @@ char* OptionWords[]        = { w_FLOW_UNITS,        w_INFIL_MODEL,
                                w_SYS_FLOW_TOL,      w_LAT_FLOW_TOL,
                                w_IGNORE_RDII,       w_MIN_ROUTE_STEP,
                                w_NUM_THREADS,       w_SURCHARGE_METHOD,
-                               NULL };
+                               w_PARALLEL_NODE_FLOWS, w_NETWORK_ORDER,
+                               w_SOLVER_METHOD,     w_RELAXATION,
+                               w_STEP_CLASSES,      w_SKIP_DORMANT,
+                               w_DETERMINISTIC,     w_LOAD_BALANCING,
+                               w_GEOMETRY_TOL,      w_DEPTH_CURVES,
+                               w_TRANSECT_TOL,      w_INLET_CURVES,
+                               w_FRICTION_CURVES,   w_CULVERT_CURVES,
+                               w_SKIP_DRY_SUBCATCH, NULL };
 char* OrificeTypeWords[]   = { w_SIDE, w_BOTTOM, NULL};
 char* OutfallTypeWords[]   = { w_FREE, w_NORMAL, w_FIXED, w_TIDAL,
                                w_TIMESERIES, NULL};
@@ -108,6 +116,7 @@ char* RainUnitsWords[]     = { w_INCHES, w_MMETER, NULL};
 char* RelationWords[]      = { w_TABULAR, w_FUNCTIONAL,
                                w_CYLINDRICAL, w_CONICAL, w_PARABOLIC,
                                w_PYRAMIDAL, NULL};
+char* RelaxationWords[]    = { w_FIXED, w_AITKEN, NULL};
 char* ReportWords[]        = { w_DISABLED, w_INPUT, w_SUBCATCH, w_NODE, w_LINK,
                                w_CONTINUITY, w_FLOWSTATS,w_CONTROLS,
                                w_AVERAGES, w_NODESTATS, NULL};
@@ -145,6 +154,7 @@ char* SectWords[]          = { ws_TITLE,          ws_OPTION,
                                ws_STREET,         ws_INLET_USAGE,
                                ws_INLET,          NULL};
 char* SnowmeltWords[]      = { w_PLOWABLE, w_IMPERV, w_PERV, w_REMOVAL, NULL};
+char* SolverWords[]        = { w_PICARD, w_NEWTON, NULL};
 char* SurchargeWords[]     = { w_EXTRAN, w_SLOT, NULL};
 char* TempKeyWords[]       = { w_TIMESERIES, w_FILE, w_WINDSPEED, w_SNOWMELT,
                                w_ADC, NULL};
@@ -37,6 +37,7 @@ extern char* LinkTypeWords[];
 extern char* LoadUnitsWords[];
 extern char* NodeTypeWords[];
 extern char* NoneAllWords[];
+extern char* NetworkOrderWords[];
 extern char* NormalFlowWords[];
 extern char* NormalizerWords[];
 extern char* NoYesWords[];
@@ -52,12 +53,14 @@ extern char* PumpTypeWords[];
 extern char* QualUnitsWords[];
 extern char* RainTypeWords[];
 extern char* RainUnitsWords[];
+extern char* RelaxationWords[];
 extern char* ReportWords[];
 extern char* RelationWords[];
 extern char* RouteModelWords[];
 extern char* RuleKeyWords[];
 extern char* SectWords[];
 extern char* SnowmeltWords[];
+extern char* SolverWords[];
 extern char* SurchargeWords[];
 extern char* TempKeyWords[];
 extern char* TransectKeyWords[];
@@ -15,6 +15,9 @@
 //     modified to return concentration instead of mass load.
 //   - landuse_getRunoffLoad() re-named to landuse_getWashoffLoad() and
 //     modified to work with landuse_getWashoffQual().
+//   Build 5.2.4:
+//   - External buildup time series lookup made safe for subcatchments
+//     analyzed concurrently.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -710,8 +713,10 @@ double landuse_getExternalBuildup(int i, int p, double buildup, double tStep)
     if (NewRunoffTime == 0.0) return 0.0;
 
     // --- get buildup rate (mass/unit/day) over the interval
+    //     (time series lookups update the series' cursor position)
     if ( ts >= 0 )
     {        
+        #pragma omp critical(landuse_tseries)
         rate = sf * table_tseriesLookup(&Tseries[ts],
                getDateTime(NewRunoffTime), FALSE);
     }
@@ -72,6 +72,10 @@
 //   - Fixed double counting of initial water volume in green roof drain mat.
 //   Build 5.2.4
 //   - Fixed test for invalid data in readDrainData function.
+//   - Evaporation and native infiltration rates and subcatchment volumes
+//     passed through runoff and LID contexts instead of shared variables.
+//   - lid_addDrainRunon() restricted to a single receiving subcatchment and
+//     lid_getDrainSubcatchs() added to support a runon schedule.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -150,22 +154,9 @@ static int        LidCount;            // number of LID processes
 static TLidGroup* LidGroups;           // array of LID process groups
 static int        GroupCount;          // number of LID groups (subcatchments)
 
-static double     EvapRate;            // evaporation rate (ft/s)
-static double     NativeInfil;         // native soil infil. rate (ft/s)
-static double     MaxNativeInfil;      // native soil infil. rate limit (ft/s)
-
 //-----------------------------------------------------------------------------
-//  Imported Variables (from SUBCATCH.C)
+//  Imported Variables
 //-----------------------------------------------------------------------------
-// Volumes (ft3) for a subcatchment over a time step 
-extern double     Vevap;               // evaporation
-extern double     Vpevap;              // pervious area evaporation
-extern double     Vinfil;              // non-LID infiltration
-extern double     VlidInfil;           // infiltration from LID units
-extern double     VlidIn;              // impervious area flow to LID units
-extern double     VlidOut;             // surface outflow from LID units
-extern double     VlidDrain;           // drain outflow from LID units
-extern double     VlidReturn;          // LID outflow returned to pervious area
 extern char       HasWetLids;          // TRUE if any LIDs are wet
                                        // (from RUNOFF.C)
 
@@ -175,6 +166,7 @@ extern char       HasWetLids;          // TRUE if any LIDs are wet
 //  lid_create               called by createObjects in project.c
 //  lid_delete               called by deleteObjects in project.c
 //  lid_validate             called by project_validate
+//  lid_remapNodes           called by reorder_network
 //  lid_initState            called by project_init
 
 //  lid_readProcParams       called by parseLine in input.c
@@ -193,6 +185,7 @@ extern char       HasWetLids;          // TRUE if any LIDs are wet
 //  lid_getRunoff            called by subcatch_getRunoff
 
 //  lid_addDrainRunon        called by subcatch_getRunon
+//  lid_getDrainSubcatchs    called by subcatch_createRunonSchedule
 //  lid_addDrainLoads        called by surfqual_getWashoff
 //  lid_addDrainInflow       called by addLidDrainInflows in routing.c
 
@@ -225,11 +218,13 @@ static double getImpervAreaRunoff(int j);
 static double getPervAreaRunoff(int j);
 static double getSurfaceDepth(int subcatch);
 static double getRainInflow(int j, TLidUnit*  lidUnit);
-static void   findNativeInfil(int j, double tStep);
+static double findNativeInfil(int j, double tStep, TRunoffCtx* ctx,
+              double* maxNativeInfil);
 
 
 static void   evalLidUnit(int j, TLidUnit* lidUnit, double lidArea,
-              double lidInflow, double tStep, double *qRunoff,
+              double lidInflow, double nativeInfil, double tStep,
+              TLidCtx* lc, TRunoffCtx* ctx, double *qRunoff,
               double *qDrain, double *qReturn);
 
 //=============================================================================
@@ -1208,6 +1203,36 @@ void validateLidGroup(int j)
 
 //=============================================================================
 
+void lid_remapNodes(int newNode[])
+//
+//  Purpose: updates the index of each LID unit's drain node after the
+//           project's nodes have been renumbered.
+//  Input:   newNode = new index of each node
+//  Output:  none
+//
+{
+    int        j;
+    TLidGroup  lidGroup;
+    TLidList*  lidList;
+    TLidUnit*  lidUnit;
+
+    for (j = 0; j < GroupCount; j++)
+    {
+        lidGroup = LidGroups[j];
+        if ( lidGroup == NULL ) continue;
+        lidList = lidGroup->lidList;
+        while ( lidList )
+        {
+            lidUnit = lidList->lidUnit;
+            if ( lidUnit->drainNode >= 0 )
+                lidUnit->drainNode = newNode[lidUnit->drainNode];
+            lidList = lidList->nextLidUnit;
+        }
+    }
+}
+
+//=============================================================================
+
 void lid_initState()
 //
 //  Purpose: initializes the internal state of each LID in a subcatchment.
@@ -1494,16 +1519,16 @@ void  lid_addDrainLoads(int j, double c[], double tStep)
 
 //=============================================================================
 
-void lid_addDrainRunon(int j)
+void lid_addDrainRunon(int j, int k)
 //
-//  Purpose: adds drain flows from LIDs in a given subcatchment to the
-//           subcatchments that were designated to receive them 
+//  Purpose: adds drain flows from LIDs in a given subcatchment to another
+//           subcatchment that was designated to receive them 
 //  Input:   j = index of subcatchment contributing underdrain flows
+//           k = index of subcatchment receiving underdrain flows
 //  Output:  none.
 //
 {
     int i;                   // index of an LID unit's LID process
-    int k;                   // index of subcatchment receiving LID drain flow
     int p;                   // pollutant index
     double q;                // drain flow rate (cfs)
     double w;                // mass of polllutant from drain flow
@@ -1519,11 +1544,10 @@ void lid_addDrainRunon(int j)
         lidList = lidGroup->lidList;
         while ( lidList )
         {
-            //... see if LID's drain discharges to another subcatchment
+            //... see if LID's drain discharges to subcatchment k
             lidUnit = lidList->lidUnit;
             i = lidUnit->lidIndex;
-            k = lidUnit->drainSubcatch;
-            if ( k >= 0 && k != j )
+            if ( lidUnit->drainSubcatch == k && k != j )
             {
                 //... distribute drain flow across subcatchment's areas
                 q = lidUnit->oldDrainFlow;
@@ -1546,6 +1570,37 @@ void lid_addDrainRunon(int j)
 
 //=============================================================================
 
+int lid_getDrainSubcatchs(int j, int k[], int n)
+//
+//  Purpose: finds the other subcatchments that receive drain flow from the
+//           LIDs in a given subcatchment.
+//  Input:   j = index of subcatchment contributing underdrain flows
+//           n = size of array k
+//  Output:  k = indexes of receiving subcatchments (first n of them);
+//           returns number of LID units draining to another subcatchment
+//
+{
+    int        count = 0;
+    TLidUnit*  lidUnit;
+    TLidList*  lidList;
+
+    if ( LidGroups[j] == NULL ) return 0;
+    lidList = LidGroups[j]->lidList;
+    while ( lidList )
+    {
+        lidUnit = lidList->lidUnit;
+        if ( lidUnit->drainSubcatch >= 0 && lidUnit->drainSubcatch != j )
+        {
+            if ( count < n ) k[count] = lidUnit->drainSubcatch;
+            count++;
+        }
+        lidList = lidList->nextLidUnit;
+    }
+    return count;
+}
+
+//=============================================================================
+
 void  lid_addDrainInflow(int j, double f)
 //
 //  Purpose: adds LID drain flow to conveyance system nodes 
@@ -1606,18 +1661,22 @@ void  lid_addDrainInflow(int j, double f)
 
 //=============================================================================
 
-void lid_getRunoff(int j, double tStep)
+void lid_getRunoff(int j, double tStep, TRunoffCtx* ctx)
 //
 //  Purpose: computes runoff and drain flows from the LIDs in a subcatchment.
 //  Input:   j     = subcatchment index 
 //           tStep = time step (sec)
-//  Output:  updates following global quantities after LID treatment applied:
-//           Vevap, Vpevap, VlidInfil, VlidIn, VlidOut, VlidDrain.
+//           ctx   = runoff context of the subcatchment
+//  Output:  updates following runoff context volumes after LID treatment
+//           applied: vEvap, vPevap, vLidInfil, vLidIn, vLidOut, vLidDrain,
+//           vLidReturn.
 //
 {
     TLidGroup  theLidGroup;       // group of LIDs placed in the subcatchment
     TLidList*  lidList;           // list of LID units in the group
     TLidUnit*  lidUnit;           // a member of the list of LID units
+    TLidCtx    lc;                // work context for evaluating LID units
+    double nativeInfil;           // native soil infil. rate (ft/s)
     double lidArea;               // area of an LID unit
     double qImperv = 0.0;         // runoff from impervious areas (cfs)
     double qPerv = 0.0;           // runoff from pervious areas (cfs)
@@ -1633,11 +1692,12 @@ void lid_getRunoff(int j, double tStep)
     if ( !lidList ) return;
 
     //... determine if evaporation can occur
-    EvapRate = Evap.rate;
-    if ( Evap.dryOnly && Subcatch[j].rainfall > 0.0 ) EvapRate = 0.0;
+    lc.evapRate = Evap.rate;
+    if ( Evap.dryOnly && Subcatch[j].rainfall > 0.0 ) lc.evapRate = 0.0;
 
     //... find subcatchment's infiltration rate into native soil
-    findNativeInfil(j, tStep);
+    lc.infilFactor = ctx->infilFactor;
+    nativeInfil = findNativeInfil(j, tStep, ctx, &lc.maxNativeInfil);
 
     //... get impervious and pervious area runoff from non-LID
     //    portion of subcatchment (cfs)
@@ -1662,7 +1722,7 @@ void lid_getRunoff(int j, double tStep)
                          qPerv * lidUnit->fromPerv) / lidArea;
 
             //... update total runoff volume treated
-            VlidIn += lidInflow * lidArea * tStep;
+            ctx->vLidIn += lidInflow * lidArea * tStep;
 
             //... add rainfall onto LID inflow (ft/s)
             lidInflow = lidInflow + getRainInflow(j, lidUnit);
@@ -1676,8 +1736,8 @@ void lid_getRunoff(int j, double tStep)
             //... evaluate the LID unit's performance, updating the LID group's
             //    total surface runoff, drain flow, and flow returned to
             //    pervious area 
-            evalLidUnit(j, lidUnit, lidArea, lidInflow, tStep,
-                        &qRunoff, &qDrain, &qReturn);
+            evalLidUnit(j, lidUnit, lidArea, lidInflow, nativeInfil, tStep,
+                        &lc, ctx, &qRunoff, &qDrain, &qReturn);
         }
         lidList = lidList->nextLidUnit;
     }
@@ -1687,46 +1747,52 @@ void lid_getRunoff(int j, double tStep)
     theLidGroup->flowToPerv = qReturn;
 
     //... save the LID group's total surface, drain and return flow volumes
-    VlidOut = qRunoff * tStep; 
-    VlidDrain = qDrain * tStep;
-    VlidReturn = qReturn * tStep;
+    ctx->vLidOut = qRunoff * tStep; 
+    ctx->vLidDrain = qDrain * tStep;
+    ctx->vLidReturn = qReturn * tStep;
 }
 
 //=============================================================================
 
-void findNativeInfil(int j, double tStep)
+double findNativeInfil(int j, double tStep, TRunoffCtx* ctx,
+                       double* maxNativeInfil)
 //
 //  Purpose: determines a subcatchment's current infiltration rate into
 //           its native soil.
 //  Input:   j = subcatchment index
 //           tStep    = time step (sec)
-//  Output:  sets values for module-level variables NativeInfil
+//           ctx      = runoff context of the subcatchment
+//  Output:  maxNativeInfil = groundwater-imposed limit on infil. (ft/s)
+//           returns native soil infiltration rate (ft/s)
 //
 {
     double nonLidArea;
+    double nativeInfil;
 
     //... subcatchment has non-LID pervious area
     nonLidArea = Subcatch[j].area - Subcatch[j].lidArea;
     if ( nonLidArea > 0.0 && Subcatch[j].fracImperv < 1.0 )
     {
-        NativeInfil = Vinfil / nonLidArea / tStep;
+        nativeInfil = ctx->vInfil / nonLidArea / tStep;
     }
 
     //... otherwise find infil. rate for the subcatchment's rainfall + runon
     else
     {
-        NativeInfil = infil_getInfil(j, tStep,
+        nativeInfil = infil_getInfil(j, tStep,
                                      Subcatch[j].rainfall,
                                      Subcatch[j].runon,
-                                     getSurfaceDepth(j));
+                                     getSurfaceDepth(j),
+                                     ctx->infilFactor);
     }
 
     //... see if there is any groundwater-imposed limit on infil.
     if ( !IgnoreGwater && Subcatch[j].groundwater )
     {
-        MaxNativeInfil = Subcatch[j].groundwater->maxInfilVol / tStep;
+        *maxNativeInfil = Subcatch[j].groundwater->maxInfilVol / tStep;
     }
-    else MaxNativeInfil = BIG;
+    else *maxNativeInfil = BIG;
+    return nativeInfil;
 }
 
 //=============================================================================
@@ -1805,14 +1871,18 @@ double getPervAreaRunoff(int j)
 //=============================================================================
 
 void evalLidUnit(int j, TLidUnit* lidUnit, double lidArea, double lidInflow,
-    double tStep, double *qRunoff, double *qDrain, double *qReturn)
+    double nativeInfil, double tStep, TLidCtx* lc, TRunoffCtx* ctx,
+    double *qRunoff, double *qDrain, double *qReturn)
 //
 //  Purpose: evaluates performance of a specific LID unit over current time step.
 //  Input:   j         = subcatchment index
 //           lidUnit   = ptr. to LID unit being evaluated
 //           lidArea   = area of LID unit
 //           lidInflow = inflow to LID unit (ft/s)
+//           nativeInfil = native soil infil. rate (ft/s)
 //           tStep     = time step (sec)
+//           lc        = work context for the LID unit
+//           ctx       = runoff context of the subcatchment
 //  Output:  qRunoff   = sum of surface runoff from all LIDs (cfs)
 //           qDrain    = sum of drain flows from all LIDs (cfs)
 //           qReturn   = sum of LID flows returned to pervious area (cfs)
@@ -1832,8 +1902,9 @@ void evalLidUnit(int j, TLidUnit* lidUnit, double lidArea, double lidInflow,
     lidInfil = 0.0;
 
     //... find surface runoff from the LID unit (in cfs)
-    lidRunoff = lidproc_getOutflow(lidUnit, lidProc, lidInflow, EvapRate,
-                                  NativeInfil, MaxNativeInfil, tStep,
+    lidRunoff = lidproc_getOutflow(lc, lidUnit, lidProc, lidInflow,
+                                  lc->evapRate, nativeInfil,
+                                  lc->maxNativeInfil, tStep,
                                   &lidEvap, &lidInfil, &lidDrain) * lidArea;
     
     //... convert drain flow to CFS
@@ -1866,11 +1937,11 @@ void evalLidUnit(int j, TLidUnit* lidUnit, double lidArea, double lidInflow,
     lidUnit->newDrainFlow = lidDrain;
 
     //... update moisture losses (ft3)
-    Vevap  += lidEvap * tStep * lidArea;
-    VlidInfil += lidInfil * tStep * lidArea;
+    ctx->vEvap  += lidEvap * tStep * lidArea;
+    ctx->vLidInfil += lidInfil * tStep * lidArea;
     if ( isLidPervious(lidUnit->lidIndex) )
     {
-        Vpevap += lidEvap * tStep * lidArea;
+        ctx->vPevap += lidEvap * tStep * lidArea;
     }
 
     //... update time since last rainfall (for Rain Barrel emptying)
@@ -1878,7 +1949,8 @@ void evalLidUnit(int j, TLidUnit* lidUnit, double lidArea, double lidInflow,
     else lidUnit->dryTime += tStep;
 
     //... update LID water balance and save results
-    lidproc_saveResults(lidUnit, UCF(RAINFALL), UCF(RAINDEPTH));
+    if ( lidproc_saveResults(lc, lidUnit, UCF(RAINFALL), UCF(RAINDEPTH)) )
+        ctx->hasWetLids = TRUE;
 
     //... update LID group totals
     *qRunoff += lidRunoff;
@@ -32,6 +32,13 @@
 //     unclogging permeable pavement at fixed intervals.
 //   Build 5.2.0:
 //   - Covered property added to RAIN_BARREL parameters
+//   Build 5.2.4:
+//   - LID context structure added so that LID units of different
+//     subcatchments can be evaluated concurrently.
+//   - Arguments for lid_getRunoff(), lidproc_getOutflow() and
+//     lidproc_saveResults() modified.
+//   - Receiving subcatchment argument added to lid_addDrainRunon() and
+//     lid_getDrainSubcatchs() added.
 //-----------------------------------------------------------------------------
 
 #ifndef LID_H
@@ -40,7 +47,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include "infil.h"
+#include "objects.h"
 
 //-----------------------------------------------------------------------------
 //  Enumerations
@@ -198,6 +205,34 @@ typedef struct
     TWaterBalance  waterBalance;     // water balance quantites
 }  TLidUnit;
 
+// LID Context - flux rates and volumes of the LID unit being analyzed
+typedef struct
+{
+    TLidUnit* lidUnit;            // ptr. to LID unit being analyzed
+    TLidProc* lidProc;            // ptr. to LID process being analyzed
+    double    tStep;              // current time step (sec)
+    double    evapRate;           // evaporation rate (ft/s)
+    double    maxNativeInfil;     // native soil infil. rate limit (ft/s)
+    double    infilFactor;        // infiltration adjustment factor
+    double    surfaceInflow;      // precip. + runon to LID unit (ft/s)
+    double    surfaceInfil;       // infil. rate from surface layer (ft/s)
+    double    surfaceEvap;        // evap. rate from surface layer (ft/s)
+    double    surfaceOutflow;     // outflow from surface layer (ft/s)
+    double    surfaceVolume;      // volume in surface storage (ft)
+    double    paveEvap;           // evap. from pavement layer (ft/s)
+    double    pavePerc;           // percolation from pavement layer (ft/s)
+    double    paveVolume;         // volume stored in pavement layer  (ft)
+    double    soilEvap;           // evap. from soil layer (ft/s)
+    double    soilPerc;           // percolation from soil layer (ft/s)
+    double    soilVolume;         // volume in soil/pavement storage (ft)
+    double    storageInflow;      // inflow rate to storage layer (ft/s)
+    double    storageExfil;       // exfil. rate from storage layer (ft/s)
+    double    storageEvap;        // evap.rate from storage layer (ft/s)
+    double    storageDrain;       // underdrain flow rate layer (ft/s)
+    double    storageVolume;      // volume in storage layer (ft)
+    double    xOld[MAX_LAYERS];   // previous moisture levels
+}  TLidCtx;
+
 //-----------------------------------------------------------------------------
 //   LID Methods
 //-----------------------------------------------------------------------------
@@ -208,6 +243,7 @@ int      lid_readProcParams(char* tok[], int ntoks);
 int      lid_readGroupParams(char* tok[], int ntoks);
 
 void     lid_validate(void);
+void     lid_remapNodes(int newNode[]);
 void     lid_initState(void);
 void     lid_setOldGroupState(int subcatch);
 
@@ -216,9 +252,10 @@ double   lid_getFlowToPerv(int subcatch);
 double   lid_getDrainFlow(int subcatch, int timePeriod);
 double   lid_getStoredVolume(int subcatch);
 void     lid_addDrainLoads(int subcatch, double c[], double tStep);
-void     lid_addDrainRunon(int subcatch);
+void     lid_addDrainRunon(int subcatch, int toSubcatch);
+int      lid_getDrainSubcatchs(int subcatch, int toSubcatch[], int n);
 void     lid_addDrainInflow(int subcatch, double f);
-void     lid_getRunoff(int subcatch, double tStep);
+void     lid_getRunoff(int subcatch, double tStep, TRunoffCtx* ctx);
 void     lid_writeSummary(void);
 void     lid_writeWaterBalance(void);
 
@@ -226,11 +263,11 @@ void     lid_writeWaterBalance(void);
 
 void     lidproc_initWaterBalance(TLidUnit *lidUnit, double initVol);
 
-double   lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc,
+double   lidproc_getOutflow(TLidCtx* lc, TLidUnit* lidUnit, TLidProc* lidProc,
          double inflow, double evap, double infil, double maxInfil,
          double tStep, double* lidEvap, double* lidInfil, double* lidDrain);
 
-void     lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall,
-         double ucfRainDepth);
+int      lidproc_saveResults(TLidCtx* lc, TLidUnit* lidUnit,
+         double ucfRainfall, double ucfRainDepth);
 
 #endif
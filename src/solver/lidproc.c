@@ -58,6 +58,8 @@
 //     trenchFluxRates.
 //   - Corrected head calculation in getStorageDrainRate when unit has both
 //     a soil and pavement layer.
+//   - Shared state variables moved into a TLidCtx work context so that
+//     LID units can be evaluated concurrently.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -98,43 +100,6 @@ enum LidRptVars {
     STOR_DEPTH,              // water level in storage layer
     MAX_RPT_VARS};
 
-//-----------------------------------------------------------------------------
-//  Imported variables 
-//-----------------------------------------------------------------------------
-extern char HasWetLids;      // TRUE if any LIDs are wet (declared in runoff.c)
-
-//-----------------------------------------------------------------------------
-//  Local Variables
-//-----------------------------------------------------------------------------
-static TLidUnit*  theLidUnit;     // ptr. to a subcatchment's LID unit
-static TLidProc*  theLidProc;     // ptr. to a LID process
-
-static double     Tstep;          // current time step (sec)
-static double     EvapRate;       // evaporation rate (ft/s)
-static double     MaxNativeInfil; // native soil infil. rate limit (ft/s)
-
-static double     SurfaceInflow;  // precip. + runon to LID unit (ft/s)
-static double     SurfaceInfil;   // infil. rate from surface layer (ft/s)
-static double     SurfaceEvap;    // evap. rate from surface layer (ft/s)
-static double     SurfaceOutflow; // outflow from surface layer (ft/s)
-static double     SurfaceVolume;  // volume in surface storage (ft)
-
-static double     PaveEvap;       // evap. from pavement layer (ft/s)
-static double     PavePerc;       // percolation from pavement layer (ft/s)
-static double     PaveVolume;     // volume stored in pavement layer  (ft)
-
-static double     SoilEvap;       // evap. from soil layer (ft/s)
-static double     SoilPerc;       // percolation from soil layer (ft/s)
-static double     SoilVolume;     // volume in soil/pavement storage (ft)
-
-static double     StorageInflow;  // inflow rate to storage layer (ft/s)
-static double     StorageExfil;   // exfil. rate from storage layer (ft/s)
-static double     StorageEvap;    // evap.rate from storage layer (ft/s)
-static double     StorageDrain;   // underdrain flow rate layer (ft/s)
-static double     StorageVolume;  // volume in storage layer (ft)
-
-static double     Xold[MAX_LAYERS];  // previous moisture level in LID layers
-
 //-----------------------------------------------------------------------------
 //  External Functions (declared in lid.h)
 //-----------------------------------------------------------------------------
@@ -145,33 +110,34 @@ static double     Xold[MAX_LAYERS];  // previous moisture level in LID layers
 //-----------------------------------------------------------------------------
 // Local Functions
 //-----------------------------------------------------------------------------
-static void   barrelFluxRates(double x[], double f[]);
-static void   biocellFluxRates(double x[], double f[]);
-static void   greenRoofFluxRates(double x[], double f[]);
-static void   pavementFluxRates(double x[], double f[]);
-static void   trenchFluxRates(double x[], double f[]);
-static void   swaleFluxRates(double x[], double f[]);
-static void   roofFluxRates(double x[], double f[]);
-
-static double getSurfaceOutflowRate(double depth);
-static double getSurfaceOverflowRate(double* surfaceDepth);
-static double getPavementPermRate(void);
-static double getSoilPercRate(double theta);
-static double getStorageExfilRate(void);
-static double getStorageDrainRate(double storageDepth, double soilTheta,
-              double paveDepth, double surfaceDepth);
-static double getDrainMatOutflow(double depth);
-static void   getEvapRates(double surfaceVol, double paveVol,
+static void   barrelFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   biocellFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   greenRoofFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   pavementFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   trenchFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   swaleFluxRates(TLidCtx* lc, double x[], double f[]);
+static void   roofFluxRates(TLidCtx* lc, double x[], double f[]);
+
+static double getSurfaceOutflowRate(TLidCtx* lc, double depth);
+static double getSurfaceOverflowRate(TLidCtx* lc, double* surfaceDepth);
+static double getPavementPermRate(TLidCtx* lc);
+static double getSoilPercRate(TLidCtx* lc, double theta);
+static double getStorageExfilRate(TLidCtx* lc);
+static double getStorageDrainRate(TLidCtx* lc, double storageDepth,
+              double soilTheta, double paveDepth, double surfaceDepth);
+static double getDrainMatOutflow(TLidCtx* lc, double depth);
+static void   getEvapRates(TLidCtx* lc, double surfaceVol, double paveVol,
               double soilVol, double storageVol, double pervFrac);
 
-static void   updateWaterBalance(TLidUnit *lidUnit, double inflow,
+static void   updateWaterBalance(TLidCtx* lc, TLidUnit *lidUnit, double inflow,
                                  double evap, double infil, double surfFlow,
                                  double drainFlow, double storage);
 
-static int    modpuls_solve(int n, double* x, double* xOld, double* xPrev,
-                            double* xMin, double* xMax, double* xTol,
-                            double* qOld, double* q, double dt, double omega,
-                            void (*derivs)(double*, double*));
+static int    modpuls_solve(TLidCtx* lc, int n, double* x, double* xOld,
+                            double* xPrev, double* xMin, double* xMax,
+                            double* xTol, double* qOld, double* q, double dt,
+                            double omega,
+                            void (*derivs)(TLidCtx*, double*, double*));
 
 //=============================================================================
 
@@ -194,13 +160,14 @@ void lidproc_initWaterBalance(TLidUnit *lidUnit, double initVol)
 
 //=============================================================================
 
-double lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc, double inflow,
-                          double evap, double infil, double maxInfil,
-                          double tStep, double* lidEvap,
+double lidproc_getOutflow(TLidCtx* lc, TLidUnit* lidUnit, TLidProc* lidProc,
+                          double inflow, double evap, double infil,
+                          double maxInfil, double tStep, double* lidEvap,
                           double* lidInfil, double* lidDrain)
 //
 //  Purpose: computes runoff outflow from a single LID unit.
-//  Input:   lidUnit  = ptr. to specific LID unit being analyzed
+//  Input:   lc       = ptr. to work context for the LID unit
+//           lidUnit  = ptr. to specific LID unit being analyzed
 //           lidProc  = ptr. to generic LID process of the LID unit
 //           inflow   = runoff rate captured by LID unit (ft/s)
 //           evap     = potential evaporation rate (ft/s)
@@ -228,81 +195,81 @@ double lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc, double inflow,
     double omega = 0.0;          // integration time weighting
 
     //... define a pointer to function that computes flux rates through the LID
-    void (*fluxRates) (double *, double *) = NULL;
+    void (*fluxRates) (TLidCtx*, double *, double *) = NULL;
 
     //... save references to the LID process and LID unit
-    theLidProc = lidProc;
-    theLidUnit = lidUnit;
+    lc->lidProc = lidProc;
+    lc->lidUnit = lidUnit;
 
-    //... save evap, max. infil. & time step to shared variables
-    EvapRate = evap;
-    MaxNativeInfil = maxInfil;
-    Tstep = tStep;
+    //... save evap, max. infil. & time step to the LID context
+    lc->evapRate = evap;
+    lc->maxNativeInfil = maxInfil;
+    lc->tStep = tStep;
 
     //... store current moisture levels in vector x
-    x[SURF] = theLidUnit->surfaceDepth;
-    x[SOIL] = theLidUnit->soilMoisture;
-    x[STOR] = theLidUnit->storageDepth;
-    x[PAVE] = theLidUnit->paveDepth;
+    x[SURF] = lc->lidUnit->surfaceDepth;
+    x[SOIL] = lc->lidUnit->soilMoisture;
+    x[STOR] = lc->lidUnit->storageDepth;
+    x[PAVE] = lc->lidUnit->paveDepth;
 
     //... initialize layer moisture volumes, flux rates and moisture limits
-    SurfaceVolume  = 0.0;
-    PaveVolume     = 0.0;
-    SoilVolume     = 0.0;
-    StorageVolume  = 0.0;
-    SurfaceInflow  = inflow;
-    SurfaceInfil   = 0.0;
-    SurfaceEvap    = 0.0;
-    SurfaceOutflow = 0.0;
-    PaveEvap       = 0.0;
-    PavePerc       = 0.0;
-    SoilEvap       = 0.0;
-    SoilPerc       = 0.0;
-    StorageInflow  = 0.0;
-    StorageExfil   = 0.0;
-    StorageEvap    = 0.0;
-    StorageDrain   = 0.0;
+    lc->surfaceVolume  = 0.0;
+    lc->paveVolume     = 0.0;
+    lc->soilVolume     = 0.0;
+    lc->storageVolume  = 0.0;
+    lc->surfaceInflow  = inflow;
+    lc->surfaceInfil   = 0.0;
+    lc->surfaceEvap    = 0.0;
+    lc->surfaceOutflow = 0.0;
+    lc->paveEvap       = 0.0;
+    lc->pavePerc       = 0.0;
+    lc->soilEvap       = 0.0;
+    lc->soilPerc       = 0.0;
+    lc->storageInflow  = 0.0;
+    lc->storageExfil   = 0.0;
+    lc->storageEvap    = 0.0;
+    lc->storageDrain   = 0.0;
     for (i = 0; i < MAX_LAYERS; i++)
     {
         f[i] = 0.0;
-        fOld[i] = theLidUnit->oldFluxRates[i];
+        fOld[i] = lc->lidUnit->oldFluxRates[i];
         xMin[i] = 0.0;
         xMax[i] = BIG;
-        Xold[i] = x[i];
+        lc->xOld[i] = x[i];
     }
 
     //... find Green-Ampt infiltration from surface layer
-    if ( theLidProc->lidType == POROUS_PAVEMENT ) SurfaceInfil = 0.0;
-    else if ( theLidUnit->soilInfil.Ks > 0.0 )
+    if ( lc->lidProc->lidType == POROUS_PAVEMENT ) lc->surfaceInfil = 0.0;
+    else if ( lc->lidUnit->soilInfil.Ks > 0.0 )
     {
-        SurfaceInfil =
-            grnampt_getInfil(&theLidUnit->soilInfil, Tstep,
-                             SurfaceInflow, theLidUnit->surfaceDepth,
-                             MOD_GREEN_AMPT);
+        lc->surfaceInfil =
+            grnampt_getInfil(&lc->lidUnit->soilInfil, lc->tStep,
+                             lc->surfaceInflow, lc->lidUnit->surfaceDepth,
+                             MOD_GREEN_AMPT, lc->infilFactor);
     }
-    else SurfaceInfil = infil;
+    else lc->surfaceInfil = infil;
 
     //... set moisture limits for soil & storage layers
-    if ( theLidProc->soil.thickness > 0.0 )
+    if ( lc->lidProc->soil.thickness > 0.0 )
     {
-        xMin[SOIL] = theLidProc->soil.wiltPoint;
-        xMax[SOIL] = theLidProc->soil.porosity;
+        xMin[SOIL] = lc->lidProc->soil.wiltPoint;
+        xMax[SOIL] = lc->lidProc->soil.porosity;
     }
-    if ( theLidProc->pavement.thickness > 0.0 )
+    if ( lc->lidProc->pavement.thickness > 0.0 )
     {
-        xMax[PAVE] = theLidProc->pavement.thickness;
+        xMax[PAVE] = lc->lidProc->pavement.thickness;
     }
-    if ( theLidProc->storage.thickness > 0.0 )
+    if ( lc->lidProc->storage.thickness > 0.0 )
     {
-        xMax[STOR] = theLidProc->storage.thickness;
+        xMax[STOR] = lc->lidProc->storage.thickness;
     }
-    if ( theLidProc->lidType == GREEN_ROOF )
+    if ( lc->lidProc->lidType == GREEN_ROOF )
     {
-        xMax[STOR] = theLidProc->drainMat.thickness;
+        xMax[STOR] = lc->lidProc->drainMat.thickness;
     }
 
     //... determine which flux rate function to use
-    switch (theLidProc->lidType)
+    switch (lc->lidProc->lidType)
     {
     case BIO_CELL:
     case RAIN_GARDEN:     fluxRates = &biocellFluxRates;   break;
@@ -318,7 +285,7 @@ double lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc, double inflow,
     }
 
     //... update moisture levels and flux rates over the time step
-    i = modpuls_solve(MAX_LAYERS, x, xOld, xPrev, xMin, xMax, xTol,
+    i = modpuls_solve(lc, MAX_LAYERS, x, xOld, xPrev, xMin, xMax, xTol,
                      fOld, f, tStep, omega, fluxRates);
 
 /** For debugging only ********************************************
@@ -329,42 +296,44 @@ double lidproc_getOutflow(TLidUnit* lidUnit, TLidProc* lidProc, double inflow,
             theDate, theTime);
         fprintf(Frpt.file,
         "\n              for LID %s placed in subcatchment %s.",
-            theLidProc->ID, theSubcatch->ID);
+            lc->lidProc->ID, theSubcatch->ID);
     }
 *******************************************************************/
 
     //... add any surface overflow to surface outflow
-    if ( theLidProc->surface.canOverflow || theLidUnit->fullWidth == 0.0 )
+    if ( lc->lidProc->surface.canOverflow || lc->lidUnit->fullWidth == 0.0 )
     {
-        SurfaceOutflow += getSurfaceOverflowRate(&x[SURF]);
+        lc->surfaceOutflow += getSurfaceOverflowRate(lc, &x[SURF]);
     }
 
     //... save updated results
-    theLidUnit->surfaceDepth = x[SURF];
-    theLidUnit->paveDepth    = x[PAVE];
-    theLidUnit->soilMoisture = x[SOIL];
-    theLidUnit->storageDepth = x[STOR];
-    for (i = 0; i < MAX_LAYERS; i++) theLidUnit->oldFluxRates[i] = f[i];
+    lc->lidUnit->surfaceDepth = x[SURF];
+    lc->lidUnit->paveDepth    = x[PAVE];
+    lc->lidUnit->soilMoisture = x[SOIL];
+    lc->lidUnit->storageDepth = x[STOR];
+    for (i = 0; i < MAX_LAYERS; i++) lc->lidUnit->oldFluxRates[i] = f[i];
 
     //... assign values to LID unit evaporation, infiltration & drain flow
-    *lidEvap = SurfaceEvap + PaveEvap + SoilEvap + StorageEvap;
-    *lidInfil = StorageExfil;
-    *lidDrain = StorageDrain;
+    *lidEvap = lc->surfaceEvap + lc->paveEvap + lc->soilEvap + lc->storageEvap;
+    *lidInfil = lc->storageExfil;
+    *lidDrain = lc->storageDrain;
 
     //... return surface outflow (per unit area) from unit
-    return SurfaceOutflow;
+    return lc->surfaceOutflow;
 }
 
 //=============================================================================
 
-void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDepth)
+int lidproc_saveResults(TLidCtx* lc, TLidUnit* lidUnit, double ucfRainfall,
+                        double ucfRainDepth)
 //
 //  Purpose: updates the mass balance for an LID unit and saves
 //           current flux rates to the LID report file.
-//  Input:   lidUnit = ptr. to LID unit
+//  Input:   lc = ptr. to work context for the LID unit
+//           lidUnit = ptr. to LID unit
 //           ucfRainfall = units conversion factor for rainfall rate
 //           ucfDepth = units conversion factor for rainfall depth
-//  Output:  none
+//  Output:  returns TRUE if the LID unit is wet, FALSE if dry
 //
 {
     double ucf;                        // units conversion factor
@@ -376,52 +345,51 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
     double elapsedHrs;                 // elapsed hours
 
     //... find total evap. rate and stored volume
-    totalEvap = SurfaceEvap + PaveEvap + SoilEvap + StorageEvap; 
-    totalVolume = SurfaceVolume + PaveVolume + SoilVolume + StorageVolume;
+    totalEvap = lc->surfaceEvap + lc->paveEvap + lc->soilEvap + lc->storageEvap; 
+    totalVolume = lc->surfaceVolume + lc->paveVolume + lc->soilVolume +
+                  lc->storageVolume;
 
     //... update mass balance totals
-    updateWaterBalance(theLidUnit, SurfaceInflow, totalEvap, StorageExfil,
-                       SurfaceOutflow, StorageDrain, totalVolume);
+    updateWaterBalance(lc, lc->lidUnit, lc->surfaceInflow, totalEvap,
+                       lc->storageExfil, lc->surfaceOutflow, lc->storageDrain,
+                       totalVolume);
 
     //... check if dry-weather conditions hold
-    if ( SurfaceInflow  < MINFLOW &&
-         SurfaceOutflow < MINFLOW &&
-         StorageDrain   < MINFLOW &&
-         StorageExfil   < MINFLOW &&
+    if ( lc->surfaceInflow  < MINFLOW &&
+         lc->surfaceOutflow < MINFLOW &&
+         lc->storageDrain   < MINFLOW &&
+         lc->storageExfil   < MINFLOW &&
          totalEvap      < MINFLOW
        ) isDry = TRUE;
 
-    //... update status of HasWetLids
-    if ( !isDry ) HasWetLids = TRUE;
-
     //... write results to LID report file
     if ( lidUnit->rptFile )
     {
         //... convert rate results to original units (in/hr or mm/hr)
         ucf = ucfRainfall;
-        rptVars[SURF_INFLOW]  = SurfaceInflow*ucf;
+        rptVars[SURF_INFLOW]  = lc->surfaceInflow*ucf;
         rptVars[TOTAL_EVAP]   = totalEvap*ucf;
-        rptVars[SURF_INFIL]   = SurfaceInfil*ucf;
-        rptVars[PAVE_PERC]    = PavePerc*ucf;
-        rptVars[SOIL_PERC]    = SoilPerc*ucf;
-        rptVars[STOR_EXFIL]   = StorageExfil*ucf;
-        rptVars[SURF_OUTFLOW] = SurfaceOutflow*ucf;
-        rptVars[STOR_DRAIN]   = StorageDrain*ucf;
+        rptVars[SURF_INFIL]   = lc->surfaceInfil*ucf;
+        rptVars[PAVE_PERC]    = lc->pavePerc*ucf;
+        rptVars[SOIL_PERC]    = lc->soilPerc*ucf;
+        rptVars[STOR_EXFIL]   = lc->storageExfil*ucf;
+        rptVars[SURF_OUTFLOW] = lc->surfaceOutflow*ucf;
+        rptVars[STOR_DRAIN]   = lc->storageDrain*ucf;
 
         //... convert storage results to original units (in or mm)
         ucf = ucfRainDepth;
-        rptVars[SURF_DEPTH] = theLidUnit->surfaceDepth*ucf;
-        rptVars[PAVE_DEPTH] = theLidUnit->paveDepth*ucf;
-        rptVars[SOIL_MOIST] = theLidUnit->soilMoisture;
-        rptVars[STOR_DEPTH] = theLidUnit->storageDepth*ucf;
+        rptVars[SURF_DEPTH] = lc->lidUnit->surfaceDepth*ucf;
+        rptVars[PAVE_DEPTH] = lc->lidUnit->paveDepth*ucf;
+        rptVars[SOIL_MOIST] = lc->lidUnit->soilMoisture;
+        rptVars[STOR_DEPTH] = lc->lidUnit->storageDepth*ucf;
 
         //... if the current LID state is wet but the previous state was dry
         //    for more than one period then write the saved previous results
         //    to the report file thus marking the end of a dry period
-        if ( !isDry && theLidUnit->rptFile->wasDry > 1)
+        if ( !isDry && lc->lidUnit->rptFile->wasDry > 1)
         {
-            fprintf(theLidUnit->rptFile->file, "%s",
-                theLidUnit->rptFile->results);
+            fprintf(lc->lidUnit->rptFile->file, "%s",
+                lc->lidUnit->rptFile->results);
         }
 
         //... write the current results to a string which is saved between
@@ -429,7 +397,8 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
         elapsedHrs = NewRunoffTime / 1000.0 / 3600.0;
         datetime_getTimeStamp(
             M_D_Y, getDateTime(NewRunoffTime), TIME_STAMP_SIZE, timeStamp);
-        snprintf(theLidUnit->rptFile->results, sizeof(theLidUnit->rptFile->results),
+        snprintf(lc->lidUnit->rptFile->results,
+             sizeof(lc->lidUnit->rptFile->results),
              "\n%20s\t %8.3f\t %8.3f\t %8.4f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t"
              "%8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f\t %8.3f",
              timeStamp, elapsedHrs, rptVars[0], rptVars[1], rptVars[2],
@@ -441,57 +410,62 @@ void lidproc_saveResults(TLidUnit* lidUnit, double ucfRainfall, double ucfRainDe
         {
             //... if the previous state was wet then write the current
             //    results to file marking the start of a dry period
-            if ( theLidUnit->rptFile->wasDry == 0 )
+            if ( lc->lidUnit->rptFile->wasDry == 0 )
             {
-                fprintf(theLidUnit->rptFile->file, "%s",
-                    theLidUnit->rptFile->results);
+                fprintf(lc->lidUnit->rptFile->file, "%s",
+                    lc->lidUnit->rptFile->results);
             }
 
             //... increment the number of successive dry periods
-            theLidUnit->rptFile->wasDry++;
+            lc->lidUnit->rptFile->wasDry++;
         }
 
         //... if the current LID state is wet
         else
         {
             //... write the current results to the report file
-            fprintf(theLidUnit->rptFile->file, "%s",
-                theLidUnit->rptFile->results);
+            fprintf(lc->lidUnit->rptFile->file, "%s",
+                lc->lidUnit->rptFile->results);
 
             //... re-set the number of successive dry periods to 0
-            theLidUnit->rptFile->wasDry = 0; 
+            lc->lidUnit->rptFile->wasDry = 0; 
         }
     }
+    return !isDry;
 }
 
 //=============================================================================
 
-void roofFluxRates(double x[], double f[])
+void roofFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates for roof disconnection.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
     double surfaceDepth = x[SURF];
 
-    getEvapRates(surfaceDepth, 0.0, 0.0, 0.0, 1.0);
-    SurfaceVolume = surfaceDepth;
-    SurfaceInfil = 0.0;
-    if ( theLidProc->surface.alpha > 0.0 )
-      SurfaceOutflow = getSurfaceOutflowRate(surfaceDepth);
-    else getSurfaceOverflowRate(&surfaceDepth);
-    StorageDrain = MIN(theLidProc->drain.coeff/UCF(RAINFALL), SurfaceOutflow);
-    SurfaceOutflow -= StorageDrain;
-    f[SURF] = (SurfaceInflow - SurfaceEvap - StorageDrain - SurfaceOutflow);
+    getEvapRates(lc, surfaceDepth, 0.0, 0.0, 0.0, 1.0);
+    lc->surfaceVolume = surfaceDepth;
+    lc->surfaceInfil = 0.0;
+    if ( lc->lidProc->surface.alpha > 0.0 )
+      lc->surfaceOutflow = getSurfaceOutflowRate(lc, surfaceDepth);
+    else getSurfaceOverflowRate(lc, &surfaceDepth);
+    lc->storageDrain = MIN(lc->lidProc->drain.coeff/UCF(RAINFALL),
+                           lc->surfaceOutflow);
+    lc->surfaceOutflow -= lc->storageDrain;
+    f[SURF] = (lc->surfaceInflow - lc->surfaceEvap - lc->storageDrain -
+               lc->surfaceOutflow);
 }
 
 //=============================================================================
 
-void greenRoofFluxRates(double x[], double f[])
+void greenRoofFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of a green roof.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -505,12 +479,12 @@ void greenRoofFluxRates(double x[], double f[])
     double maxRate;
 
     // Green roof properties
-    double soilThickness    = theLidProc->soil.thickness;
-    double storageThickness = theLidProc->storage.thickness;
-    double soilPorosity     = theLidProc->soil.porosity;
-    double storageVoidFrac  = theLidProc->storage.voidFrac;
-    double soilFieldCap     = theLidProc->soil.fieldCap;
-    double soilWiltPoint    = theLidProc->soil.wiltPoint;
+    double soilThickness    = lc->lidProc->soil.thickness;
+    double storageThickness = lc->lidProc->storage.thickness;
+    double soilPorosity     = lc->lidProc->soil.porosity;
+    double storageVoidFrac  = lc->lidProc->storage.voidFrac;
+    double soilFieldCap     = lc->lidProc->soil.fieldCap;
+    double soilWiltPoint    = lc->lidProc->soil.wiltPoint;
 
     //... retrieve moisture levels from input vector
     surfaceDepth = x[SURF];
@@ -518,78 +492,79 @@ void greenRoofFluxRates(double x[], double f[])
     storageDepth = x[STOR];
 
     //... convert moisture levels to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    SoilVolume = soilTheta * soilThickness;
-    StorageVolume = storageDepth * storageVoidFrac;
+    lc->surfaceVolume = surfaceDepth * lc->lidProc->surface.voidFrac;
+    lc->soilVolume = soilTheta * soilThickness;
+    lc->storageVolume = storageDepth * storageVoidFrac;
 
     //... get ET rates
-    availVolume = SoilVolume - soilWiltPoint * soilThickness;
-    getEvapRates(SurfaceVolume, 0.0, availVolume, StorageVolume, 1.0);
-    if ( soilTheta >= soilPorosity ) StorageEvap = 0.0;
+    availVolume = lc->soilVolume - soilWiltPoint * soilThickness;
+    getEvapRates(lc, lc->surfaceVolume, 0.0, availVolume, lc->storageVolume, 1.0);
+    if ( soilTheta >= soilPorosity ) lc->storageEvap = 0.0;
 
     //... soil layer perc rate
-    SoilPerc = getSoilPercRate(soilTheta);
+    lc->soilPerc = getSoilPercRate(lc, soilTheta);
 
     //... limit perc rate by available water
     availVolume = (soilTheta - soilFieldCap) * soilThickness;
-    maxRate = MAX(availVolume, 0.0) / Tstep - SoilEvap;
-    SoilPerc = MIN(SoilPerc, maxRate);
-    SoilPerc = MAX(SoilPerc, 0.0);
+    maxRate = MAX(availVolume, 0.0) / lc->tStep - lc->soilEvap;
+    lc->soilPerc = MIN(lc->soilPerc, maxRate);
+    lc->soilPerc = MAX(lc->soilPerc, 0.0);
 
     //... storage (drain mat) outflow rate
-    StorageExfil = 0.0;
-    StorageDrain = getDrainMatOutflow(storageDepth);
+    lc->storageExfil = 0.0;
+    lc->storageDrain = getDrainMatOutflow(lc, storageDepth);
 
     //... unit is full
     if ( soilTheta >= soilPorosity && storageDepth >= storageThickness )
     {
         //... outflow from both layers equals limiting rate
-        maxRate = MIN(SoilPerc, StorageDrain);
-        SoilPerc = maxRate;
-        StorageDrain = maxRate;
+        maxRate = MIN(lc->soilPerc, lc->storageDrain);
+        lc->soilPerc = maxRate;
+        lc->storageDrain = maxRate;
 
         //... adjust inflow rate to soil layer
-        SurfaceInfil = MIN(SurfaceInfil, maxRate);
+        lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
     }
 
     //... unit not full
     else
     {
         //... limit drainmat outflow by available storage volume
-        maxRate = storageDepth * storageVoidFrac / Tstep - StorageEvap;
-        if ( storageDepth >= storageThickness ) maxRate += SoilPerc;
+        maxRate = storageDepth * storageVoidFrac / lc->tStep - lc->storageEvap;
+        if ( storageDepth >= storageThickness ) maxRate += lc->soilPerc;
         maxRate = MAX(maxRate, 0.0);
-        StorageDrain = MIN(StorageDrain, maxRate);
+        lc->storageDrain = MIN(lc->storageDrain, maxRate);
 
         //... limit soil perc inflow by unused storage volume
-        maxRate = (storageThickness - storageDepth) * storageVoidFrac / Tstep +
-                  StorageDrain + StorageEvap;
-        SoilPerc = MIN(SoilPerc, maxRate);
+        maxRate = (storageThickness - storageDepth) * storageVoidFrac / lc->tStep +
+                  lc->storageDrain + lc->storageEvap;
+        lc->soilPerc = MIN(lc->soilPerc, maxRate);
                 
         //... adjust surface infil. so soil porosity not exceeded
-        maxRate = (soilPorosity - soilTheta) * soilThickness / Tstep +
-                  SoilPerc + SoilEvap;
-        SurfaceInfil = MIN(SurfaceInfil, maxRate);
+        maxRate = (soilPorosity - soilTheta) * soilThickness / lc->tStep +
+                  lc->soilPerc + lc->soilEvap;
+        lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
     }
 
     // ... find surface outflow rate
-    SurfaceOutflow = getSurfaceOutflowRate(surfaceDepth);
+    lc->surfaceOutflow = getSurfaceOutflowRate(lc, surfaceDepth);
 
     // ... compute overall layer flux rates
-    f[SURF] = (SurfaceInflow - SurfaceEvap - SurfaceInfil - SurfaceOutflow) /
-              theLidProc->surface.voidFrac;
-    f[SOIL] = (SurfaceInfil - SoilEvap - SoilPerc) /
-              theLidProc->soil.thickness;
-    f[STOR] = (SoilPerc - StorageEvap - StorageDrain) /
-              theLidProc->storage.voidFrac;
+    f[SURF] = (lc->surfaceInflow - lc->surfaceEvap - lc->surfaceInfil -
+               lc->surfaceOutflow) / lc->lidProc->surface.voidFrac;
+    f[SOIL] = (lc->surfaceInfil - lc->soilEvap - lc->soilPerc) /
+              lc->lidProc->soil.thickness;
+    f[STOR] = (lc->soilPerc - lc->storageEvap - lc->storageDrain) /
+              lc->lidProc->storage.voidFrac;
 }
 
 //=============================================================================
 
-void biocellFluxRates(double x[], double f[])
+void biocellFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of a bio-retention cell LID.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -603,12 +578,12 @@ void biocellFluxRates(double x[], double f[])
     double maxRate;
 
     // LID layer properties
-    double soilThickness    = theLidProc->soil.thickness;
-    double soilPorosity     = theLidProc->soil.porosity;
-    double soilFieldCap     = theLidProc->soil.fieldCap;
-    double soilWiltPoint    = theLidProc->soil.wiltPoint;
-    double storageThickness = theLidProc->storage.thickness;
-    double storageVoidFrac  = theLidProc->storage.voidFrac;
+    double soilThickness    = lc->lidProc->soil.thickness;
+    double soilPorosity     = lc->lidProc->soil.porosity;
+    double soilFieldCap     = lc->lidProc->soil.fieldCap;
+    double soilWiltPoint    = lc->lidProc->soil.wiltPoint;
+    double storageThickness = lc->lidProc->storage.thickness;
+    double storageVoidFrac  = lc->lidProc->storage.voidFrac;
 
     //... retrieve moisture levels from input vector
     surfaceDepth = x[SURF];
@@ -616,47 +591,47 @@ void biocellFluxRates(double x[], double f[])
     storageDepth = x[STOR];
 
     //... convert moisture levels to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    SoilVolume    = soilTheta * soilThickness;
-    StorageVolume = storageDepth * storageVoidFrac;
+    lc->surfaceVolume = surfaceDepth * lc->lidProc->surface.voidFrac;
+    lc->soilVolume    = soilTheta * soilThickness;
+    lc->storageVolume = storageDepth * storageVoidFrac;
 
     //... get ET rates
-    availVolume = SoilVolume - soilWiltPoint * soilThickness;
-    getEvapRates(SurfaceVolume, 0.0, availVolume, StorageVolume, 1.0);
-    if ( soilTheta >= soilPorosity ) StorageEvap = 0.0;
+    availVolume = lc->soilVolume - soilWiltPoint * soilThickness;
+    getEvapRates(lc, lc->surfaceVolume, 0.0, availVolume, lc->storageVolume, 1.0);
+    if ( soilTheta >= soilPorosity ) lc->storageEvap = 0.0;
 
     //... soil layer perc rate
-    SoilPerc = getSoilPercRate(soilTheta);
+    lc->soilPerc = getSoilPercRate(lc, soilTheta);
 
     //... limit perc rate by available water
     availVolume =  (soilTheta - soilFieldCap) * soilThickness;
-    maxRate = MAX(availVolume, 0.0) / Tstep - SoilEvap;
-    SoilPerc = MIN(SoilPerc, maxRate);
-    SoilPerc = MAX(SoilPerc, 0.0);
+    maxRate = MAX(availVolume, 0.0) / lc->tStep - lc->soilEvap;
+    lc->soilPerc = MIN(lc->soilPerc, maxRate);
+    lc->soilPerc = MAX(lc->soilPerc, 0.0);
 
     //... exfiltration rate out of storage layer
-    StorageExfil = getStorageExfilRate();
+    lc->storageExfil = getStorageExfilRate(lc);
 
     //... underdrain flow rate
-    StorageDrain = 0.0;
-    if ( theLidProc->drain.coeff > 0.0 )
+    lc->storageDrain = 0.0;
+    if ( lc->lidProc->drain.coeff > 0.0 )
     {
-        StorageDrain = getStorageDrainRate(storageDepth, soilTheta, 0.0,
+        lc->storageDrain = getStorageDrainRate(lc, storageDepth, soilTheta, 0.0,
                                            surfaceDepth);
     }
 
     //... special case of no storage layer present
     if ( storageThickness == 0.0 )
     {
-        StorageEvap = 0.0;
-        maxRate = MIN(SoilPerc, StorageExfil);
-        SoilPerc = maxRate;
-        StorageExfil = maxRate;
+        lc->storageEvap = 0.0;
+        maxRate = MIN(lc->soilPerc, lc->storageExfil);
+        lc->soilPerc = maxRate;
+        lc->storageExfil = maxRate;
 
         //... limit surface infil. by unused soil volume
-        maxRate = (soilPorosity - soilTheta) * soilThickness / Tstep +
-                  SoilPerc + SoilEvap;
-        SurfaceInfil = MIN(SurfaceInfil, maxRate);
+        maxRate = (soilPorosity - soilTheta) * soilThickness / lc->tStep +
+                  lc->soilPerc + lc->soilEvap;
+        lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
     }
 
     else
@@ -665,77 +640,80 @@ void biocellFluxRates(double x[], double f[])
         if ( soilTheta >= soilPorosity && storageDepth >= storageThickness )
         {
             //... limiting rate is smaller of soil perc and storage outflow
-            maxRate = StorageExfil + StorageDrain;
-            if ( SoilPerc < maxRate )
+            maxRate = lc->storageExfil + lc->storageDrain;
+            if ( lc->soilPerc < maxRate )
             {
-                maxRate = SoilPerc;
-                if ( maxRate > StorageExfil ) StorageDrain = maxRate - StorageExfil;
+                maxRate = lc->soilPerc;
+                if ( maxRate > lc->storageExfil )
+                    lc->storageDrain = maxRate - lc->storageExfil;
                 else
                 {
-                    StorageExfil = maxRate;
-                    StorageDrain = 0.0;
+                    lc->storageExfil = maxRate;
+                    lc->storageDrain = 0.0;
                 }
             }
-            else SoilPerc = maxRate;
+            else lc->soilPerc = maxRate;
 
             //... apply limiting rate to surface infil.
-            SurfaceInfil = MIN(SurfaceInfil, maxRate);
+            lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
         }
 
         //... either layer not full
         else
         {
             //... limit storage exfiltration by available storage volume
-            maxRate = SoilPerc - StorageEvap + storageDepth*storageVoidFrac/Tstep;
-            StorageExfil = MIN(StorageExfil, maxRate);
-            StorageExfil = MAX(StorageExfil, 0.0);
+            maxRate = lc->soilPerc - lc->storageEvap +
+                      storageDepth*storageVoidFrac/lc->tStep;
+            lc->storageExfil = MIN(lc->storageExfil, maxRate);
+            lc->storageExfil = MAX(lc->storageExfil, 0.0);
 
             //... limit underdrain flow by volume above drain offset
-            if ( StorageDrain > 0.0 )
+            if ( lc->storageDrain > 0.0 )
             {
-                maxRate = -StorageExfil - StorageEvap;
-                if ( storageDepth >= storageThickness) maxRate += SoilPerc;
-                if ( theLidProc->drain.offset <= storageDepth )
+                maxRate = -lc->storageExfil - lc->storageEvap;
+                if ( storageDepth >= storageThickness) maxRate += lc->soilPerc;
+                if ( lc->lidProc->drain.offset <= storageDepth )
                 {
-                    maxRate += (storageDepth - theLidProc->drain.offset) *
-                               storageVoidFrac/Tstep;
+                    maxRate += (storageDepth - lc->lidProc->drain.offset) *
+                               storageVoidFrac/lc->tStep;
                 }
                 maxRate = MAX(maxRate, 0.0);
-                StorageDrain = MIN(StorageDrain, maxRate);
+                lc->storageDrain = MIN(lc->storageDrain, maxRate);
             }
         
             //... limit soil perc by unused storage volume
-            maxRate = StorageExfil + StorageDrain + StorageEvap +
+            maxRate = lc->storageExfil + lc->storageDrain + lc->storageEvap +
                       (storageThickness - storageDepth) *
-                      storageVoidFrac/Tstep;
-            SoilPerc = MIN(SoilPerc, maxRate);
+                      storageVoidFrac/lc->tStep;
+            lc->soilPerc = MIN(lc->soilPerc, maxRate);
 
             //... limit surface infil. by unused soil volume
-            maxRate = (soilPorosity - soilTheta) * soilThickness / Tstep +
-                      SoilPerc + SoilEvap;
-            SurfaceInfil = MIN(SurfaceInfil, maxRate);
+            maxRate = (soilPorosity - soilTheta) * soilThickness / lc->tStep +
+                      lc->soilPerc + lc->soilEvap;
+            lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
         }
     }
     
     //... find surface layer outflow rate
-    SurfaceOutflow = getSurfaceOutflowRate(surfaceDepth);
+    lc->surfaceOutflow = getSurfaceOutflowRate(lc, surfaceDepth);
 
     //... compute overall layer flux rates
-    f[SURF] = (SurfaceInflow - SurfaceEvap - SurfaceInfil - SurfaceOutflow) /
-              theLidProc->surface.voidFrac;
-    f[SOIL] = (SurfaceInfil - SoilEvap - SoilPerc) / 
-              theLidProc->soil.thickness;
+    f[SURF] = (lc->surfaceInflow - lc->surfaceEvap - lc->surfaceInfil -
+               lc->surfaceOutflow) / lc->lidProc->surface.voidFrac;
+    f[SOIL] = (lc->surfaceInfil - lc->soilEvap - lc->soilPerc) / 
+              lc->lidProc->soil.thickness;
     if ( storageThickness == 0.0 ) f[STOR] = 0.0;
-    else f[STOR] = (SoilPerc - StorageEvap - StorageExfil - StorageDrain) /
-                   theLidProc->storage.voidFrac;
+    else f[STOR] = (lc->soilPerc - lc->storageEvap - lc->storageExfil -
+                    lc->storageDrain) / lc->lidProc->storage.voidFrac;
 }
 
 //=============================================================================
 
-void trenchFluxRates(double x[], double f[])
+void trenchFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates from the layers of an infiltration trench LID.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -748,82 +726,85 @@ void trenchFluxRates(double x[], double f[])
     double maxRate;
 
     // Storage layer properties
-    double storageThickness = theLidProc->storage.thickness;
-    double storageVoidFrac = theLidProc->storage.voidFrac;
+    double storageThickness = lc->lidProc->storage.thickness;
+    double storageVoidFrac = lc->lidProc->storage.voidFrac;
 
     //... retrieve moisture levels from input vector
     surfaceDepth = x[SURF];
     storageDepth = x[STOR];
 
     //... convert moisture levels to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    SoilVolume = 0.0;
-    StorageVolume = storageDepth * storageVoidFrac;
+    lc->surfaceVolume = surfaceDepth * lc->lidProc->surface.voidFrac;
+    lc->soilVolume = 0.0;
+    lc->storageVolume = storageDepth * storageVoidFrac;
 
     //... get ET rates
     availVolume = (storageThickness - storageDepth) * storageVoidFrac;
-    getEvapRates(SurfaceVolume, 0.0, 0.0, StorageVolume, 1.0);
+    getEvapRates(lc, lc->surfaceVolume, 0.0, 0.0, lc->storageVolume, 1.0);
 
     //... no storage evap if surface ponded
-    if ( surfaceDepth > 0.0 ) StorageEvap = 0.0;
+    if ( surfaceDepth > 0.0 ) lc->storageEvap = 0.0;
 
     //... nominal storage inflow
-    StorageInflow = SurfaceInflow + SurfaceVolume / Tstep;
+    lc->storageInflow = lc->surfaceInflow + lc->surfaceVolume / lc->tStep;
 
     //... exfiltration rate out of storage layer
-   StorageExfil = getStorageExfilRate();
+   lc->storageExfil = getStorageExfilRate(lc);
 
     //... underdrain flow rate
-    StorageDrain = 0.0;
-    if ( theLidProc->drain.coeff > 0.0 )
+    lc->storageDrain = 0.0;
+    if ( lc->lidProc->drain.coeff > 0.0 )
     {
-        StorageDrain = getStorageDrainRate(storageDepth, 0.0, 0.0, surfaceDepth);
+        lc->storageDrain = getStorageDrainRate(lc, storageDepth, 0.0, 0.0,
+                                               surfaceDepth);
     }
 
     //... limit storage exfiltration by available storage volume
-    maxRate = StorageInflow - StorageEvap + storageDepth*storageVoidFrac/Tstep;
-    StorageExfil = MIN(StorageExfil, maxRate);
-    StorageExfil = MAX(StorageExfil, 0.0);
+    maxRate = lc->storageInflow - lc->storageEvap +
+              storageDepth*storageVoidFrac/lc->tStep;
+    lc->storageExfil = MIN(lc->storageExfil, maxRate);
+    lc->storageExfil = MAX(lc->storageExfil, 0.0);
 
     //... limit underdrain flow by volume above drain offset
-    if ( StorageDrain > 0.0 )
+    if ( lc->storageDrain > 0.0 )
     {
-        maxRate = -StorageExfil - StorageEvap;
-        if (storageDepth >= storageThickness ) maxRate += StorageInflow;
-        if ( theLidProc->drain.offset <= storageDepth )
+        maxRate = -lc->storageExfil - lc->storageEvap;
+        if (storageDepth >= storageThickness ) maxRate += lc->storageInflow;
+        if ( lc->lidProc->drain.offset <= storageDepth )
         {
-            maxRate += (storageDepth - theLidProc->drain.offset) *
-                       storageVoidFrac/Tstep;
+            maxRate += (storageDepth - lc->lidProc->drain.offset) *
+                       storageVoidFrac/lc->tStep;
         }
         maxRate = MAX(maxRate, 0.0);
-        StorageDrain = MIN(StorageDrain, maxRate);
+        lc->storageDrain = MIN(lc->storageDrain, maxRate);
     }
 
     //... limit storage inflow to not exceed storage layer capacity
-    maxRate = (storageThickness - storageDepth)*storageVoidFrac/Tstep +
-              StorageExfil + StorageEvap + StorageDrain;
-    StorageInflow = MIN(StorageInflow, maxRate);
+    maxRate = (storageThickness - storageDepth)*storageVoidFrac/lc->tStep +
+              lc->storageExfil + lc->storageEvap + lc->storageDrain;
+    lc->storageInflow = MIN(lc->storageInflow, maxRate);
 
     //... equate surface infil to storage inflow
-    SurfaceInfil = StorageInflow;
+    lc->surfaceInfil = lc->storageInflow;
 
     //... find surface outflow rate
-    SurfaceOutflow = getSurfaceOutflowRate(surfaceDepth);
+    lc->surfaceOutflow = getSurfaceOutflowRate(lc, surfaceDepth);
 
     // ... find net fluxes for each layer
-    f[SURF] = (SurfaceInflow - SurfaceEvap - StorageInflow - SurfaceOutflow) /
-              theLidProc->surface.voidFrac;;
-    f[STOR] = (StorageInflow - StorageEvap - StorageExfil - StorageDrain) /
-              theLidProc->storage.voidFrac;
+    f[SURF] = (lc->surfaceInflow - lc->surfaceEvap - lc->storageInflow -
+               lc->surfaceOutflow) / lc->lidProc->surface.voidFrac;;
+    f[STOR] = (lc->storageInflow - lc->storageEvap - lc->storageExfil -
+               lc->storageDrain) / lc->lidProc->storage.voidFrac;
     f[SOIL] = 0.0;
 }
 
 //=============================================================================
 
-void pavementFluxRates(double x[], double f[])
+void pavementFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates for the layers of a porous pavement LID.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -834,20 +815,20 @@ void pavementFluxRates(double x[], double f[])
     double storageDepth;
 
     //... Intermediate variables
-    double pervFrac = (1.0 - theLidProc->pavement.impervFrac);
+    double pervFrac = (1.0 - lc->lidProc->pavement.impervFrac);
     double storageInflow;    // inflow rate to storage layer (ft/s)
     double availVolume;
     double maxRate;
 
     //... LID layer properties
-    double paveVoidFrac     = theLidProc->pavement.voidFrac * pervFrac;
-    double paveThickness    = theLidProc->pavement.thickness;
-    double soilThickness    = theLidProc->soil.thickness;
-    double soilPorosity     = theLidProc->soil.porosity;
-    double soilFieldCap     = theLidProc->soil.fieldCap;
-    double soilWiltPoint    = theLidProc->soil.wiltPoint;
-    double storageThickness = theLidProc->storage.thickness;
-    double storageVoidFrac  = theLidProc->storage.voidFrac;
+    double paveVoidFrac     = lc->lidProc->pavement.voidFrac * pervFrac;
+    double paveThickness    = lc->lidProc->pavement.thickness;
+    double soilThickness    = lc->lidProc->soil.thickness;
+    double soilPorosity     = lc->lidProc->soil.porosity;
+    double soilFieldCap     = lc->lidProc->soil.fieldCap;
+    double soilWiltPoint    = lc->lidProc->soil.wiltPoint;
+    double storageThickness = lc->lidProc->storage.thickness;
+    double storageVoidFrac  = lc->lidProc->storage.voidFrac;
 
     //... retrieve moisture levels from input vector
     surfaceDepth = x[SURF];
@@ -856,55 +837,55 @@ void pavementFluxRates(double x[], double f[])
     storageDepth = x[STOR];
 
     //... convert moisture levels to volumes
-    SurfaceVolume = surfaceDepth * theLidProc->surface.voidFrac;
-    PaveVolume = paveDepth * paveVoidFrac;
-    SoilVolume = soilTheta * soilThickness;
-    StorageVolume = storageDepth * storageVoidFrac;
+    lc->surfaceVolume = surfaceDepth * lc->lidProc->surface.voidFrac;
+    lc->paveVolume = paveDepth * paveVoidFrac;
+    lc->soilVolume = soilTheta * soilThickness;
+    lc->storageVolume = storageDepth * storageVoidFrac;
 
     //... get ET rates
-    availVolume = SoilVolume - soilWiltPoint * soilThickness;
-    getEvapRates(SurfaceVolume, PaveVolume, availVolume, StorageVolume,
-                 pervFrac);
+    availVolume = lc->soilVolume - soilWiltPoint * soilThickness;
+    getEvapRates(lc, lc->surfaceVolume, lc->paveVolume, availVolume,
+                 lc->storageVolume, pervFrac);
 
     //... no storage evap if soil or pavement layer saturated
     if ( paveDepth >= paveThickness ||
        ( soilThickness > 0.0 && soilTheta >= soilPorosity )
-       ) StorageEvap = 0.0;
+       ) lc->storageEvap = 0.0;
 
     //... find nominal rate of surface infiltration into pavement layer
-    SurfaceInfil = SurfaceInflow + (SurfaceVolume / Tstep);
+    lc->surfaceInfil = lc->surfaceInflow + (lc->surfaceVolume / lc->tStep);
 
     //... find perc rate out of pavement layer
-    PavePerc = getPavementPermRate() * pervFrac;
+    lc->pavePerc = getPavementPermRate(lc) * pervFrac;
 
     //... surface infiltration can't exceed pavement permeability
-    SurfaceInfil = MIN(SurfaceInfil, PavePerc);
+    lc->surfaceInfil = MIN(lc->surfaceInfil, lc->pavePerc);
 
     //... limit pavement perc by available water
-    maxRate = PaveVolume/Tstep + SurfaceInfil - PaveEvap;
+    maxRate = lc->paveVolume/lc->tStep + lc->surfaceInfil - lc->paveEvap;
     maxRate = MAX(maxRate, 0.0);
-    PavePerc = MIN(PavePerc, maxRate);
+    lc->pavePerc = MIN(lc->pavePerc, maxRate);
 
     //... find soil layer perc rate
     if ( soilThickness > 0.0 )
     {
-        SoilPerc = getSoilPercRate(soilTheta);
+        lc->soilPerc = getSoilPercRate(lc, soilTheta);
         availVolume = (soilTheta - soilFieldCap) * soilThickness;
-        maxRate = MAX(availVolume, 0.0) / Tstep - SoilEvap;
-        SoilPerc = MIN(SoilPerc, maxRate);
-        SoilPerc = MAX(SoilPerc, 0.0);
+        maxRate = MAX(availVolume, 0.0) / lc->tStep - lc->soilEvap;
+        lc->soilPerc = MIN(lc->soilPerc, maxRate);
+        lc->soilPerc = MAX(lc->soilPerc, 0.0);
     }
-    else SoilPerc = PavePerc;
+    else lc->soilPerc = lc->pavePerc;
 
     //... exfiltration rate out of storage layer
-    StorageExfil = getStorageExfilRate();
+    lc->storageExfil = getStorageExfilRate(lc);
 
     //... underdrain flow rate
-    StorageDrain = 0.0;
-    if ( theLidProc->drain.coeff > 0.0 )
+    lc->storageDrain = 0.0;
+    if ( lc->lidProc->drain.coeff > 0.0 )
     {
-        StorageDrain = getStorageDrainRate(storageDepth, soilTheta, paveDepth,
-                                           surfaceDepth);
+        lc->storageDrain = getStorageDrainRate(lc, storageDepth, soilTheta,
+                                               paveDepth, surfaceDepth);
     }
 
     //... check for adjacent saturated layers
@@ -915,22 +896,22 @@ void pavementFluxRates(double x[], double f[])
          paveDepth >= paveThickness )
     {
         //... pavement outflow can't exceed storage outflow
-        maxRate = StorageEvap + StorageDrain + StorageExfil;
-        if ( PavePerc > maxRate ) PavePerc = maxRate;
+        maxRate = lc->storageEvap + lc->storageDrain + lc->storageExfil;
+        if ( lc->pavePerc > maxRate ) lc->pavePerc = maxRate;
 
         //... storage outflow can't exceed pavement outflow
         else
         {
             //... use up available exfiltration capacity first
-            StorageExfil = MIN(StorageExfil, PavePerc);
-            StorageDrain = PavePerc - StorageExfil;
+            lc->storageExfil = MIN(lc->storageExfil, lc->pavePerc);
+            lc->storageDrain = lc->pavePerc - lc->storageExfil;
         }
 
         //... set soil perc to pavement perc
-        SoilPerc = PavePerc;
+        lc->soilPerc = lc->pavePerc;
 
         //... limit surface infil. by pavement perc
-        SurfaceInfil = MIN(SurfaceInfil, PavePerc);
+        lc->surfaceInfil = MIN(lc->surfaceInfil, lc->pavePerc);
     }
 
     //... pavement, soil & storage layers are full
@@ -940,22 +921,23 @@ void pavementFluxRates(double x[], double f[])
               paveDepth >= paveThickness )
     {
         //... find which layer has limiting flux rate
-        maxRate = StorageExfil + StorageDrain;
-        if ( SoilPerc < maxRate) maxRate = SoilPerc;
-        else maxRate = MIN(maxRate, PavePerc);
+        maxRate = lc->storageExfil + lc->storageDrain;
+        if ( lc->soilPerc < maxRate) maxRate = lc->soilPerc;
+        else maxRate = MIN(maxRate, lc->pavePerc);
 
         //... use up available storage exfiltration capacity first
-        if ( maxRate > StorageExfil ) StorageDrain = maxRate - StorageExfil;
+        if ( maxRate > lc->storageExfil )
+            lc->storageDrain = maxRate - lc->storageExfil;
         else
         {
-            StorageExfil = maxRate;
-            StorageDrain = 0.0;
+            lc->storageExfil = maxRate;
+            lc->storageDrain = 0.0;
         }
-        SoilPerc = maxRate;
-        PavePerc = maxRate;
+        lc->soilPerc = maxRate;
+        lc->pavePerc = maxRate;
 
         //... limit surface infil. by pavement perc
-        SurfaceInfil = MIN(SurfaceInfil, PavePerc);
+        lc->surfaceInfil = MIN(lc->surfaceInfil, lc->pavePerc);
     }
 
     //... storage & soil layers are full
@@ -964,22 +946,22 @@ void pavementFluxRates(double x[], double f[])
               soilTheta >= soilPorosity )
     {
         //... soil perc can't exceed storage outflow
-        maxRate = StorageDrain + StorageExfil;
-        if ( SoilPerc > maxRate ) SoilPerc = maxRate;
+        maxRate = lc->storageDrain + lc->storageExfil;
+        if ( lc->soilPerc > maxRate ) lc->soilPerc = maxRate;
 
         //... storage outflow can't exceed soil perc
         else
         {
             //... use up available exfiltration capacity first
-            StorageExfil = MIN(StorageExfil, SoilPerc);
-            StorageDrain = SoilPerc - StorageExfil;
+            lc->storageExfil = MIN(lc->storageExfil, lc->soilPerc);
+            lc->storageDrain = lc->soilPerc - lc->storageExfil;
         }
-        PavePerc = MIN(PavePerc, SoilPerc);        
+        lc->pavePerc = MIN(lc->pavePerc, lc->soilPerc);        
 
         //... limit surface infil. by available pavement volume
         availVolume = (paveThickness - paveDepth) * paveVoidFrac;
-        maxRate = availVolume / Tstep + PavePerc + PaveEvap;
-        SurfaceInfil = MIN(SurfaceInfil, maxRate);
+        maxRate = availVolume / lc->tStep + lc->pavePerc + lc->paveEvap;
+        lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
     }
 
     //... soil and pavement layers are full
@@ -987,81 +969,85 @@ void pavementFluxRates(double x[], double f[])
               paveDepth >= paveThickness &&
               soilTheta >= soilPorosity )
     {
-        PavePerc = MIN(PavePerc, SoilPerc);
-        SoilPerc = PavePerc;
-        SurfaceInfil = MIN(SurfaceInfil,PavePerc); 
-        maxRate = MAX(StorageVolume / Tstep + SoilPerc - StorageEvap, 0.0);
-	    StorageExfil = MIN(StorageExfil, maxRate); 
+        lc->pavePerc = MIN(lc->pavePerc, lc->soilPerc);
+        lc->soilPerc = lc->pavePerc;
+        lc->surfaceInfil = MIN(lc->surfaceInfil,lc->pavePerc); 
+        maxRate = MAX(lc->storageVolume / lc->tStep + lc->soilPerc -
+                      lc->storageEvap, 0.0);
+	    lc->storageExfil = MIN(lc->storageExfil, maxRate); 
     }
 
     //... no adjoining layers are full
     else
     {
         //... limit storage exfiltration by available storage volume
-        //    (if no soil layer, SoilPerc is same as PavePerc)
-        maxRate = SoilPerc - StorageEvap + StorageVolume / Tstep;
+        //    (if no soil layer, lc->soilPerc is same as lc->pavePerc)
+        maxRate = lc->soilPerc - lc->storageEvap + lc->storageVolume / lc->tStep;
         maxRate = MAX(0.0, maxRate);
-        StorageExfil = MIN(StorageExfil, maxRate);
+        lc->storageExfil = MIN(lc->storageExfil, maxRate);
 
         //... limit underdrain flow by volume above drain offset
-        if ( StorageDrain > 0.0 )
+        if ( lc->storageDrain > 0.0 )
         {
-            maxRate = -StorageExfil - StorageEvap;
-            if (storageDepth >= storageThickness ) maxRate += SoilPerc;
-            if ( theLidProc->drain.offset <= storageDepth ) 
+            maxRate = -lc->storageExfil - lc->storageEvap;
+            if (storageDepth >= storageThickness ) maxRate += lc->soilPerc;
+            if ( lc->lidProc->drain.offset <= storageDepth ) 
             {
-                maxRate += (storageDepth - theLidProc->drain.offset) *
-                           storageVoidFrac/Tstep;
+                maxRate += (storageDepth - lc->lidProc->drain.offset) *
+                           storageVoidFrac/lc->tStep;
             }
             maxRate = MAX(maxRate, 0.0);
-            StorageDrain = MIN(StorageDrain, maxRate);
+            lc->storageDrain = MIN(lc->storageDrain, maxRate);
         }
 
         //... limit soil & pavement outflow by unused storage volume
         availVolume = (storageThickness - storageDepth) * storageVoidFrac;
-        maxRate = availVolume/Tstep + StorageEvap + StorageDrain + StorageExfil;
+        maxRate = availVolume/lc->tStep + lc->storageEvap + lc->storageDrain +
+                  lc->storageExfil;
         maxRate = MAX(maxRate, 0.0);
         if ( soilThickness > 0.0 )
         {
-            SoilPerc = MIN(SoilPerc, maxRate);
-            maxRate = (soilPorosity - soilTheta) * soilThickness / Tstep +
-                      SoilPerc;
+            lc->soilPerc = MIN(lc->soilPerc, maxRate);
+            maxRate = (soilPorosity - soilTheta) * soilThickness / lc->tStep +
+                      lc->soilPerc;
         }
-        PavePerc = MIN(PavePerc, maxRate);
+        lc->pavePerc = MIN(lc->pavePerc, maxRate);
 
         //... limit surface infil. by available pavement volume
         availVolume = (paveThickness - paveDepth) * paveVoidFrac;
-        maxRate = availVolume / Tstep + PavePerc + PaveEvap;
-        SurfaceInfil = MIN(SurfaceInfil, maxRate);
+        maxRate = availVolume / lc->tStep + lc->pavePerc + lc->paveEvap;
+        lc->surfaceInfil = MIN(lc->surfaceInfil, maxRate);
     }
 
     //... surface outflow
-    SurfaceOutflow = getSurfaceOutflowRate(surfaceDepth);
+    lc->surfaceOutflow = getSurfaceOutflowRate(lc, surfaceDepth);
 
     //... compute overall layer flux rates
-    f[SURF] = SurfaceInflow - SurfaceEvap - SurfaceInfil - SurfaceOutflow;
-    f[PAVE] = (SurfaceInfil - PaveEvap - PavePerc) / paveVoidFrac;
-    if ( theLidProc->soil.thickness > 0.0)
+    f[SURF] = lc->surfaceInflow - lc->surfaceEvap - lc->surfaceInfil -
+              lc->surfaceOutflow;
+    f[PAVE] = (lc->surfaceInfil - lc->paveEvap - lc->pavePerc) / paveVoidFrac;
+    if ( lc->lidProc->soil.thickness > 0.0)
     {
-        f[SOIL] = (PavePerc - SoilEvap - SoilPerc) / soilThickness;
-        storageInflow = SoilPerc;
+        f[SOIL] = (lc->pavePerc - lc->soilEvap - lc->soilPerc) / soilThickness;
+        storageInflow = lc->soilPerc;
     }
     else
     {
         f[SOIL] = 0.0;
-        storageInflow = PavePerc;
-        SoilPerc = 0.0;
+        storageInflow = lc->pavePerc;
+        lc->soilPerc = 0.0;
     }
-    f[STOR] = (storageInflow - StorageEvap - StorageExfil - StorageDrain) /
-              storageVoidFrac;
+    f[STOR] = (storageInflow - lc->storageEvap - lc->storageExfil -
+               lc->storageDrain) / storageVoidFrac;
 }
 
 //=============================================================================
 
-void swaleFluxRates(double x[], double f[])
+void swaleFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates from a vegetative swale LID.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -1083,57 +1069,57 @@ void swaleFluxRates(double x[], double f[])
 
     //... retrieve state variable from work vector
     depth = x[SURF];
-    depth = MIN(depth, theLidProc->surface.thickness);
+    depth = MIN(depth, lc->lidProc->surface.thickness);
 
     //... depression storage depth
     dStore = 0.0;
 
     //... get swale's bottom width
     //    (0.5 ft minimum to avoid numerical problems)
-    slope = theLidProc->surface.sideSlope;
-    topWidth = theLidUnit->fullWidth;
+    slope = lc->lidProc->surface.sideSlope;
+    topWidth = lc->lidUnit->fullWidth;
     topWidth = MAX(topWidth, 0.5);
-    botWidth = topWidth - 2.0 * slope * theLidProc->surface.thickness;
+    botWidth = topWidth - 2.0 * slope * lc->lidProc->surface.thickness;
     if ( botWidth < 0.5 )
     {
         botWidth = 0.5;
-        slope = 0.5 * (topWidth - 0.5) / theLidProc->surface.thickness;
+        slope = 0.5 * (topWidth - 0.5) / lc->lidProc->surface.thickness;
     }
 
     //... swale's length
-    lidArea = theLidUnit->area;
+    lidArea = lc->lidUnit->area;
     length = lidArea / topWidth;
 
     //... top width, surface area and flow area of current ponded depth
     surfWidth = botWidth + 2.0 * slope * depth;
     surfArea = length * surfWidth;
     flowArea = (depth * (botWidth + slope * depth)) *
-               theLidProc->surface.voidFrac;
+               lc->lidProc->surface.voidFrac;
 
     //... wet volume and effective depth
     volume = length * flowArea;
 
     //... surface inflow into swale (cfs)
-    surfInflow = SurfaceInflow * lidArea;
+    surfInflow = lc->surfaceInflow * lidArea;
 
     //... ET rate in cfs
-    SurfaceEvap = EvapRate * surfArea;
-    SurfaceEvap = MIN(SurfaceEvap, volume/Tstep);
+    lc->surfaceEvap = lc->evapRate * surfArea;
+    lc->surfaceEvap = MIN(lc->surfaceEvap, volume/lc->tStep);
 
     //... infiltration rate to native soil in cfs
-    StorageExfil = SurfaceInfil * surfArea;
+    lc->storageExfil = lc->surfaceInfil * surfArea;
 
     //... no surface outflow if depth below depression storage
     xDepth = depth - dStore;
-    if ( xDepth <= ZERO ) SurfaceOutflow = 0.0;
+    if ( xDepth <= ZERO ) lc->surfaceOutflow = 0.0;
 
     //... otherwise compute a surface outflow
     else
     {
         //... modify flow area to remove depression storage,
         flowArea -= (dStore * (botWidth + slope * dStore)) *
-                     theLidProc->surface.voidFrac;
-        if ( flowArea < ZERO ) SurfaceOutflow = 0.0;
+                     lc->lidProc->surface.voidFrac;
+        if ( flowArea < ZERO ) lc->surfaceOutflow = 0.0;
         else
         {
             //... compute hydraulic radius
@@ -1142,41 +1128,42 @@ void swaleFluxRates(double x[], double f[])
             hydRadius = flowArea / hydRadius;
 
             //... use Manning Eqn. to find outflow rate in cfs
-            SurfaceOutflow = theLidProc->surface.alpha * flowArea *
+            lc->surfaceOutflow = lc->lidProc->surface.alpha * flowArea *
                              pow(hydRadius, 2./3.);
         }
     }
 
     //... net flux rate (dV/dt) in cfs
-    dVdT = surfInflow - SurfaceEvap - StorageExfil - SurfaceOutflow;
+    dVdT = surfInflow - lc->surfaceEvap - lc->storageExfil - lc->surfaceOutflow;
 
     //... when full, any net positive inflow becomes spillage
-    if ( depth == theLidProc->surface.thickness && dVdT > 0.0 )
+    if ( depth == lc->lidProc->surface.thickness && dVdT > 0.0 )
     {
-        SurfaceOutflow += dVdT;
+        lc->surfaceOutflow += dVdT;
         dVdT = 0.0;
     }
 
     //... convert flux rates to ft/s
-    SurfaceEvap /= lidArea;
-    StorageExfil /= lidArea;
-    SurfaceOutflow /= lidArea;
+    lc->surfaceEvap /= lidArea;
+    lc->storageExfil /= lidArea;
+    lc->surfaceOutflow /= lidArea;
     f[SURF] = dVdT / surfArea;
     f[SOIL] = 0.0;
     f[STOR] = 0.0;
 
     //... assign values to layer volumes
-    SurfaceVolume = volume / lidArea;
-    SoilVolume = 0.0;
-    StorageVolume = 0.0;
+    lc->surfaceVolume = volume / lidArea;
+    lc->soilVolume = 0.0;
+    lc->storageVolume = 0.0;
 }
 
 //=============================================================================
 
-void barrelFluxRates(double x[], double f[])
+void barrelFluxRates(TLidCtx* lc, double x[], double f[])
 //
 //  Purpose: computes flux rates for a rain barrel LID.
-//  Input:   x = vector of storage levels
+//  Input:   lc = ptr. to LID work context
+//           x = vector of storage levels
 //  Output:  f = vector of flux rates
 //
 {
@@ -1185,48 +1172,49 @@ void barrelFluxRates(double x[], double f[])
     double maxValue;
 
     //... assign values to layer volumes
-    SurfaceVolume = 0.0;
-    SoilVolume = 0.0;
-    StorageVolume = storageDepth;
+    lc->surfaceVolume = 0.0;
+    lc->soilVolume = 0.0;
+    lc->storageVolume = storageDepth;
 
     //... initialize flows
-    SurfaceInfil = 0.0;
-    SurfaceOutflow = 0.0;
-    StorageDrain = 0.0;
+    lc->surfaceInfil = 0.0;
+    lc->surfaceOutflow = 0.0;
+    lc->storageDrain = 0.0;
 
     //... compute outflow if time since last rain exceeds drain delay
     //    (dryTime is updated in lid.evalLidUnit at each time step)
-    if ( theLidProc->drain.delay == 0.0 ||
-        theLidUnit->dryTime >= theLidProc->drain.delay )
+    if ( lc->lidProc->drain.delay == 0.0 ||
+        lc->lidUnit->dryTime >= lc->lidProc->drain.delay )
     {
-        head = storageDepth - theLidProc->drain.offset;
+        head = storageDepth - lc->lidProc->drain.offset;
         if ( head > 0.0 )
         {
-            StorageDrain = getStorageDrainRate(storageDepth, 0.0, 0.0, 0.0);
-            maxValue = (head/Tstep);
-            StorageDrain = MIN(StorageDrain, maxValue);
+            lc->storageDrain = getStorageDrainRate(lc, storageDepth, 0.0, 0.0, 0.0);
+            maxValue = (head/lc->tStep);
+            lc->storageDrain = MIN(lc->storageDrain, maxValue);
         }
     }
 
     //... limit inflow to available storage
-    StorageInflow = SurfaceInflow;
-    maxValue = (theLidProc->storage.thickness - storageDepth) / Tstep +
-        StorageDrain;
-    StorageInflow = MIN(StorageInflow, maxValue);
-    SurfaceInfil = StorageInflow;
+    lc->storageInflow = lc->surfaceInflow;
+    maxValue = (lc->lidProc->storage.thickness - storageDepth) / lc->tStep +
+        lc->storageDrain;
+    lc->storageInflow = MIN(lc->storageInflow, maxValue);
+    lc->surfaceInfil = lc->storageInflow;
 
     //... assign values to layer flux rates
-    f[SURF] = SurfaceInflow - StorageInflow;
-    f[STOR] = StorageInflow - StorageDrain;
+    f[SURF] = lc->surfaceInflow - lc->storageInflow;
+    f[STOR] = lc->storageInflow - lc->storageDrain;
     f[SOIL] = 0.0;
 }
 
 //=============================================================================
 
-double getSurfaceOutflowRate(double depth)
+double getSurfaceOutflowRate(TLidCtx* lc, double depth)
 //
 //  Purpose: computes outflow rate from a LID's surface layer.
-//  Input:   depth = depth of ponded water on surface layer (ft)
+//  Input:   lc = ptr. to LID work context
+//           depth = depth of ponded water on surface layer (ft)
 //  Output:  returns outflow from surface layer (ft/s)
 //
 //  Note: this function should not be applied to swales or rain barrels.
@@ -1236,29 +1224,29 @@ double getSurfaceOutflowRate(double depth)
     double outflow;
 
     //... no outflow if ponded depth below storage depth
-    delta = depth - theLidProc->surface.thickness;
+    delta = depth - lc->lidProc->surface.thickness;
     if ( delta < 0.0 ) return 0.0;
 
     //... compute outflow from overland flow Manning equation
-    outflow = theLidProc->surface.alpha * pow(delta, 5.0/3.0) *
-              theLidUnit->fullWidth / theLidUnit->area;
-    outflow = MIN(outflow, delta / Tstep);
+    outflow = lc->lidProc->surface.alpha * pow(delta, 5.0/3.0) *
+              lc->lidUnit->fullWidth / lc->lidUnit->area;
+    outflow = MIN(outflow, delta / lc->tStep);
     return outflow;
 }
 
 //=============================================================================
 
-double getPavementPermRate()
+double getPavementPermRate(TLidCtx* lc)
 //
 //  Purpose: computes reduced permeability of a pavement layer due to
 //           clogging.
-//  Input:   none
+//  Input:   lc = ptr. to LID work context
 //  Output:  returns the reduced permeability of the pavement layer (ft/s).
 //
 {
     double permReduction = 0.0;
-    double clogFactor= theLidProc->pavement.clogFactor;
-    double regenDays = theLidProc->pavement.regenDays;
+    double clogFactor= lc->lidProc->pavement.clogFactor;
+    double regenDays = lc->lidProc->pavement.regenDays;
 
     // ... find permeability reduction due to clogging     
     if ( clogFactor > 0.0 )
@@ -1268,80 +1256,82 @@ double getPavementPermRate()
         //      volumetric loading that the pavement has received)
         if ( regenDays > 0.0 )
         {
-            if ( OldRunoffTime / 1000.0 / SECperDAY >= theLidUnit->nextRegenDay )
+            if ( OldRunoffTime / 1000.0 / SECperDAY >= lc->lidUnit->nextRegenDay )
             {
                 // ... reduce total volume treated by degree of regeneration
-                theLidUnit->volTreated *= 
-                    (1.0 - theLidProc->pavement.regenDegree);
+                lc->lidUnit->volTreated *= 
+                    (1.0 - lc->lidProc->pavement.regenDegree);
 
                 // ... update next day that regenration occurs
-                theLidUnit->nextRegenDay += regenDays;
+                lc->lidUnit->nextRegenDay += regenDays;
             }
         }
 
         // ... find permeabiity reduction factor
-        permReduction = theLidUnit->volTreated / clogFactor;
+        permReduction = lc->lidUnit->volTreated / clogFactor;
         permReduction = MIN(permReduction, 1.0);
     }
 
     // ... return the effective pavement permeability
-    return theLidProc->pavement.kSat * (1.0 - permReduction);
+    return lc->lidProc->pavement.kSat * (1.0 - permReduction);
 }
 
 //=============================================================================
 
-double getSoilPercRate(double theta)
+double getSoilPercRate(TLidCtx* lc, double theta)
 //
 //  Purpose: computes percolation rate of water through a LID's soil layer.
-//  Input:   theta = moisture content (fraction)
+//  Input:   lc = ptr. to LID work context
+//           theta = moisture content (fraction)
 //  Output:  returns percolation rate within soil layer (ft/s)
 //
 {
     double delta;            // moisture deficit
 
     // ... no percolation if soil moisture <= field capacity
-    if ( theta <= theLidProc->soil.fieldCap ) return 0.0;
+    if ( theta <= lc->lidProc->soil.fieldCap ) return 0.0;
 
     // ... perc rate = unsaturated hydraulic conductivity
-    delta = theLidProc->soil.porosity - theta;
-    return theLidProc->soil.kSat * exp(-delta * theLidProc->soil.kSlope);
+    delta = lc->lidProc->soil.porosity - theta;
+    return lc->lidProc->soil.kSat * exp(-delta * lc->lidProc->soil.kSlope);
 
 }
 
 //=============================================================================
 
-double getStorageExfilRate()
+double getStorageExfilRate(TLidCtx* lc)
 //
 //  Purpose: computes exfiltration rate from storage zone into
 //           native soil beneath a LID.
-//  Input:   depth = depth of water storage zone (ft)
+//  Input:   lc = ptr. to LID work context
+//           depth = depth of water storage zone (ft)
 //  Output:  returns infiltration rate (ft/s)
 //
 {
     double infil = 0.0;
     double clogFactor = 0.0;
 
-    if ( theLidProc->storage.kSat == 0.0 ) return 0.0;
-    if ( MaxNativeInfil == 0.0 ) return 0.0;
+    if ( lc->lidProc->storage.kSat == 0.0 ) return 0.0;
+    if ( lc->maxNativeInfil == 0.0 ) return 0.0;
 
     //... reduction due to clogging
-    clogFactor = theLidProc->storage.clogFactor;
+    clogFactor = lc->lidProc->storage.clogFactor;
     if ( clogFactor > 0.0 )
     {
-        clogFactor = theLidUnit->waterBalance.inflow / clogFactor;
+        clogFactor = lc->lidUnit->waterBalance.inflow / clogFactor;
         clogFactor = MIN(clogFactor, 1.0);
     }
 
     //... infiltration rate = storage Ksat reduced by any clogging
-    infil = theLidProc->storage.kSat * (1.0 - clogFactor);
+    infil = lc->lidProc->storage.kSat * (1.0 - clogFactor);
 
     //... limit infiltration rate by any groundwater-imposed limit
-    return MIN(infil, MaxNativeInfil);
+    return MIN(infil, lc->maxNativeInfil);
 }
 
 //=============================================================================
 
-double  getStorageDrainRate(double storageDepth, double soilTheta, 
+double  getStorageDrainRate(TLidCtx* lc, double storageDepth, double soilTheta, 
                             double paveDepth, double surfaceDepth)
 //
 //  Purpose: computes underdrain flow rate in a LID's storage layer.
@@ -1356,14 +1346,14 @@ double  getStorageDrainRate(double storageDepth, double soilTheta,
 //           layers above it (soil, pavement, and surface in that order)
 //           minus the drain outlet offset.
 {
-    int    curve = theLidProc->drain.qCurve;
+    int    curve = lc->lidProc->drain.qCurve;
     double head = storageDepth;
     double outflow = 0.0;
-    double paveThickness    = theLidProc->pavement.thickness;
-    double soilThickness    = theLidProc->soil.thickness;
-    double soilPorosity     = theLidProc->soil.porosity;
-    double soilFieldCap     = theLidProc->soil.fieldCap;
-    double storageThickness = theLidProc->storage.thickness;
+    double paveThickness    = lc->lidProc->pavement.thickness;
+    double soilThickness    = lc->lidProc->soil.thickness;
+    double soilPorosity     = lc->lidProc->soil.porosity;
+    double soilFieldCap     = lc->lidProc->soil.fieldCap;
+    double storageThickness = lc->lidProc->storage.thickness;
 
     // --- storage layer is full
     if ( storageDepth >= storageThickness )
@@ -1403,13 +1393,13 @@ double  getStorageDrainRate(double storageDepth, double soilTheta,
     // --- no outflow if:
     //     a) no prior outflow and head below open threshold
     //     b) prior outflow and head below closed threshold
-    if ( theLidUnit->oldDrainFlow == 0.0 &&
-         head <= theLidProc->drain.hOpen ) return 0.0;
-    if ( theLidUnit->oldDrainFlow > 0.0 &&
-         head <= theLidProc->drain.hClose ) return 0.0;
+    if ( lc->lidUnit->oldDrainFlow == 0.0 &&
+         head <= lc->lidProc->drain.hOpen ) return 0.0;
+    if ( lc->lidUnit->oldDrainFlow > 0.0 &&
+         head <= lc->lidProc->drain.hClose ) return 0.0;
 
     // --- make head relative to drain offset
-    head -= theLidProc->drain.offset;
+    head -= lc->lidProc->drain.offset;
 
     // --- compute drain outflow from underdrain flow equation in user units
     //     (head in inches or mm, flow rate in in/hr or mm/hr)
@@ -1419,8 +1409,8 @@ double  getStorageDrainRate(double storageDepth, double soilTheta,
         head *= UCF(RAINDEPTH);
 
         // --- compute drain outflow in user units
-        outflow = theLidProc->drain.coeff *
-                  pow(head, theLidProc->drain.expon);
+        outflow = lc->lidProc->drain.coeff *
+                  pow(head, lc->lidProc->drain.expon);
 
         // --- apply user-supplied control curve to outflow
         if (curve >= 0)  outflow *= table_lookup(&Curve[curve], head);
@@ -1433,33 +1423,35 @@ double  getStorageDrainRate(double storageDepth, double soilTheta,
 
 //=============================================================================
 
-double getDrainMatOutflow(double depth)
+double getDrainMatOutflow(TLidCtx* lc, double depth)
 //
 //  Purpose: computes flow rate through a green roof's drainage mat.
-//  Input:   depth = depth of water in drainage mat (ft)
+//  Input:   lc = ptr. to LID work context
+//           depth = depth of water in drainage mat (ft)
 //  Output:  returns flow in drainage mat (ft/s)
 //
 {
     //... default is to pass all inflow
-    double result = SoilPerc;
+    double result = lc->soilPerc;
 
     //... otherwise use Manning eqn. if its parameters were supplied
-    if ( theLidProc->drainMat.alpha > 0.0 )
+    if ( lc->lidProc->drainMat.alpha > 0.0 )
     {
-        result = theLidProc->drainMat.alpha * pow(depth, 5.0/3.0) *
-                 theLidUnit->fullWidth / theLidUnit->area *
-                 theLidProc->drainMat.voidFrac;
+        result = lc->lidProc->drainMat.alpha * pow(depth, 5.0/3.0) *
+                 lc->lidUnit->fullWidth / lc->lidUnit->area *
+                 lc->lidProc->drainMat.voidFrac;
     }
     return result;
 }
 
 //=============================================================================
 
-void getEvapRates(double surfaceVol, double paveVol, double soilVol,
+void getEvapRates(TLidCtx* lc, double surfaceVol, double paveVol, double soilVol,
     double storageVol, double pervFrac)
 //
 //  Purpose: computes surface, pavement, soil, and storage evaporation rates.
-//  Input:   surfaceVol = volume/area of ponded water on surface layer (ft)
+//  Input:   lc = ptr. to LID work context
+//           surfaceVol = volume/area of ponded water on surface layer (ft)
 //           paveVol    = volume/area of water in pavement pores (ft)
 //           soilVol    = volume/area of water in soil (or pavement) pores (ft)
 //           storageVol = volume/area of water in storage layer (ft)
@@ -1470,57 +1462,59 @@ void getEvapRates(double surfaceVol, double paveVol, double soilVol,
     double availEvap;
 
     //... surface evaporation flux
-    availEvap = EvapRate;
-    SurfaceEvap = MIN(availEvap, surfaceVol/Tstep);
-    SurfaceEvap = MAX(0.0, SurfaceEvap);
-    availEvap = MAX(0.0, (availEvap - SurfaceEvap));
+    availEvap = lc->evapRate;
+    lc->surfaceEvap = MIN(availEvap, surfaceVol/lc->tStep);
+    lc->surfaceEvap = MAX(0.0, lc->surfaceEvap);
+    availEvap = MAX(0.0, (availEvap - lc->surfaceEvap));
     availEvap *= pervFrac;
 
     //... no subsurface evap if water is infiltrating
-    if ( SurfaceInfil > 0.0 )
+    if ( lc->surfaceInfil > 0.0 )
     {
-        PaveEvap = 0.0;
-        SoilEvap = 0.0;
-        StorageEvap = 0.0;
+        lc->paveEvap = 0.0;
+        lc->soilEvap = 0.0;
+        lc->storageEvap = 0.0;
     }
     else
     {
         //... pavement evaporation flux
-        PaveEvap = MIN(availEvap, paveVol / Tstep);
-        availEvap = MAX(0.0, (availEvap - PaveEvap));
+        lc->paveEvap = MIN(availEvap, paveVol / lc->tStep);
+        availEvap = MAX(0.0, (availEvap - lc->paveEvap));
 
         //... soil evaporation flux
-        SoilEvap = MIN(availEvap, soilVol / Tstep);
-        availEvap = MAX(0.0, (availEvap - SoilEvap));
+        lc->soilEvap = MIN(availEvap, soilVol / lc->tStep);
+        availEvap = MAX(0.0, (availEvap - lc->soilEvap));
 
         //... storage evaporation flux
-        StorageEvap = MIN(availEvap, storageVol / Tstep);
+        lc->storageEvap = MIN(availEvap, storageVol / lc->tStep);
     }
 }
 
 //=============================================================================
 
-double getSurfaceOverflowRate(double* surfaceDepth)
+double getSurfaceOverflowRate(TLidCtx* lc, double* surfaceDepth)
 //
 //  Purpose: finds surface overflow rate from a LID unit.
-//  Input:   surfaceDepth = depth of water stored in surface layer (ft)
+//  Input:   lc = ptr. to LID work context
+//           surfaceDepth = depth of water stored in surface layer (ft)
 //  Output:  returns the overflow rate (ft/s)
 //
 {
-    double delta = *surfaceDepth - theLidProc->surface.thickness;
+    double delta = *surfaceDepth - lc->lidProc->surface.thickness;
     if (  delta <= 0.0 ) return 0.0;
-    *surfaceDepth = theLidProc->surface.thickness;
-    return delta * theLidProc->surface.voidFrac / Tstep;
+    *surfaceDepth = lc->lidProc->surface.thickness;
+    return delta * lc->lidProc->surface.voidFrac / lc->tStep;
 }
 
 //=============================================================================
 
-void updateWaterBalance(TLidUnit *lidUnit, double inflow, double evap,
-    double infil, double surfFlow, double drainFlow, double storage)
+void updateWaterBalance(TLidCtx* lc, TLidUnit *lidUnit, double inflow,
+    double evap, double infil, double surfFlow, double drainFlow, double storage)
 //
 //  Purpose: updates components of the water mass balance for a LID unit
 //           over the current time step.
-//  Input:   lidUnit   = a particular LID unit
+//  Input:   lc = ptr. to LID work context
+//           lidUnit   = a particular LID unit
 //           inflow    = runon + rainfall to the LID unit (ft/s)
 //           evap      = evaporation rate from the unit (ft/s)
 //           infil     = infiltration out the bottom of the unit (ft/s)
@@ -1530,25 +1524,26 @@ void updateWaterBalance(TLidUnit *lidUnit, double inflow, double evap,
 //  Output:  none
 //
 {
-    lidUnit->volTreated += inflow * Tstep;
-    lidUnit->waterBalance.inflow += inflow * Tstep;
-    lidUnit->waterBalance.evap += evap * Tstep;
-    lidUnit->waterBalance.infil += infil * Tstep;
-    lidUnit->waterBalance.surfFlow += surfFlow * Tstep;
-    lidUnit->waterBalance.drainFlow += drainFlow * Tstep;
+    lidUnit->volTreated += inflow * lc->tStep;
+    lidUnit->waterBalance.inflow += inflow * lc->tStep;
+    lidUnit->waterBalance.evap += evap * lc->tStep;
+    lidUnit->waterBalance.infil += infil * lc->tStep;
+    lidUnit->waterBalance.surfFlow += surfFlow * lc->tStep;
+    lidUnit->waterBalance.drainFlow += drainFlow * lc->tStep;
     lidUnit->waterBalance.finalVol = storage;
 }
 
 //=============================================================================
 
-int modpuls_solve(int n, double* x, double* xOld, double* xPrev,
+int modpuls_solve(TLidCtx* lc, int n, double* x, double* xOld, double* xPrev,
                   double* xMin, double* xMax, double* xTol,
                   double* qOld, double* q, double dt, double omega,
-                  void (*derivs)(double*, double*))
+                  void (*derivs)(TLidCtx*, double*, double*))
 //
 //  Purpose: solves system of equations dx/dt = q(x) for x at end of time step
 //           dt using a modified Puls method.
-//  Input:   n = number of state variables
+//  Input:   lc = ptr. to LID work context
+//           n = number of state variables
 //           x = vector of state variables
 //           xOld = state variable values at start of time step
 //           xPrev = state variable values from previous iteration
@@ -1583,7 +1578,7 @@ int modpuls_solve(int n, double* x, double* xOld, double* xPrev,
     {
         //... compute flux rates for current state levels
         canStop = 1;
-        derivs(x, q);
+        derivs(lc, x, q);
 
         //... update state levels based on current flux rates
         for (i=0; i<n; i++)
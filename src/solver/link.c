@@ -48,6 +48,10 @@
 //   - Warning for conduit elevation drop < MIN_DELTA_Z restored.
 //   Build 5.2.4:
 //   - Conduit evap+seepage loss under DW routing limited by conduit volume.
+//   - Uniform geometry tables built for cross sections when requested.
+//   - Normal & critical depths can be found from precomputed curves.
+//   - Force main friction factor curves built when requested.
+//   - Culvert inlet control curves built when requested.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -62,6 +66,18 @@
 //-----------------------------------------------------------------------------
 static const double MIN_DELTA_Z = 0.001; // minimum elevation change for conduit
                                          // slopes (ft)
+static const int    DEPTH_CURVE_ITEMS = 65;    // points per depth curve
+static const double DEPTH_CURVE_TOL = 0.001;   // max. curve error as fraction
+                                               // of full depth
+static const double DEPTH_CURVE_MEMORY = 16.e6;// max. bytes used by all
+                                               // depth curves
+enum DepthCurveFlags {YNORM_EXACT = 1, YCRIT_EXACT = 2};
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static double       CurveMemory;   // bytes used by conduit depth curves
+static TDepthCurves NoCurves;      // placeholder for conduits without curves
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
@@ -82,6 +98,7 @@ static const double MIN_DELTA_Z = 0.001; // minimum elevation change for conduit
 //  link_setOutfallDepth   (called in flowrout.c & dynwave.c)
 //  link_getYcrit          (called by link_setOutfallDepth & in dwflow.c)
 //  link_getYnorm          (called by conduit_initState, link_setOutfallDepth & in dwflow.c)
+//  link_deleteDepthCurves (called by deleteObjects in project.c)
 //  link_getVelocity       (called by link_getResults & stats_updateLinkStats)
 //  link_getPower          (called by stats_updateLinkStats in stats.c)
 //  link_getLossRate       (called in dwflow.c, kinwave.c & flowrout.c)
@@ -103,6 +120,11 @@ static double conduit_getSlope(int j);
 static double conduit_getInflow(int j);
 static double conduit_getLossRate(int j, int routeModel, double q,
               double tstep);
+static double conduit_getYnorm(int j, int k, double q);
+static TDepthCurves* conduit_getDepthCurves(int j, int k);
+static TDepthCurves* conduit_createDepthCurves(int j, int k);
+static int    conduit_getCurveDepth(TDepthCurves* curves, double* y, int flag,
+              double q, double* depth);
 
 static int    pump_readParams(int j, int k, char* tok[], int ntoks);
 static void   pump_validate(int j, int k);
@@ -418,6 +440,11 @@ void  link_validate(int j)
       case WEIR:    weir_validate(j, Link[j].subIndex);    break;
     }
 
+    // --- build uniform geometry tables for the link's cross section
+    if ( GeometryTol > 0.0 &&
+         !xsect_createTables(&Link[j].xsect, GeometryTol) )
+        report_writeErrorMsg(ERR_MEMORY, "");
+
     // --- check if crest of regulator opening < invert of downstream node
     switch ( Link[j].type )
     {
@@ -775,6 +802,16 @@ double link_getYcrit(int j, double q)
 //  Purpose: computes critical depth for given flow rate.
 //
 {
+    TDepthCurves* curves;
+    double y;
+
+    if ( DepthCurves && Link[j].type == CONDUIT &&
+         Link[j].xsect.type != DUMMY )
+    {
+        curves = conduit_getDepthCurves(j, Link[j].subIndex);
+        if ( conduit_getCurveDepth(curves, curves->yCrit, YCRIT_EXACT,
+                                   fabs(q), &y) ) return y;
+    }
     return xsect_getYcrit(&Link[j].xsect, q);
 }
 
@@ -789,7 +826,8 @@ double  link_getYnorm(int j, double q)
 //
 {
     int    k;
-    double s, a, y;
+    double y;
+    TDepthCurves* curves;
 
     if ( Link[j].type != CONDUIT ) return 0.0;
     if ( Link[j].xsect.type == DUMMY ) return 0.0;
@@ -797,10 +835,38 @@ double  link_getYnorm(int j, double q)
     k = Link[j].subIndex;
     if ( q > Conduit[k].qMax ) q = Conduit[k].qMax;
     if ( q <= 0.0 ) return 0.0;
-    s = q / Conduit[k].beta;
-    a = xsect_getAofS(&Link[j].xsect, s);
-    y = xsect_getYofA(&Link[j].xsect, a);
-    return y;
+    if ( DepthCurves )
+    {
+        curves = conduit_getDepthCurves(j, k);
+        if ( conduit_getCurveDepth(curves, curves->yNorm, YNORM_EXACT, q, &y) )
+            return y;
+    }
+    return conduit_getYnorm(j, k, q);
+}
+
+//=============================================================================
+
+void link_deleteDepthCurves(int j)
+//
+//  Input:   j = link index
+//  Output:  none
+//  Purpose: frees the normal & critical depth curves of a conduit.
+//
+{
+    int k;
+    TDepthCurves* curves;
+
+    if ( Conduit == NULL || Link[j].type != CONDUIT ) return;
+    k = Link[j].subIndex;
+    curves = Conduit[k].curves;
+    Conduit[k].curves = NULL;
+    if ( curves == NULL || curves == &NoCurves ) return;
+    CurveMemory -= sizeof(TDepthCurves) +
+                   curves->nItems * 2 * sizeof(double) + curves->nItems - 1;
+    FREE(curves->yNorm);
+    FREE(curves->yCrit);
+    FREE(curves->exact);
+    free(curves);
 }
 
 //=============================================================================
@@ -1126,6 +1192,10 @@ void  conduit_validate(int j, int k)
     {
         Link[j].xsect.sBot =
             forcemain_getRoughFactor(j, lengthFactor);
+
+        // --- tabulate its Darcy-Weisbach friction factors if requested
+        if ( FrictionCurves && !forcemain_createFricCurve(j, k) )
+            report_writeErrorMsg(ERR_MEMORY, "");
     }
     Conduit[k].roughFactor = GRAVITY * SQR(roughness/PHI);
 
@@ -1151,6 +1221,10 @@ void  conduit_validate(int j, int k)
          Link[j].cLossAvg    == 0.0
        ) Conduit[k].hasLosses = FALSE;
     else Conduit[k].hasLosses = TRUE;
+
+    // --- tabulate inlet controlled flows of a culvert if requested
+    if ( CulvertCurves && Link[j].xsect.culvertCode > 0 &&
+         !culvert_createCurve(j, k) ) report_writeErrorMsg(ERR_MEMORY, "");
 }
 
 //=============================================================================
@@ -1398,6 +1472,168 @@ double conduit_getLossRate(int j, int routeModel, double q, double tstep)
     return totalLossRate;
 }
 
+//=============================================================================
+
+double conduit_getYnorm(int j, int k, double q)
+//
+//  Input:   j = link index
+//           k = conduit index
+//           q = flow rate per barrel (cfs), 0 < q <= qMax
+//  Output:  returns normal depth (ft)
+//  Purpose: computes the exact normal depth of a conduit.
+//
+{
+    double s, a;
+
+    s = q / Conduit[k].beta;
+    a = xsect_getAofS(&Link[j].xsect, s);
+    return xsect_getYofA(&Link[j].xsect, a);
+}
+
+//=============================================================================
+
+TDepthCurves* conduit_getDepthCurves(int j, int k)
+//
+//  Input:   j = link index
+//           k = conduit index
+//  Output:  returns a conduit's normal & critical depth curves
+//  Purpose: retrieves a conduit's depth curves, building them the first
+//           time they are needed.
+//
+{
+    TDepthCurves* curves;
+
+    // --- depth curves may be first requested from within parallel
+    //     routing loops, so the pointer to them is read and published
+    //     atomically (seq_cst makes the curves' contents visible too)
+    #pragma omp atomic read seq_cst
+    curves = Conduit[k].curves;
+    if ( curves == NULL )
+    {
+        #pragma omp critical(link_depthCurves)
+        {
+            #pragma omp atomic read seq_cst
+            curves = Conduit[k].curves;
+            if ( curves == NULL )
+            {
+                curves = conduit_createDepthCurves(j, k);
+                #pragma omp atomic write seq_cst
+                Conduit[k].curves = curves;
+            }
+        }
+    }
+    return curves;
+}
+
+//=============================================================================
+
+TDepthCurves* conduit_createDepthCurves(int j, int k)
+//
+//  Input:   j = link index
+//           k = conduit index
+//  Output:  returns a conduit's normal & critical depth curves
+//  Purpose: tabulates normal & critical depth against flow for a conduit.
+//
+//  Curve points are spaced uniformly in sqrt(q) which makes depth close to
+//  linear in the curve's variable near zero flow. Intervals where depth
+//  decreases with flow or whose mid-point error exceeds DEPTH_CURVE_TOL
+//  (e.g., where normal depth jumps to full depth in closed shapes) are
+//  flagged to use exact depths instead, so interpolated depths are always
+//  monotone in flow. A placeholder without any points is returned
+//  once the memory used by all curves would exceed DEPTH_CURVE_MEMORY.
+//
+{
+    int    i, n = DEPTH_CURVE_ITEMS;
+    double bytes, qMax, q, u, y, yTol;
+    TDepthCurves* curves;
+    TXsect* xsect = &Link[j].xsect;
+
+    qMax = Conduit[k].qMax;
+    bytes = sizeof(TDepthCurves) + n * 2 * sizeof(double) + n - 1;
+    if ( qMax <= 0.0 || CurveMemory + bytes > DEPTH_CURVE_MEMORY )
+        return &NoCurves;
+
+    curves = (TDepthCurves *) calloc(1, sizeof(TDepthCurves));
+    if ( curves == NULL ) return &NoCurves;
+    curves->yNorm = (double *) calloc(n, sizeof(double));
+    curves->yCrit = (double *) calloc(n, sizeof(double));
+    curves->exact = (char *) calloc(n - 1, sizeof(char));
+    if ( curves->yNorm == NULL || curves->yCrit == NULL ||
+         curves->exact == NULL )
+    {
+        FREE(curves->yNorm);
+        FREE(curves->yCrit);
+        FREE(curves->exact);
+        free(curves);
+        return &NoCurves;
+    }
+    curves->nItems = n;
+    curves->qMax = qMax;
+    CurveMemory += bytes;
+
+    // --- depths at each curve point
+    for ( i = 1; i < n; i++ )
+    {
+        u = (double)i / (double)(n - 1);
+        q = qMax * u * u;
+        curves->yNorm[i] = conduit_getYnorm(j, k, q);
+        curves->yCrit[i] = xsect_getYcrit(xsect, q);
+    }
+
+    // --- flag intervals that are not monotone or where interpolation
+    //     is not accurate enough
+    yTol = DEPTH_CURVE_TOL * xsect->yFull;
+    for ( i = 0; i < n - 1; i++ )
+    {
+        u = ((double)i + 0.5) / (double)(n - 1);
+        q = qMax * u * u;
+        y = 0.5 * (curves->yNorm[i] + curves->yNorm[i+1]);
+        if ( curves->yNorm[i+1] < curves->yNorm[i] ||
+             fabs(y - conduit_getYnorm(j, k, q)) > yTol )
+            curves->exact[i] |= YNORM_EXACT;
+        y = 0.5 * (curves->yCrit[i] + curves->yCrit[i+1]);
+        if ( curves->yCrit[i+1] < curves->yCrit[i] ||
+             fabs(y - xsect_getYcrit(xsect, q)) > yTol )
+            curves->exact[i] |= YCRIT_EXACT;
+    }
+    return curves;
+}
+
+//=============================================================================
+
+int conduit_getCurveDepth(TDepthCurves* curves, double* y, int flag, double q,
+    double* depth)
+//
+//  Input:   curves = a conduit's depth curves
+//           y = normal or critical depths at each curve point (ft)
+//           flag = flag marking intervals where y should not be used
+//           q = flow rate per barrel (cfs)
+//  Output:  depth = interpolated depth (ft);
+//           returns TRUE if depth was found from the curve
+//  Purpose: interpolates a depth from a conduit's depth curve.
+//
+{
+    int    i, n = curves->nItems;
+    double u;
+
+    if ( n == 0 || q > curves->qMax ) return FALSE;
+    if ( q <= 0.0 )
+    {
+        *depth = 0.0;
+        return TRUE;
+    }
+    u = (n - 1) * sqrt(q / curves->qMax);
+    i = (int)u;
+    if ( i >= n - 1 )
+    {
+        *depth = y[n-1];
+        return TRUE;
+    }
+    if ( curves->exact[i] & flag ) return FALSE;
+    *depth = y[i] + (u - i) * (y[i+1] - y[i]);
+    return TRUE;
+}
+
 
 //=============================================================================
 //                        P U M P   M E T H O D S
@@ -28,6 +28,9 @@
 //     nodes are when updating total outflow volume.
 //   Build 5.1.013:
 //   - Volume from MinSurfArea no longer included in initial & final storage.
+//   Build 5.2.4:
+//   - Per-thread logs added so that runoff, loading and groundwater totals
+//     updated from a parallel runoff loop are summed in subcatchment order.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -36,12 +39,46 @@
 #include <math.h>
 #include "headers.h"
 
+// Protect against lack of compiler support for OpenMP
+#if defined(_OPENMP)
+  #include <omp.h>
+#else
+  static int omp_get_thread_num(void) { return 0; }
+#endif
+
 //-----------------------------------------------------------------------------
 //  Constants   
 //-----------------------------------------------------------------------------
 static const double MAX_RUNOFF_BALANCE_ERR = 10.0;
 static const double MAX_FLOW_BALANCE_ERR   = 10.0;
 
+enum MassbalLogTotals {RUNOFF_TOTALS, LOADING_TOTALS, GWATER_TOTALS};
+
+enum GwaterTotalsTypes {GW_INFIL, GW_UPPER_EVAP, GW_LOWER_EVAP,
+                        GW_LOWER_PERC, GW_GWATER};
+
+//-----------------------------------------------------------------------------
+//  Local data types
+//-----------------------------------------------------------------------------
+// An update to the runoff, loading or groundwater totals
+typedef struct
+{
+    char           totals;        // type of totals updated (RUNOFF_TOTALS,
+                                  // LOADING_TOTALS or GWATER_TOTALS)
+    char           type;          // flow, loading or groundwater type
+    int            p;             // pollutant index
+    double         v;             // flow volume or mass load
+}  TMassbalEntry;
+
+// Updates made by one thread over a parallel runoff time step
+typedef struct
+{
+    TMassbalEntry* entries;       // array of logged updates
+    int            count;         // number of logged updates
+    int            size;          // allocated size of entries array
+    char           failed;        // TRUE if entries array could not grow
+}  TMassbalLog;
+
 //-----------------------------------------------------------------------------
 //  Shared variables   
 //-----------------------------------------------------------------------------
@@ -54,6 +91,13 @@ TRoutingTotals   StepFlowTotals;  // routed flow totals over time step
 TRoutingTotals   OldStepFlowTotals;
 TRoutingTotals*  StepQualTotals;  // routed WQ totals over time step
 
+// NOTE: floating point sums depend on the order in which terms are added,
+//       so updates made while runoff is computed in parallel are logged
+//       per thread and then replayed in subcatchment order.
+static TMassbalLog* RunoffLogs;   // per-thread logs of runoff updates
+static int       RunoffLogCount;  // number of per-thread logs allocated
+static char      UseRunoffLogs;   // TRUE if updates are being logged
+
 //-----------------------------------------------------------------------------
 //  Exportable variables
 //-----------------------------------------------------------------------------
@@ -83,6 +127,8 @@ double   TotalArea;               // total drainage area (ft2)
 //  massbal_addSeepageLoss      (called from routing.c)
 //  massbal_addToFinalStorage   (called from qualrout.c)
 //  massbal_getStepFlowError    (called from routing.c)
+//  massbal_beginRunoffLogs     (called from runoff_execute)
+//  massbal_endRunoffLogs       (called from runoff_execute)
 
 //-----------------------------------------------------------------------------
 //  Local Functions   
@@ -94,6 +140,11 @@ double massbal_getLoadingError(void);
 double massbal_getGwaterError(void);
 double massbal_getQualError(void);
 
+static void addToRunoffLog(int totals, int type, int p, double v);
+static void addRunoffTotal(int type, double v);
+static void addLoadingTotal(int type, int p, double w);
+static void addGwaterTotal(int type, double v);
+
 
 //=============================================================================
 
@@ -250,11 +301,17 @@ void massbal_close()
 //  Purpose: frees memory used by mass balance system.
 //
 {
+    int i;
+
     FREE(LoadingTotals);
     FREE(QualTotals);
     FREE(StepQualTotals);
     FREE(NodeInflow);
     FREE(NodeOutflow);
+    for (i = 0; i < RunoffLogCount; i++) FREE(RunoffLogs[i].entries);
+    FREE(RunoffLogs);
+    RunoffLogCount = 0;
+    UseRunoffLogs = FALSE;
 }
 
 //=============================================================================
@@ -343,6 +400,20 @@ void massbal_updateRunoffTotals(int flowType, double v)
 //  Output:  none
 //  Purpose: updates runoff totals after current time step.
 //
+{
+    if ( UseRunoffLogs ) addToRunoffLog(RUNOFF_TOTALS, flowType, 0, v);
+    else addRunoffTotal(flowType, v);
+}
+
+//=============================================================================
+
+void addRunoffTotal(int flowType, double v)
+//
+//  Input:   flowType = type of flow
+//           v = flow volume (ft3)
+//  Output:  none
+//  Purpose: adds a flow volume to the runoff totals.
+//
 {
     switch(flowType)
     {
@@ -369,6 +440,15 @@ void massbal_updateGwaterTotals(double vInfil, double vUpperEvap, double vLowerE
 //  Purpose: updates groundwater totals after current time step.
 //
 {
+    if ( UseRunoffLogs )
+    {
+        addToRunoffLog(GWATER_TOTALS, GW_INFIL, 0, vInfil);
+        addToRunoffLog(GWATER_TOTALS, GW_UPPER_EVAP, 0, vUpperEvap);
+        addToRunoffLog(GWATER_TOTALS, GW_LOWER_EVAP, 0, vLowerEvap);
+        addToRunoffLog(GWATER_TOTALS, GW_LOWER_PERC, 0, vLowerPerc);
+        addToRunoffLog(GWATER_TOTALS, GW_GWATER, 0, vGwater);
+        return;
+    }
     GwaterTotals.infil     += vInfil;
     GwaterTotals.upperEvap += vUpperEvap;
     GwaterTotals.lowerEvap += vLowerEvap;
@@ -378,6 +458,26 @@ void massbal_updateGwaterTotals(double vInfil, double vUpperEvap, double vLowerE
 
 //=============================================================================
 
+void addGwaterTotal(int type, double v)
+//
+//  Input:   type = groundwater flux type
+//           v = volume depth of the flux (ft)
+//  Output:  none
+//  Purpose: adds a single flux volume to the groundwater totals.
+//
+{
+    switch (type)
+    {
+    case GW_INFIL:      GwaterTotals.infil     += v; break;
+    case GW_UPPER_EVAP: GwaterTotals.upperEvap += v; break;
+    case GW_LOWER_EVAP: GwaterTotals.lowerEvap += v; break;
+    case GW_LOWER_PERC: GwaterTotals.lowerPerc += v; break;
+    case GW_GWATER:     GwaterTotals.gwater    += v; break;
+    }
+}
+
+//=============================================================================
+
 void massbal_initTimeStepTotals()
 //
 //  Input:   none
@@ -443,6 +543,21 @@ void massbal_updateLoadingTotals(int type, int p, double w)
 //  Output:  none
 //  Purpose: adds inflow mass loading to loading totals for current time step.
 //
+{
+    if ( UseRunoffLogs ) addToRunoffLog(LOADING_TOTALS, type, p, w);
+    else addLoadingTotal(type, p, w);
+}
+
+//=============================================================================
+
+void addLoadingTotal(int type, int p, double w)
+//
+//  Input:   type = type of inflow
+//           p    = pollutant index
+//           w    = mass loading
+//  Output:  none
+//  Purpose: adds a mass loading to the loading totals.
+//
 {
     switch (type)
     {
@@ -458,6 +573,121 @@ void massbal_updateLoadingTotals(int type, int p, double w)
 
 //=============================================================================
 
+int massbal_beginRunoffLogs(int nThreads)
+//
+//  Input:   nThreads = number of threads computing runoff
+//  Output:  returns TRUE if logging was started, FALSE if not
+//  Purpose: starts logging updates to the runoff, loading and groundwater
+//           totals made by each thread of a parallel runoff loop.
+//
+//  Under a static loop schedule thread k processes a contiguous block of
+//  subcatchments that follows the block of thread k-1, so replaying the
+//  logs in thread order adds the updates in subcatchment order.
+//
+{
+    int i;
+    TMassbalLog* logs;
+
+    if ( nThreads > RunoffLogCount )
+    {
+        logs = (TMassbalLog *) realloc(RunoffLogs,
+                                       nThreads * sizeof(TMassbalLog));
+        if ( logs == NULL )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return FALSE;
+        }
+        RunoffLogs = logs;
+        for (i = RunoffLogCount; i < nThreads; i++)
+        {
+            RunoffLogs[i].entries = NULL;
+            RunoffLogs[i].size = 0;
+        }
+        RunoffLogCount = nThreads;
+    }
+    for (i = 0; i < RunoffLogCount; i++)
+    {
+        RunoffLogs[i].count = 0;
+        RunoffLogs[i].failed = FALSE;
+    }
+    UseRunoffLogs = TRUE;
+    return TRUE;
+}
+
+//=============================================================================
+
+void massbal_endRunoffLogs()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: stops logging and adds the logged updates to the runoff,
+//           loading and groundwater totals in thread order.
+//
+{
+    int i, k;
+    TMassbalEntry* e;
+
+    if ( !UseRunoffLogs ) return;
+    UseRunoffLogs = FALSE;
+    for (i = 0; i < RunoffLogCount; i++)
+    {
+        if ( RunoffLogs[i].failed )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return;
+        }
+        for (k = 0; k < RunoffLogs[i].count; k++)
+        {
+            e = &RunoffLogs[i].entries[k];
+            switch (e->totals)
+            {
+            case RUNOFF_TOTALS:  addRunoffTotal(e->type, e->v);        break;
+            case LOADING_TOTALS: addLoadingTotal(e->type, e->p, e->v); break;
+            case GWATER_TOTALS:  addGwaterTotal(e->type, e->v);        break;
+            }
+        }
+    }
+}
+
+//=============================================================================
+
+void addToRunoffLog(int totals, int type, int p, double v)
+//
+//  Input:   totals = type of totals being updated
+//           type   = flow, loading or groundwater type
+//           p      = pollutant index
+//           v      = flow volume or mass load
+//  Output:  none
+//  Purpose: appends an update to the calling thread's runoff log.
+//
+{
+    TMassbalLog*   log = &RunoffLogs[omp_get_thread_num()];
+    TMassbalEntry* entries;
+    int            size;
+
+    if ( log->failed ) return;
+    if ( log->count == log->size )
+    {
+        size = (log->size > 0) ? 2 * log->size : 256;
+        entries = (TMassbalEntry *) realloc(log->entries,
+                                            size * sizeof(TMassbalEntry));
+        if ( entries == NULL )
+        {
+            log->failed = TRUE;
+            return;
+        }
+        log->entries = entries;
+        log->size = size;
+    }
+    log->entries[log->count].totals = (char)totals;
+    log->entries[log->count].type = (char)type;
+    log->entries[log->count].p = p;
+    log->entries[log->count].v = v;
+    log->count++;
+}
+
+//=============================================================================
+
 void massbal_addInflowQual(int type, int p, double w)
 //
 //  Input:   type = type of inflow
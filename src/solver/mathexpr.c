@@ -9,6 +9,11 @@
 **  VERSION:       5.2.2
 **  LAST UPDATE:   09/02/2022
 **  BUG FIXES:     Problems related to '^' operator (F. Shang, 09/02/2022)
+**
+**  Build 5.2.4:
+**  - mathexpr_evalCtx() added to evaluate an expression whose variable values
+**    depend on a caller supplied context, so that it can be called by
+**    several threads at once.
 ******************************************************************************/
 /*
 **   Operand codes:
@@ -513,8 +518,10 @@ void deleteTree(ExprTree *tree)
 // Turn on "precise" floating point option
 #pragma float_control(precise, on, push)
 
-double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
-//  Mathematica expression evaluation using a stack
+double mathexpr_evalCtx(MathExpr *expr,
+                        double (*getVariableValue) (int, void *), void *p)
+//  Mathematica expression evaluation using a stack, where the values of
+//  variables are supplied by getVariableValue for the context p
 {
     
 // --- Note: the ExprStack array must be declared locally and not globally
@@ -571,7 +578,7 @@ double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
             case 8:
                 if (getVariableValue != NULL)
                 {
-                    r1 = getVariableValue(node->ivar);
+                    r1 = getVariableValue(node->ivar, p);
                 }
                 else r1 = 0.0;
 		stackindex++;
@@ -732,6 +739,29 @@ double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
 
 //=============================================================================
 
+//  Variable value function used by mathexpr_eval()
+typedef struct
+{
+    double (*getValue) (int);
+} TValueFunc;
+
+static double getFuncValue(int varIndex, void *p)
+{
+    return ((TValueFunc *)p)->getValue(varIndex);
+}
+
+double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
+//  Mathematica expression evaluation using a stack
+{
+    TValueFunc f;
+
+    if ( getVariableValue == NULL ) return mathexpr_evalCtx(expr, NULL, NULL);
+    f.getValue = getVariableValue;
+    return mathexpr_evalCtx(expr, getFuncValue, &f);
+}
+
+//=============================================================================
+
 void mathexpr_delete(MathExpr *expr)
 {
     if (expr) mathexpr_delete(expr->next);
@@ -29,6 +29,11 @@ MathExpr* mathexpr_create(char* s, int (*getVar) (char *));
 //  Evaluates a tokenized math expression
 double mathexpr_eval(MathExpr* expr, double (*getVal) (int));
 
+//  Evaluates a tokenized math expression whose variable values are
+//  supplied for a context p (safe to call from several threads)
+double mathexpr_evalCtx(MathExpr* expr, double (*getVal) (int, void*),
+                        void* p);
+
 //  Deletes a tokenized math expression
 void  mathexpr_delete(MathExpr* expr);
 
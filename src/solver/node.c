@@ -3,7 +3,7 @@
 //
 //   Project:  EPA SWMM5
 //   Version:  5.2
-//   Date:     10/29/22   (Build 5.2.2)
+//   Date:     06/12/23   (Build 5.2.4)
 //   Author:   L. Rossman
 //
 //   Conveyance system node functions.
@@ -37,6 +37,9 @@
 //   Build 5.2.2:
 //   - Warning restored for node full depth being increased to crown of highest
 //     connecting link.
+//   Build 5.2.4:
+//   - Cumulative volumes of tabular storage curves precomputed in
+//     node_validate().
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -204,6 +207,7 @@ void  node_validate(int j)
 //  Purpose: validates a node's properties.
 //
 {
+    int k;
     TDwfInflow* inflow;
 
     // --- see if full depth was increased to accommodate conduit crown
@@ -216,6 +220,15 @@ void  node_validate(int j)
     if ( Node[j].initDepth > Node[j].fullDepth + Node[j].surDepth )
         report_writeErrorMsg(ERR_NODE_DEPTH, Node[j].ID);
 
+    // --- precompute cumulative volumes of a tabular storage curve
+    if (Node[j].type == STORAGE)
+    {
+        k = Storage[Node[j].subIndex].aCurve;
+        if (Storage[Node[j].subIndex].shape == TABULAR && k >= 0)
+            if (!table_createVolumes(&Curve[k]))
+                report_writeErrorMsg(ERR_MEMORY, "");
+    }
+
     // --- check for negative volume for storage node at full depth
     if (Node[j].type == STORAGE)
         if (node_getVolume(j, Node[j].fullDepth) < 0.0)
@@ -56,6 +56,19 @@
 //  - Support added for tracking a gage's prior n-hour rainfall total.
 //  - Removed extIfaceInflow member from ExtInflow struct.
 //  - Refactored TRptFlags struct.
+//  Build 5.2.4:
+//  - Uniform geometry tables added to cross section data structure.
+//  - Normal & critical depth curves added to conduit data structure.
+//  - Contiguous data arrays added to curve/time series data structure.
+//  - Cumulative volumes added to curve data structure for storage curves.
+//  - Transect geometry tables made shareable with optional depth entries.
+//  - Friction factor curve added to conduit data structure for force mains.
+//  - Inlet control curve added to conduit data structure for culverts.
+//  - Runoff context structure added to hold a subcatchment's water balance
+//    over a runoff time step.
+//  - Last unsaturated hydraulic conductivity saved with groundwater object.
+//  - Deferred dry time added to subcatchment data structure.
+//  - ODE solver work arrays added to runoff context structure.
 //-----------------------------------------------------------------------------
 
 #ifndef OBJECTS_H
@@ -66,6 +79,7 @@
 #include "enums.h"
 #include "datetime.h"
 #include "mathexpr.h"
+#include "odesolve.h"
 #include "inlet.h"
 #include "infil.h"
 #include "exfil.h"
@@ -104,9 +118,16 @@ typedef struct
    double        lastDate;        // last input date for time series
    double        x1, x2;          // current bracket on x-values
    double        y1, y2;          // current bracket on y-values
-   TTableEntry*  firstEntry;      // first data point
-   TTableEntry*  lastEntry;       // last data point
-   TTableEntry*  thisEntry;       // current data point
+   TTableEntry*  firstEntry;      // first data point (while parsing)
+   TTableEntry*  lastEntry;       // last data point (while parsing)
+   int           nItems;          // number of data points
+   int           thisItem;        // index of current data point
+   int           lastItem;        // interval found by last lookup
+   char          yAscending;      // TRUE if y-values never decrease
+   char          vAscending;      // TRUE if volumes never decrease
+   double*       xItems;          // x-values of data points
+   double*       yItems;          // y-values of data points
+   double*       vItems;          // cumulative volumes (storage curves)
    TFile         file;            // external data file
 }  TTable;
 
@@ -290,6 +311,7 @@ typedef struct
     double        newFlow;        // gw outflow from current time period (fps)
     double        evapLoss;       // evaporation loss rate (ft/sec)
     double        maxInfilVol;    // max. infil. upper zone can accept (ft)
+    double        hydCon;         // last unsat. hyd. conductivity (ft/sec)
     TGWaterStats  stats;          // gw statistics
 } TGroundwater;
 
@@ -407,12 +429,37 @@ typedef struct
    double        newRunoff;       // current runoff (cfs)
    double        oldSnowDepth;    // previous snow depth (ft)
    double        newSnowDepth;    // current snow depth (ft)
+   double        dryTime;         // dry time not yet analyzed (sec)
    double*       oldQual;         // previous runoff quality (mass/L)
    double*       newQual;         // current runoff quality (mass/L)
    double*       pondedQual;      // ponded surface water quality (mass)
    double*       totalLoad;       // total washoff load (lbs or kg)
 }  TSubcatch;
 
+//----------------
+// RUNOFF CONTEXT
+//----------------
+// Water balance of the subcatchment currently being analyzed. One context
+// is used by each thread that computes runoff.
+typedef struct
+{
+   double        vEvap;           // evaporation (ft3)
+   double        vPevap;          // pervious area evaporation (ft3)
+   double        vInfil;          // non-LID infiltration (ft3)
+   double        vInflow;         // non-LID precip + snowmelt + runon +
+                                  // ponded water (ft3)
+   double        vOutflow;        // non-LID runoff to subcatch outlet (ft3)
+   double        vLidIn;          // impervious area flow to LID units (ft3)
+   double        vLidInfil;       // infiltration from LID units (ft3)
+   double        vLidOut;         // surface outflow from LID units (ft3)
+   double        vLidDrain;       // drain outflow from LID units (ft3)
+   double        vLidReturn;      // LID outflow returned to pervious area (ft3)
+   double        infilFactor;     // infiltration adjustment factor
+   double*       outflowLoad;     // pollutant mass load in runoff (mass)
+   char          hasWetLids;      // TRUE if any LID units are wet
+   TOdeSolver    odeSolver;       // work arrays for ODE integration
+}  TRunoffCtx;
+
 //-----------------------
 // TIME PATTERN DATA
 //-----------------------
@@ -575,6 +622,20 @@ typedef struct
    int         flowCurve;         // index of inflow v. diverted flow curve
 }  TDivider;
 
+//--------------------------------------
+// UNIFORM CROSS SECTION GEOMETRY TABLES
+//--------------------------------------
+#define N_GEOM_TABLES 6
+typedef struct
+{
+   int           nItems[N_GEOM_TABLES];    // number of equally spaced items
+   double        xFull[N_GEOM_TABLES];     // independent variable at table end
+   double        maxError[N_GEOM_TABLES];  // max. error relative to full value
+   double        exactFrac[N_GEOM_TABLES]; // fraction of intervals not used
+   double*       f[N_GEOM_TABLES];         // dependent variable at each item
+   char*         exact[N_GEOM_TABLES];     // TRUE if interval not used
+}  TGeomTables;
+
 //-----------------------------
 // CROSS SECTION DATA STRUCTURE
 //-----------------------------
@@ -596,6 +657,7 @@ typedef struct
    double        aBot;            // area of bottom section
    double        sBot;            // slope of bottom section
    double        rBot;            // radius of bottom section
+   TGeomTables*  tables;          // uniform geometry tables (or NULL)
 }  TXsect;
 
 //--------------------------------------
@@ -615,9 +677,10 @@ typedef struct
     double       lengthFactor;              // floodplain / channel length 
     //--------------------------------------
     double       roughness;                 // Manning's n
-    double       areaTbl[N_TRANSECT_TBL];   // table of area v. depth
-    double       hradTbl[N_TRANSECT_TBL];   // table of hyd. radius v. depth
-    double       widthTbl[N_TRANSECT_TBL];  // table of top width v. depth
+    double*      depthTbl;                  // table of depths (NULL if uniform)
+    double*      areaTbl;                   // table of area v. depth
+    double*      hradTbl;                   // table of hyd. radius v. depth
+    double*      widthTbl;                  // table of top width v. depth
     int          nTbl;                      // size of geometry tables
 }   TTransect;
 
@@ -705,6 +768,28 @@ typedef struct
    char          inletControl;    // culvert inlet control flag
 }  TLink;
 
+//---------------------------------------
+// CONDUIT NORMAL & CRITICAL DEPTH CURVES
+//---------------------------------------
+typedef struct
+{
+   int           nItems;          // number of curve points
+   double        qMax;            // flow at last curve point (cfs)
+   double*       yNorm;           // normal depth at each point (ft)
+   double*       yCrit;           // critical depth at each point (ft)
+   char*         exact;           // exact depth flags for each interval
+}  TDepthCurves;
+
+//---------------------------------------
+// CULVERT INLET CONTROL CURVE
+//---------------------------------------
+typedef struct
+{
+   double        yMax;            // depth at last curve point (ft)
+   double*       q;               // inlet controlled flow at each point (cfs)
+   char*         exact;           // exact flow flags for each interval
+}  TCulvertCurve;
+
 //---------------
 // CONDUIT OBJECT
 //---------------
@@ -728,6 +813,11 @@ typedef struct
    char          superCritical;   // super-critical flow flag
    char          hasLosses;       // local losses flag
    char          fullState;       // determines if either or both ends full
+   TDepthCurves* curves;          // normal & critical depth curves (or NULL)
+   double*       fricCurve;       // D-W friction factors of a force main
+                                  // (or NULL)
+   TCulvertCurve* culvertCurve;   // inlet control curve of a culvert
+                                  // (or NULL)
 }  TConduit;
 
 //------------
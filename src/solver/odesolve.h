@@ -9,11 +9,25 @@
 #define ODESOLVE_H
 
 
-// functions that open, close, and use the ODE solver
-int  odesolve_open(int n);
-void odesolve_close(void);
-int  odesolve_integrate(double ystart[], int n, double x1, double x2,
-     double eps, double h1, void (*derivs)(double, double*, double*));
+// work arrays used by the ODE solver (each thread integrating
+// equations at the same time must use its own solver)
+typedef struct
+{
+    int      nmax;      // max. number of equations
+    double*  y;         // dependent variable
+    double*  yscal;     // scaling factors
+    double*  yerr;      // integration errors
+    double*  ytemp;     // temporary values of y
+    double*  dydx;      // derivatives of y
+    double*  ak;        // derivatives at intermediate points
+}  TOdeSolver;
+
+// functions that open, close, and use an ODE solver
+int  odesolve_open(TOdeSolver* ode, int n);
+void odesolve_close(TOdeSolver* ode);
+int  odesolve_integrate(TOdeSolver* ode, double ystart[], int n, double x1,
+     double x2, double eps, double h1,
+     void (*derivs)(double, double*, double*, void*), void* p);
 
 
 #endif //ODESOLVE_H
@@ -28,6 +28,8 @@
 //   - Large file support added.
 //   Build5.2.1:
 //   - Corrects the definition of F_OFF for non-Microsoft C/C++ compilers.
+//   Build 5.2.4:
+//   - Nodes and links are saved in input order if they were renumbered.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -125,7 +127,7 @@ int output_open()
 //  Purpose: writes basic project data to binary output file.
 //
 {
-    int   j;
+    int   i, j;
     int   m;
     INT4  k;
     REAL4 x;
@@ -210,12 +212,14 @@ int output_open()
     {
         if ( Subcatch[j].rptFlag ) output_saveID(Subcatch[j].ID, Fout.file);
     }
-    for (j=0; j<Nobjects[NODE]; j++)
+    for (i=0; i<Nobjects[NODE]; i++)
     {
+        j = reorder_getIndex(NODE, i);
         if ( Node[j].rptFlag ) output_saveID(Node[j].ID, Fout.file);
     }
-    for (j=0; j<Nobjects[LINK]; j++)
+    for (i=0; i<Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
         if ( Link[j].rptFlag ) output_saveID(Link[j].ID, Fout.file);
     }
     for (j=0; j<NumPolluts; j++) output_saveID(Pollut[j].ID, Fout.file);
@@ -250,8 +254,9 @@ int output_open()
     fwrite(&k, sizeof(INT4), 1, Fout.file);
     k = INPUT_MAX_DEPTH;
     fwrite(&k, sizeof(INT4), 1, Fout.file);
-    for (j=0; j<Nobjects[NODE]; j++)
+    for (i=0; i<Nobjects[NODE]; i++)
     {
+        j = reorder_getIndex(NODE, i);
         if ( !Node[j].rptFlag ) continue;
         k = Node[j].type;
         NodeResults[0] = (REAL4)(Node[j].invertElev * UCF(LENGTH));
@@ -274,8 +279,9 @@ int output_open()
     k = INPUT_LENGTH;
     fwrite(&k, sizeof(INT4), 1, Fout.file);
 
-    for (j=0; j<Nobjects[LINK]; j++)
+    for (i=0; i<Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
         if ( !Link[j].rptFlag ) continue;
         k = Link[j].type;
         if ( k == PUMP )
@@ -641,15 +647,17 @@ void output_saveNodeResults(double reportTime, FILE* file)
 //  Purpose: writes computed node results to binary file.
 //
 {
-    int j;
+    int i, j;
 
     // --- find where current reporting time lies between latest routing times
     double f = (reportTime - OldRoutingTime) /
                (NewRoutingTime - OldRoutingTime);
 
-    // --- write node results to file
-    for (j=0; j<Nobjects[NODE]; j++)
+    // --- write node results to file (in input order)
+    for (i=0; i<Nobjects[NODE]; i++)
     {
+        j = reorder_getIndex(NODE, i);
+
         // --- retrieve interpolated results for reporting time & write to file
         node_getResults(j, f, NodeResults);
         if ( Node[j].rptFlag )
@@ -671,16 +679,18 @@ void output_saveLinkResults(double reportTime, FILE* file)
 //  Purpose: writes computed link results to binary file.
 //
 {
-    int j;
+    int i, j;
     double f;
     double z;
 
     // --- find where current reporting time lies between latest routing times
     f = (reportTime - OldRoutingTime) / (NewRoutingTime - OldRoutingTime);
 
-    // --- write link results to file
-    for (j=0; j<Nobjects[LINK]; j++)
+    // --- write link results to file (in input order)
+    for (i=0; i<Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
+
         // --- retrieve interpolated results for reporting time & write to file
         if (Link[j].rptFlag )
         {
@@ -856,12 +866,13 @@ void output_initAvgResults()
 
 void output_updateAvgResults()
 {
-    int i, j, k, sign;
+    int i, j, k, n, sign;
 
     // --- update average accumulations for nodes
     k = 0;
-    for (i = 0; i < Nobjects[NODE]; i++)
+    for (n = 0; n < Nobjects[NODE]; n++)
     {
+        i = reorder_getIndex(NODE, n);
         if ( !Node[i].rptFlag ) continue;
         node_getResults(i, 1.0, NodeResults);
         for (j = 0; j < NumNodeVars; j++)
@@ -873,8 +884,9 @@ void output_updateAvgResults()
 
     // --- update average accumulations for links
     k = 0;
-    for (i = 0; i < Nobjects[LINK]; i++)
+    for (n = 0; n < Nobjects[LINK]; n++)
     {
+        i = reorder_getIndex(LINK, n);
         if ( !Link[i].rptFlag ) continue;
         link_getResults(i, 1.0, LinkResults);
 
@@ -910,7 +922,7 @@ void output_updateAvgResults()
 
 void output_saveAvgResults(FILE* file)
 {
-    int i, j;
+    int i, j, k;
 
     // --- examine each reportable node
     for (i = 0; i < NumNodes; i++)
@@ -926,8 +938,9 @@ void output_saveAvgResults(FILE* file)
     }
 
     // --- update each node's max depth and contribution to system storage
-    for (i = 0; i < Nobjects[NODE]; i++)
+    for (k = 0; k < Nobjects[NODE]; k++)
     {
+        i = reorder_getIndex(NODE, k);
         stats_updateMaxNodeDepth(i, Node[i].newDepth * UCF(LENGTH));
         SysResults[SYS_STORAGE] += (REAL4)(Node[i].newVolume * UCF(VOLUME));
     }
@@ -946,8 +959,9 @@ void output_saveAvgResults(FILE* file)
     }
  
     // --- add each link's volume to total system storage
-    for (i = 0; i < Nobjects[LINK]; i++)
+    for (k = 0; k < Nobjects[LINK]; k++)
     {
+        i = reorder_getIndex(LINK, k);
         SysResults[SYS_STORAGE] += (REAL4)(Link[i].newVolume * UCF(VOLUME));
     }
 
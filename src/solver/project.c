@@ -56,6 +56,21 @@
 //   - Default Inertial Damping changed from SOME to PARTIAL_DAMPING.
 //   - Default CourantFactor changed from 0 (fixed routing time step)
 //   - to 0.75 (variable time step)
+//   - NETWORK_ORDER option added for renumbering nodes and links.
+//   - SOLVER_METHOD option added for dynamic wave routing.
+//   - RELAXATION option added for dynamic wave routing.
+//   - STEP_CLASSES option added for multi-rate dynamic wave routing.
+//   - SKIP_DORMANT option added for dynamic wave routing.
+//   - DETERMINISTIC option added for multithreaded routing.
+//   - LOAD_BALANCING option added for multithreaded routing.
+//   - GEOMETRY_TOL option added for uniform cross section geometry tables.
+//   - DEPTH_CURVES option added for tabulated normal & critical depths.
+//   - TRANSECT_TOL option added for adaptive transect geometry tables.
+//   - INLET_CURVES option added for tabulated inlet capture.
+//   - FRICTION_CURVES option added for tabulated force main friction factors.
+//   - CULVERT_CURVES option added for tabulated culvert inlet control.
+//   - Memory error reported when curve data cannot be moved into arrays.
+//   - SKIP_DRY_SUBCATCH option added to defer updates of dry subcatchments.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -198,7 +213,8 @@ void project_validate()
     for ( i=0; i<Nobjects[CURVE]; i++ )
     {
          err = table_validate(&Curve[i]);
-         if ( err ) report_writeErrorMsg(ERR_CURVE_SEQUENCE, Curve[i].ID);
+         if ( err == ERR_MEMORY ) report_writeErrorMsg(ERR_MEMORY, "");
+         else if ( err ) report_writeErrorMsg(ERR_CURVE_SEQUENCE, Curve[i].ID);
     }
     for ( i=0; i<Nobjects[TSERIES]; i++ )
     {
@@ -214,6 +230,8 @@ void project_validate()
     if ( Nobjects[AQUIFER]  == 0 ) IgnoreGwater   = TRUE;
     for ( i=0; i<Nobjects[AQUIFER]; i++ )  gwater_validateAquifer(i);
     for ( i=0; i<Nobjects[SUBCATCH]; i++ ) subcatch_validate(i);
+    if ( subcatch_createRunonSchedule() > 0 )
+        report_writeErrorMsg(ERR_MEMORY, "");
     for ( i=0; i<Nobjects[GAGE]; i++ )     gage_validate(i);
     for ( i=0; i<Nobjects[SNOWMELT]; i++ ) snow_validateSnowmelt(i);
 
@@ -263,6 +281,9 @@ void project_validate()
     // --- validate street/channel inlets
     inlet_validate();
 
+    // --- renumber nodes & links for better memory locality
+    reorder_network();
+
     // --- adjust number of parallel threads to be used
     if ( NumThreads == 0 ) NumThreads = omp_get_max_threads();
     else NumThreads = MIN(NumThreads, omp_get_max_threads());
@@ -278,6 +299,7 @@ void project_close()
 //  Purpose: closes a SWMM project.
 //
 {
+    reorder_delete();
     deleteObjects();
     deleteHashTables();
 }
@@ -291,7 +313,7 @@ int  project_init(void)
 //  Purpose: initializes the internal state of all objects.
 // 
 {
-    int j, k;
+    int i, j, k;
     climate_initState();
     lid_initState();
     for (j=0; j<Nobjects[TSERIES]; j++)  table_tseriesInit(&Tseries[j]);
@@ -307,8 +329,9 @@ int  project_init(void)
         }
     }
     k = 1;
-    for (j=0; j<Nobjects[NODE]; j++)
+    for (i=0; i<Nobjects[NODE]; i++)
     {
+        j = reorder_getIndex(NODE, i);
         node_initState(j);
         if (Node[j].rptFlag > 0)
         {
@@ -317,8 +340,9 @@ int  project_init(void)
         }
     }
     k = 1;        
-    for (j=0; j<Nobjects[LINK]; j++)
+    for (i=0; i<Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
         link_initState(j);
         if (Link[j].rptFlag > 0)
         {
@@ -361,6 +385,31 @@ int   project_addObject(int type, char *id, int n)
 
 //=============================================================================
 
+int project_reindexObjects(int type)
+//
+//  Input:   type = object type (NODE or LINK)
+//  Output:  returns 1 if successful, 0 if hashing fails
+//  Purpose: rebuilds the hash table for an object type after its objects
+//           have been renumbered.
+//
+{
+    int   i;
+    char* id;
+
+    HTfree(Htable[type]);
+    Htable[type] = HTcreate();
+    if ( Htable[type] == NULL ) return 0;
+    for (i = 0; i < Nobjects[type]; i++)
+    {
+        if ( type == NODE ) id = Node[i].ID;
+        else                id = Link[i].ID;
+        if ( !HTinsert(Htable[type], id, i) ) return 0;
+    }
+    return 1;
+}
+
+//=============================================================================
+
 int project_findObject(int type, const char *id)
 //
 //  Input:   type = object type
@@ -609,6 +658,15 @@ int project_readOption(char* s1, char* s2)
       case IGNORE_ROUTING:
       case IGNORE_QUALITY:
       case IGNORE_RDII:
+      case PARALLEL_NODE_FLOWS:
+      case SKIP_DORMANT:
+      case DETERMINISTIC:
+      case LOAD_BALANCING:
+      case DEPTH_CURVES:
+      case INLET_CURVES:
+      case FRICTION_CURVES:
+      case CULVERT_CURVES:
+      case SKIP_DRY_SUBCATCH:
         m = findmatch(s2, NoYesWords);
         if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
         switch ( k )
@@ -622,6 +680,15 @@ int project_readOption(char* s1, char* s2)
           case IGNORE_ROUTING:    IgnoreRouting   = m;  break;
           case IGNORE_QUALITY:    IgnoreQuality   = m;  break;
           case IGNORE_RDII:       IgnoreRDII      = m;  break;
+          case PARALLEL_NODE_FLOWS: ParallelNodeFlows = m; break;
+          case SKIP_DORMANT:      SkipDormant     = m;  break;
+          case DETERMINISTIC:     Deterministic   = m;  break;
+          case LOAD_BALANCING:    LoadBalancing   = m;  break;
+          case DEPTH_CURVES:      DepthCurves     = m;  break;
+          case INLET_CURVES:      InletCurves     = m;  break;
+          case FRICTION_CURVES:   FrictionCurves  = m;  break;
+          case CULVERT_CURVES:    CulvertCurves   = m;  break;
+          case SKIP_DRY_SUBCATCH: SkipDrySubcatch = m;  break;
         }
         break;
 
@@ -760,6 +827,50 @@ int project_readOption(char* s1, char* s2)
           SurchargeMethod = m;
           break;
 
+      // --- internal ordering of nodes and links
+      case NETWORK_ORDER:
+          m = findmatch(s2, NetworkOrderWords);
+          if (m < 0) return error_setInpError(ERR_KEYWORD, s2);
+          NetworkOrder = m;
+          break;
+
+      // --- method used to solve dynamic wave equations
+      case SOLVER_METHOD:
+          m = findmatch(s2, SolverWords);
+          if (m < 0) return error_setInpError(ERR_KEYWORD, s2);
+          SolverMethod = m;
+          break;
+
+      // --- under-relaxation used in Picard iterations
+      case RELAXATION:
+          m = findmatch(s2, RelaxationWords);
+          if (m < 0) return error_setInpError(ERR_KEYWORD, s2);
+          Relaxation = m;
+          break;
+
+      // --- number of power-of-two time step classes for DW conduits
+      case STEP_CLASSES:
+        m = atoi(s2);
+        if ( m < 1 ) return error_setInpError(ERR_NUMBER, s2);
+        StepClasses = m;
+        break;
+
+      // --- error tolerance of uniform cross section geometry tables
+      case GEOMETRY_TOL:
+        if ( !getDouble(s2, &GeometryTol) )
+            return error_setInpError(ERR_NUMBER, s2);
+        if ( GeometryTol < 0.0 )
+            return error_setInpError(ERR_NUMBER, s2);
+        break;
+
+      // --- error tolerance of adaptive transect geometry tables
+      case TRANSECT_TOL:
+        if ( !getDouble(s2, &TransectTol) )
+            return error_setInpError(ERR_NUMBER, s2);
+        if ( TransectTol < 0.0 )
+            return error_setInpError(ERR_NUMBER, s2);
+        break;
+
       case TEMPDIR: // Temporary Directory
         sstrncpy(TempDir, s2, MAXFNAME);
         break;
@@ -844,6 +955,9 @@ void setDefaults()
    InfilModel      = HORTON;           // Horton infiltration method
    RouteModel      = DW;               // Dynamic wave flow routing method
    SurchargeMethod = EXTRAN;           // Use EXTRAN method for surcharging
+   SolverMethod    = PICARD;           // Use Picard iterations for DW
+   Relaxation      = FIXED_RELAXATION; // Use constant under-relaxation
+   StepClasses     = 1;                // All links use the routing step
    CrownCutoff     = 0.96;             // Fractional pipe crown cutoff 
    AllowPonding    = FALSE;            // No ponding at nodes
    InertDamping    = PARTIAL_DAMPING;  // Partial inertial damping
@@ -872,7 +986,19 @@ void setDefaults()
    HeadTol         = 0.0;              // Force use of default head tolerance
    SysFlowTol      = 0.05;             // System flow tolerance for steady state
    LatFlowTol      = 0.05;             // Lateral flow tolerance for steady state
+   GeometryTol     = 0.0;              // Use exact cross section geometry
+   TransectTol     = 0.0;              // Use uniform transect geometry tables
    NumThreads      = 1;                // Number of parallel threads to use
+   ParallelNodeFlows = FALSE;          // Accumulate node flows serially
+   SkipDormant     = FALSE;            // Route flow through entire network
+   Deterministic   = FALSE;            // Allow any order of parallel sums
+   LoadBalancing   = FALSE;            // Split conduits evenly by count
+   DepthCurves     = FALSE;            // Compute normal & critical depths
+   InletCurves     = FALSE;            // Compute inlet capture exactly
+   FrictionCurves  = FALSE;            // Compute friction factors exactly
+   CulvertCurves   = FALSE;            // Compute culvert inlet control exactly
+   SkipDrySubcatch = FALSE;            // Analyze every subcatchment each step
+   NetworkOrder    = INPUT_ORDER;      // Keep nodes & links in input order
    NumEvents       = 0;                // Number of detailed routing events
 
    // Deprecated options
@@ -1153,6 +1279,7 @@ void createObjects()
     for (j = 0; j < Nobjects[LINK]; j++)
     {
         Link[j].xsect.type   = -1;
+        Link[j].xsect.tables = NULL;
         Link[j].cLossInlet   = 0.0;
         Link[j].cLossOutlet  = 0.0;
         Link[j].cLossAvg     = 0.0;
@@ -1263,6 +1390,13 @@ void deleteObjects()
 
     // --- delete cross section transects
     transect_delete();
+    xsect_deleteTables();
+    if ( Link ) for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        link_deleteDepthCurves(j);
+        forcemain_deleteFricCurve(j);
+        culvert_deleteCurve(j);
+    }
 
     // --- delete street and inlet design objects
     street_delete();
@@ -1274,6 +1408,9 @@ void deleteObjects()
     // --- delete LIDs
     lid_delete();
 
+    // --- delete subcatchment runon schedule
+    subcatch_deleteRunonSchedule();
+
     // --- now free each major category of object
     FREE(Gage);
     FREE(Subcatch);
@@ -19,6 +19,9 @@
 //   - Rainfall climate adjustment implemented.
 //   Build 5.1.014:
 //   - Fixes bug related to isUsed property of a unit hydrograph's rain gage.
+//   Build 5.2.4:
+//   - Nodes saved to a binary RDII file by their input order position so
+//     that the file can be reused with any NETWORK_ORDER option.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -580,10 +583,14 @@ int readRdiiFileHeader()
 
     // --- read indexes of RDII nodes
     if ( feof(Frdii.file) ) return ERR_RDII_FILE_FORMAT;
+    //     (saved by their position in the input file)
     fread(RdiiNodeIndex, sizeof(INT4), NumRdiiNodes, Frdii.file);
     for ( i=0; i<NumRdiiNodes; i++ )
     {
         j = RdiiNodeIndex[i];
+        if ( j < 0 || j >= Nobjects[NODE] ) return ERR_RDII_FILE_FORMAT;
+        j = reorder_getIndex(NODE, j);
+        RdiiNodeIndex[i] = j;
         if ( Node[j].rdiiInflow == NULL ) return ERR_RDII_FILE_FORMAT;
     }
     if ( feof(Frdii.file) ) return ERR_RDII_FILE_FORMAT;
@@ -1133,6 +1140,7 @@ int openNewRdiiFile()
 //
 {
     int j;                             // node index
+    int n;                             // input order position of node
 
     // --- create a temporary file name if scratch file being used
     if ( Frdii.mode == SCRATCH_FILE ) getTempFileName(Frdii.name);
@@ -1148,12 +1156,16 @@ int openNewRdiiFile()
     fwrite(FileStamp, sizeof(char), strlen(FileStamp), Frdii.file);
 
     // --- initialize the contents of the file with RDII time step (sec),
-    //     number of RDII nodes, and index of each node
+    //     number of RDII nodes, and input order position of each node
     fwrite(&RdiiStep, sizeof(INT4), 1, Frdii.file);
     fwrite(&NumRdiiNodes, sizeof(INT4), 1, Frdii.file);
     for (j=0; j<Nobjects[NODE]; j++)
     {
-        if ( Node[j].rdiiInflow ) fwrite(&j, sizeof(INT4), 1, Frdii.file);
+        if ( Node[j].rdiiInflow )
+        {
+            n = reorder_getInputIndex(NODE, j);
+            fwrite(&n, sizeof(INT4), 1, Frdii.file);
+        }
     }
     return TRUE;
 }
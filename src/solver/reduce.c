@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+//   reduce.c
+//
+//   Fixed-order parallel reductions.
+//
+//   Date:     07/13/23  (Build 5.2.4)
+//
+//   The terms being summed are split into blocks of a fixed size. Each
+//   block is summed serially by whichever thread it is assigned to and
+//   the block sums are then combined by a pairwise tree. Since neither
+//   the blocks nor the tree depend on the number of threads, the result
+//   is the same bit for bit no matter how many threads are used.
+//
+//   The caller supplies the work array that holds the block sums so that
+//   a reduction made at every iteration does not allocate memory.
+//
+//   Any reduction whose result must be reproducible across thread counts
+//   (e.g., in dynwave.c, massbal.c or stats.c) should be made with these
+//   functions rather than with an OpenMP reduction clause.
+//-----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include "reduce.h"
+
+#define BLOCKSIZE 256     // number of terms summed serially in a block
+
+//-----------------------------------------------------------------------------
+//    Local functions
+//-----------------------------------------------------------------------------
+static double reduce(double x[], double y[], int n, double blockSum[],
+                     int nThreads);
+static double sumBlock(double x[], double y[], int n, int b);
+static double sumTree(double blockSum[], double x[], double y[], int n,
+                      int first, int last);
+
+//=============================================================================
+
+int reduce_getBlockCount(int n)
+//
+//  Input:   n = number of values
+//  Output:  returns number of blocks the values are split into
+//  Purpose: finds the size of the block sum array used by a reduction.
+//
+{
+    if ( n <= 0 ) return 0;
+    return (n + BLOCKSIZE - 1) / BLOCKSIZE;
+}
+
+//=============================================================================
+
+double reduce_sum(double x[], int n, double blockSum[], int nThreads)
+//
+//  Input:   x = array of values
+//           n = number of values
+//           blockSum = work array of reduce_getBlockCount(n) values (or NULL)
+//           nThreads = number of threads to use
+//  Output:  returns sum of the values in x
+//  Purpose: sums an array using a fixed-order reduction.
+//
+{
+    return reduce(x, NULL, n, blockSum, nThreads);
+}
+
+//=============================================================================
+
+double reduce_dot(double x[], double y[], int n, double blockSum[],
+                  int nThreads)
+//
+//  Input:   x, y = arrays of values
+//           n = number of values
+//           blockSum = work array of reduce_getBlockCount(n) values (or NULL)
+//           nThreads = number of threads to use
+//  Output:  returns dot product of x and y
+//  Purpose: finds the dot product of two arrays using a fixed-order
+//           reduction.
+//
+{
+    return reduce(x, y, n, blockSum, nThreads);
+}
+
+//=============================================================================
+
+double reduce(double x[], double y[], int n, double blockSum[], int nThreads)
+//
+//  Input:   x = array of values
+//           y = array of multipliers (or NULL)
+//           n = number of values
+//           blockSum = work array for the block sums (or NULL)
+//           nThreads = number of threads to use
+//  Output:  returns sum of x (or of x*y)
+//  Purpose: sums the terms in blocks and combines the block sums
+//           with a pairwise tree.
+//
+{
+    int    b;
+    int    nBlocks = reduce_getBlockCount(n);
+
+    if ( n <= 0 ) return 0.0;
+
+    // --- sum each block in parallel (without a work array the blocks
+    //     are summed serially as the tree is traversed)
+    if ( nThreads <= 1 || nBlocks <= 1 ) blockSum = NULL;
+    if ( blockSum )
+    {
+#pragma omp parallel num_threads(nThreads)
+{
+        #pragma omp for
+        for ( b = 0; b < nBlocks; b++ ) blockSum[b] = sumBlock(x, y, n, b);
+}
+    }
+
+    // --- combine the block sums
+    return sumTree(blockSum, x, y, n, 0, nBlocks - 1);
+}
+
+//=============================================================================
+
+double sumBlock(double x[], double y[], int n, int b)
+//
+//  Input:   x = array of values
+//           y = array of multipliers (or NULL)
+//           n = number of values
+//           b = block index
+//  Output:  returns sum of the terms in block b
+//  Purpose: sums the terms of a single block serially.
+//
+{
+    int    i;
+    int    i2 = (b + 1) * BLOCKSIZE;
+    double s = 0.0;
+
+    if ( i2 > n ) i2 = n;
+    if ( y == NULL ) for ( i = b * BLOCKSIZE; i < i2; i++ ) s += x[i];
+    else             for ( i = b * BLOCKSIZE; i < i2; i++ ) s += x[i] * y[i];
+    return s;
+}
+
+//=============================================================================
+
+double sumTree(double blockSum[], double x[], double y[], int n,
+               int first, int last)
+//
+//  Input:   blockSum = array of block sums (or NULL)
+//           x, y, n  = terms being summed
+//           first, last = range of blocks to combine
+//  Output:  returns sum of blocks first through last
+//  Purpose: combines block sums pairwise.
+//
+{
+    int mid;
+    if ( first == last )
+    {
+        if ( blockSum ) return blockSum[first];
+        return sumBlock(x, y, n, first);
+    }
+    mid = (first + last) / 2;
+    return sumTree(blockSum, x, y, n, first, mid) +
+           sumTree(blockSum, x, y, n, mid + 1, last);
+}
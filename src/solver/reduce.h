@@ -0,0 +1,20 @@
+//-----------------------------------------------------------------------------
+//  reduce.h
+//
+//  Header file for the fixed-order reductions contained in reduce.c
+//
+//-----------------------------------------------------------------------------
+
+#ifndef REDUCE_H
+#define REDUCE_H
+
+
+// functions that sum arrays in an order that does not depend on the
+// number of threads used
+int    reduce_getBlockCount(int n);
+double reduce_sum(double x[], int n, double blockSum[], int nThreads);
+double reduce_dot(double x[], double y[], int n, double blockSum[],
+                  int nThreads);
+
+
+#endif //REDUCE_H
@@ -0,0 +1,390 @@
+//-----------------------------------------------------------------------------
+//   reorder.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.2
+//   Date:     06/12/23   (Build 5.2.4)
+//
+//   Locality-aware renumbering of conveyance network nodes and links.
+//
+//   When the NETWORK_ORDER option is set to RCM the Node and Link arrays
+//   are permuted, once the project has been validated, into reverse
+//   Cuthill-McKee order grown from the system's outfalls. Nodes that are
+//   hydraulically close then sit close together in memory, as do the links
+//   that connect them, which improves cache reuse in the routing loops.
+//
+//   All stored cross-references to node and link indexes are remapped and
+//   the ID hash tables are rebuilt, so the rest of the program works with
+//   the new indexes. Anything that reports or exchanges objects by position
+//   (output file, report tables, hot start & interface files, and the
+//   toolkit API) converts between positions and indexes with
+//   reorder_getIndex() and reorder_getInputIndex() so that objects still
+//   appear in the order they were listed in the input file.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdlib.h>
+#include <string.h>
+#include "headers.h"
+#include "lid.h"
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static int* NodeIndex;       // current index of each node in input order
+static int* NodeInput;       // input order position of each current node
+static int* LinkIndex;       // current index of each link in input order
+static int* LinkInput;       // input order position of each current link
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  reorder_network       (called by project_validate)
+//  reorder_delete        (called by project_close)
+//  reorder_getIndex
+//  reorder_getInputIndex
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int  findNodeOrder(int newNode[]);
+static void findLinkOrder(int newNode[], int newLink[]);
+static int  permuteNodes(int newNode[]);
+static int  permuteLinks(int newLink[]);
+static void remapReferences(int newNode[], int newLink[]);
+
+//=============================================================================
+
+void reorder_network()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: renumbers nodes and links in the order selected by the
+//           NETWORK_ORDER option.
+//
+{
+    int i;
+
+    NodeIndex = NULL;
+    NodeInput = NULL;
+    LinkIndex = NULL;
+    LinkInput = NULL;
+    if ( NetworkOrder == INPUT_ORDER || ErrorCode ) return;
+    if ( Nobjects[NODE] == 0 ) return;
+
+    // --- allocate index maps
+    NodeIndex = (int *) calloc(Nobjects[NODE], sizeof(int));
+    NodeInput = (int *) calloc(Nobjects[NODE], sizeof(int));
+    LinkIndex = (int *) calloc(Nobjects[LINK] + 1, sizeof(int));
+    LinkInput = (int *) calloc(Nobjects[LINK] + 1, sizeof(int));
+    if ( !NodeIndex || !NodeInput || !LinkIndex || !LinkInput )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        reorder_delete();
+        return;
+    }
+
+    // --- find the new position of each node and link
+    if ( !findNodeOrder(NodeIndex) )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        reorder_delete();
+        return;
+    }
+    findLinkOrder(NodeIndex, LinkIndex);
+
+    // --- move node & link data to their new positions
+    if ( !permuteNodes(NodeIndex) || !permuteLinks(LinkIndex) )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        reorder_delete();
+        return;
+    }
+    remapReferences(NodeIndex, LinkIndex);
+    project_reindexObjects(NODE);
+    project_reindexObjects(LINK);
+
+    // --- save inverse maps
+    for (i = 0; i < Nobjects[NODE]; i++) NodeInput[NodeIndex[i]] = i;
+    for (i = 0; i < Nobjects[LINK]; i++) LinkInput[LinkIndex[i]] = i;
+}
+
+//=============================================================================
+
+void reorder_delete()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees memory used by the node & link index maps.
+//
+{
+    FREE(NodeIndex);
+    FREE(NodeInput);
+    FREE(LinkIndex);
+    FREE(LinkInput);
+}
+
+//=============================================================================
+
+int reorder_getIndex(int type, int i)
+//
+//  Input:   type = object type
+//           i = object's position in the input file
+//  Output:  returns the object's current index
+//  Purpose: converts an input order position into an object index.
+//
+{
+    if ( type == NODE && NodeIndex ) return NodeIndex[i];
+    if ( type == LINK && LinkIndex ) return LinkIndex[i];
+    return i;
+}
+
+//=============================================================================
+
+int reorder_getInputIndex(int type, int j)
+//
+//  Input:   type = object type
+//           j = object's current index
+//  Output:  returns the object's position in the input file
+//  Purpose: converts an object index into its input order position.
+//
+{
+    if ( type == NODE && NodeInput ) return NodeInput[j];
+    if ( type == LINK && LinkInput ) return LinkInput[j];
+    return j;
+}
+
+//=============================================================================
+
+int findNodeOrder(int newNode[])
+//
+//  Input:   none
+//  Output:  newNode = new index of each node;
+//           returns FALSE if out of memory
+//  Purpose: finds a reverse Cuthill-McKee ordering of the nodes that starts
+//           from each outfall in turn.
+//
+{
+    int  nNodes = Nobjects[NODE];
+    int  nLinks = Nobjects[LINK];
+    int  i, j, k, m, n, first, last, root, pass;
+    int* degree = (int *) calloc(nNodes, sizeof(int));
+    int* start  = (int *) calloc(nNodes + 1, sizeof(int));
+    int* adj    = (int *) calloc(2 * nLinks + 1, sizeof(int));
+    int* queue  = (int *) calloc(nNodes, sizeof(int));
+    char* visited = (char *) calloc(nNodes, sizeof(char));
+
+    if ( !degree || !start || !adj || !queue || !visited )
+    {
+        FREE(degree);
+        FREE(start);
+        FREE(adj);
+        FREE(queue);
+        FREE(visited);
+        return FALSE;
+    }
+
+    // --- build undirected node adjacency list
+    for (j = 0; j < nLinks; j++)
+    {
+        degree[Link[j].node1]++;
+        degree[Link[j].node2]++;
+    }
+    for (i = 0; i < nNodes; i++) start[i+1] = start[i] + degree[i];
+    for (i = 0; i < nNodes; i++) queue[i] = start[i];
+    for (j = 0; j < nLinks; j++)
+    {
+        adj[queue[Link[j].node1]++] = Link[j].node2;
+        adj[queue[Link[j].node2]++] = Link[j].node1;
+    }
+
+    // --- sort each node's neighbors by increasing degree
+    //     (insertion sort; node degrees are small)
+    for (i = 0; i < nNodes; i++)
+    {
+        for (k = start[i] + 1; k < start[i+1]; k++)
+        {
+            n = adj[k];
+            m = k - 1;
+            while ( m >= start[i] && (degree[adj[m]] > degree[n] ||
+                   (degree[adj[m]] == degree[n] && adj[m] > n)) )
+            {
+                adj[m+1] = adj[m];
+                m--;
+            }
+            adj[m+1] = n;
+        }
+    }
+
+    // --- breadth-first search from each outfall in turn, then from the
+    //     first node of any component that has no outfall
+    last = 0;
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (root = 0; root < nNodes; root++)
+        {
+            if ( visited[root] ) continue;
+            if ( pass == 0 && Node[root].type != OUTFALL ) continue;
+            first = last;
+            queue[last++] = root;
+            visited[root] = TRUE;
+            while ( first < last )
+            {
+                i = queue[first++];
+                for (k = start[i]; k < start[i+1]; k++)
+                {
+                    n = adj[k];
+                    if ( visited[n] ) continue;
+                    visited[n] = TRUE;
+                    queue[last++] = n;
+                }
+            }
+        }
+    }
+
+    // --- reverse the visiting order so that headwater nodes come first
+    //     and outfalls last
+    for (k = 0; k < nNodes; k++) newNode[queue[k]] = nNodes - 1 - k;
+
+    FREE(degree);
+    FREE(start);
+    FREE(adj);
+    FREE(queue);
+    FREE(visited);
+    return TRUE;
+}
+
+//=============================================================================
+
+void findLinkOrder(int newNode[], int newLink[])
+//
+//  Input:   newNode = new index of each node
+//  Output:  newLink = new index of each link
+//  Purpose: orders links by the new index of their lower, then higher
+//           numbered end node.
+//
+{
+    int  nNodes = Nobjects[NODE];
+    int  nLinks = Nobjects[LINK];
+    int  i, j, n1, n2;
+    int* count = (int *) calloc(nNodes + 1, sizeof(int));
+    int* byHigh = (int *) calloc(nLinks + 1, sizeof(int));
+
+    // --- fall back to input order if out of memory
+    if ( !count || !byHigh )
+    {
+        for (j = 0; j < nLinks; j++) newLink[j] = j;
+        FREE(count);
+        FREE(byHigh);
+        return;
+    }
+
+    // --- stable counting sort on higher numbered end node
+    for (j = 0; j < nLinks; j++)
+    {
+        n1 = newNode[Link[j].node1];
+        n2 = newNode[Link[j].node2];
+        count[MAX(n1, n2) + 1]++;
+    }
+    for (i = 0; i < nNodes; i++) count[i+1] += count[i];
+    for (j = 0; j < nLinks; j++)
+    {
+        n1 = newNode[Link[j].node1];
+        n2 = newNode[Link[j].node2];
+        byHigh[count[MAX(n1, n2)]++] = j;
+    }
+
+    // --- stable counting sort on lower numbered end node
+    memset(count, 0, (nNodes + 1) * sizeof(int));
+    for (j = 0; j < nLinks; j++)
+    {
+        n1 = newNode[Link[j].node1];
+        n2 = newNode[Link[j].node2];
+        count[MIN(n1, n2) + 1]++;
+    }
+    for (i = 0; i < nNodes; i++) count[i+1] += count[i];
+    for (i = 0; i < nLinks; i++)
+    {
+        j = byHigh[i];
+        n1 = newNode[Link[j].node1];
+        n2 = newNode[Link[j].node2];
+        newLink[j] = count[MIN(n1, n2)]++;
+    }
+    FREE(count);
+    FREE(byHigh);
+}
+
+//=============================================================================
+
+int permuteNodes(int newNode[])
+//
+//  Input:   newNode = new index of each node
+//  Output:  returns FALSE if out of memory
+//  Purpose: moves each node's data to its new position in the Node array.
+//
+{
+    int    i;
+    TNode* tmp = (TNode *) malloc(Nobjects[NODE] * sizeof(TNode));
+
+    if ( !tmp ) return FALSE;
+    for (i = 0; i < Nobjects[NODE]; i++) tmp[newNode[i]] = Node[i];
+    memcpy(Node, tmp, Nobjects[NODE] * sizeof(TNode));
+    free(tmp);
+    return TRUE;
+}
+
+//=============================================================================
+
+int permuteLinks(int newLink[])
+//
+//  Input:   newLink = new index of each link
+//  Output:  returns FALSE if out of memory
+//  Purpose: moves each link's data to its new position in the Link array.
+//
+{
+    int    j;
+    TLink* tmp;
+
+    if ( Nobjects[LINK] == 0 ) return TRUE;
+    tmp = (TLink *) malloc(Nobjects[LINK] * sizeof(TLink));
+    if ( !tmp ) return FALSE;
+    for (j = 0; j < Nobjects[LINK]; j++) tmp[newLink[j]] = Link[j];
+    memcpy(Link, tmp, Nobjects[LINK] * sizeof(TLink));
+    free(tmp);
+    return TRUE;
+}
+
+//=============================================================================
+
+void remapReferences(int newNode[], int newLink[])
+//
+//  Input:   newNode = new index of each node
+//           newLink = new index of each link
+//  Output:  none
+//  Purpose: updates all stored references to node and link indexes.
+//
+{
+    int     i, n;
+    TGroundwater* gw;
+
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        Link[i].node1 = newNode[Link[i].node1];
+        Link[i].node2 = newNode[Link[i].node2];
+    }
+    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    {
+        n = Subcatch[i].outNode;
+        if ( n >= 0 ) Subcatch[i].outNode = newNode[n];
+        gw = Subcatch[i].groundwater;
+        if ( gw && gw->node >= 0 ) gw->node = newNode[gw->node];
+    }
+    for (i = 0; i < Nnodes[DIVIDER]; i++)
+    {
+        n = Divider[i].link;
+        if ( n >= 0 ) Divider[i].link = newLink[n];
+    }
+    lid_remapNodes(newNode);
+    inlet_remapObjects(newNode, newLink);
+    controls_remapObjects(newNode, newLink);
+}
@@ -39,6 +39,16 @@
 //   - Support added for reporting most frequent non-converging links.
 //   - Support added for RptFlags.disabled flag.
 //   - Refactored report_readOptions().
+//   Build 5.2.4:
+//   - Support added for reporting busy & idle times of routing threads.
+//   - Support added for reporting accuracy of uniform geometry tables.
+//   - DEPTH_CURVES option reported.
+//   - TRANSECT_TOL option reported.
+//   - INLET_CURVES option reported.
+//   - FRICTION_CURVES option reported.
+//   - CULVERT_CURVES option reported.
+//   - SKIP_DRY_SUBCATCH option reported.
+//   - Newton trials that fell back to a Picard update reported.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -309,6 +319,12 @@ void report_writeOptions()
     if (RouteModel == DW)
     fprintf(Frpt.file, "\n  Surcharge Method ......... %s",
         SurchargeWords[SurchargeMethod]);
+    if (RouteModel == DW && SolverMethod != PICARD)
+    fprintf(Frpt.file, "\n  Solver Method ............ %s",
+        SolverWords[SolverMethod]);
+    if (RouteModel == DW && Relaxation != FIXED_RELAXATION)
+    fprintf(Frpt.file, "\n  Relaxation Method ........ %s",
+        RelaxationWords[Relaxation]);
 
     datetime_dateToStr(StartDate, str);
     fprintf(Frpt.file, "\n  Starting Date ............ %s", str);
@@ -327,17 +343,45 @@ void report_writeOptions()
         fprintf(Frpt.file, "\n  Wet Time Step ............ %s", str);
         datetime_timeToStr(datetime_encodeTime(0, 0, DryStep), str);
         fprintf(Frpt.file, "\n  Dry Time Step ............ %s", str);
+        if ( SkipDrySubcatch )
+            fprintf(Frpt.file, "\n  Skip Dry Subcatchments ... YES");
     }
     if ( Nobjects[LINK] > 0 )
     {
         fprintf(Frpt.file, "\n  Routing Time Step ........ %.2f sec", RouteStep);
+        if ( GeometryTol > 0.0 )
+            fprintf(Frpt.file, "\n  Geometry Tolerance ....... %g", GeometryTol);
+        if ( DepthCurves )
+            fprintf(Frpt.file, "\n  Depth Curves ............. YES");
+        if ( TransectTol > 0.0 )
+            fprintf(Frpt.file, "\n  Transect Tolerance ....... %g", TransectTol);
+        if ( InletCurves )
+            fprintf(Frpt.file, "\n  Inlet Curves ............. YES");
+        if ( FrictionCurves )
+            fprintf(Frpt.file, "\n  Friction Curves .......... YES");
+        if ( CulvertCurves )
+            fprintf(Frpt.file, "\n  Culvert Curves ........... YES");
         if ( RouteModel == DW )
         {
             fprintf(Frpt.file, "\n  Variable Time Step ....... ");
             if ( CourantFactor > 0.0 ) fprintf(Frpt.file, "YES");
             else                       fprintf(Frpt.file, "NO");
+            if ( CourantFactor > 0.0 && StepClasses > 1 )
+                fprintf(Frpt.file, "\n  Step Classes ............. %d",
+                    StepClasses);
             fprintf(Frpt.file, "\n  Maximum Trials ........... %d", MaxTrials);
             fprintf(Frpt.file, "\n  Number of Threads ........ %d", NumThreads);
+            if ( ParallelNodeFlows )
+                fprintf(Frpt.file, "\n  Parallel Node Flows ...... YES");
+            if ( SkipDormant )
+                fprintf(Frpt.file, "\n  Skip Dormant Regions ..... YES");
+            if ( Deterministic )
+                fprintf(Frpt.file, "\n  Deterministic ............ YES");
+            if ( LoadBalancing )
+                fprintf(Frpt.file, "\n  Load Balancing ........... YES");
+            if ( NetworkOrder != INPUT_ORDER )
+                fprintf(Frpt.file, "\n  Network Order ............ %s",
+                    NetworkOrderWords[NetworkOrder]);
             fprintf(Frpt.file, "\n  Head Tolerance ........... %.6f ",
                 HeadTol*UCF(LENGTH));
             if ( UnitSystem == US ) fprintf(Frpt.file, "ft");
@@ -1073,6 +1117,10 @@ void report_writeTimeStepStats(TTimeStepStats* timeStepStats)
     fprintf(Frpt.file,
         "\n  %% of Steps Not Converging   :  %7.2f",
         100.0 * (double)NonConvergeCount / timeStepCount);
+    if ( SolverMethod == NEWTON && timeStepStats->trialsCount > 0.0 )
+        fprintf(Frpt.file,
+        "\n  %% of Trials Using Picard    :  %7.2f",
+        100.0 * (double)PicardFallbackCount / timeStepStats->trialsCount);
 
     // --- write grouped frequency table of variable routing time steps
     if (RouteModel == DW && CourantFactor > 0.0)
@@ -1082,6 +1130,86 @@ void report_writeTimeStepStats(TTimeStepStats* timeStepStats)
 
 //=============================================================================
 
+void report_writeGeometryTables()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the size and interpolation error of the uniform cross
+//           section geometry tables used with the GEOMETRY_TOL option.
+//
+{
+    int    k, nTables;
+    int    nItems[N_GEOM_TABLES];
+    double maxError[N_GEOM_TABLES];
+    double exactFrac[N_GEOM_TABLES];
+    char*  names[] = {"Area v. Depth", "Hyd. Radius v. Depth",
+                      "Top Width v. Depth", "Depth v. Area",
+                      "Section Factor v. Area", "Area v. Section Factor"};
+
+    if ( GeometryTol <= 0.0 ) return;
+    nTables = xsect_getTableStats(nItems, maxError, exactFrac);
+    if ( nTables == 0 ) return;
+
+    WRITE("");
+    WRITE("*****************************");
+    WRITE("Cross Section Geometry Tables");
+    WRITE("*****************************");
+    fprintf(Frpt.file,
+    "\n  %d distinct cross sections tabulated for an error tolerance of %g."
+    "\n  Errors are at interval mid-points as a fraction of full values."
+    "\n  Intervals that cannot meet the tolerance use exact functions.",
+    nTables, GeometryTol);
+    WRITE("");
+    fprintf(Frpt.file,
+    "\n  ---------------------------------------------------------------"
+    "\n                             Max. Table        Max.   Max. Pcnt."
+    "\n  Table                           Items       Error       Exact"
+    "\n  ---------------------------------------------------------------");
+    for ( k = 0; k < N_GEOM_TABLES; k++ )
+    {
+        fprintf(Frpt.file, "\n  %-24s %10d  %10.6f  %10.2f",
+            names[k], nItems[k], maxError[k], 100.0 * exactFrac[k]);
+    }
+    WRITE("");
+}
+
+//=============================================================================
+
+void report_writeThreadTimes()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes time each thread spent finding conduit flows and
+//           waiting on other threads when the LOAD_BALANCING option is used.
+//
+{
+    int    k;
+    double busyTime, idleTime, total;
+
+    if ( RouteModel != DW || !dynwave_getThreadTimes(0, &busyTime, &idleTime) )
+        return;
+
+    WRITE("");
+    WRITE("*********************");
+    WRITE("Conduit Thread Timing");
+    WRITE("*********************");
+    fprintf(Frpt.file,
+    "\n  -----------------------------------------"
+    "\n                 Busy         Idle    Idle"
+    "\n  Thread     Time (sec)   Time (sec)     %%"
+    "\n  -----------------------------------------");
+    for ( k = 0; dynwave_getThreadTimes(k, &busyTime, &idleTime); k++ )
+    {
+        total = busyTime + idleTime;
+        if ( total > 0.0 ) total = 100.0 * idleTime / total;
+        fprintf(Frpt.file, "\n  %6d  %13.3f  %11.3f  %6.2f",
+            k + 1, busyTime, idleTime, total);
+    }
+    WRITE("");
+}
+
+//=============================================================================
+
 void report_RouteStepFreq(TTimeStepStats* timeStepStats)
 //
 //  Input:   timeStepStats = routing time step statistics
@@ -1265,7 +1393,7 @@ void report_Nodes()
 //  Purpose: writes results for selected nodes to report file.
 //
 {
-    int      j, p, k;
+    int      i, j, p, k;
     int      period;
     DateTime days;
     char     theDate[DATE_STR_SIZE];
@@ -1276,8 +1404,9 @@ void report_Nodes()
     WRITE("************************");
     WRITE("Node Time Series Results");
     WRITE("************************");
-    for (j = 0; j < Nobjects[NODE]; j++)
+    for (i = 0; i < Nobjects[NODE]; i++)
     {
+        j = reorder_getIndex(NODE, i);
         k = Node[j].rptFlag - 1;
         if ( k >= 0 )
         {
@@ -1343,7 +1472,7 @@ void report_Links()
 //  Purpose: writes results for selected links to report file.
 //
 {
-    int      j, p, k;
+    int      i, j, p, k;
     int      period;
     DateTime days;
     char     theDate[DATE_STR_SIZE];
@@ -1354,8 +1483,9 @@ void report_Links()
     WRITE("************************");
     WRITE("Link Time Series Results");
     WRITE("************************");
-    for (j = 0; j < Nobjects[LINK]; j++)
+    for (i = 0; i < Nobjects[LINK]; i++)
     {
+        j = reorder_getIndex(LINK, i);
         k = Link[j].rptFlag - 1;
         if ( k >= 0 )
         {
@@ -37,6 +37,9 @@
 //   Build 5.2.0:
 //   - Support added for street flow capture and sewer backflow thru inlets.
 //   - Shell sort replaces insertion sort for sorting Event array.
+//   Build 5.2.4:
+//   - Infiltration factor no longer set here (exfiltration now passes the
+//     global conductivity adjustment factor to grnampt_getInfil).
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -320,10 +323,6 @@ void  initSystemInflows()
         for (j=0; j<Nobjects[LINK]; j++) link_setOldQualState(j);
     }
 
-    // --- set infiltration factor for storage unit seepage
-    //     (-1 argument indicates global factor is used)
-    infil_setInfilFactor(-1);
-
     // --- initialize lateral inflows at nodes
     for (j = 0; j < Nobjects[NODE]; j++)
     {
@@ -30,6 +30,14 @@
 //   - Support added for saving rainfall amounts in previous 48 hours.
 //   Build 5.2.2:
 //   - Fixed possible use of canSweep in runoff_execute() with no assigned value. 
+//   Build 5.2.4:
+//   - Subcatchment runoff and washoff computed in parallel, with each thread
+//     using its own runoff context.
+//   - Runon from upstream subcatchments found in parallel.
+//   - SKIP_DRY_SUBCATCH option added to defer the analysis of dry
+//     subcatchments until they become wet.
+//   - Each runoff context given its own ODE solver so that groundwater and
+//     ponded depths are integrated in parallel.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -39,6 +47,13 @@
 #include "headers.h"
 #include "odesolve.h"
 
+// Protect against lack of compiler support for OpenMP
+#if defined(_OPENMP)
+  #include <omp.h>
+#else
+  static int omp_get_thread_num(void) { return 0; }
+#endif
+
 //-----------------------------------------------------------------------------
 // Shared variables
 //-----------------------------------------------------------------------------
@@ -49,12 +64,13 @@ static int   Nsteps;                   // number of runoff time steps taken
 static int   MaxSteps;                 // final number of runoff time steps
 static long  MaxStepsPos;              // position in Runoff interface file
                                        //    where MaxSteps is saved
+static TRunoffCtx* RunoffCtx;          // runoff context for each thread
+static int*  ActiveSubcatch;           // subcatchments analyzed each step
 
 //-----------------------------------------------------------------------------
 //  Exportable variables 
 //-----------------------------------------------------------------------------
-char    HasWetLids;  // TRUE if any LIDs are wet (used in lidproc.c)
-double* OutflowLoad; // exported pollutant mass load (used in surfqual.c)
+char    HasWetLids;  // TRUE if any LIDs are wet (used in lid.c)
 
 //-----------------------------------------------------------------------------
 //  Imported variables
@@ -76,6 +92,9 @@ static void   runoff_initFile(void);
 static void   runoff_readFromFile(void);
 static void   runoff_saveToFile(float tStep);
 static void   runoff_getOutfallRunon(double tStep);
+static int    runoff_createContexts(void);
+static void   runoff_deleteContexts(void);
+static void   endDryTime(int j);
 
 //=============================================================================
 
@@ -86,22 +105,31 @@ int runoff_open()
 //  Purpose: opens the runoff analyzer.
 //
 {
+    int i;
+
     IsRaining = FALSE;
     HasRunoff = FALSE;
     HasSnow = FALSE;
     Nsteps = 0;
 
-    // --- open the Ordinary Differential Equation solver
-    if ( !odesolve_open(MAXODES) ) report_writeErrorMsg(ERR_ODE_SOLVER, "");
+    // --- allocate a runoff context (with its pollutant runoff loads)
+    //     for each thread
+    if ( !runoff_createContexts() ) report_writeErrorMsg(ERR_MEMORY, "");
 
-    // --- allocate memory for pollutant runoff loads
-    OutflowLoad = NULL;
-    if ( Nobjects[POLLUT] > 0 )
+    // --- open an Ordinary Differential Equation solver for each thread
+    else for (i = 0; i < NumThreads; i++)
     {
-        OutflowLoad = (double *) calloc(Nobjects[POLLUT], sizeof(double));
-        if ( !OutflowLoad ) report_writeErrorMsg(ERR_MEMORY, "");
+        if ( !odesolve_open(&RunoffCtx[i].odeSolver, MAXODES) )
+        {
+            report_writeErrorMsg(ERR_ODE_SOLVER, "");
+            break;
+        }
     }
 
+    // --- allocate a list of the subcatchments analyzed at each time step
+    ActiveSubcatch = (int *) calloc(Nobjects[SUBCATCH] + 1, sizeof(int));
+    if ( ActiveSubcatch == NULL ) report_writeErrorMsg(ERR_MEMORY, "");
+
     // --- see if a runoff interface file should be opened
     switch ( Frunoff.mode )
     {
@@ -128,11 +156,9 @@ void runoff_close()
 //  Purpose: closes the runoff analyzer.
 //
 {
-    // --- close the ODE solver
-    odesolve_close();
-
-    // --- free memory for pollutant runoff loads
-    FREE(OutflowLoad);
+    // --- free memory for runoff contexts (and their ODE solvers)
+    runoff_deleteContexts();
+    FREE(ActiveSubcatch);
 
     // --- close runoff interface file if in use
     if ( Frunoff.file )
@@ -166,6 +192,12 @@ void runoff_execute()
     double   runoff;                   // subcatchment runoff (ft/sec)
     DateTime currentDate;              // current date/time 
     char     canSweep;                 // TRUE if street sweeping can occur
+    int      hasRunoff;                // TRUE if any subcatchment has runoff
+    int      hasSnow;                  // TRUE if any subcatchment has snow
+    int      useLogs;                  // TRUE if mass balance updates logged
+    int      n;                        // active subcatchment index
+    int      nActive;                  // number of active subcatchments
+    TRunoffCtx* ctx;                   // runoff context of current thread
 
     if ( ErrorCode ) return;
 
@@ -175,6 +207,14 @@ void runoff_execute()
     // --- convert elapsed runoff time in milliseconds to a calendar date
     currentDate = getDateTime(NewRunoffTime);
 
+    // --- analyze the dry time deferred for dry subcatchments before
+    //     a new month changes their infiltration recovery rates
+    if ( SkipDrySubcatch && datetime_monthOfYear(currentDate) !=
+         datetime_monthOfYear(getDateTime(OldRunoffTime)) )
+    {
+        for (j = 0; j < Nobjects[SUBCATCH]; j++) endDryTime(j);
+    }
+
     // --- update climatological conditions
     climate_setState(currentDate);
 
@@ -242,29 +282,72 @@ void runoff_execute()
     // --- determine any runon from drainage system outfall nodes
     if ( oldRunoffStep > 0.0 ) runoff_getOutfallRunon(oldRunoffStep);
 
-    // --- determine runon from upstream subcatchments, and implement snow removal
+    // --- determine runon from upstream subcatchments
+    //     (each subcatchment gathers its own runon so they can be
+    //     processed in parallel)
+#pragma omp parallel num_threads(NumThreads)
+{
+    #pragma omp for
+    for (j = 0; j < Nobjects[SUBCATCH]; j++) subcatch_getRunon(j);
+}
+
+    // --- implement snow removal
+    if ( !IgnoreSnowmelt )
+    {
+        for (j = 0; j < Nobjects[SUBCATCH]; j++)
+        {
+            if ( Subcatch[j].area == 0.0 ) continue;
+            snow_plowSnow(j, runoffStep);
+        }
+    }
+    
+    // --- list the subcatchments to be analyzed, deferring the analysis
+    //     of dry subcatchments until they become wet (or get swept)
+    nActive = 0;
     for (j = 0; j < Nobjects[SUBCATCH]; j++)
     {
         if ( Subcatch[j].area == 0.0 ) continue;
-        subcatch_getRunon(j);
-        if ( !IgnoreSnowmelt ) snow_plowSnow(j, runoffStep);
+        if ( SkipDrySubcatch && subcatch_isDry(j) )
+        {
+            subcatch_addDryTime(j, runoffStep);
+            if ( !IgnoreQuality && canSweep &&
+                 surfqual_isSweepDue(j, currentDate) )
+            {
+                endDryTime(j);
+                surfqual_sweepBuildup(j, currentDate);
+            }
+            continue;
+        }
+        ActiveSubcatch[nActive] = j;
+        nActive++;
     }
-    
+
     // --- determine runoff and pollutant buildup/washoff in each subcatchment
-    HasSnow = FALSE;
-    HasRunoff = FALSE;
-    HasWetLids = FALSE;
-    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    //     (mass balance updates are logged by each thread and then added
+    //     to the system totals in subcatchment order)
+    hasSnow = FALSE;
+    hasRunoff = FALSE;
+    for (j = 0; j < NumThreads; j++) RunoffCtx[j].hasWetLids = FALSE;
+    useLogs = (NumThreads > 1) && massbal_beginRunoffLogs(NumThreads);
+    if ( ErrorCode ) return;
+#pragma omp parallel num_threads(NumThreads) private(ctx, runoff, j)
+{
+    ctx = &RunoffCtx[omp_get_thread_num()];
+    #pragma omp for schedule(static) reduction(||:hasRunoff, hasSnow)
+    for (n = 0; n < nActive; n++)
     {
+        // --- analyze any dry time deferred for the subcatchment
+        j = ActiveSubcatch[n];
+        if ( Subcatch[j].dryTime > 0.0 ) endDryTime(j);
+
         // --- find total runoff rate (in ft/sec) over the subcatchment
         //     (the amount that actually leaves the subcatchment (in cfs)
         //     is also computed and is stored in Subcatch[j].newRunoff)
-        if ( Subcatch[j].area == 0.0 ) continue;
-        runoff = subcatch_getRunoff(j, runoffStep);
+        runoff = subcatch_getRunoff(j, runoffStep, ctx);
 
         // --- update state of study area surfaces
-        if ( runoff > 0.0 ) HasRunoff = TRUE;
-        if ( Subcatch[j].newSnowDepth > 0.0 ) HasSnow = TRUE;
+        if ( runoff > 0.0 ) hasRunoff = TRUE;
+        if ( Subcatch[j].newSnowDepth > 0.0 ) hasSnow = TRUE;
 
         // --- skip pollutant buildup/washoff if quality ignored
         if ( IgnoreQuality ) continue;
@@ -277,7 +360,16 @@ void runoff_execute()
             surfqual_sweepBuildup(j, currentDate);
 
         // --- compute pollutant washoff 
-        surfqual_getWashoff(j, runoff, runoffStep);
+        surfqual_getWashoff(j, runoff, runoffStep, ctx);
+    }
+}
+    if ( useLogs ) massbal_endRunoffLogs();
+    HasSnow = (char)hasSnow;
+    HasRunoff = (char)hasRunoff;
+    HasWetLids = FALSE;
+    for (j = 0; j < NumThreads; j++)
+    {
+        if ( RunoffCtx[j].hasWetLids ) HasWetLids = TRUE;
     }
 
     // --- update tracking of system-wide max. runoff rate
@@ -292,6 +384,12 @@ void runoff_execute()
 
     // --- reset subcatchment runon to 0
     for (j = 0; j < Nobjects[SUBCATCH]; j++) Subcatch[j].runon = 0.0;
+
+    // --- analyze all deferred dry time at the end of the simulation
+    if ( SkipDrySubcatch && NewRunoffTime >= TotalDuration )
+    {
+        for (j = 0; j < Nobjects[SUBCATCH]; j++) endDryTime(j);
+    }
 }
 
 //=============================================================================
@@ -525,3 +623,62 @@ void runoff_getOutfallRunon(double tStep)
         }
     }
 }
+
+//=============================================================================
+
+void endDryTime(int j)
+//
+//  Input:   j = subcatchment index
+//  Output:  none
+//  Purpose: updates infiltration capacity and pollutant buildup of a
+//           subcatchment over the dry time deferred by the SKIP_DRY_SUBCATCH
+//           option.
+//
+{
+    double tDry = subcatch_endDryTime(j);
+    if ( tDry > 0.0 && !IgnoreQuality ) surfqual_getBuildup(j, tDry);
+}
+
+//=============================================================================
+
+int runoff_createContexts()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: allocates a runoff context for each thread used to compute
+//           subcatchment runoff.
+//
+{
+    int i;
+
+    RunoffCtx = (TRunoffCtx *) calloc(NumThreads, sizeof(TRunoffCtx));
+    if ( RunoffCtx == NULL ) return FALSE;
+    if ( Nobjects[POLLUT] == 0 ) return TRUE;
+    for (i = 0; i < NumThreads; i++)
+    {
+        RunoffCtx[i].outflowLoad = (double *) calloc(Nobjects[POLLUT],
+                                                     sizeof(double));
+        if ( RunoffCtx[i].outflowLoad == NULL ) return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void runoff_deleteContexts()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the runoff contexts used to compute subcatchment runoff.
+//
+{
+    int i;
+
+    if ( RunoffCtx == NULL ) return;
+    for (i = 0; i < NumThreads; i++)
+    {
+        FREE(RunoffCtx[i].outflowLoad);
+        odesolve_close(&RunoffCtx[i].odeSolver);
+    }
+    FREE(RunoffCtx);
+}
@@ -37,6 +37,8 @@
 //   - Support added for reporting most frequent non-converging nodes.
 //   - Support added for RptFlags.disabled option.
 //   - Fixed display of routing statistics report for RptFlags.flowStats = FALSE.
+//   Build 5.2.4:
+//   - Support added for reporting thread busy & idle times.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -356,6 +358,7 @@ void  stats_report()
             report_writeMaxFlowTurns(MaxFlowTurns, MAX_STATS);
             report_writeNonconvergedStats(MaxNonConverged, MAX_STATS);
             report_writeTimeStepStats(&TimeStepStats);
+            report_writeThreadTimes();
         }
     }
 
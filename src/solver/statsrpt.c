@@ -317,7 +317,7 @@ void writeNodeDepths()
 //  Purpose: writes simulation statistics for nodes to report file.
 //
 {
-    int j, days, hrs, mins;
+    int j, m, days, hrs, mins;
     if ( Nobjects[LINK] == 0 ) return;
 
     WRITE("");
@@ -337,8 +337,9 @@ void writeNodeDepths()
     fprintf(Frpt.file,
 "\n  ---------------------------------------------------------------------------------");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( m = 0; m < Nobjects[NODE]; m++ )
     {
+        j = reorder_getIndex(NODE, m);
         fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
         fprintf(Frpt.file, " %-9s ", NodeTypeWords[Node[j].type]);
         getElapsedTime(NodeStats[j].maxDepthDate, &days, &hrs, &mins);
@@ -360,7 +361,7 @@ void writeNodeFlows()
 //  Purpose: writes flow statistics for nodes to report file.
 //
 {
-    int j;
+    int j, m;
     int days1, hrs1, mins1;
 
     WRITE("");
@@ -380,8 +381,9 @@ void writeNodeFlows()
     fprintf(Frpt.file,
 "\n  -------------------------------------------------------------------------------------------------");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( m = 0; m < Nobjects[NODE]; m++ )
     {
+        j = reorder_getIndex(NODE, m);
         fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
         fprintf(Frpt.file, " %-9s", NodeTypeWords[Node[j].type]);
         getElapsedTime(NodeStats[j].maxInflowDate, &days1, &hrs1, &mins1);
@@ -405,7 +407,7 @@ void writeNodeFlows()
 
 void writeNodeSurcharge()
 {
-    int    j, n = 0;
+    int    j, m, n = 0;
     double t, d1, d2;
 
     WRITE("");
@@ -414,8 +416,9 @@ void writeNodeSurcharge()
     WRITE("**********************");
     WRITE("");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( m = 0; m < Nobjects[NODE]; m++ )
     {
+        j = reorder_getIndex(NODE, m);
         if ( Node[j].type == OUTFALL ) continue;
         if ( NodeStats[j].timeSurcharged == 0.0 ) continue;
         t = MAX(0.01, (NodeStats[j].timeSurcharged / 3600.0));
@@ -451,7 +454,7 @@ void writeNodeSurcharge()
 
 void writeNodeFlooding()
 {
-    int    j, n = 0;
+    int    j, m, n = 0;
     int    days, hrs, mins;
     double t;
 
@@ -461,8 +464,9 @@ void writeNodeFlooding()
     WRITE("*********************");
     WRITE("");
 
-    for ( j = 0; j < Nobjects[NODE]; j++ )
+    for ( m = 0; m < Nobjects[NODE]; m++ )
     {
+        j = reorder_getIndex(NODE, m);
         if ( Node[j].type == OUTFALL ) continue;
         if ( NodeStats[j].timeFlooded == 0.0 ) continue;
         t = MAX(0.01, (NodeStats[j].timeFlooded / 3600.0));
@@ -515,7 +519,7 @@ void writeStorageVolumes()
 //  Purpose: writes simulation statistics for storage units to report file.
 //
 {
-    int    j, k, days, hrs, mins;
+    int    j, m, k, days, hrs, mins;
     double avgVol, maxVol, pctAvgVol, pctMaxVol;
     double pctEvapLoss, pctSeepLoss;
 
@@ -539,8 +543,9 @@ void writeStorageVolumes()
         fprintf(Frpt.file,
 "\n  ------------------------------------------------------------------------------------------------");
 
-        for ( j = 0; j < Nobjects[NODE]; j++ )
+        for ( m = 0; m < Nobjects[NODE]; m++ )
         {
+            j = reorder_getIndex(NODE, m);
             if ( Node[j].type != STORAGE ) continue;
             k = Node[j].subIndex;
             fprintf(Frpt.file, "\n  %-20s", Node[j].ID);
@@ -583,7 +588,7 @@ void writeOutfallLoads()
 //
 {
     char    units[15];
-    int     i, j, k, p;
+    int     i, j, m, k, p;
     double  x;
     double  outfallCount, flowCount;
     double  flowSum, freqSum, volSum;
@@ -631,8 +636,9 @@ void writeOutfallLoads()
         for (p = 0; p < Nobjects[POLLUT]; p++) fprintf(Frpt.file, "--------------");
 
         // --- identify each outfall node
-        for (j=0; j<Nobjects[NODE]; j++)
+        for (m=0; m<Nobjects[NODE]; m++)
         {
+            j = reorder_getIndex(NODE, m);
             if ( Node[j].type != OUTFALL ) continue;
             k = Node[j].subIndex;
             flowCount = OutfallStats[k].totalPeriods;
@@ -698,7 +704,7 @@ void writeLinkFlows()
 //  Purpose: writes simulation statistics for links to report file.
 //
 {
-    int    j, k, days, hrs, mins;
+    int    j, m, k, days, hrs, mins;
     double v, fullDepth;
 
     if (Nobjects[LINK] == 0) return;
@@ -721,8 +727,9 @@ void writeLinkFlows()
     fprintf(Frpt.file,
         "\n  -----------------------------------------------------------------------------");
 
-    for (j = 0; j < Nobjects[LINK]; j++)
+    for (m = 0; m < Nobjects[LINK]; m++)
     {
+        j = reorder_getIndex(LINK, m);
         // --- print link ID
         k = Link[j].subIndex;
         fprintf(Frpt.file, "\n  %-20s", Link[j].ID);
@@ -785,7 +792,7 @@ void writeFlowClass()
 //  Purpose: writes flow classification for each conduit to report file.
 //
 {
-    int   i, j, k;
+    int   i, j, m, k;
     double totalSeconds = RoutingTimeSpan;
 
     if ( RouteModel != DW ) return;
@@ -800,8 +807,9 @@ void writeFlowClass()
 "\n                       /Actual         Up    Down  Sub   Sup   Up    Down  Norm  Inlet "
 "\n  Conduit               Length    Dry  Dry   Dry   Crit  Crit  Crit  Crit  Ltd   Ctrl  "
 "\n  -------------------------------------------------------------------------------------");
-    for ( j = 0; j < Nobjects[LINK]; j++ )
+    for ( m = 0; m < Nobjects[LINK]; m++ )
     {
+        j = reorder_getIndex(LINK, m);
         if ( Link[j].type != CONDUIT ) continue;
         if ( Link[j].xsect.type == DUMMY ) continue;
         k = Link[j].subIndex;
@@ -823,7 +831,7 @@ void writeFlowClass()
 
 void writeLinkSurcharge()
 {
-    int    i, j, n = 0;
+    int    i, j, m, n = 0;
     double t[5];
 
     WRITE("");
@@ -831,8 +839,9 @@ void writeLinkSurcharge()
     WRITE("Conduit Surcharge Summary");
     WRITE("*************************");
     WRITE("");
-    for ( j = 0; j < Nobjects[LINK]; j++ )
+    for ( m = 0; m < Nobjects[LINK]; m++ )
     {
+        j = reorder_getIndex(LINK, m);
         if ( Link[j].type != CONDUIT ||
              Link[j].xsect.type == DUMMY ) continue; 
         t[0] = LinkStats[j].timeSurcharged / 3600.0;
@@ -869,7 +878,7 @@ void writePumpFlows()
 //  Purpose: writes simulation statistics for pumps to report file.
 //
 {
-    int    j, k;
+    int    j, m, k;
     double avgFlow, pctUtilized, pctOffCurve1, pctOffCurve2,
            totalSeconds = RoutingTimeSpan;
 
@@ -889,8 +898,9 @@ void writePumpFlows()
 "\n  ---------------------------------------------------------------------------------------------------------",
         FlowUnitWords[FlowUnits], FlowUnitWords[FlowUnits],
         FlowUnitWords[FlowUnits], VolUnitsWords[UnitSystem]);
-    for ( j = 0; j < Nobjects[LINK]; j++ )
+    for ( m = 0; m < Nobjects[LINK]; m++ )
     {
+        j = reorder_getIndex(LINK, m);
         if ( Link[j].type != PUMP ) continue;
         k = Link[j].subIndex;
         fprintf(Frpt.file, "\n  %-20s", Link[j].ID);
@@ -918,7 +928,7 @@ void writePumpFlows()
 
 void writeLinkLoads()
 {
-    int i, j, p;
+    int i, j, m, p;
     double x;
     char  units[15];
     char  linkLine[] = "--------------------";
@@ -946,8 +956,9 @@ void writeLinkLoads()
     for (p = 0; p < Nobjects[POLLUT]; p++) fprintf(Frpt.file, "%s", pollutLine);
 
     // --- print the pollutant loadings carried by each link
-    for ( j = 0; j < Nobjects[LINK]; j++ )
+    for ( m = 0; m < Nobjects[LINK]; m++ )
     {
+        j = reorder_getIndex(LINK, m);
         fprintf(Frpt.file, "\n  %-20s", Link[j].ID);
         for (p = 0; p < Nobjects[POLLUT]; p++)
         {
@@ -37,6 +37,14 @@
 //   Build 5.1.015: 
 //   - Support added for multiple infiltration methods within a project.
 //   - Only pervious area depression storage receives monthly adjustment.
+//   Build 5.2.4:
+//   - Shared water balance volumes and subarea variables replaced with
+//     context structures so that runoff can be computed in parallel.
+//   - Runon schedule added so that each subcatchment collects its own runon
+//     from upstream subcatchments, allowing runon to be found in parallel.
+//   - Support added for deferring the analysis of dry subcatchments.
+//   - Ponded depths integrated with the ODE solver of the runoff context
+//     instead of within a critical section.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -54,28 +62,35 @@ const double MEXP      = 1.6666667;         // exponent in Manning Eq.
 const double ODETOL    = 0.0001;            // acceptable error for ODE solver
 
 //-----------------------------------------------------------------------------
-// Globally shared variables   
+// Local data types
 //-----------------------------------------------------------------------------
-// Volumes (ft3) for a subcatchment over a time step
-double     Vevap;         // evaporation
-double     Vpevap;        // pervious area evaporation
-double     Vinfil;        // non-LID infiltration
-double     Vinflow;       // non-LID precip + snowmelt + runon + ponded water
-double     Voutflow;      // non-LID runoff to subcatchment's outlet
-double     VlidIn;        // impervious area flow to LID units
-double     VlidInfil;     // infiltration from LID units
-double     VlidOut;       // surface outflow from LID units
-double     VlidDrain;     // drain outflow from LID units
-double     VlidReturn;    // LID outflow returned to pervious area
+// Subarea whose ponded depth is being updated
+typedef struct
+{
+    TSubarea*   subarea;          // subarea being analyzed
+    double      dStore;           // monthly adjusted depression storage (ft)
+    double      alpha;            // monthly adjusted runoff coeff.
+}   TSubareaCtx;
+
+// Runon path from one subcatchment to another (or to itself for flow
+// re-routed between its own subareas)
+typedef struct
+{
+    int         receiver;         // subcatchment receiving runon
+    int         source;           // subcatchment sending runon
+}   TRunonPath;
 
 //-----------------------------------------------------------------------------
 // Locally shared variables   
 //-----------------------------------------------------------------------------
-static  TSubarea* theSubarea;     // subarea to which getDdDt() is applied
-static  double    Dstore;         // monthly adjusted depression storage (ft)
-static  double    Alpha;          // monthly adjusted runoff coeff.
 static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 
+// Runon schedule: the subcatchments sending runon to subcatchment j are
+// RunonSources[RunonStart[j]] to RunonSources[RunonStart[j+1]-1], listed
+// in index order.
+static  int*  RunonStart;         // start of each subcatchment's sources
+static  int*  RunonSources;       // runon source subcatchments
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
 //-----------------------------------------------------------------------------
@@ -85,10 +100,15 @@ static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 //  subcatch_readInitBuildup   (called from parseLine in input.c)
 
 //  subcatch_validate          (called from project_validate)
+//  subcatch_createRunonSchedule (called from project_validate)
+//  subcatch_deleteRunonSchedule (called from deleteObjects in project.c)
 //  subcatch_initState         (called from project_init)
 
 //  subcatch_setOldState       (called from runoff_execute)
 //  subcatch_getRunon          (called from runoff_execute)
+//  subcatch_isDry             (called from runoff_execute)
+//  subcatch_addDryTime        (called from runoff_execute)
+//  subcatch_endDryTime        (called from endDryTime in runoff.c)
 //  subcatch_addRunon          (called from subcatch_getRunon,
 //                              lid_addDrainRunon, & runoff_getOutfallRunon)
 //  subcatch_getRunoff         (called from runoff_execute)
@@ -106,13 +126,18 @@ static  char *RunoffRoutingWords[] = { w_OUTLET,  w_IMPERV, w_PERV, NULL};
 //-----------------------------------------------------------------------------
 static void   getNetPrecip(int j, double* netPrecip, double tStep);
 static double getSubareaRunoff(int subcatch, int subarea, double area,
-              double rainfall, double evap, double tStep);
+              double rainfall, double evap, double tStep, TRunoffCtx* ctx);
 static double getSubareaInfil(int j, TSubarea* subarea, double precip,
-              double tStep);
-static double findSubareaRunoff(TSubarea* subarea, double tRunoff);
-static void   updatePondedDepth(TSubarea* subarea, double* tx);
-static void   getDdDt(double t, double* d, double* dddt);
-static void   adjustSubareaParams(int subareaType, int subcatch);
+              double tStep, double factor);
+static double findSubareaRunoff(TSubareaCtx* sc, double tRunoff);
+static void   updatePondedDepth(TSubareaCtx* sc, double* tx,
+              TOdeSolver* ode);
+static void   getDdDt(double t, double* d, double* dddt, void* p);
+static void   adjustSubareaParams(TSubareaCtx* sc, int subareaType,
+              int subcatch);
+static int    compareRunonPaths(const void* p1, const void* p2);
+static void   addUpstreamRunon(int source, int j);
+static void   getSubareaRunon(int j);
 
 //=============================================================================
 
@@ -434,6 +459,7 @@ void  subcatch_initState(int j)
     Subcatch[j].runon = 0.0;
     Subcatch[j].evapLoss = 0.0;
     Subcatch[j].infilLoss = 0.0;
+    Subcatch[j].dryTime = 0.0;
 
     // --- initialize state of infiltration, groundwater, & snow pack objects
     if ( Subcatch[j].infil == j )  infil_initState(j);
@@ -520,36 +546,202 @@ double subcatch_getStorage(int j)
 
 //=============================================================================
 
+int subcatch_createRunonSchedule()
+//
+//  Input:   none
+//  Output:  returns an error code
+//  Purpose: lists the subcatchments that send runon to each subcatchment.
+//
+//  A subcatchment receives runon from the subcatchments (and LID drains)
+//  that discharge onto it and from flow re-routed between its own subareas.
+//  Because runon is based on the previous period's runoff, the order in
+//  which subcatchments are processed doesn't matter except for the order
+//  in which runon flows get summed, which the index ordering of the source
+//  lists preserves.
+//
+{
+    int j, k, i, n;
+    int nPaths;
+    int maxLidSubcatchs;
+    int* lidSubcatchs;
+    TRunonPath* paths;
+
+    // --- count the runon paths
+    nPaths = 0;
+    maxLidSubcatchs = 0;
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        if ( Subcatch[j].area == 0.0 ) continue;
+        nPaths++;
+        k = Subcatch[j].outSubcatch;
+        if ( k >= 0 && k != j ) nPaths++;
+        if ( Subcatch[j].lidArea > 0.0 )
+        {
+            i = lid_getDrainSubcatchs(j, NULL, 0);
+            nPaths += i;
+            maxLidSubcatchs = MAX(maxLidSubcatchs, i);
+        }
+    }
+
+    // --- allocate memory for the paths and the schedule
+    paths = (TRunonPath *) calloc(nPaths + 1, sizeof(TRunonPath));
+    lidSubcatchs = (int *) calloc(maxLidSubcatchs + 1, sizeof(int));
+    RunonStart = (int *) calloc(Nobjects[SUBCATCH] + 1, sizeof(int));
+    RunonSources = (int *) calloc(nPaths + 1, sizeof(int));
+    if ( !paths || !lidSubcatchs || !RunonStart || !RunonSources )
+    {
+        FREE(paths);
+        FREE(lidSubcatchs);
+        return ERR_MEMORY;
+    }
+
+    // --- list each path (including the path from a subcatchment
+    //     to itself for flow re-routed between its subareas)
+    nPaths = 0;
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        if ( Subcatch[j].area == 0.0 ) continue;
+        paths[nPaths].receiver = j;
+        paths[nPaths].source = j;
+        nPaths++;
+        k = Subcatch[j].outSubcatch;
+        if ( k >= 0 && k != j )
+        {
+            paths[nPaths].receiver = k;
+            paths[nPaths].source = j;
+            nPaths++;
+        }
+        if ( Subcatch[j].lidArea > 0.0 )
+        {
+            n = lid_getDrainSubcatchs(j, lidSubcatchs, maxLidSubcatchs);
+            for (i = 0; i < n; i++)
+            {
+                paths[nPaths].receiver = lidSubcatchs[i];
+                paths[nPaths].source = j;
+                nPaths++;
+            }
+        }
+    }
+
+    // --- sort paths by receiving subcatchment and then by source,
+    //     and save each distinct source
+    qsort(paths, nPaths, sizeof(TRunonPath), compareRunonPaths);
+    n = 0;
+    for (i = 0; i < nPaths; i++)
+    {
+        if ( i > 0 && paths[i].receiver == paths[i-1].receiver &&
+             paths[i].source == paths[i-1].source ) continue;
+        RunonSources[n] = paths[i].source;
+        RunonStart[paths[i].receiver + 1]++;
+        n++;
+    }
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        RunonStart[j+1] += RunonStart[j];
+    }
+    FREE(paths);
+    FREE(lidSubcatchs);
+    return 0;
+}
+
+//=============================================================================
+
+void subcatch_deleteRunonSchedule()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees memory used by the runon schedule.
+//
+{
+    FREE(RunonStart);
+    FREE(RunonSources);
+}
+
+//=============================================================================
+
+int compareRunonPaths(const void* p1, const void* p2)
+//
+//  Input:   p1, p2 = pointers to two runon paths
+//  Output:  returns -1, 0 or 1
+//  Purpose: orders runon paths by receiving and then by source subcatchment.
+//
+{
+    const TRunonPath* r1 = (const TRunonPath*)p1;
+    const TRunonPath* r2 = (const TRunonPath*)p2;
+
+    if ( r1->receiver != r2->receiver )
+        return (r1->receiver < r2->receiver) ? -1 : 1;
+    if ( r1->source != r2->source )
+        return (r1->source < r2->source) ? -1 : 1;
+    return 0;
+}
+
+//=============================================================================
+
 void subcatch_getRunon(int j)
 //
 //  Input:   j = subcatchment index
 //  Output:  none
-//  Purpose: Routes runoff from a subcatchment to its outlet subcatchment
-//           or between its subareas.
+//  Purpose: Adds runoff from upstream subcatchments to a subcatchment's
+//           runon and routes runoff between its subareas.
+//
+//  Only subcatchment j is modified, so different subcatchments can be
+//  processed concurrently.
+//
+{
+    int i;                             // runon schedule index
+    int m;                             // runon source subcatchment
+
+    for (i = RunonStart[j]; i < RunonStart[j+1]; i++)
+    {
+        m = RunonSources[i];
+        if ( m == j ) getSubareaRunon(j);
+        else addUpstreamRunon(m, j);
+    }
+}
+
+//=============================================================================
+
+void addUpstreamRunon(int m, int j)
+//
+//  Input:   m = index of upstream subcatchment
+//           j = index of subcatchment receiving runon
+//  Output:  none
+//  Purpose: adds previous period's runoff and LID drain flow sent from an
+//           upstream subcatchment to the runon of a subcatchment.
 //
 {
-    int    k;                          // outlet subcatchment index
     int    p;                          // pollutant index
-    double q;                          // runon to outlet subcatchment (ft/sec)
-    double q1, q2;                     // runoff from imperv. areas (ft/sec)
-    double pervArea;                   // subcatchment pervious area (ft2)
+    double q;                          // runon from upstream subcatch. (cfs)
 
-    // --- add previous period's runoff from this subcatchment to the
-    //     runon of the outflow subcatchment, if it exists
-    k = Subcatch[j].outSubcatch;
-    q = Subcatch[j].oldRunoff;
-    if ( k >= 0 && k != j )
+    // --- add previous period's runoff from the upstream subcatchment
+    //     if this subcatchment is its outlet
+    if ( Subcatch[m].outSubcatch == j )
     {
-        subcatch_addRunonFlow(k, q);
+        q = Subcatch[m].oldRunoff;
+        subcatch_addRunonFlow(j, q);
         for (p = 0; p < Nobjects[POLLUT]; p++)
         {
-            Subcatch[k].newQual[p] += q * Subcatch[j].oldQual[p] * LperFT3;
+            Subcatch[j].newQual[p] += q * Subcatch[m].oldQual[p] * LperFT3;
         }
     }
 
-    // --- add any LID underdrain flow sent from this subcatchment to
-    //     other subcatchments
-    if ( Subcatch[j].lidArea > 0.0 ) lid_addDrainRunon(j);
+    // --- add any LID underdrain flow sent from the upstream subcatchment
+    if ( Subcatch[m].lidArea > 0.0 ) lid_addDrainRunon(m, j);
+}
+
+//=============================================================================
+
+void getSubareaRunon(int j)
+//
+//  Input:   j = subcatchment index
+//  Output:  none
+//  Purpose: Routes runoff between a subcatchment's subareas.
+//
+{
+    double q;                          // re-routed runoff (ft/sec)
+    double q1, q2;                     // runoff from imperv. areas (ft/sec)
+    double pervArea;                   // subcatchment pervious area (ft2)
 
     // --- add to sub-area inflow any outflow from other subarea in previous period
     //     (NOTE: no transfer of runoff pollutant load, since runoff loads are
@@ -626,10 +818,107 @@ void  subcatch_addRunonFlow(int k, double q)
 
 //=============================================================================
 
-double subcatch_getRunoff(int j, double tStep)
+int subcatch_isDry(int j)
+//
+//  Input:   j = subcatchment index
+//  Output:  returns TRUE if subcatchment is dry, FALSE if not
+//  Purpose: determines if a subcatchment has no precipitation, runon or
+//           ponded water so that infiltration recovery and pollutant buildup
+//           are the only changes it undergoes over the current time step.
+//
+//  Subcatchments with LIDs, groundwater, snow packs or externally supplied
+//  pollutant buildup are never considered dry.
+//
+{
+    int    i;                          // subarea or land use index
+    int    p;                          // pollutant index
+    double rainfall;                   // rainfall (ft/sec)
+    double snowfall;                   // snowfall (ft/sec)
+
+    // --- check for components that must be analyzed every time step
+    if ( Subcatch[j].lidArea > 0.0 ) return FALSE;
+    if ( !IgnoreGwater && Subcatch[j].groundwater ) return FALSE;
+    if ( !IgnoreSnowmelt && Subcatch[j].snowpack ) return FALSE;
+
+    // --- check for precipitation, runon and previous runoff
+    if ( Subcatch[j].gage >= 0 &&
+         gage_getPrecip(Subcatch[j].gage, &rainfall, &snowfall) > 0.0 )
+        return FALSE;
+    if ( Subcatch[j].runon != 0.0 || Subcatch[j].oldRunoff != 0.0 )
+        return FALSE;
+
+    // --- check for inflow or ponded water on each subarea
+    for (i = IMPERV0; i <= PERV; i++)
+    {
+        if ( Subcatch[j].subArea[i].inflow != 0.0 ||
+             Subcatch[j].subArea[i].depth > 0.0 ||
+             Subcatch[j].subArea[i].runoff > 0.0 ) return FALSE;
+    }
+
+    // --- check for ponded pollutant mass and buildup from time series
+    for (p = 0; p < Nobjects[POLLUT]; p++)
+    {
+        if ( Subcatch[j].pondedQual[p] != 0.0 ) return FALSE;
+        for (i = 0; i < Nobjects[LANDUSE]; i++)
+        {
+            if ( Subcatch[j].landFactor[i].fraction > 0.0 &&
+                 Landuse[i].buildupFunc[p].funcType == EXTERNAL_BUILDUP )
+                return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void subcatch_addDryTime(int j, double tStep)
+//
+//  Input:   j = subcatchment index
+//           tStep = time step (sec)
+//  Output:  none
+//  Purpose: adds a time step to the dry time of a dry subcatchment whose
+//           analysis is being deferred.
+//
+{
+    Subcatch[j].dryTime += tStep;
+    Subcatch[j].rainfall = 0.0;
+    Subcatch[j].evapLoss = 0.0;
+    Subcatch[j].infilLoss = 0.0;
+    Subcatch[j].newRunoff = 0.0;
+}
+
+//=============================================================================
+
+double subcatch_endDryTime(int j)
+//
+//  Input:   j = subcatchment index
+//  Output:  returns the subcatchment's deferred dry time (sec)
+//  Purpose: recovers a subcatchment's infiltration capacity over its
+//           deferred dry time.
+//
+//  The recovery computed by each infiltration method over a single dry
+//  period is the same as over the sequence of time steps it replaces as
+//  long as the monthly recovery and conductivity factors don't change.
+//
+{
+    double tDry = Subcatch[j].dryTime;
+
+    if ( tDry == 0.0 ) return 0.0;
+    if ( Subcatch[j].subArea[PERV].fArea > 0.0 )
+    {
+        infil_getInfil(j, tDry, 0.0, 0.0, 0.0, infil_getInfilFactor(j));
+    }
+    Subcatch[j].dryTime = 0.0;
+    return tDry;
+}
+
+//=============================================================================
+
+double subcatch_getRunoff(int j, double tStep, TRunoffCtx* ctx)
 //
 //  Input:   j = subcatchment index
 //           tStep = time step (sec)
+//           ctx = runoff context that receives the subcatchment's water balance
 //  Output:  returns total runoff produced by subcatchment (ft/sec)
 //  Purpose: Computes runoff & new storage depth for subcatchment.
 //
@@ -655,30 +944,30 @@ double subcatch_getRunoff(int j, double tStep)
     double vImpervRunoff = 0.0;        // impervious area runoff volume (ft3)
     double vPervRunoff = 0.0;          // pervious area runoff volume (ft3)
 
-    // --- initialize shared water balance variables
-    Vevap     = 0.0;
-    Vpevap    = 0.0;
-    Vinfil    = 0.0;
-    Voutflow  = 0.0;
-    VlidIn    = 0.0;
-    VlidInfil = 0.0;
-    VlidOut   = 0.0;
-    VlidDrain = 0.0;
-    VlidReturn = 0.0;
+    // --- initialize the context's water balance volumes
+    ctx->vEvap      = 0.0;
+    ctx->vPevap     = 0.0;
+    ctx->vInfil     = 0.0;
+    ctx->vOutflow   = 0.0;
+    ctx->vLidIn     = 0.0;
+    ctx->vLidInfil  = 0.0;
+    ctx->vLidOut    = 0.0;
+    ctx->vLidDrain  = 0.0;
+    ctx->vLidReturn = 0.0;
 
     // --- find volume of inflow to non-LID portion of subcatchment as existing
     //     ponded water + any runon volume from upstream areas;
     //     rainfall and snowmelt will be added as each sub-area is analyzed
     nonLidArea = Subcatch[j].area - Subcatch[j].lidArea;
     vRunon = Subcatch[j].runon * tStep * nonLidArea;
-    Vinflow = vRunon + subcatch_getDepth(j) * nonLidArea;
+    ctx->vInflow = vRunon + subcatch_getDepth(j) * nonLidArea;
 
     // --- find LID runon only if LID occupies full subcatchment
     if ( nonLidArea == 0.0 )
         vRunon = Subcatch[j].runon * tStep * Subcatch[j].area;
 
     // --- get net precip. (rainfall + snowfall + snowmelt) on the 3 types
-    //     of subcatchment sub-areas and update Vinflow with it
+    //     of subcatchment sub-areas and update vInflow with it
     getNetPrecip(j, netPrecip, tStep);
 
     // --- find potential evaporation rate
@@ -686,55 +975,56 @@ double subcatch_getRunoff(int j, double tStep)
     else evapRate = Evap.rate;
 
     // --- set monthly infiltration adjustment factor
-    infil_setInfilFactor(j);
+    ctx->infilFactor = infil_getInfilFactor(j);
 
     // --- examine each type of sub-area (impervious w/o depression storage,
     //     impervious w/ depression storage, and pervious)
     if ( nonLidArea > 0.0 ) for (i = IMPERV0; i <= PERV; i++)
     {
-        // --- get runoff from sub-area updating Vevap, Vpevap,
-        //     Vinfil & Voutflow)
+        // --- get runoff from sub-area updating vEvap, vPevap,
+        //     vInfil & vOutflow)
         area = nonLidArea * Subcatch[j].subArea[i].fArea;
         Subcatch[j].subArea[i].runoff =
-            getSubareaRunoff(j, i, area, netPrecip[i], evapRate, tStep);
+            getSubareaRunoff(j, i, area, netPrecip[i], evapRate, tStep, ctx);
         subAreaRunoff = Subcatch[j].subArea[i].runoff * area;
         if (i == PERV) vPervRunoff = subAreaRunoff * tStep;
         else           vImpervRunoff += subAreaRunoff * tStep;
         runoff += subAreaRunoff;
     }
 
-    // --- evaluate any LID treatment provided (updating Vevap,
-    //     Vpevap, VlidInfil, VlidIn, VlidOut, & VlidDrain)
+    // --- evaluate any LID treatment provided (updating vEvap,
+    //     vPevap, vLidInfil, vLidIn, vLidOut, & vLidDrain)
     if ( Subcatch[j].lidArea > 0.0 )
     {
-        lid_getRunoff(j, tStep);
+        lid_getRunoff(j, tStep, ctx);
     }
 
     // --- update groundwater levels & flows if applicable
     if ( !IgnoreGwater && Subcatch[j].groundwater )
     {
-        gwater_getGroundwater(j, Vpevap, Vinfil+VlidInfil, tStep);
+        gwater_getGroundwater(j, ctx->vPevap, ctx->vInfil+ctx->vLidInfil,
+                              tStep, ctx);
     }
 
     // --- save subcatchment's total loss rates (ft/s)
     area = Subcatch[j].area;
-    Subcatch[j].evapLoss = Vevap / tStep / area;
-    Subcatch[j].infilLoss = (Vinfil + VlidInfil) / tStep / area;
+    Subcatch[j].evapLoss = ctx->vEvap / tStep / area;
+    Subcatch[j].infilLoss = (ctx->vInfil + ctx->vLidInfil) / tStep / area;
 
     // --- find net surface runoff volume
-    //     (VlidDrain accounts for LID drain flows)
-    vOutflow = Voutflow      // runoff from all non-LID areas
-               - VlidIn      // runoff treated by LID units
-               + VlidOut;    // runoff from LID units
+    //     (vLidDrain accounts for LID drain flows)
+    vOutflow = ctx->vOutflow      // runoff from all non-LID areas
+               - ctx->vLidIn      // runoff treated by LID units
+               + ctx->vLidOut;    // runoff from LID units
     Subcatch[j].newRunoff = vOutflow / tStep;
 
     // --- obtain external precip. volume (without any snowmelt)
     vRain = Subcatch[j].rainfall * tStep * area;
 
     // --- update the cumulative stats for this subcatchment
-    stats_updateSubcatchStats(j, vRain, vRunon, Vevap, Vinfil + VlidInfil,
-        vImpervRunoff, vPervRunoff, vOutflow + VlidDrain,
-        Subcatch[j].newRunoff + VlidDrain/tStep);
+    stats_updateSubcatchStats(j, vRain, vRunon, ctx->vEvap,
+        ctx->vInfil + ctx->vLidInfil, vImpervRunoff, vPervRunoff,
+        vOutflow + ctx->vLidDrain, Subcatch[j].newRunoff + ctx->vLidDrain/tStep);
 
     // --- include this subcatchment's contribution to overall flow balance
     //     only if its outlet is a drainage system node
@@ -745,8 +1035,8 @@ double subcatch_getRunoff(int j, double tStep)
 
     // --- update mass balances
     massbal_updateRunoffTotals(RUNOFF_RAINFALL, vRain);
-    massbal_updateRunoffTotals(RUNOFF_EVAP, Vevap);
-    massbal_updateRunoffTotals(RUNOFF_INFIL, Vinfil+VlidInfil);
+    massbal_updateRunoffTotals(RUNOFF_EVAP, ctx->vEvap);
+    massbal_updateRunoffTotals(RUNOFF_INFIL, ctx->vInfil+ctx->vLidInfil);
     massbal_updateRunoffTotals(RUNOFF_RUNOFF, vOutflow);
 
     // --- return area-averaged runoff (ft/s)
@@ -905,7 +1195,7 @@ void  subcatch_getResults(int j, double f, float x[])
 //=============================================================================
 
 double getSubareaRunoff(int j, int i, double area, double precip, double evap,
-    double tStep)
+    double tStep, TRunoffCtx* ctx)
 //
 //  Purpose: computes runoff & losses from a subarea over the current time step.
 //  Input:   j = subcatchment index
@@ -914,8 +1204,9 @@ double getSubareaRunoff(int j, int i, double area, double precip, double evap,
 //           precip = rainfall + snowmelt over subarea (ft/sec)
 //           evap = evaporation (ft/sec)
 //           tStep = time step (sec)
+//           ctx = runoff context of the subcatchment
 //  Output:  returns runoff rate from the sub-area (cfs);
-//           updates shared variables Vinflow, Vevap, Vpevap, Vinfil & Voutflow.
+//           updates context volumes vInflow, vEvap, vPevap, vInfil & vOutflow.
 //
 {
     double    tRunoff;                 // time over which runoff occurs (sec)
@@ -924,6 +1215,7 @@ double getSubareaRunoff(int j, int i, double area, double precip, double evap,
     double    infil = 0.0;             // infiltration rate (ft/sec)
     double    runoff = 0.0;            // runoff rate (ft/sec)
     TSubarea* subarea;                 // pointer to subarea being analyzed
+    TSubareaCtx sc;                    // adjusted subarea parameters
 
     // --- no runoff if no area
     if ( area == 0.0 ) return 0.0;
@@ -939,22 +1231,24 @@ double getSubareaRunoff(int j, int i, double area, double precip, double evap,
     surfEvap = MIN(surfMoisture, evap);
 
     // --- compute infiltration loss rate
-    if ( i == PERV ) infil = getSubareaInfil(j, subarea, precip, tStep);
+    if ( i == PERV )
+        infil = getSubareaInfil(j, subarea, precip, tStep, ctx->infilFactor);
 
     // --- add precip to other subarea inflows
     subarea->inflow += precip;
     surfMoisture += subarea->inflow;
 
     // --- update total inflow, evaporation & infiltration volumes
-    Vinflow += precip * area * tStep;
-    Vevap += surfEvap * area * tStep;
-    if ( i == PERV ) Vpevap += Vevap;
-    Vinfil += infil * area * tStep;
+    ctx->vInflow += precip * area * tStep;
+    ctx->vEvap += surfEvap * area * tStep;
+    if ( i == PERV ) ctx->vPevap += ctx->vEvap;
+    ctx->vInfil += infil * area * tStep;
 
-    // --- assign adjusted runoff coeff. & storage to shared variables
-    Alpha = subarea->alpha;
-    Dstore = subarea->dStore;
-    adjustSubareaParams(i, j); 
+    // --- assign adjusted runoff coeff. & storage to subarea context
+    sc.subarea = subarea;
+    sc.alpha = subarea->alpha;
+    sc.dStore = subarea->dStore;
+    adjustSubareaParams(&sc, i, j); 
 
     // --- if losses exceed available moisture then no ponded water remains
     if ( surfEvap + infil >= surfMoisture )
@@ -967,28 +1261,30 @@ double getSubareaRunoff(int j, int i, double area, double precip, double evap,
     else
     {
         subarea->inflow -= surfEvap + infil;
-        updatePondedDepth(subarea, &tRunoff);
+        updatePondedDepth(&sc, &tRunoff, &ctx->odeSolver);
     }
 
     // --- compute runoff based on updated ponded depth
-    runoff = findSubareaRunoff(subarea, tRunoff);
+    runoff = findSubareaRunoff(&sc, tRunoff);
 
     // --- compute runoff volume leaving subcatchment for mass balance purposes
     //     (fOutlet is the fraction of this subarea's runoff that goes to the
     //     subcatchment outlet as opposed to another subarea of the subcatchment)
-    Voutflow += subarea->fOutlet * runoff * area * tStep;
+    ctx->vOutflow += subarea->fOutlet * runoff * area * tStep;
     return runoff;
 }
 
 //=============================================================================
 
-double getSubareaInfil(int j, TSubarea* subarea, double precip, double tStep)
+double getSubareaInfil(int j, TSubarea* subarea, double precip, double tStep,
+    double factor)
 //
 //  Purpose: computes infiltration rate at current time step.
 //  Input:   j = subcatchment index
 //           subarea = ptr. to a subarea
 //           precip = rainfall + snowmelt over subarea (ft/sec)
 //           tStep = time step (sec)
+//           factor = infiltration adjustment factor
 //  Output:  returns infiltration rate (ft/s)
 //
 {
@@ -996,7 +1292,7 @@ double getSubareaInfil(int j, TSubarea* subarea, double precip, double tStep)
 
     // --- compute infiltration rate 
     infil = infil_getInfil(j, tStep, precip,
-                           subarea->inflow, subarea->depth);
+                           subarea->inflow, subarea->depth, factor);
 
     // --- limit infiltration rate by available void space in unsaturated
     //     zone of any groundwater aquifer
@@ -1010,15 +1306,16 @@ double getSubareaInfil(int j, TSubarea* subarea, double precip, double tStep)
 
 //=============================================================================
 
-double findSubareaRunoff(TSubarea* subarea, double tRunoff)
+double findSubareaRunoff(TSubareaCtx* sc, double tRunoff)
 //
 //  Purpose: computes runoff (ft/s) from subarea after current time step.
-//  Input:   subarea = ptr. to a subarea
+//  Input:   sc = ptr. to a subarea context
 //           tRunoff = time step over which runoff occurs (sec)
 //  Output:  returns runoff rate (ft/s)
 //
 {
-    double xDepth = subarea->depth - Dstore;
+    TSubarea* subarea = sc->subarea;
+    double xDepth = subarea->depth - sc->dStore;
     double runoff = 0.0;
 
     if ( xDepth > ZERO )
@@ -1026,14 +1323,14 @@ double findSubareaRunoff(TSubarea* subarea, double tRunoff)
         // --- case where nonlinear routing is used
         if ( subarea->N > 0.0 )
         {
-            runoff = Alpha * pow(xDepth, MEXP);
+            runoff = sc->alpha * pow(xDepth, MEXP);
         }
 
         // --- case where no routing is used (Mannings N = 0)
         else
         {
             runoff = xDepth / tRunoff;
-            subarea->depth = Dstore;
+            subarea->depth = sc->dStore;
         }
     }
     else
@@ -1045,20 +1342,22 @@ double findSubareaRunoff(TSubarea* subarea, double tRunoff)
 
 //=============================================================================
 
-void updatePondedDepth(TSubarea* subarea, double* dt)
+void updatePondedDepth(TSubareaCtx* sc, double* dt, TOdeSolver* ode)
 //
-//  Input:   subarea = ptr. to a subarea,
+//  Input:   sc = ptr. to a subarea context,
 //           dt = time step (sec)
+//           ode = ODE solver of the current thread
 //  Output:  dt = time ponded depth is above depression storage (sec)
 //  Purpose: computes new ponded depth over subarea after current time step.
 //
 {
+    TSubarea* subarea = sc->subarea;   // subarea being analyzed
     double ix = subarea->inflow;       // excess inflow to subarea (ft/sec)
     double dx;                         // depth above depression storage (ft)
     double tx = *dt;                   // time over which dx > 0 (sec)
     
     // --- see if not enough inflow to fill depression storage (dStore)
-    if ( subarea->depth + ix*tx <= Dstore )
+    if ( subarea->depth + ix*tx <= sc->dStore )
     {
         subarea->depth += ix * tx;
     }
@@ -1067,19 +1366,18 @@ void updatePondedDepth(TSubarea* subarea, double* dt)
     else
     {
         // --- if depth < Dstore then fill up Dstore & reduce time step
-        dx = Dstore - subarea->depth;
+        dx = sc->dStore - subarea->depth;
         if ( dx > 0.0 && ix > 0.0 )
         {
             tx -= dx / ix;
-            subarea->depth = Dstore;
+            subarea->depth = sc->dStore;
         }
 
         // --- now integrate depth over remaining time step tx
-        if ( Alpha > 0.0 && tx > 0.0 )
+        if ( sc->alpha > 0.0 && tx > 0.0 )
         {
-            theSubarea = subarea;
-            odesolve_integrate(&(subarea->depth), 1, 0, tx, ODETOL, tx,
-                               getDdDt);
+            odesolve_integrate(ode, &(subarea->depth), 1, 0, tx, ODETOL, tx,
+                               getDdDt, sc);
         }
         else
         {
@@ -1098,35 +1396,38 @@ void updatePondedDepth(TSubarea* subarea, double* dt)
 
 //=============================================================================
 
-void  getDdDt(double t, double* d, double* dddt)
+void  getDdDt(double t, double* d, double* dddt, void* p)
 //
 //  Input:   t = current time (not used)
 //           d = stored depth (ft)
+//           p = ptr. to the context of the subarea being analyzed
 //  Output   dddt = derivative of d with respect to time
 //  Purpose: evaluates derivative of stored depth w.r.t. time
 //           for the subarea whose runoff is being computed.
 //
 {
-    double ix = theSubarea->inflow;
-    double rx = *d - Dstore;
+    TSubareaCtx* sc = (TSubareaCtx *)p;
+    double ix = sc->subarea->inflow;
+    double rx = *d - sc->dStore;
     if ( rx < 0.0 )
     {
         rx = 0.0;
     }
     else
     {
-        rx = Alpha * pow(rx, MEXP);
+        rx = sc->alpha * pow(rx, MEXP);
     }
     *dddt = ix - rx;
 }
 
 //=============================================================================
 
-void adjustSubareaParams(int i, int j)
+void adjustSubareaParams(TSubareaCtx* sc, int i, int j)
 //
-//  Input:   i = type of subarea being analyzed
+//  Input:   sc = ptr. to context of subarea being analyzed
+//           i = type of subarea being analyzed
 //           j = index of current subcatchment being analyzed
-//  Output   adjusted values of module-level variables Dstore & Alpha
+//  Output   adjusted values of context variables dStore & alpha
 //  Purpose: adjusts a pervious subarea's depression storage and its
 //           runoff coeff. by month of the year.
 //
@@ -1143,7 +1444,7 @@ void adjustSubareaParams(int i, int j)
         {
             m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
             f = Pattern[p].factor[m];
-            if (f >= 0.0) Dstore *= f;
+            if (f >= 0.0) sc->dStore *= f;
         }
 
         // --- roughness adjustment to runoff coeff.
@@ -1152,8 +1453,8 @@ void adjustSubareaParams(int i, int j)
         {
             m = datetime_monthOfYear(getDateTime(OldRunoffTime)) - 1;
             f = Pattern[p].factor[m];
-            if (f <= 0.0) Alpha = 0.0;
-            else          Alpha /= f;
+            if (f <= 0.0) sc->alpha = 0.0;
+            else          sc->alpha /= f;
         }
     }
 }
@@ -20,6 +20,9 @@
 //   - Set low runoff flow concentrations to zero before computing runoff
 //     mass loads rather than after so that they match wet weather mass
 //     inflows reported for conveyance system nodes. 
+//   - Runoff volumes and outflow loads passed in a runoff context instead
+//     of through imported variables.
+//   - surfqual_isSweepDue() added to find when dry subcatchments get swept.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -28,22 +31,6 @@
 #include "headers.h"
 #include "lid.h"
 
-//-----------------------------------------------------------------------------
-//  Imported variables 
-//-----------------------------------------------------------------------------
-// Declared in RUNOFF.C
-extern  double*    OutflowLoad;   // exported pollutant mass load
-
-// Volumes (ft3) for a subcatchment over a time step declared in SUBCATCH.C
-extern double      Vinfil;        // non-LID infiltration
-extern double      Vinflow;       // non-LID precip + snowmelt + runon + ponded water
-extern double      Voutflow;      // non-LID runoff to subcatchment's outlet
-extern double      VlidIn;        // inflow to LID units
-extern double      VlidInfil;     // infiltration from LID units
-extern double      VlidOut;       // surface outflow from LID units
-extern double      VlidDrain;     // drain outflow from LID units
-extern double      VlidReturn;    // LID outflow returned to pervious area
-
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
 //-----------------------------------------------------------------------------
@@ -51,14 +38,15 @@ extern double      VlidReturn;    // LID outflow returned to pervious area
 //  surfqual_getWashoff        (called from runoff_execute)
 //  surfqual_getBuildup        (called from runoff_execute)
 //  surfqual_sweepBuildup      (called from runoff_execute)
+//  surfqual_isSweepDue        (called from runoff_execute)
 //  surfqual_getWtdWashoff     (called from addWetWeatherInflows in routing.c)
 
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
-static void  findWashoffLoads(int j, double runoff);
-static void  findPondedLoads(int j, double tStep);
-static void  findLidLoads(int j, double tStep);
+static void  findWashoffLoads(int j, double runoff, TRunoffCtx* ctx);
+static void  findPondedLoads(int j, double tStep, TRunoffCtx* ctx);
+static void  findLidLoads(int j, double tStep, TRunoffCtx* ctx);
 
 //=============================================================================
 
@@ -189,12 +177,36 @@ void surfqual_sweepBuildup(int j, DateTime aDate)
 
 //=============================================================================
 
-void  surfqual_getWashoff(int j, double runoff, double tStep)
+int surfqual_isSweepDue(int j, DateTime aDate)
+//
+//  Input:   j = subcatchment index
+//           aDate = current date/time
+//  Output:  returns TRUE if any land use in the subcatchment is due to be
+//           swept, FALSE if not
+//  Purpose: checks if street sweeping interval has been reached.
+//
+{
+    int i;                             // land use index
+
+    for (i = 0; i < Nobjects[LANDUSE]; i++)
+    {
+        if ( Subcatch[j].landFactor[i].fraction == 0.0 ) continue;
+        if ( Landuse[i].sweepInterval == 0.0 ) continue;
+        if ( aDate - Subcatch[j].landFactor[i].lastSwept >=
+             Landuse[i].sweepInterval ) return TRUE;
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+void  surfqual_getWashoff(int j, double runoff, double tStep, TRunoffCtx* ctx)
 //
 //  Input:   j = subcatchment index
 //           runoff = total subcatchment runoff before internal re-routing or
 //                    LID controls (ft/sec)
 //           tStep = time step (sec)
+//           ctx = runoff context holding the subcatchment's volumes
 //  Output:  none
 //  Purpose: computes new runoff quality for a subcatchment.
 //
@@ -221,11 +233,11 @@ void  surfqual_getWashoff(int j, double runoff, double tStep)
     area = Subcatch[j].area;
     if ( Nobjects[POLLUT] == 0 || area == 0.0 ) return;
 
-    // --- find contributions from washoff, runon and wet precip. to OutflowLoad
-    for (p = 0; p < Nobjects[POLLUT]; p++) OutflowLoad[p] = 0.0;
-    findWashoffLoads(j, runoff);
-    findPondedLoads(j, tStep);
-    findLidLoads(j, tStep);
+    // --- find contributions from washoff, runon and wet precip. to outflowLoad
+    for (p = 0; p < Nobjects[POLLUT]; p++) ctx->outflowLoad[p] = 0.0;
+    findWashoffLoads(j, runoff, ctx);
+    findPondedLoads(j, tStep, ctx);
+    findLidLoads(j, tStep, ctx);
 
     // --- contribution from direct rainfall on LID areas
     vLidRain = Subcatch[j].rainfall * Subcatch[j].lidArea * tStep;
@@ -239,15 +251,15 @@ void  surfqual_getWashoff(int j, double runoff, double tStep)
     }
 
     // --- runoff volume before LID treatment (ft3)
-    //     (Voutflow, computed in subcatch_getRunoff, is subcatchment
+    //     (vOutflow, computed in subcatch_getRunoff, is subcatchment
     //      runoff volume before LID treatment)
-    vOut1 = Voutflow + vLidRain + vLidRunon;             
+    vOut1 = ctx->vOutflow + vLidRain + vLidRunon;             
 
     // --- surface runoff + LID drain flow volume leaving the subcatchment
     //     (Subcatch.newRunoff, computed in subcatch_getRunoff, includes
     //      any surface runoff reduction from LID treatment)
     vSurfOut = Subcatch[j].newRunoff * tStep;
-    vOut2 = vSurfOut + VlidDrain;
+    vOut2 = vSurfOut + ctx->vLidDrain;
 
     // --- determine if subcatchment outflow is below a small cutoff
     hasOutflow = (vOut2 > MIN_RUNOFF * area * tStep);
@@ -257,7 +269,7 @@ void  surfqual_getWashoff(int j, double runoff, double tStep)
     {
         // --- convert washoff load to a concentration
         cOut = 0.0;
-        if ( vOut1 > 0.0 && hasOutflow ) cOut = OutflowLoad[p] / vOut1;
+        if ( vOut1 > 0.0 && hasOutflow ) cOut = ctx->outflowLoad[p] / vOut1;
 
         // --- assign any difference between pre- and post-LID
         //     subcatchment outflow loads to BMP removal
@@ -310,11 +322,12 @@ double surfqual_getWtdWashoff(int j, int p, double f)
 
 //=============================================================================
 
-void findPondedLoads(int j, double tStep)
+void findPondedLoads(int j, double tStep, TRunoffCtx* ctx)
 //
 //  Input:   j = subcatchment index
 //           tStep = time step (sec)
-//  Output:  updates pondedQual and OutflowLoad 
+//           ctx = runoff context holding the subcatchment's volumes
+//  Output:  updates pondedQual and ctx->outflowLoad 
 //  Purpose: mixes wet deposition and runon pollutant loading with existing
 //           ponded pollutant mass to compute an ouflow loading.
 //
@@ -347,7 +360,7 @@ void findPondedLoads(int j, double tStep)
 
         // --- surface is dry and has no runon -- add any remaining mass
         //     to overall mass balance's FINAL_LOAD category
-        if ( Vinflow == 0.0 )
+        if ( ctx->vInflow == 0.0 )
         {
             massbal_updateLoadingTotals(FINAL_LOAD, p,
                 Subcatch[j].pondedQual[p] * Pollut[p].mcf);
@@ -359,16 +372,16 @@ void findPondedLoads(int j, double tStep)
             //     (newQual[] temporarily holds runon mass loading)
             wRunon = Subcatch[j].newQual[p] * tStep;
             wPonded = Subcatch[j].pondedQual[p] + wRain + wRunon;
-            cPonded = wPonded / Vinflow;
+            cPonded = wPonded / ctx->vInflow;
 
             // --- mass lost to infiltration
-            wInfil = cPonded * Vinfil;
+            wInfil = cPonded * ctx->vInfil;
             wInfil = MIN(wInfil, wPonded);
             massbal_updateLoadingTotals(INFIL_LOAD, p, wInfil * Pollut[p].mcf);
             wPonded -= wInfil;
 
             // --- mass lost to runoff
-            wOutflow = cPonded * Voutflow;
+            wOutflow = cPonded * ctx->vOutflow;
             wOutflow = MIN(wOutflow, wPonded);
             wPonded -= wOutflow;
 
@@ -380,19 +393,20 @@ void findPondedLoads(int j, double tStep)
 
             // --- update ponded mass (using newly computed ponded depth)
             Subcatch[j].pondedQual[p] = cPonded * subcatch_getDepth(j) * nonLidArea;
-            OutflowLoad[p] += wOutflow;
+            ctx->outflowLoad[p] += wOutflow;
         }
     }
 }
 
 //=============================================================================
 
-void  findWashoffLoads(int j, double runoff)
+void  findWashoffLoads(int j, double runoff, TRunoffCtx* ctx)
 //
 //  Input:   j = subcatchment index
 //           runoff = subcatchment runoff before internal re-routing or
 //                    LID controls (ft/sec)
-//  Output:  updates OutflowLoad array
+//           ctx = runoff context holding the subcatchment's volumes
+//  Output:  updates ctx->outflowLoad array
 //  Purpose: computes pollutant washoff loads for each land use and adds these
 //           to the subcatchment's total outflow loads.
 //
@@ -412,8 +426,9 @@ void  findWashoffLoads(int j, double runoff)
             // --- compute load generated by washoff function
             for (p = 0; p < Nobjects[POLLUT]; p++)
             {
-                OutflowLoad[p] += landuse_getWashoffLoad(
-                    i, p, area, Subcatch[j].landFactor, runoff, Voutflow);
+                ctx->outflowLoad[p] += landuse_getWashoffLoad(
+                    i, p, area, Subcatch[j].landFactor, runoff,
+                    ctx->vOutflow);
             }
         }
     }
@@ -426,25 +441,26 @@ void  findWashoffLoads(int j, double runoff)
         if ( k >= 0 )
         {
             // --- compute addition to washoff from co-pollutant
-            w = Pollut[p].coFraction * OutflowLoad[k];
+            w = Pollut[p].coFraction * ctx->outflowLoad[k];
 
             // --- add this washoff to buildup mass balance totals
             //     so that things will balance
             massbal_updateLoadingTotals(BUILDUP_LOAD, p, w * Pollut[p].mcf);
 
             // --- then also add it to the total washoff load
-            OutflowLoad[p] += w;
+            ctx->outflowLoad[p] += w;
         }
     }
 }
 
 //=============================================================================
 
-void  findLidLoads(int j, double tStep)
+void  findLidLoads(int j, double tStep, TRunoffCtx* ctx)
 //
 //  Input:   j = subcatchment index
 //           tStep = time step (sec)
-//  Output:  updates OutflowLoad array
+//           ctx = runoff context holding the subcatchment's outflow loads
+//  Output:  updates ctx->outflowLoad array
 //  Purpose: finds addition to subcatchment pollutant loads from wet deposition 
 //           and upstream runon to LID areas.
 //
@@ -476,6 +492,6 @@ void  findLidLoads(int j, double tStep)
         else            wLidRunon = 0.0;
 
         // --- update total outflow pollutant load (mass)
-        OutflowLoad[p] += wLidRain + wLidRunon;
+        ctx->outflowLoad[p] += wLidRain + wLidRunon;
     }
 }
@@ -42,6 +42,10 @@
 //   - Prevented possible infinite loop if swmm_step() called when ErrorCode > 0.
 //   - Prevented early exit from swmm_end() when ErrorCode > 0.
 //   - Support added for relative file names.
+//   Build 5.2.4:
+//   - API node & link indexes follow input order if the network was
+//     renumbered.
+//   - Accuracy of uniform geometry tables reported after analysis options.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -175,6 +179,7 @@ static void   setOutfallStage(int index, double value);
 static void   setLinkSetting(int index, double value);
 static void   setRoutingStep(double value);
 static void   getAbsolutePath(const char* fname, char* absPath, size_t size);
+static int    getObjectIndex(int objType, int index);
 
 // Exception filtering function
 #ifdef EXH
@@ -331,6 +336,7 @@ int DLLEXPORT swmm_start(int saveResults)
         if (RptFlags.input)
             inputrpt_writeInput();
         report_writeOptions();
+        report_writeGeometryTables();
     }
 
     // --- save saveResults flag to global variable
@@ -353,6 +359,7 @@ int DLLEXPORT swmm_start(int saveResults)
         TotalStepCount = 0;
         ReportStepCount = 0;
         NonConvergeCount = 0;
+        PicardFallbackCount = 0;
         IsStartedFlag = TRUE;
 
         // --- initialize global continuity errors
@@ -810,6 +817,7 @@ void  DLLEXPORT swmm_getName(int objType, int index, char *name, int size)
         return;
     if (index < 0 || index >= Nobjects[objType])
         return;
+    index = getObjectIndex(objType, index);
     switch (objType)
     {
         case GAGE:     idName = Gage[index].ID;     break;
@@ -830,11 +838,15 @@ int  DLLEXPORT swmm_getIndex(int objType, const char *name)
 //  Output:  returns the object's position in the array of like objects;
 //  Purpose: retrieves the index of a named object.
 {
+    int index;
     if (!IsOpenFlag)
         return -1;
     if (objType < swmm_GAGE || objType > swmm_LINK)
         return -1;
-    return project_findObject(objType, name);
+    index = project_findObject(objType, name);
+    if (index < 0)
+        return index;
+    return reorder_getInputIndex(objType, index);
 }
 
 //=============================================================================
@@ -856,9 +868,9 @@ double  DLLEXPORT swmm_getValue(int property, int index)
     if (property < 300)
         return getSubcatchValue(property, index);
     if (property < 400)
-        return getNodeValue(property, index);
+        return getNodeValue(property, getObjectIndex(NODE, index));
     if (property < 500)
-        return getLinkValue(property, index);
+        return getLinkValue(property, getObjectIndex(LINK, index));
     return 0;
 }
 
@@ -874,6 +886,10 @@ void  DLLEXPORT swmm_setValue(int property, int index, double value)
 {
     if (!IsOpenFlag)
         return;
+    if (property >= 300 && property < 400)
+        index = getObjectIndex(NODE, index);
+    else if (property >= 400 && property < 500)
+        index = getObjectIndex(LINK, index);
     switch (property)
     {
     case swmm_GAGE_RAINFALL:
@@ -938,9 +954,11 @@ double  DLLEXPORT swmm_getSavedValue(int property, int index, int period)
     if (property >= 200 && property < 300)
         return getSavedSubcatchValue(property, index, period);
     if (property < 400)
-        return getSavedNodeValue(property, index, period);
+        return getSavedNodeValue(property, getObjectIndex(NODE, index),
+                                 period);
     if (property < 500)
-        return getSavedLinkValue(property, index, period);
+        return getSavedLinkValue(property, getObjectIndex(LINK, index),
+                                 period);
     return 0;
 }
 
@@ -1072,9 +1090,9 @@ double getLinkValue(int property, int index)
         case swmm_LINK_TYPE:
           return link->type;
         case swmm_LINK_NODE1:
-          return link->node1;
+          return reorder_getInputIndex(NODE, link->node1);
         case swmm_LINK_NODE2:
-          return link->node2;
+          return reorder_getInputIndex(NODE, link->node2);
         case swmm_LINK_LENGTH:
           if (link->type == CONDUIT)
               return Conduit[link->subIndex].length * UCF(LENGTH);
@@ -1371,6 +1389,21 @@ void  setRoutingStep(double value)
     RouteStep = value;
 }
 
+//=============================================================================
+
+int getObjectIndex(int objType, int index)
+//
+//  Input:   objType = a type of SWMM object
+//           index = the object's position in the project's input file
+//  Output:  returns the object's index in its array of objects
+//  Purpose: converts an API object index into an internal one (the two
+//           differ only when nodes & links have been renumbered).
+{
+    if (index < 0 || index >= Nobjects[objType])
+        return index;
+    return reorder_getIndex(objType, index);
+}
+
 //=============================================================================
 //   General purpose functions
 //=============================================================================
@@ -3,7 +3,7 @@
 //
 //   Project:  EPA SWMM5
 //   Version:  5.2
-//   Date:     10/17/22   (Build 5.2.2)
+//   Date:     06/12/23   (Build 5.2.4)
 //   Author:   L. Rossman
 //
 //   Table (curve and time series) functions.
@@ -30,6 +30,13 @@
 //   - Support added for relative file names.
 //   Build 5.2.2:
 //   - Prevent re-reading a time series file from start once end is reached.
+//   Build 5.2.4:
+//   - Table entries moved from a linked list into contiguous arrays once
+//     validated.
+//   - Curve lookups use a binary search started from the last interval found
+//     (a hint read and written atomically by parallel lookups).
+//   - Cumulative volumes of storage curves are precomputed so that volume
+//     and depth lookups no longer integrate the curve on each call.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -44,6 +51,8 @@
 int    table_getNextFileEntry(TTable* table, double* x, double* y);
 int    table_parseFileLine(char* line, TTable* table, double* x, double* y);
 double table_interpolate(double x, double x1, double y1, double x2, double y2);
+int    table_createArrays(TTable* table);
+int    table_findItem(TTable* table, double* v, double x);
 
 
 //=============================================================================
@@ -213,6 +222,9 @@ int table_addEntry(TTable* table, double x, double y)
 //  Output:  returns TRUE if successful, FALSE if not
 //  Purpose: adds a new x/y entry to a table.
 //
+//  NOTE: entries are held in a linked list while input data is being
+//        parsed and are moved to arrays by table_validate.
+//
 {
     TTableEntry *entry;
     entry = (TTableEntry *) malloc(sizeof(TTableEntry));
@@ -246,7 +258,12 @@ void   table_deleteEntries(TTable *table)
     }
     table->firstEntry = NULL;
     table->lastEntry  = NULL;
-    table->thisEntry  = NULL;
+    FREE(table->xItems);
+    FREE(table->yItems);
+    FREE(table->vItems);
+    table->nItems = 0;
+    table->thisItem = 0;
+    table->lastItem = 0;
 
     if (table->file.file)
     { 
@@ -268,7 +285,14 @@ void   table_init(TTable *table)
     table->refersTo = -1;
     table->firstEntry = NULL;
     table->lastEntry = NULL;
-    table->thisEntry = table->firstEntry;
+    table->nItems = 0;
+    table->thisItem = 0;
+    table->lastItem = 0;
+    table->yAscending = TRUE;
+    table->vAscending = TRUE;
+    table->xItems = NULL;
+    table->yItems = NULL;
+    table->vItems = NULL;
     table->lastDate = 0.0;
     table->x1 = 0.0;
     table->x2 = 0.0;
@@ -286,7 +310,8 @@ int   table_validate(TTable *table)
 //
 //  Input:   table = pointer to a TTable structure
 //  Output:  returns error code
-//  Purpose: checks that table's x-values are in ascending order.
+//  Purpose: moves a table's entries into arrays and checks that its
+//           x-values are in ascending order.
 //
 {
     int    result;
@@ -300,6 +325,9 @@ int   table_validate(TTable *table)
         if ( table->file.file == NULL ) return ERR_TABLE_FILE_OPEN;
     }
 
+    // --- otherwise move parsed entries into arrays
+    else if ( !table_createArrays(table) ) return ERR_MEMORY;
+
     // --- retrieve the first data entry in the table
     result = table_getFirstEntry(table, &x1, &y1);
 
@@ -328,6 +356,108 @@ int   table_validate(TTable *table)
 
 //=============================================================================
 
+int table_createArrays(TTable *table)
+//
+//  Input:   table = pointer to a TTable structure
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: copies the linked list of a table's entries into contiguous
+//           x & y arrays and then frees the list.
+//
+{
+    int    i, n = 0;
+    TTableEntry *entry;
+    TTableEntry *nextEntry;
+
+    // --- table's entries were already moved to arrays
+    if ( table->firstEntry == NULL && table->nItems > 0 ) return TRUE;
+
+    for ( entry = table->firstEntry; entry; entry = entry->next ) n++;
+    if ( n > 0 )
+    {
+        table->xItems = (double *) calloc(n, sizeof(double));
+        table->yItems = (double *) calloc(n, sizeof(double));
+        if ( table->xItems == NULL || table->yItems == NULL )
+        {
+            FREE(table->xItems);
+            FREE(table->yItems);
+            return FALSE;
+        }
+    }
+
+    // --- copy & free each entry
+    table->yAscending = TRUE;
+    entry = table->firstEntry;
+    for ( i = 0; i < n; i++ )
+    {
+        table->xItems[i] = entry->x;
+        table->yItems[i] = entry->y;
+        if ( i > 0 && entry->y < table->yItems[i-1] )
+            table->yAscending = FALSE;
+        nextEntry = entry->next;
+        free(entry);
+        entry = nextEntry;
+    }
+    table->firstEntry = NULL;
+    table->lastEntry = NULL;
+    table->nItems = n;
+    table->thisItem = 0;
+    table->lastItem = 0;
+    return TRUE;
+}
+
+//=============================================================================
+
+int table_findItem(TTable *table, double* v, double x)
+//
+//  Input:   table = pointer to a TTable structure
+//           v = either the table's x-value or y-value array (in ascending
+//               order)
+//           x = value being searched for
+//  Output:  returns the index of the first array item >= x
+//           (or the number of items if there is none)
+//  Purpose: locates the table interval that contains a value.
+//
+//  NOTE: the interval found by the previous lookup, and the one following
+//        it, are checked before a binary search is made. Lookups on the
+//        same table can be made concurrently in parallel routing loops,
+//        so this hint is read and written atomically and is range-checked
+//        (another thread's hint can at worst lead to a binary search).
+//
+{
+    int n = table->nItems;
+    int i;
+    int lo, hi, mid;
+
+    // --- check interval found by last lookup and the one that follows it
+    #pragma omp atomic read
+    i = table->lastItem;
+    if ( i > 0 && i < n && v[i-1] < x )
+    {
+        if ( x <= v[i] ) return i;
+        if ( i + 1 < n && x <= v[i+1] )
+        {
+            #pragma omp atomic write
+            table->lastItem = i + 1;
+            return i + 1;
+        }
+    }
+
+    // --- otherwise conduct a binary search
+    lo = 0;
+    hi = n;
+    while ( lo < hi )
+    {
+        mid = (lo + hi) / 2;
+        if ( v[mid] < x ) lo = mid + 1;
+        else hi = mid;
+    }
+    #pragma omp atomic write
+    table->lastItem = lo;
+    return lo;
+}
+
+//=============================================================================
+
 int table_getFirstEntry(TTable *table, double *x, double *y)
 //
 //  Input:   table = pointer to a TTable structure
@@ -336,10 +466,9 @@ int table_getFirstEntry(TTable *table, double *x, double *y)
 //           returns TRUE if successful, FALSE if not
 //  Purpose: retrieves the first x/y entry in a table.
 //
-//  NOTE: also moves the current position pointer (thisEntry) to the 1st entry.
+//  NOTE: also moves the current position (thisItem) to the 1st entry.
 //
 {
-    TTableEntry *entry;
     *x = 0;
     *y = 0.0;
 
@@ -350,12 +479,11 @@ int table_getFirstEntry(TTable *table, double *x, double *y)
         return table_getNextFileEntry(table, x, y);
     }
 
-    entry = table->firstEntry;
-    if ( entry )
+    if ( table->nItems > 0 )
     {
-        *x = entry->x;
-        *y = entry->y;
-        table->thisEntry = entry;
+        *x = table->xItems[0];
+        *y = table->yItems[0];
+        table->thisItem = 0;
         return TRUE;
     }
     else return FALSE;
@@ -371,20 +499,20 @@ int table_getNextEntry(TTable *table, double *x, double *y)
 //           returns TRUE if successful, FALSE if not
 //  Purpose: retrieves the next x/y entry in a table.
 //
-//  NOTE: also updates the current position pointer (thisEntry).
+//  NOTE: also updates the current position (thisItem).
 //
 {
-    TTableEntry *entry;
+    int i;
 
     if ( table->file.mode == USE_FILE )
         return table_getNextFileEntry(table, x, y);
     
-    entry = table->thisEntry->next;
-    if ( entry )
+    i = table->thisItem + 1;
+    if ( i < table->nItems )
     {
-        *x = entry->x;
-        *y = entry->y;
-        table->thisEntry = entry;
+        *x = table->xItems[i];
+        *y = table->yItems[i];
+        table->thisItem = i;
         return TRUE;
     }
     else return FALSE;
@@ -405,24 +533,15 @@ double table_lookup(TTable *table, double x)
 //        returned.
 //
 {
-    double x1,y1,x2,y2;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if ( entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( x <= x1 ) return y1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
-        x1 = x2;
-        y1 = y2;
-    }
-    return y1;
+    int     i, n = table->nItems;
+    double* xx = table->xItems;
+    double* yy = table->yItems;
+
+    if ( n == 0 ) return 0.0;
+    if ( x <= xx[0] ) return yy[0];
+    i = table_findItem(table, xx, x);
+    if ( i == n ) return yy[n-1];
+    return table_interpolate(x, xx[i-1], yy[i-1], xx[i], yy[i]);
 }
 
 //=============================================================================
@@ -434,29 +553,21 @@ double table_getSlope(TTable *table, double x)
 //  Output:  returns the slope of the curve at x
 //  Purpose: retrieves the slope of the curve at the line segment containing x.
 //
+//  NOTE: the slope is 0 if x is above the last table entry.
+//
 {
-    double x1,y1,x2,y2;
-    double dx;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if ( entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    x2 = x1;
-    y2 = y1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x <= x2 ) break;
-        x1 = x2;
-        y1 = y2;
-    }
-    dx = x2 - x1;
+    int     i, n = table->nItems;
+    double  dx;
+    double* xx = table->xItems;
+    double* yy = table->yItems;
+
+    if ( n < 2 ) return 0.0;
+    if ( x <= xx[1] ) i = 1;
+    else i = table_findItem(table, xx, x);
+    if ( i == n ) return 0.0;
+    dx = xx[i] - xx[i-1];
     if ( dx == 0.0 ) return 0.0;
-    return (y2 - y1) / dx;
+    return (yy[i] - yy[i-1]) / dx;
 }
 
 //=============================================================================
@@ -471,31 +582,25 @@ double table_lookupEx(TTable *table, double x)
 //           extrapolation outside of the table.
 //
 {
-    double x1,y1,x2,y2;
-    double s = 0.0;
-    TTableEntry* entry;
+    int     i, n = table->nItems;
+    double  s = 0.0;
+    double* xx = table->xItems;
+    double* yy = table->yItems;
 
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( x <= x1 )
+    if ( n == 0 ) return 0.0;
+    if ( x <= xx[0] )
     {
-        if (x1 > 0.0 ) return x/x1*y1;
-        else return y1;
-    }
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( x2 != x1 ) s = (y2 - y1) / (x2 - x1);
-        if ( x <= x2 ) return table_interpolate(x, x1, y1, x2, y2);
-        x1 = x2;
-        y1 = y2;
+        if ( xx[0] > 0.0 ) return x/xx[0]*yy[0];
+        else return yy[0];
     }
+    i = table_findItem(table, xx, x);
+    if ( i < n ) return table_interpolate(x, xx[i-1], yy[i-1], xx[i], yy[i]);
+
+    // --- extrapolate using slope of last table segment
+    if ( n > 1 && xx[n-1] != xx[n-2] )
+        s = (yy[n-1] - yy[n-2]) / (xx[n-1] - xx[n-2]);
     if ( s < 0.0 ) s = 0.0;
-    return y1 + s*(x - x1);
+    return yy[n-1] + s*(x - xx[n-1]);
 }
 
 //=============================================================================
@@ -509,17 +614,15 @@ double table_intervalLookup(TTable *table, double x)
 //           whose x-value is > x.
 //
 {
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    if ( x < entry->x ) return entry->y;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        if ( x < entry->x ) return entry->y;
-    }
-    return entry->y;
+    int     i, n = table->nItems;
+    double* xx = table->xItems;
+
+    if ( n == 0 ) return 0.0;
+    if ( x < xx[0] ) return table->yItems[0];
+    i = table_findItem(table, xx, x);
+    if ( i < n && xx[i] == x ) i++;
+    if ( i == n ) return table->yItems[n-1];
+    return table->yItems[i];
 }
 
 //=============================================================================
@@ -537,24 +640,19 @@ double table_inverseLookup(TTable *table, double y)
 //        returned.
 //
 {
-    double x1,y1,x2,y2;
-    TTableEntry* entry;
-
-    entry = table->firstEntry;
-    if (entry == NULL ) return 0.0;
-    x1 = entry->x;
-    y1 = entry->y;
-    if ( y <= y1 ) return x1;
-    while ( entry->next )
-    {
-        entry = entry->next;
-        x2 = entry->x;
-        y2 = entry->y;
-        if ( y <= y2 ) return table_interpolate(y, y1, x1, y2, x2);
-        x1 = x2;
-        y1 = y2;
-    }
-    return x1;
+    int     i, n = table->nItems;
+    double* xx = table->xItems;
+    double* yy = table->yItems;
+
+    if ( n == 0 ) return 0.0;
+    if ( y <= yy[0] ) return xx[0];
+
+    // --- binary search applies only if y-values never decrease,
+    //     otherwise find first entry whose y-value is >= y
+    if ( table->yAscending ) i = table_findItem(table, yy, y);
+    else for ( i = 1; i < n; i++ ) if ( y <= yy[i] ) break;
+    if ( i == n ) return xx[n-1];
+    return table_interpolate(y, yy[i-1], xx[i-1], yy[i], xx[i]);
 }
 
 //=============================================================================
@@ -568,22 +666,53 @@ double  table_getMaxY(TTable *table, double x)
 //           portion of a table that appear before value x.
 //
 {
-    double ymax;
-    TTableEntry* entry;
+    int     i = 0, n = table->nItems;
+    double  ymax;
 
-    entry = table->firstEntry;
-    ymax = entry->y;
-    while ( x > entry->x && entry->next )
+    if ( n == 0 ) return 0.0;
+    ymax = table->yItems[0];
+    while ( x > table->xItems[i] && i + 1 < n )
     {
-        entry = entry->next;
-        if ( entry->y < ymax ) return ymax;
-        ymax = entry->y;
+        i++;
+        if ( table->yItems[i] < ymax ) return ymax;
+        ymax = table->yItems[i];
     }
     return 0.0;
 }
 
 //=============================================================================
 
+int table_createVolumes(TTable *table)
+//
+//  Input:   table = pointer to a TTable structure
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: computes the cumulative storage volume at each depth entry of
+//           a storage curve (surface area v. depth).
+//
+//  NOTE: volumes are measured from the curve's first depth entry using the
+//        end area method, the same way table_getStorageVolume accumulates
+//        them.
+//
+{
+    int    i, n = table->nItems;
+    double dv;
+
+    if ( table->vItems || n == 0 ) return TRUE;
+    table->vItems = (double *) calloc(n, sizeof(double));
+    if ( table->vItems == NULL ) return FALSE;
+    table->vAscending = TRUE;
+    for ( i = 1; i < n; i++ )
+    {
+        dv = (table->yItems[i-1] + table->yItems[i]) / 2.0 *
+             (table->xItems[i] - table->xItems[i-1]);
+        if ( dv < 0.0 ) table->vAscending = FALSE;
+        table->vItems[i] = table->vItems[i-1] + dv;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
 double table_getStorageVolume(TTable *table, double x)
 //
 //  Input:   table = pointer to a TTable structure
@@ -591,16 +720,18 @@ double table_getStorageVolume(TTable *table, double x)
 //  Output:  returns a storage volume 
 //  Purpose: finds volume for a given depth in a Storage Curve table.
 //
+//  NOTE: table_createVolumes must have been called for the table.
+//
 {
-    double a, a1, x1, v, dx = 0.0, dy = 0.0, s;
-    TTableEntry* entry;
+    int     i, n = table->nItems;
+    double  a, a1, x1, v, dx, dy, s;
+    double* xx = table->xItems;
+    double* yy = table->yItems;
 
     // --- get first entry in table
-    v = 0.0;
-    entry = table->firstEntry;
-    if (entry == NULL) return 0.0;
-    x1 = entry->x;
-    a1 = entry->y;
+    if (n == 0 || table->vItems == NULL) return 0.0;
+    x1 = xx[0];
+    a1 = yy[0];
 
     // --- target depth is below first tabulated depth
     if (x <= x1)
@@ -609,28 +740,24 @@ double table_getStorageVolume(TTable *table, double x)
         return (a1/x1) * x * x / 2.0;
     }
 
-    // --- otherwise traverse table entries until target depth is bracketed
-    while (entry->next)
+    // --- target depth is bracketed - apply end area method to
+    //     interpolated area
+    i = table_findItem(table, xx, x);
+    if (i < n)
     {
-        entry = entry->next;
-        // --- target is bracketed - apply end area method to interpolated area
-        if (entry->x >= x)
-        {
-            a = table_interpolate(x, x1, a1, entry->x, entry->y);
-            return v + (a1 + a) / 2.0 * (x - x1);
-        }
-        // --- target not yet bracketed so update volume using end area method
-        else
-        {
-            dx = entry->x - x1;
-            dy = entry->y - a1;
-            v = v + (a1 + entry->y) / 2.0 * dx;
-            x1 = entry->x;
-            a1 = entry->y;
-        }
+        x1 = xx[i-1];
+        a1 = yy[i-1];
+        a = table_interpolate(x, x1, a1, xx[i], yy[i]);
+        return table->vItems[i-1] + (a1 + a) / 2.0 * (x - x1);
     }
 
     // --- extrapolate area if table limit exceeded
+    v = table->vItems[n-1];
+    if (n < 2) return v;
+    x1 = xx[n-1];
+    a1 = yy[n-1];
+    dx = x1 - xx[n-2];
+    dy = a1 - yy[n-2];
     if (dx > 1.0e-6)
     {
         s = dy / dx;
@@ -655,62 +782,90 @@ double table_getStorageDepth(TTable *table, double v)
 //  Output:  returns a storage depth 
 //  Purpose: finds depth for a given volume in a Storage Curve table.
 //
+//  NOTE: table_createVolumes must have been called for the table.
+//
 {
-    double a1, a2, d1, d2, dd = 0.0, da = 0.0, v1, v2, s;
-    TTableEntry* entry;
+    int     i, lo, hi, n = table->nItems;
+    double  a1, a2, d1, d2, dd = 0.0, da = 0.0, v0, v1, v2, s;
+    double* vv = table->vItems;
 
     // --- see if target volume is below that of 1st table entry
     if (v == 0.0) return 0.0;
-    entry = table->firstEntry;
-    if (entry == NULL) return 0.0;
-    d1 = entry->x;
-    a1 = entry->y;
-    v1 = a1 * d1 / 2.0;
+    if (n == 0 || vv == NULL) return 0.0;
+    d1 = table->xItems[0];
+    a1 = table->yItems[0];
+    v0 = a1 * d1 / 2.0;
+    v1 = v0;
     if (v <= v1)
     {
         if (a1 > 0.0) return sqrt(2.0 * v * d1 / a1);
         else return 0.0;
     }
 
-    // --- add next table entry to volume until target volume is bracketed
-    while (entry->next)
+    // --- find first table entry whose cumulative volume is >= v
+    //     (by binary search if volumes never decrease, starting with
+    //     the interval found by the last lookup)
+    if ( table->vAscending )
     {
-        entry = entry->next;
-        d2 = entry->x;
-        a2 = entry->y;
-        dd = d2 - d1;
-        da = a2 - a1;
-        v2 = v1 + (a1 + a2) / 2.0 * dd;
-
-        // target volume is bracketed
-        if (v <= v2)
+        #pragma omp atomic read
+        i = table->lastItem;
+        if ( i <= 0 || i >= n || v <= v0 + vv[i-1] || v > v0 + vv[i] )
         {
-            // --- target coincides with point on curve
-            if (dd <= 0.0) return d1;
-            if (da == 0.0)
+            lo = 1;
+            hi = n;
+            while ( lo < hi )
             {
-                if (fabs(v2 - v1) < 1.e-6) return d1;
-                else return d1 + dd * (v - v1) / (v2 - v1);
+                i = (lo + hi) / 2;
+                if ( v <= v0 + vv[i] ) hi = i;
+                else lo = i + 1;
             }
-            // --- if area decreases with depth then replace point 1 with point 2
-            if (da < 0.0)
-            {
-                d1 = d2;
-                a1 = a2;
-                v1 = v2;
-            }
-            // --- interpolate between volumes derived from curve
-            s = da / dd;
-            return d1 + (sqrt(a1*a1 + 2.0*s*(v-v1)) - a1) / s;
+            i = lo;
+            #pragma omp atomic write
+            table->lastItem = i;
         }
+    }
+    else for ( i = 1; i < n; i++ ) if ( v <= v0 + vv[i] ) break;
 
-        // --- replace point 1 with point 2
-        d1 = d2;
-        a1 = a2;
-        v1 = v2;
+    // --- target volume is bracketed
+    if (i < n)
+    {
+        d1 = table->xItems[i-1];
+        a1 = table->yItems[i-1];
+        v1 = v0 + vv[i-1];
+        d2 = table->xItems[i];
+        a2 = table->yItems[i];
+        v2 = v0 + vv[i];
+        dd = d2 - d1;
+        da = a2 - a1;
+
+        // --- target coincides with point on curve
+        if (dd <= 0.0) return d1;
+        if (da == 0.0)
+        {
+            if (fabs(v2 - v1) < 1.e-6) return d1;
+            else return d1 + dd * (v - v1) / (v2 - v1);
+        }
+        // --- if area decreases with depth then replace point 1 with point 2
+        if (da < 0.0)
+        {
+            d1 = d2;
+            a1 = a2;
+            v1 = v2;
+        }
+        // --- interpolate between volumes derived from curve
+        s = da / dd;
+        return d1 + (sqrt(a1*a1 + 2.0*s*(v-v1)) - a1) / s;
     }
 
     // --- extrapolate volume if table limit exceeded
+    if (n > 1)
+    {
+        dd = table->xItems[n-1] - table->xItems[n-2];
+        da = table->yItems[n-1] - table->yItems[n-2];
+        d1 = table->xItems[n-1];
+        a1 = table->yItems[n-1];
+        v1 = v0 + vv[n-1];
+    }
     if (dd == 0.0 || da == 0.0)
     {
         if (a1 > 0.0) dd = (v - v1) / a1;
@@ -104,6 +104,21 @@
 #define  w_MIN_ROUTE_STEP    "MINIMUM_STEP"
 #define  w_NUM_THREADS       "THREADS"
 #define  w_SURCHARGE_METHOD  "SURCHARGE_METHOD"
+#define  w_PARALLEL_NODE_FLOWS "PARALLEL_NODE_FLOWS"
+#define  w_NETWORK_ORDER     "NETWORK_ORDER"
+#define  w_SOLVER_METHOD     "SOLVER_METHOD"
+#define  w_RELAXATION        "RELAXATION"
+#define  w_STEP_CLASSES      "STEP_CLASSES"
+#define  w_SKIP_DORMANT      "SKIP_DORMANT"
+#define  w_DETERMINISTIC     "DETERMINISTIC"
+#define  w_LOAD_BALANCING    "LOAD_BALANCING"
+#define  w_GEOMETRY_TOL      "GEOMETRY_TOL"
+#define  w_DEPTH_CURVES      "DEPTH_CURVES"
+#define  w_TRANSECT_TOL      "TRANSECT_TOL"
+#define  w_INLET_CURVES      "INLET_CURVES"
+#define  w_FRICTION_CURVES   "FRICTION_CURVES"
+#define  w_CULVERT_CURVES    "CULVERT_CURVES"
+#define  w_SKIP_DRY_SUBCATCH "SKIP_DRY_SUBCATCH"
 
 // Flow Units
 #define  w_CFS               "CFS"
@@ -128,6 +143,16 @@
 #define  w_EXTRAN            "EXTRAN"
 #define  w_SLOT              "SLOT"
 
+// Network Ordering Methods
+#define  w_RCM               "RCM"
+
+// Dynamic Wave Solver Methods
+#define  w_PICARD            "PICARD"
+#define  w_NEWTON            "NEWTON"
+
+// Picard Iteration Relaxation Methods
+#define  w_AITKEN            "AITKEN"
+
 // Infiltration Methods
 #define  w_HORTON            "HORTON"
 #define  w_MOD_HORTON        "MODIFIED_HORTON"
@@ -14,6 +14,8 @@
 //   - Function added to create a transect for a Street cross-section.
 //   Build 5.2.4:
 //   - Corrected street transect points in transect_createStreetTransect.
+//   - Sections with identical station data share one set of geometry tables.
+//   - Optional adaptive geometry tables added (TRANSECT_TOL option).
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -26,6 +28,24 @@
 //  Constants
 //-----------------------------------------------------------------------------
 #define MAXSTATION 1500                // max. number of stations in a transect
+#define MAXTBL     4000                // max. size of adaptive geometry tables
+#define MINDEPTH   1.0e-4              // min. depth increment of adaptive
+                                       //   tables (fraction of full depth)
+#define NBUCKETS   256                 // size of geometry table hash index
+#define NKEYS      (7 + 2*(MAXSTATION+1)) // max. size of a table set's key
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct                         // geometry tables shared by all
+{                                      //   sections with same station data
+    unsigned int hash;                 // hash value of station data
+    int          nKeys;                // number of station data values
+    double*      keys;                 // station data tables were built from
+    double*      data;                 // memory block holding the tables
+    TTransect    geom;                 // geometry tables & full section values
+    int          next;                 // next table set in same bucket (+1)
+}   TTableSet;
 
 //-----------------------------------------------------------------------------
 //  Shared variables
@@ -42,6 +62,17 @@ static double  Xrightbank;             // station where right overbank begins
 static double  Xfactor;                // multiplier for station spacing
 static double  Yfactor;                // factor added to station elevations
 static double  Lfactor;                // main channel/flood plain length
+static double  Keys[NKEYS];            // station data of current section
+static double  Elevs[MAXSTATION+1];    // sorted station elevations
+static double  WorkY[MAXTBL];          // work arrays for adaptive tables
+static double  WorkA[MAXTBL];
+static double  WorkR[MAXTBL];
+static double  WorkW[MAXTBL];
+static int     Nwork;                  // number of entries in work arrays
+static int        NtableSets;          // number of geometry table sets
+static int        MaxTableSets;        // allocated size of TableSets array
+static TTableSet* TableSets;           // distinct geometry table sets
+static int        Buckets[NBUCKETS];   // first table set in each bucket (+1)
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)   
@@ -60,7 +91,17 @@ static int    setManning(double n[]);
 static int    addStation(double x, double y);
 static double getFlow(int k, double a, double wp, int findFlow);
 static void   createTables(TTransect *transect, double ymin, double ymax);
-static void   getGeometry(TTransect *transect, int i, double y);
+static int    findTableSet(double ymin, double ymax, unsigned int *hash);
+static TTableSet* addTableSet(unsigned int hash);
+static int    createUniformTables(TTableSet *set, double ymin, double ymax);
+static int    createAdaptiveTables(TTableSet *set, double ymin, double ymax);
+static void   refineTables(double y1, double g1[], double y2, double g2[],
+              double gFull[], double yFull);
+static int    allocTables(TTableSet *set, int n, int hasDepths);
+static void   normalizeTables(TTransect *transect);
+static void   copyTables(TTransect *transect, TTransect *geom);
+static int    compareElevs(const void *e1, const void *e2);
+static void   getGeometry(double y, double *a, double *w, double *r);
 static void   getSliceGeom(int k, double y, double yu, double yd, double *w,
               double *a, double *wp);
 static void   setMaxSectionFactor(TTransect *transect);
@@ -91,9 +132,23 @@ void transect_delete(void)
 //
 //  Input:   none
 //  Output:  none
-//  Purpose: deletes memory allocated for all transects.
+//  Purpose: deletes memory allocated for all transects and for the
+//           geometry tables used by transects and streets.
 //
 {
+    int i;
+
+    // --- free the geometry tables shared by transects & streets
+    for (i = 0; i < NtableSets; i++)
+    {
+        FREE(TableSets[i].keys);
+        FREE(TableSets[i].data);
+    }
+    FREE(TableSets);
+    NtableSets = 0;
+    MaxTableSets = 0;
+    for (i = 0; i < NBUCKETS; i++) Buckets[i] = 0;
+
     if ( Ntransects == 0 ) return;
     FREE(Transect);
     Ntransects = 0;
@@ -252,7 +307,6 @@ void  transect_validate(int j)
     Elev[Nstations] = Elev[0];
 
     // --- create geometry tables
-    Transect[j].nTbl = N_TRANSECT_TBL;
     createTables(&Transect[j], ymin, ymax);
 
     // --- save unadjusted main channel roughness 
@@ -262,17 +316,152 @@ void  transect_validate(int j)
 //=============================================================================
 
 void createTables(TTransect *transect, double ymin, double ymax)
+//
+//  Input:   transect = transect being analyzed
+//           ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  none
+//  Purpose: assigns a set of geometry tables to a transect, re-using the
+//           tables of a previous section with identical station data.
+//
 {
-    int    i, nLast;
-    double dy, y;
+    int          k;
+    int          ok;
+    unsigned int hash;
+    TTableSet*   set;
+
+    // --- check if tables were already built for the same station data
+    k = findTableSet(ymin, ymax, &hash);
+    if ( k >= 0 )
+    {
+        copyTables(transect, &TableSets[k].geom);
+        return;
+    }
 
-    transect->yFull = ymax - ymin;
-    transect->wMax = 0.0;
+    // --- otherwise build a new set of tables
+    set = addTableSet(hash);
+    if ( set == NULL ) ok = FALSE;
+    else if ( TransectTol > 0.0 ) ok = createAdaptiveTables(set, ymin, ymax);
+    else ok = createUniformTables(set, ymin, ymax);
+    if ( !ok )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    copyTables(transect, &set->geom);
+}
+
+//=============================================================================
+
+int findTableSet(double ymin, double ymax, unsigned int *hash)
+//
+//  Input:   ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  hash = hash value of current station data;
+//           returns index of table set built from the same station data
+//           or -1 if there is none
+//  Purpose: looks up the geometry tables of the section currently being
+//           processed.
+//
+{
+    int           i, k, n;
+    unsigned int  h = 2166136261u;
+    unsigned char *bytes;
+
+    // --- place all data that the tables depend on in Keys array
+    Keys[0] = ymin;
+    Keys[1] = ymax;
+    Keys[2] = Nleft;
+    Keys[3] = Nright;
+    Keys[4] = Nchannel;
+    Keys[5] = Xleftbank;
+    Keys[6] = Xrightbank;
+    n = 7;
+    for (i = 0; i <= Nstations; i++)
+    {
+        Keys[n++] = Station[i];
+        Keys[n++] = Elev[i];
+    }
+
+    // --- compute the key's FNV-1a hash value
+    bytes = (unsigned char *)Keys;
+    for (i = 0; i < n * (int)sizeof(double); i++)
+    {
+        h ^= bytes[i];
+        h *= 16777619u;
+    }
+    *hash = h;
 
-    // --- set 1st table entries to zero
-    transect->areaTbl[0] = 0.0;
-    transect->hradTbl[0] = 0.0;
-    transect->widthTbl[0] = 0.0;
+    // --- search the hash bucket for a table set with the same key
+    k = Buckets[h % NBUCKETS] - 1;
+    while ( k >= 0 )
+    {
+        if ( TableSets[k].hash == h && TableSets[k].nKeys == n &&
+             memcmp(TableSets[k].keys, Keys, n * sizeof(double)) == 0 )
+            return k;
+        k = TableSets[k].next - 1;
+    }
+    return -1;
+}
+
+//=============================================================================
+
+TTableSet* addTableSet(unsigned int hash)
+//
+//  Input:   hash = hash value of current station data
+//  Output:  returns a pointer to a new table set or NULL if out of memory
+//  Purpose: adds an empty set of geometry tables for the station data held
+//           in the Keys array.
+//
+{
+    int        n;
+    TTableSet* sets;
+    TTableSet* set;
+
+    // --- enlarge the TableSets array if need be
+    if ( NtableSets == MaxTableSets )
+    {
+        n = MAX(2 * MaxTableSets, 16);
+        sets = (TTableSet *) realloc(TableSets, n * sizeof(TTableSet));
+        if ( sets == NULL ) return NULL;
+        TableSets = sets;
+        MaxTableSets = n;
+    }
+
+    // --- save a copy of the station data the tables are built from
+    n = 7 + 2 * (Nstations + 1);
+    set = &TableSets[NtableSets];
+    memset(set, 0, sizeof(TTableSet));
+    set->keys = (double *) malloc(n * sizeof(double));
+    if ( set->keys == NULL ) return NULL;
+    memcpy(set->keys, Keys, n * sizeof(double));
+    set->nKeys = n;
+
+    // --- add the set to its hash bucket
+    set->hash = hash;
+    set->next = Buckets[hash % NBUCKETS];
+    NtableSets++;
+    Buckets[hash % NBUCKETS] = NtableSets;
+    return set;
+}
+
+//=============================================================================
+
+int createUniformTables(TTableSet *set, double ymin, double ymax)
+//
+//  Input:   set = table set being built
+//           ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  returns FALSE if out of memory, TRUE otherwise
+//  Purpose: creates geometry tables at equally spaced depths.
+//
+{
+    int        i;
+    double     dy, y, a, w, r;
+    TTransect* transect = &set->geom;
+
+    if ( !allocTables(set, N_TRANSECT_TBL, FALSE) ) return FALSE;
+    transect->yFull = ymax - ymin;
 
     // --- compute geometry for each depth increment
     dy = (ymax - ymin) / ((double)(transect->nTbl) - 1);
@@ -280,11 +469,216 @@ void createTables(TTransect *transect, double ymin, double ymax)
     for (i = 1; i < transect->nTbl; i++)
     {
         y += dy;
-        transect->areaTbl[i] = 0.0;
-        transect->hradTbl[i] = 0.0;
-        transect->widthTbl[i] = 0.0;
-        getGeometry(transect, i, y);
+        getGeometry(y, &a, &w, &r);
+        transect->areaTbl[i] = a;
+        transect->widthTbl[i] = w;
+        if ( a == 0.0 ) transect->hradTbl[i] = transect->hradTbl[i-1];
+        else            transect->hradTbl[i] = r;
     }
+    normalizeTables(transect);
+    return TRUE;
+}
+
+//=============================================================================
+
+int createAdaptiveTables(TTableSet *set, double ymin, double ymax)
+//
+//  Input:   set = table set being built
+//           ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  returns FALSE if out of memory, TRUE otherwise
+//  Purpose: creates geometry tables with an entry at each distinct station
+//           elevation plus whatever entries in between are needed for
+//           linear interpolation to meet the TRANSECT_TOL error tolerance.
+//
+{
+    int        i, k;
+    double     dyMin, y, yLast;
+    double     g[3], gLast[3], gFull[3];
+    TTransect* transect = &set->geom;
+
+    // --- geometry of the full section sets the scale of the tolerance
+    dyMin = MINDEPTH * (ymax - ymin);
+    getGeometry(ymax, &gFull[0], &gFull[2], &gFull[1]);
+
+    // --- first entry is the empty section whose width is that of
+    //     any flat portions of the channel bottom
+    gLast[0] = 0.0;
+    gLast[1] = 0.0;
+    gLast[2] = 0.0;
+    for (i = 1; i <= Nstations; i++)
+    {
+        if ( Elev[i-1] == ymin && Elev[i] == ymin )
+            gLast[2] += fabs(Station[i] - Station[i-1]);
+    }
+    WorkY[0] = ymin;
+    WorkA[0] = 0.0;
+    WorkR[0] = 0.0;
+    WorkW[0] = gLast[2];
+    Nwork = 1;
+    yLast = ymin;
+
+    // --- visit station elevations in increasing order
+    k = 0;
+    for (i = 0; i <= Nstations; i++)
+    {
+        if ( Elev[i] > ymin && Elev[i] < ymax ) Elevs[k++] = Elev[i];
+    }
+    qsort(Elevs, k, sizeof(double), compareElevs);
+    for (i = 0; i <= k; i++)
+    {
+        if ( i == k ) y = ymax;
+        else y = Elevs[i];
+        if ( i < k && (y - yLast < dyMin || ymax - y < dyMin) ) continue;
+        if ( y == ymax )
+        {
+            g[0] = gFull[0];
+            g[1] = gFull[1];
+            g[2] = gFull[2];
+        }
+        else getGeometry(y, &g[0], &g[2], &g[1]);
+
+        // --- add entries between the last elevation and this one
+        //     followed by an entry for this elevation
+        refineTables(yLast, gLast, y, g, gFull, ymax - ymin);
+        WorkY[Nwork] = y;
+        WorkA[Nwork] = g[0];
+        WorkR[Nwork] = g[1];
+        WorkW[Nwork] = g[2];
+        Nwork++;
+        yLast = y;
+        gLast[0] = g[0];
+        gLast[1] = g[1];
+        gLast[2] = g[2];
+    }
+
+    // --- transfer the work arrays to the set's tables
+    if ( !allocTables(set, Nwork, TRUE) ) return FALSE;
+    transect->yFull = ymax - ymin;
+    for (i = 1; i < Nwork; i++)
+    {
+        transect->depthTbl[i] = (WorkY[i] - ymin) / transect->yFull;
+        transect->areaTbl[i] = WorkA[i];
+        transect->hradTbl[i] = WorkR[i];
+        transect->widthTbl[i] = WorkW[i];
+    }
+    transect->depthTbl[Nwork-1] = 1.0;
+    normalizeTables(transect);
+
+    // --- keep the actual width of a flat channel bottom at zero depth
+    if ( WorkW[0] > 0.0 ) transect->widthTbl[0] = WorkW[0] / transect->wMax;
+    return TRUE;
+}
+
+//=============================================================================
+
+void refineTables(double y1, double g1[], double y2, double g2[],
+                  double gFull[], double yFull)
+//
+//  Input:   y1, y2 = elevations at ends of a table interval
+//           g1, g2 = area, hyd. radius & width at y1 and y2
+//           gFull = area, hyd. radius & width of full section
+//           yFull = full depth of section
+//  Output:  none
+//  Purpose: adds entries to the adaptive work tables between elevations
+//           y1 and y2 until linear interpolation between them is accurate.
+//
+{
+    int    i;
+    double y, yInterp, g[3], err, errMax = 0.0;
+
+    // --- leave room for the remaining station elevations
+    if ( Nwork >= MAXTBL - MAXSTATION - 2 ) return;
+    if ( y2 - y1 < 2.0 * MINDEPTH * yFull ) return;
+
+    // --- compare geometry at the interval's mid-point to the
+    //     interpolated value
+    y = (y1 + y2) / 2.0;
+    getGeometry(y, &g[0], &g[2], &g[1]);
+    if ( g[0] == 0.0 ) g[1] = g1[1];
+    for (i = 0; i < 3; i++)
+    {
+        if ( gFull[i] <= 0.0 ) continue;
+        err = fabs(g[i] - (g1[i] + g2[i]) / 2.0) / gFull[i];
+        errMax = MAX(errMax, err);
+    }
+
+    // --- also compare the mid-point depth to the depth interpolated
+    //     from its area (as used to find depth from area)
+    if ( g2[0] > g1[0] )
+    {
+        yInterp = y1 + (g[0] - g1[0]) / (g2[0] - g1[0]) * (y2 - y1);
+        errMax = MAX(errMax, fabs(y - yInterp) / yFull);
+    }
+
+    // --- the first interval of a sloping channel bottom is kept as short
+    //     as in a uniform table since its width is also used at zero depth
+    if ( y1 == WorkY[0] && WorkW[0] == 0.0 &&
+         y2 - y1 > yFull / (N_TRANSECT_TBL - 1) ) errMax = BIG;
+    if ( errMax <= TransectTol ) return;
+
+    // --- split the interval at its mid-point
+    refineTables(y1, g1, y, g, gFull, yFull);
+    WorkY[Nwork] = y;
+    WorkA[Nwork] = g[0];
+    WorkR[Nwork] = g[1];
+    WorkW[Nwork] = g[2];
+    Nwork++;
+    refineTables(y, g, y2, g2, gFull, yFull);
+}
+
+//=============================================================================
+
+int allocTables(TTableSet *set, int n, int hasDepths)
+//
+//  Input:   set = table set being built
+//           n = number of table entries
+//           hasDepths = TRUE if the tables have their own depth entries
+//  Output:  returns FALSE if out of memory, TRUE otherwise
+//  Purpose: allocates zeroed geometry tables for a table set.
+//
+{
+    int        m = hasDepths ? 4 : 3;
+    TTransect* transect = &set->geom;
+
+    set->data = (double *) calloc(m * n, sizeof(double));
+    if ( set->data == NULL ) return FALSE;
+    transect->nTbl = n;
+    transect->areaTbl = set->data;
+    transect->hradTbl = set->data + n;
+    transect->widthTbl = set->data + 2 * n;
+    if ( hasDepths ) transect->depthTbl = set->data + 3 * n;
+    else transect->depthTbl = NULL;
+    return TRUE;
+}
+
+//=============================================================================
+
+int compareElevs(const void *e1, const void *e2)
+//
+//  Input:   e1, e2 = pointers to two elevations
+//  Output:  returns -1, 0 or 1 as e1 is below, at or above e2
+//  Purpose: comparison function used to sort station elevations.
+//
+{
+    double y1 = *(const double *)e1;
+    double y2 = *(const double *)e2;
+    if ( y1 < y2 ) return -1;
+    if ( y1 > y2 ) return 1;
+    return 0;
+}
+
+//=============================================================================
+
+void normalizeTables(TTransect *transect)
+//
+//  Input:   transect = transect being analyzed
+//  Output:  none
+//  Purpose: finds a transect's full section properties and normalizes its
+//           geometry tables with them.
+//
+{
+    int i, nLast;
 
     // --- determine max. section factor 
     setMaxSectionFactor(transect);
@@ -309,6 +703,29 @@ void createTables(TTransect *transect, double ymin, double ymax)
 
 //=============================================================================
 
+void copyTables(TTransect *transect, TTransect *geom)
+//
+//  Input:   transect = transect receiving geometry tables
+//           geom = geometry tables & full section properties
+//  Output:  none
+//  Purpose: assigns a set of geometry tables to a transect.
+//
+{
+    transect->yFull = geom->yFull;
+    transect->aFull = geom->aFull;
+    transect->rFull = geom->rFull;
+    transect->wMax = geom->wMax;
+    transect->sMax = geom->sMax;
+    transect->aMax = geom->aMax;
+    transect->depthTbl = geom->depthTbl;
+    transect->areaTbl = geom->areaTbl;
+    transect->hradTbl = geom->hradTbl;
+    transect->widthTbl = geom->widthTbl;
+    transect->nTbl = geom->nTbl;
+}
+
+//=============================================================================
+
 int  setManning(double n[])
 //
 //  Input:   n[] = array of Manning's n values
@@ -385,13 +802,13 @@ int  addStation(double y, double x)
 
 //=============================================================================
 
-void  getGeometry(TTransect *transect, int i, double y)
+void  getGeometry(double y, double *aTotal, double *wTotal, double *r)
 //
-//  Input:   transect = transect being analyzed
-//           i = index of current entry in geometry tables
-//           y = depth of current entry in geometry tables
-//  Output:  none
-//  Purpose: computes entries in a transect's geometry tables at a given depth. 
+//  Input:   y = water surface elevation
+//  Output:  aTotal = flow area
+//           wTotal = top width
+//           r = hyd. radius (0 if flow area is 0)
+//  Purpose: computes a transect's geometry at a given water elevation.
 //
 {
     int    k;                // station index
@@ -410,6 +827,8 @@ void  getGeometry(TTransect *transect, int i, double y)
     wpSum = 0.0;
     aSum = 0.0;
     qSum = 0.0;
+    *aTotal = 0.0;
+    *wTotal = 0.0;
 
     // --- examine each horizontal station from left to right
     for (k = 1; k <= Nstations; k++)
@@ -436,8 +855,8 @@ void  getGeometry(TTransect *transect, int i, double y)
         // --- update total transect values
         wpSum += wp;
         aSum += a;
-        transect->areaTbl[i] += a;
-        transect->widthTbl[i] += w;
+        *aTotal += a;
+        *wTotal += w;
 
         // --- must update flow if station elevation is above water level
         if ( Elev[k] >= y ) findFlow = TRUE;
@@ -454,13 +873,11 @@ void  getGeometry(TTransect *transect, int i, double y)
 
     }   // next station k 
 
-    // --- find hyd. radius table entry solving Manning eq. with
+    // --- find hyd. radius solving Manning eq. with
     //     total flow, total area, and main channel n
-    aSum = transect->areaTbl[i];
-    if ( aSum == 0.0 )
-        transect->hradTbl[i] = transect->hradTbl[i-1];
-    else
-        transect->hradTbl[i] = pow(qSum * Nchannel / 1.49 / aSum, 1.5);
+    aSum = *aTotal;
+    if ( aSum == 0.0 ) *r = 0.0;
+    else *r = pow(qSum * Nchannel / 1.49 / aSum, 1.5);
 }
 
 //=============================================================================
@@ -636,7 +1053,6 @@ void  transect_createStreetTransect(TStreet* street)
         Station[5] = Station[4];
         Elev[5] = ymax;
         Nstations = 5;
-        street->transect.nTbl = N_TRANSECT_TBL;
     }
 
     // --- the right side of a full street mirrors the left side
@@ -651,7 +1067,6 @@ void  transect_createStreetTransect(TStreet* street)
         Station[8] = Station[7] + w1;
         Elev[8] = ymax;
         Nstations = 8;
-        street->transect.nTbl = N_TRANSECT_TBL;
     }
 
     // --- assign Manning's N to street
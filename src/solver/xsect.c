@@ -34,9 +34,15 @@
 //   - Support added for Street cross sections.
 //   Build 5.2.2:
 //   - Feasibility check added to Mod. Baskethandle & Rect.-Round shapes.
+//   Build 5.2.4:
+//   - Optional uniform geometry tables added with a user-supplied error
+//     tolerance.
+//   - Lookups added for transect geometry tables with unevenly spaced
+//     depths.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>
 #include <math.h>
 #include "headers.h"
 #include "findroot.h"
@@ -44,6 +50,14 @@
 #define  RECT_ALFMAX        0.97
 #define  RECT_TRIANG_ALFMAX 0.98
 #define  RECT_ROUND_ALFMAX  0.98
+#define  MIN_GEOM_ITEMS     33     // initial size of uniform geometry tables
+#define  MAX_GEOM_ITEMS     4097   // max. size of uniform geometry tables
+#define  GEOM_EDGE          1.0e-9 // offset of last table item from full value
+#define  GEOM_LIST_SIZE     64     // growth increment of geometry table list
+
+// Kinds of uniform geometry tables
+enum GeomTableType {AOFY_TABLE, ROFY_TABLE, WOFY_TABLE, YOFA_TABLE,
+                    SOFA_TABLE, AOFS_TABLE};
 
 #include "xsect.dat"    // File containing geometry tables for rounded shapes
 
@@ -90,6 +104,10 @@ typedef struct
     TXsect* xsect;            // pointer to a cross section object
 } TXsectStar;
 
+static int           NgeomTables;   // number of distinct geometry table sets
+static TXsect*       GeomXsects;    // cross sections the table sets belong to
+static TGeomTables** GeomTables;    // uniform geometry table sets
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -108,6 +126,9 @@ typedef struct
 //  xsect_getRofY
 //  xsect_getWofY
 //  xsect_getYcrit
+//  xsect_createTables
+//  xsect_deleteTables
+//  xsect_getTableStats
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -121,6 +142,8 @@ static double generic_getdSdA(TXsect* xsect, double a);
 static double lookup(double x, double *table, int nItems);
 static double invLookup(double y, double *table, int nItems);
 static int    locate(double y, double *table, int nItems);
+static double transectLookup(TTransect* transect, double x, double *table);
+static double transectInvLookup(TTransect* transect, double y);
 
 static double rect_closed_getSofA(TXsect* xsect, double a);
 static double rect_closed_getdSdA(TXsect* xsect, double a);
@@ -199,6 +222,12 @@ static double getQcritical(double yc, void* p);
 static double getYcritEnum(TXsect* xsect, double q, double y0);
 static double getYcritRidder(TXsect* xsect, double q, double y0);
 
+static int    isSameXsect(TXsect* xsect1, TXsect* xsect2);
+static int    createGeomTable(TXsect* xsect, TGeomTables* tables, int k,
+              double tol);
+static double getExactValue(TXsect* xsect, int k, double x);
+static int    getTableValue(TGeomTables* tables, int k, double x, double* f);
+
 //=============================================================================
 
 int xsect_isOpen(int type)
@@ -721,6 +750,8 @@ double xsect_getSofA(TXsect *xsect, double a)
 {
     double alpha = a / xsect->aFull;
     double r;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, SOFA_TABLE, a, &r) ) return r;
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -779,6 +810,9 @@ double xsect_getYofA(TXsect *xsect, double a)
 //
 {
     double alpha = a / xsect->aFull;
+    double y;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, YOFA_TABLE, a, &y) ) return y;
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -815,17 +849,16 @@ double xsect_getYofA(TXsect *xsect, double a)
         return xsect->yFull * invLookup(alpha, A_VertEllipse, N_A_VertEllipse);
 
       case IRREGULAR:
-        return xsect->yFull * invLookup(alpha,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+        return xsect->yFull * transectInvLookup(&Transect[xsect->transect],
+            alpha);
 
       case CUSTOM:
         return xsect->yFull * invLookup(alpha,
             Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
 
       case STREET_XSECT:
-        return xsect->yFull * invLookup(alpha,
-            Street[xsect->transect].transect.areaTbl, 
-            Street[xsect->transect].transect.nTbl);
+        return xsect->yFull * transectInvLookup(&Street[xsect->transect].transect,
+            alpha);
 
       case ARCH:
         return xsect->yFull * invLookup(alpha, A_Arch, N_A_Arch);
@@ -863,7 +896,10 @@ double xsect_getAofY(TXsect *xsect, double y)
 //
 {
     double yNorm = y / xsect->yFull;
+    double a;
     if ( y <= 0.0 ) return 0.0;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, AOFY_TABLE, y, &a) ) return a;
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -904,17 +940,16 @@ double xsect_getAofY(TXsect *xsect, double y)
         return xsect->aFull * lookup(yNorm, A_Arch, N_A_Arch);
 
       case IRREGULAR:
-        return xsect->aFull * lookup(yNorm,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+        return xsect->aFull * transectLookup(&Transect[xsect->transect],
+            yNorm, Transect[xsect->transect].areaTbl);
 
       case CUSTOM:
         return xsect->aFull * lookup(yNorm,
             Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
 
       case STREET_XSECT:
-          return xsect->aFull * lookup(yNorm,
-              Street[xsect->transect].transect.areaTbl,
-              Street[xsect->transect].transect.nTbl);
+          return xsect->aFull * transectLookup(&Street[xsect->transect].transect,
+              yNorm, Street[xsect->transect].transect.areaTbl);
 
      case RECT_CLOSED:  return y * xsect->wMax;
 
@@ -949,6 +984,9 @@ double xsect_getWofY(TXsect *xsect, double y)
 //
 {
     double yNorm = y / xsect->yFull;
+    double w;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, WOFY_TABLE, y, &w) ) return w;
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -990,17 +1028,16 @@ double xsect_getWofY(TXsect *xsect, double y)
         return xsect->wMax * lookup(yNorm, W_Arch, N_W_Arch);
 
       case IRREGULAR:
-        return xsect->wMax * lookup(yNorm,
-            Transect[xsect->transect].widthTbl, N_TRANSECT_TBL);
+        return xsect->wMax * transectLookup(&Transect[xsect->transect],
+            yNorm, Transect[xsect->transect].widthTbl);
 
       case CUSTOM:
         return xsect->wMax * lookup(yNorm,
             Shape[Curve[xsect->transect].refersTo].widthTbl, N_SHAPE_TBL);
 
       case STREET_XSECT:
-          return xsect->wMax * lookup(yNorm,
-              Street[xsect->transect].transect.widthTbl,
-              Street[xsect->transect].transect.nTbl);
+          return xsect->wMax * transectLookup(&Street[xsect->transect].transect,
+              yNorm, Street[xsect->transect].transect.widthTbl);
 
       case RECT_CLOSED: 
           if (yNorm == 1.0) return 0.0;
@@ -1037,6 +1074,9 @@ double xsect_getRofY(TXsect *xsect, double y)
 //
 {
     double yNorm = y / xsect->yFull;
+    double r;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, ROFY_TABLE, y, &r) ) return r;
     switch ( xsect->type )
     {
       case FORCE_MAIN:
@@ -1067,17 +1107,16 @@ double xsect_getRofY(TXsect *xsect, double y)
         return xsect->rFull * lookup(yNorm, R_Arch, N_R_Arch);
 
       case IRREGULAR:
-        return xsect->rFull * lookup(yNorm,
-            Transect[xsect->transect].hradTbl, N_TRANSECT_TBL);
+        return xsect->rFull * transectLookup(&Transect[xsect->transect],
+            yNorm, Transect[xsect->transect].hradTbl);
 
       case CUSTOM:
         return xsect->rFull * lookup(yNorm,
             Shape[Curve[xsect->transect].refersTo].hradTbl, N_SHAPE_TBL);
 
       case STREET_XSECT:
-          return xsect->rFull * lookup(yNorm,
-              Street[xsect->transect].transect.hradTbl,
-              Street[xsect->transect].transect.nTbl);
+          return xsect->rFull * transectLookup(&Street[xsect->transect].transect,
+              yNorm, Street[xsect->transect].transect.hradTbl);
 
       case RECT_TRIANG:  return rect_triang_getRofY(xsect, y);
 
@@ -1155,7 +1194,10 @@ double xsect_getAofS(TXsect* xsect, double s)
 //
 {
     double psi = s / xsect->sFull;
+    double a;
     if ( s <= 0.0 ) return 0.0;
+    if ( xsect->tables &&
+         getTableValue(xsect->tables, AOFS_TABLE, s, &a) ) return a;
     if ( s > xsect->sMax ) s = xsect->sMax;
     switch ( xsect->type )
     {
@@ -1351,7 +1393,10 @@ void getTransectParams(TXsect *xsect, TTransect *transect)
     }
 
     // Determine height at lowest widest point
-    xsect->ywMax = xsect->yFull * (double)iMax / ((double)(transect->nTbl) - 1);
+    if ( transect->depthTbl )
+        xsect->ywMax = xsect->yFull * transect->depthTbl[iMax];
+    else
+        xsect->ywMax = xsect->yFull * (double)iMax / ((double)(transect->nTbl) - 1);
 }
 
 //=============================================================================
@@ -1609,6 +1654,54 @@ int locate(double y, double *table, int jLast)
 
 //=============================================================================
 
+double transectLookup(TTransect* transect, double x, double *table)
+//
+//  Input:   transect = ptr. to a transect's geometry tables
+//           x = normalized depth
+//           table = one of the transect's area, hyd. radius or width tables
+//  Output:  returns normalized value of the table's variable
+//  Purpose: looks up a value in a transect's geometry table whose depths are
+//           either equally spaced or listed in its depth table.
+//
+{
+    int     i;
+    int     n = transect->nTbl;
+    double* xTbl = transect->depthTbl;
+
+    if ( xTbl == NULL ) return lookup(x, table, n);
+    if ( x <= 0.0 ) return table[0];
+    if ( x >= 1.0 ) return table[n-1];
+    i = locate(x, xTbl, n - 1);
+    return table[i] + (x - xTbl[i]) * (table[i+1] - table[i]) /
+           (xTbl[i+1] - xTbl[i]);
+}
+
+//=============================================================================
+
+double transectInvLookup(TTransect* transect, double y)
+//
+//  Input:   transect = ptr. to a transect's geometry tables
+//           y = normalized area
+//  Output:  returns normalized depth
+//  Purpose: finds the depth in a transect's geometry tables at which a
+//           given area occurs.
+//
+{
+    int     i;
+    int     n = transect->nTbl;
+    double* xTbl = transect->depthTbl;
+    double* aTbl = transect->areaTbl;
+
+    if ( xTbl == NULL ) return invLookup(y, aTbl, n);
+    if ( y <= 0.0 ) return 0.0;
+    if ( y >= aTbl[n-1] ) return 1.0;
+    i = locate(y, aTbl, n - 1);
+    return xTbl[i] + (y - aTbl[i]) * (xTbl[i+1] - xTbl[i]) /
+           (aTbl[i+1] - aTbl[i]);
+}
+
+//=============================================================================
+
 double getQcritical(double yc, void* p)
 //
 //  Input:   yc = critical depth (ft)
@@ -2616,3 +2709,310 @@ double getThetaOfPsi(double psi)
     }
     return theta1;
 }
+
+//=============================================================================
+//  UNIFORM GEOMETRY TABLES
+//=============================================================================
+//  When the GEOMETRY_TOL option is used each cross section is given dense,
+//  equally spaced tables of area, hyd. radius and top width v. depth, depth
+//  and section factor v. area, and area v. section factor. A table is
+//  refined by halving its spacing until the error of linear interpolation
+//  at the middle of every interval, relative to the property's full value,
+//  is within the tolerance. Intervals that still exceed the tolerance at
+//  the maximum table size (e.g. where a function becomes vertical) and
+//  values beyond the end of a table come from the exact functions.
+//  Identical cross sections share tables. Only xsect_getAofY, RofY, WofY,
+//  YofA, SofA and AofS read the tables; other geometry functions use them
+//  only through calls to these.
+//=============================================================================
+
+int xsect_createTables(TXsect* xsect, double tol)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//           tol = max. interpolation error relative to full values
+//  Output:  returns FALSE if out of memory, TRUE otherwise
+//  Purpose: assigns uniform geometry tables to a cross section.
+//
+{
+    int          i, k;
+    TGeomTables* tables;
+    TXsect*      xsects;
+    TGeomTables** tableList;
+
+    xsect->tables = NULL;
+    if ( xsect->type <= DUMMY ) return TRUE;
+
+    // --- use the tables of an identical cross section if one exists
+    for ( i = 0; i < NgeomTables; i++ )
+    {
+        if ( isSameXsect(xsect, &GeomXsects[i]) )
+        {
+            xsect->tables = GeomTables[i];
+            return TRUE;
+        }
+    }
+
+    // --- enlarge the list of tables if need be
+    if ( NgeomTables % GEOM_LIST_SIZE == 0 )
+    {
+        xsects = (TXsect *) realloc(GeomXsects,
+                 (NgeomTables + GEOM_LIST_SIZE) * sizeof(TXsect));
+        if ( xsects == NULL ) return FALSE;
+        GeomXsects = xsects;
+        tableList = (TGeomTables **) realloc(GeomTables,
+                    (NgeomTables + GEOM_LIST_SIZE) * sizeof(TGeomTables *));
+        if ( tableList == NULL ) return FALSE;
+        GeomTables = tableList;
+    }
+
+    // --- build a new set of tables
+    tables = (TGeomTables *) calloc(1, sizeof(TGeomTables));
+    if ( tables == NULL ) return FALSE;
+    GeomXsects[NgeomTables] = *xsect;
+    GeomTables[NgeomTables] = tables;
+    NgeomTables++;
+    for ( k = 0; k < N_GEOM_TABLES; k++ )
+    {
+        if ( !createGeomTable(xsect, tables, k, tol) ) return FALSE;
+    }
+    xsect->tables = tables;
+    return TRUE;
+}
+
+//=============================================================================
+
+void xsect_deleteTables()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees all uniform geometry tables.
+//
+{
+    int i, k;
+
+    for ( i = 0; i < NgeomTables; i++ )
+    {
+        for ( k = 0; k < N_GEOM_TABLES; k++ )
+        {
+            FREE(GeomTables[i]->f[k]);
+            FREE(GeomTables[i]->exact[k]);
+        }
+        FREE(GeomTables[i]);
+    }
+    FREE(GeomTables);
+    FREE(GeomXsects);
+    NgeomTables = 0;
+}
+
+//=============================================================================
+
+int xsect_getTableStats(int nItems[], double maxError[], double exactFrac[])
+//
+//  Input:   none
+//  Output:  nItems = largest size of each kind of geometry table
+//           maxError = largest interpolation error of each kind of table
+//           (as fraction of full value)
+//           exactFrac = largest fraction of each kind of table evaluated
+//           with the exact function
+//           returns number of distinct sets of geometry tables
+//  Purpose: summarizes the size and accuracy of the uniform geometry tables.
+//
+{
+    int i, k;
+
+    for ( k = 0; k < N_GEOM_TABLES; k++ )
+    {
+        nItems[k] = 0;
+        maxError[k] = 0.0;
+        exactFrac[k] = 0.0;
+        for ( i = 0; i < NgeomTables; i++ )
+        {
+            nItems[k] = MAX(nItems[k], GeomTables[i]->nItems[k]);
+            maxError[k] = MAX(maxError[k], GeomTables[i]->maxError[k]);
+            exactFrac[k] = MAX(exactFrac[k], GeomTables[i]->exactFrac[k]);
+        }
+    }
+    return NgeomTables;
+}
+
+//=============================================================================
+
+int isSameXsect(TXsect* xsect1, TXsect* xsect2)
+//
+//  Input:   xsect1, xsect2 = ptrs. to cross section data structures
+//  Output:  returns TRUE if the two cross sections have the same geometry
+//
+{
+    return xsect1->type == xsect2->type &&
+           xsect1->transect == xsect2->transect &&
+           xsect1->yFull == xsect2->yFull &&
+           xsect1->wMax  == xsect2->wMax  &&
+           xsect1->ywMax == xsect2->ywMax &&
+           xsect1->aFull == xsect2->aFull &&
+           xsect1->rFull == xsect2->rFull &&
+           xsect1->sFull == xsect2->sFull &&
+           xsect1->sMax  == xsect2->sMax  &&
+           xsect1->yBot  == xsect2->yBot  &&
+           xsect1->aBot  == xsect2->aBot  &&
+           xsect1->sBot  == xsect2->sBot  &&
+           xsect1->rBot  == xsect2->rBot;
+}
+
+//=============================================================================
+
+int createGeomTable(TXsect* xsect, TGeomTables* tables, int k, double tol)
+//
+//  Input:   xsect = ptr. to a cross section data structure (without tables)
+//           tables = ptr. to the cross section's geometry tables
+//           k = kind of table to create
+//           tol = max. interpolation error relative to full value
+//  Output:  returns FALSE if out of memory, TRUE otherwise
+//  Purpose: creates a uniform geometry table whose interpolation error is
+//           within a given tolerance.
+//
+//  Note: the last table item holds the value just short of the full one
+//        so that shapes whose top width drops to 0 when full interpolate
+//        properly.
+{
+    int     i, n = MIN_GEOM_ITEMS;
+    int     nExact;
+    double  xFull, fFull, dx, e, err;
+    double* f;
+    double* fMid;
+    double* fNew;
+    char*   exact;
+
+    // --- find end of table and value used to normalize errors
+    switch ( k )
+    {
+      case AOFY_TABLE: xFull = xsect->yFull; fFull = xsect->aFull; break;
+      case ROFY_TABLE: xFull = xsect->yFull; fFull = xsect->rFull; break;
+      case WOFY_TABLE: xFull = xsect->yFull; fFull = xsect->wMax;  break;
+      case YOFA_TABLE: xFull = xsect->aFull; fFull = xsect->yFull; break;
+      case SOFA_TABLE: xFull = xsect->aFull; fFull = xsect->sMax;  break;
+      default:         xFull = xsect->sMax;  fFull = xsect->aFull; break;
+    }
+    fFull = MAX(fFull, TINY);
+
+    // --- evaluate the property at each table item
+    f = (double *) calloc(n, sizeof(double));
+    if ( f == NULL ) return FALSE;
+    for ( i = 0; i < n - 1; i++ )
+        f[i] = getExactValue(xsect, k, i * xFull / (n - 1));
+    f[n-1] = getExactValue(xsect, k, xFull * (1.0 - GEOM_EDGE));
+
+    // --- keep halving the table's spacing until error is small enough
+    for (;;)
+    {
+        // --- find the error at the middle of each interval
+        fMid = (double *) calloc(n - 1, sizeof(double));
+        if ( fMid == NULL )
+        {
+            FREE(f);
+            return FALSE;
+        }
+        dx = xFull / (n - 1);
+        err = 0.0;
+        for ( i = 0; i < n - 1; i++ )
+        {
+            fMid[i] = getExactValue(xsect, k, (i + 0.5) * dx);
+            err = MAX(err, fabs(0.5 * (f[i] + f[i+1]) - fMid[i]) / fFull);
+        }
+        if ( err <= tol || 2 * n - 1 > MAX_GEOM_ITEMS ) break;
+
+        // --- interleave the table with its mid-interval values
+        fNew = (double *) calloc(2 * n - 1, sizeof(double));
+        if ( fNew == NULL )
+        {
+            FREE(f);
+            FREE(fMid);
+            return FALSE;
+        }
+        for ( i = 0; i < n - 1; i++ )
+        {
+            fNew[2*i] = f[i];
+            fNew[2*i+1] = fMid[i];
+        }
+        fNew[2*n-2] = f[n-1];
+        FREE(f);
+        FREE(fMid);
+        f = fNew;
+        n = 2 * n - 1;
+    }
+
+    // --- mark intervals whose error still exceeds the tolerance
+    exact = (char *) calloc(n - 1, sizeof(char));
+    if ( exact == NULL )
+    {
+        FREE(f);
+        FREE(fMid);
+        return FALSE;
+    }
+    err = 0.0;
+    nExact = 0;
+    for ( i = 0; i < n - 1; i++ )
+    {
+        e = fabs(0.5 * (f[i] + f[i+1]) - fMid[i]) / fFull;
+        if ( e > tol )
+        {
+            exact[i] = TRUE;
+            nExact++;
+        }
+        else err = MAX(err, e);
+    }
+    FREE(fMid);
+    tables->nItems[k] = n;
+    tables->xFull[k] = xFull;
+    tables->maxError[k] = err;
+    tables->exactFrac[k] = (double)nExact / (n - 1);
+    tables->f[k] = f;
+    tables->exact[k] = exact;
+    return TRUE;
+}
+
+//=============================================================================
+
+double getExactValue(TXsect* xsect, int k, double x)
+//
+//  Input:   xsect = ptr. to a cross section data structure (without tables)
+//           k = kind of geometry table
+//           x = value of table's independent variable
+//  Output:  returns value of table's dependent variable
+//  Purpose: evaluates the exact geometry function tabulated by a table.
+//
+{
+    switch ( k )
+    {
+      case AOFY_TABLE: return xsect_getAofY(xsect, x);
+      case ROFY_TABLE: return xsect_getRofY(xsect, x);
+      case WOFY_TABLE: return xsect_getWofY(xsect, x);
+      case YOFA_TABLE: return xsect_getYofA(xsect, x);
+      case SOFA_TABLE: return xsect_getSofA(xsect, x);
+      default:         return xsect_getAofS(xsect, x);
+    }
+}
+
+//=============================================================================
+
+int getTableValue(TGeomTables* tables, int k, double x, double* f)
+//
+//  Input:   tables = ptr. to a cross section's geometry tables
+//           k = kind of geometry table
+//           x = value of table's independent variable
+//  Output:  f = interpolated value of table's dependent variable;
+//           returns FALSE if x lies outside of the table
+//  Purpose: interpolates a value from a uniform geometry table.
+//
+{
+    int    i;
+    int    n = tables->nItems[k];
+    double u;
+
+    if ( x < 0.0 || x >= tables->xFull[k] ) return FALSE;
+    u = x / tables->xFull[k] * (n - 1);
+    i = (int)u;
+    if ( i > n - 2 ) i = n - 2;
+    if ( tables->exact[k][i] ) return FALSE;
+    *f = tables->f[k][i] + (u - i) * (tables->f[k][i+1] - tables->f[k][i]);
+    return TRUE;
+}
@@ -0,0 +1,104 @@
+/*
+ *   test_dryweather.cpp
+ *
+ *   Created: 07/18/2023
+ *
+ *   Regression test for SWMM's SKIP_DRY_SUBCATCH option using Boost Test.
+ *   A continuous simulation with long dry periods is run with the option
+ *   turned off and on. Subcatchment results must agree to within round-off
+ *   and results with the option on must not depend on the thread count.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_solver.hpp"
+
+// NOTE: the drainage network must have at least 4 links per thread
+//       for the solver to use the requested number of threads.
+#define NUM_NODES    40
+#define NUM_SUBCATCH 120
+
+using namespace std;
+
+// Returns an input file for subcatchments that mix infiltration methods,
+// pollutant buildup functions and street sweeping over a 60 day period
+// with a storm every 11 days.
+static string make_input(int threads, const string& skipDry)
+{
+    const char* infil[] = {"3.0 0.5 4 7 0 HORTON",
+                           "3.0 0.5 4 7 2 MODIFIED_HORTON",
+                           "3.5 0.5 0.25 GREEN_AMPT",
+                           "3.5 0.5 0.25 MODIFIED_GREEN_AMPT",
+                           "75 0.5 7 CURVE_NUMBER"};
+    ostringstream f;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING KINWAVE\nINFILTRATION HORTON\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 03/01/2020\nEND_TIME 00:00:00\n"
+      << "SWEEP_START 01/15\nSWEEP_END 12/31\n"
+      << "REPORT_STEP 01:00:00\nWET_STEP 00:05:00\nDRY_STEP 01:00:00\n"
+      << "ROUTING_STEP 300\nTHREADS " << threads << "\n"
+      << "SKIP_DRY_SUBCATCH " << skipDry << "\n\n";
+    f << "[EVAPORATION]\nCONSTANT 0.1\nRECOVERY RP1\n\n";
+    f << "[RAINGAGES]\nRG1 INTENSITY 1:00 1.0 TIMESERIES TS1\n\n";
+    f << "[SUBCATCHMENTS]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        f << "S" << i << " RG1 ";
+        if (i % 4 == 3) f << "S" << i - 3;
+        else f << "J" << i % NUM_NODES;
+        f << " " << 1 + i % 5 << " " << 10 + i % 70 << " 400 1 0\n";
+    }
+    f << "\n[SUBAREAS]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        f << "S" << i << " 0.012 0.15 0.05 0.1 25 ";
+        if (i % 3 == 1) f << "PERVIOUS 50\n";
+        else f << "OUTLET\n";
+    }
+    f << "\n[INFILTRATION]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " " << infil[i % 5] << "\n";
+    f << "\n[POLLUTANTS]\nTSS MG/L 0 0 0 0 NO * 0 0 0\n"
+      << "LEAD UG/L 0 0 0 0 NO * 0 0 0\n\n"
+      << "[LANDUSES]\nRES 7 0.5 3\nCOM 0 0 0\n\n[COVERAGES]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " RES 60 COM 40\n";
+    f << "\n[BUILDUP]\nRES TSS SAT 50 0 2 AREA\nRES LEAD POW 1 0.5 0.5 CURB\n"
+      << "COM TSS EXP 80 0.3 0 AREA\nCOM LEAD SAT 2 0 3 AREA\n\n"
+      << "[WASHOFF]\nRES TSS EXP 0.1 1.5 50 0\nRES LEAD EMC 10 0 50 0\n"
+      << "COM TSS EXP 0.2 1.2 0 0\nCOM LEAD RC 0.5 1.0 0 0\n\n";
+    write_chain(f, NUM_NODES, 4.0, 0.2);
+    f << "[PATTERNS]\nRP1 MONTHLY 0.5 0.6 0.8 1.0 1.2 1.5\n"
+      << "RP1 1.5 1.4 1.2 1.0 0.7 0.5\n\n";
+    f << "[TIMESERIES]\n";
+    for (int day = 3; day < 60; day += 11) {
+        int hr = 24 * day + day % 7;
+        f << "TS1 " << hr << ":00 0.2\nTS1 " << hr + 1 << ":00 0.5\n"
+          << "TS1 " << hr + 2 << ":00 0.1\nTS1 " << hr + 3 << ":00 0\n";
+    }
+    f << "\n[REPORT]\nSUBCATCHMENTS ALL\nNODES ALL\nLINKS ALL\n";
+    return f.str();
+}
+
+BOOST_AUTO_TEST_SUITE(test_dryweather)
+
+// Subcatchment results (rainfall, losses, runoff and washoff) found by
+// skipping dry subcatchments agree with those from analyzing them at
+// every time step.
+BOOST_AUTO_TEST_CASE(test_same_results) {
+    vector<char> ref = run_model("dry_no", make_input(1, "NO"));
+    vector<char> test = run_model("dry_yes", make_input(1, "YES"));
+    BOOST_CHECK_EQUAL(count_subcatch_diffs(ref, test, NUM_SUBCATCH, 1.0e-4), 0);
+}
+
+// Results found by skipping dry subcatchments are the same for any
+// number of threads.
+BOOST_AUTO_TEST_CASE(test_threads) {
+    check_threads("dry", [](int threads) {
+        return make_input(threads, "YES");
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
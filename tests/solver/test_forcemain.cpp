@@ -0,0 +1,85 @@
+/*
+ *   test_forcemain.cpp
+ *
+ *   Created: 07/15/2023
+ *
+ *   Validation test for SWMM's FRICTION_CURVES option using Boost Test.
+ *   A network of pressurized Darcy-Weisbach force mains is routed with
+ *   friction factors computed exactly and with them interpolated from
+ *   tabulated curves, and the link flows must agree at every time step.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "swmm5.h"
+#include "test_solver.hpp"
+
+#define NUM_NODES 40
+
+using namespace std;
+
+// Returns an input file for a tree of force mains draining to an outfall
+// whose fixed stage keeps every pipe flowing full.
+static string make_input(const string& options)
+{
+    unsigned int seed = 12345;
+    vector<int>    parent(NUM_NODES, -1);
+    vector<double> invert(NUM_NODES, 0.0);
+    ostringstream f;
+
+    for (int i = 1; i < NUM_NODES; i++) {
+        seed = seed * 1103515245 + 12345;
+        parent[i] = (int)((seed >> 16) % (unsigned)i);
+        invert[i] = invert[parent[i]] + 0.5;
+    }
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING DYNWAVE\nFORCE_MAIN_EQUATION D-W\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 03:00:00\n"
+      << "REPORT_STEP 00:15:00\nROUTING_STEP 5\nVARIABLE_STEP 0\n"
+      << options << "\n\n";
+    f << "[JUNCTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++)
+        f << "J" << i << " " << invert[i] << " 5 40 200 0\n";
+    f << "\n[OUTFALLS]\nO1 -1 FIXED 40 NO\n\n[CONDUITS]\n";
+    for (int i = 1; i < NUM_NODES; i++)
+        f << "C" << i << " J" << i << " J" << parent[i] << " "
+          << 300 + 50 * (i % 7) << " 0.01 0 0 0 0\n";
+    f << "C0 J0 O1 500 0.01 0 0 0 0\n\n[XSECTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++) {
+        f << "C" << i << " FORCE_MAIN " << (i ? 1.0 : 3.0) << " "
+          << 0.0005 * (1 + i % 5) << " 0 0 1\n";
+    }
+    f << "\n[INFLOWS]\n";
+    for (int i = 1; i < NUM_NODES; i++)
+        f << "J" << i << " FLOW TS" << i % 3 << " FLOW 1.0 "
+          << 0.5 + 0.1 * (i % 4) << "\n";
+    f << "\n[TIMESERIES]\n";
+    for (int k = 0; k < 3; k++)
+        f << "TS" << k << " 0:00 0.0\nTS" << k << " " << k + 1
+          << ":00 " << 1.5 + k << "\nTS" << k << " 4:00 0.01\n";
+    f << "\n[REPORT]\nNODES ALL\nLINKS ALL\n";
+    return f.str();
+}
+
+// Runs the network and returns the flow in each link at each time step.
+static vector<double> get_flows(const string& name, const string& options)
+{
+    vector<int> props(1, swmm_LINK_FLOW);
+    return get_link_values(name, make_input(options), props, NULL);
+}
+
+BOOST_AUTO_TEST_SUITE(test_forcemain)
+
+BOOST_AUTO_TEST_CASE(test_friction_curves) {
+    vector<double> ref = get_flows("exact", "FRICTION_CURVES NO");
+    vector<double> test = get_flows("curves", "FRICTION_CURVES YES");
+    double diff = get_max_diff(ref, test, 0, 1);
+    BOOST_CHECK_MESSAGE(diff <= 1.0e-3, "max. flow difference of "
+        << diff << " exceeds 0.1% of max. flow");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
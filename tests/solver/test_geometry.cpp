@@ -0,0 +1,159 @@
+/*
+ *   test_geometry.cpp
+ *
+ *   Created: 07/21/2023
+ *
+ *   Validation test for SWMM's GEOMETRY_TOL option using Boost Test.
+ *   A chain of conduits using every closed and open cross section shape is
+ *   routed with exact geometry and with geometry interpolated from uniform
+ *   tables. Link flows and depths must agree at every time step and the
+ *   interpolation errors listed in the report must meet the tolerance.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "swmm5.h"
+#include "test_solver.hpp"
+
+#define GEOMETRY_TOL 1.0e-4
+
+using namespace std;
+
+// Cross section shapes and their parameters
+static const char* Shapes[] = {
+    "CIRCULAR 3",              "FORCE_MAIN 3 0.01",
+    "FILLED_CIRCULAR 3 0.5",   "RECT_CLOSED 3 4",
+    "RECT_OPEN 3 4",           "TRAPEZOIDAL 3 4 1 2",
+    "TRIANGULAR 3 6",          "HORIZ_ELLIPSE 3 4.5",
+    "VERT_ELLIPSE 4.5 3",      "ARCH 3 4.5",
+    "PARABOLIC 3 6",           "POWER 3 6 2.5",
+    "RECT_TRIANGULAR 4 3 0.5", "RECT_ROUND 4 3 2",
+    "MODBASKETHANDLE 4 3 1.5", "EGG 3",
+    "HORSESHOE 3",             "GOTHIC 3",
+    "CATENARY 3",              "SEMIELLIPTICAL 3",
+    "BASKETHANDLE 3",          "SEMICIRCULAR 3"
+};
+static const int NumShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+// Returns an input file for a chain of conduits, one of each shape,
+// carrying a storm hydrograph to an outfall.
+static string make_input(const string& options)
+{
+    ostringstream f;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 06:00:00\n"
+      << "REPORT_STEP 00:15:00\nROUTING_STEP 5\nVARIABLE_STEP 0\n"
+      << options << "\n\n";
+    f << "[JUNCTIONS]\n";
+    for (int i = 0; i < NumShapes; i++)
+        f << "J" << i << " " << 0.8 * (NumShapes - i) << " 10 0 0 0\n";
+    f << "\n[OUTFALLS]\nO1 -1 FREE NO\n\n[CONDUITS]\n";
+    for (int i = 0; i < NumShapes; i++) {
+        f << "C" << i << " J" << i << " ";
+        if (i == NumShapes - 1) f << "O1";
+        else f << "J" << i + 1;
+        f << " 400 0.013 0 0 0 0\n";
+    }
+    f << "\n[XSECTIONS]\n";
+    for (int i = 0; i < NumShapes; i++) {
+        istringstream shape(Shapes[i]);
+        string name;
+        double g[4] = {0.0, 0.0, 0.0, 0.0};
+        shape >> name;
+        for (int k = 0; k < 4 && shape >> g[k]; k++) {}
+        f << "C" << i << " " << name << " " << g[0] << " " << g[1] << " "
+          << g[2] << " " << g[3] << " 1\n";
+    }
+    f << "\n[INFLOWS]\nJ0 FLOW TS1\n\n[TIMESERIES]\n"
+      << "TS1 0:00 0.1\nTS1 1:00 12\nTS1 2:00 25\nTS1 3:00 4\n"
+      << "TS1 6:00 0.1\n\n[REPORT]\nLINKS ALL\n";
+    return f.str();
+}
+
+// Reads the largest interpolation error listed in a report's table of
+// cross section geometry tables.
+static double read_max_error(const string& report)
+{
+    istringstream f(report);
+    string   line;
+    double   maxError = -1.0;
+    bool     inTable = false;
+
+    while (getline(f, line)) {
+        if (line.find("Cross Section Geometry Tables") != string::npos)
+            inTable = true;
+        if (!inTable || line.find(" v. ") == string::npos) continue;
+
+        // --- error is next to last item on a table's line
+        istringstream s(line);
+        vector<string> items;
+        string item;
+        while (s >> item) items.push_back(item);
+        if (items.size() >= 3)
+            maxError = fmax(maxError, atof(items[items.size()-2].c_str()));
+    }
+    return maxError;
+}
+
+// Runs the network and returns each link's flow and depth at each time
+// step along with the largest geometry table error in the report.
+static vector<double> get_results(const string& name, const string& options,
+                                  double* maxError)
+{
+    vector<int> props;
+    string      report;
+
+    props.push_back(swmm_LINK_FLOW);
+    props.push_back(swmm_LINK_DEPTH);
+    vector<double> results = get_link_values(name, make_input(options),
+                                             props, &report);
+    *maxError = read_max_error(report);
+    return results;
+}
+
+// Compares results found with and without geometry tables, allowing
+// differences of up to a fraction tol of the largest flow and depth.
+static void check_tables(const string& name, const string& routing, double tol)
+{
+    ostringstream option;
+    double exactError, tableError;
+
+    option << "GEOMETRY_TOL " << GEOMETRY_TOL;
+    vector<double> ref = get_results(name + "_exact", routing, &exactError);
+    vector<double> test = get_results(name + "_tables",
+                                      routing + "\n" + option.str(), &tableError);
+    // --- interpolation errors are only reported when tables are used
+    BOOST_CHECK(exactError < 0.0);
+    BOOST_CHECK(tableError >= 0.0);
+    BOOST_CHECK_MESSAGE(tableError <= GEOMETRY_TOL, name
+        << ": max. table error " << tableError << " exceeds tolerance");
+
+    // --- flows and depths (which alternate) agree with exact geometry
+    double flowDiff = get_max_diff(ref, test, 0, 2);
+    double depthDiff = get_max_diff(ref, test, 1, 2);
+    BOOST_CHECK_MESSAGE(flowDiff <= tol, name << ": max. flow difference of "
+        << flowDiff << " exceeds " << tol << " of max. flow");
+    BOOST_CHECK_MESSAGE(depthDiff <= tol, name << ": max. depth difference of "
+        << depthDiff << " exceeds " << tol << " of max. depth");
+}
+
+BOOST_AUTO_TEST_SUITE(test_geometry)
+
+BOOST_AUTO_TEST_CASE(test_dynwave) {
+    check_tables("dynwave", "FLOW_ROUTING DYNWAVE", 0.01);
+}
+
+BOOST_AUTO_TEST_CASE(test_kinwave) {
+    // --- kinematic wave areas are only converged to 0.1% of full area,
+    //     so its results with and without tables differ by more
+    check_tables("kinwave", "FLOW_ROUTING KINWAVE", 0.02);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
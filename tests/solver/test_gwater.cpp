@@ -0,0 +1,151 @@
+/*
+ *   test_gwater.cpp
+ *
+ *   Created: 07/20/2023
+ *
+ *   Regression test for parallel groundwater using Boost Test.
+ *   Subcatchments linked to aquifers, some with custom lateral and deep
+ *   groundwater flow expressions, are run with 1, 2, 4 and 8 threads and
+ *   the binary output files must match bit for bit.
+ */
+
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_solver.hpp"
+
+// NOTE: the drainage network must have at least 4 links per thread
+//       for the solver to use the requested number of threads.
+#define NUM_NODES    40
+#define NUM_SUBCATCH 400
+
+using namespace std;
+
+// Returns an input file for twenty days of storms on subcatchments that
+// exchange groundwater with the drainage system. When deepExpr is set,
+// each subcatchment's deep GW flow is given by an expression equivalent
+// to the aquifer's own seepage rate. When fixedDepth is set, the surface
+// water depth at the nodes that exchange groundwater is held fixed. When
+// reverse is set, subcatchments are listed (and so analyzed) in reverse
+// order.
+static string make_input(int threads, bool deepExpr, bool fixedDepth = false,
+                         bool reverse = false)
+{
+    ostringstream f;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING KINWAVE\nINFILTRATION HORTON\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/21/2020\nEND_TIME 00:00:00\n"
+      << "REPORT_STEP 01:00:00\nWET_STEP 00:15:00\nDRY_STEP 01:00:00\n"
+      << "ROUTING_STEP 300\nTHREADS " << threads << "\n\n";
+    f << "[EVAPORATION]\nCONSTANT 0.1\n\n";
+    f << "[RAINGAGES]\nRG1 INTENSITY 1:00 1.0 TIMESERIES TS1\n\n";
+    f << "[SUBCATCHMENTS]\n";
+    for (int n = 0; n < NUM_SUBCATCH; n++) {
+        int i = reverse ? NUM_SUBCATCH - 1 - n : n;
+        f << "S" << i << " RG1 J" << i % NUM_NODES << " "
+          << 0.5 * (1 + i % 5) << " " << 10 + i % 50 << " 400 1 0\n";
+    }
+    f << "\n[SUBAREAS]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " 0.012 0.15 0.05 0.1 25 OUTLET\n";
+    f << "\n[INFILTRATION]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " 3.0 0.5 4 7 0\n";
+
+    // --- two aquifers with different soils and seepage rates
+    f << "\n[AQUIFERS]\n"
+      << "A1 0.5 0.15 0.30 5.0 10.0 15.0 0.35 14.0 0.002 90 95 0.40\n"
+      << "A2 0.4 0.10 0.25 2.0 8.0 10.0 0.35 10.0 0.010 90 95 0.30\n\n";
+    f << "[GROUNDWATER]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        int    k = i % NUM_NODES;
+        double invert = 100.0 + 0.5 * (NUM_NODES - k);
+        f << "S" << i << " A" << 1 + i % 2 << " J" << k << " "
+          << invert + 6.0 << " 0.05 1.5 0.0005 1 0 " << (fixedDepth ? 0.5 : 0.0)
+          << " "
+          << invert - 1.0 + 0.01 * (i % 200) << "\n";
+    }
+
+    // --- custom lateral flow for every third subcatchment and deep flow
+    //     matching each aquifer's seepage rate for the rest
+    f << "\n[GWF]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        if (i % 3 == 0)
+            f << "S" << i << " LATERAL 0.0002*STEP(HGW-HCB)*(HGW-HCB)*K/KS"
+              << " + 0.0001*THETA*FI\n";
+        else if (deepExpr)
+            f << "S" << i << " DEEP " << (i % 2 == 0 ? 0.002 : 0.010)
+              << " * HGW / HGS\n";
+    }
+
+    f << "\n";
+    write_chain(f, NUM_NODES, 4.0, 0.1);
+
+    // --- a storm every 4 days
+    f << "[TIMESERIES]\n";
+    for (int day = 1; day < 20; day += 4) {
+        int hr = 24 * day + day % 7;
+        f << "TS1 " << hr << ":00 0.3\nTS1 " << hr + 1 << ":00 0.8\n"
+          << "TS1 " << hr + 2 << ":00 0.2\nTS1 " << hr + 3 << ":00 0\n";
+    }
+    f << "\n[REPORT]\nSUBCATCHMENTS ALL\nNODES ALL\nLINKS ALL\n";
+    return f.str();
+}
+
+BOOST_AUTO_TEST_SUITE(test_gwater)
+
+// Deep GW flow found from an expression evaluated for each subcatchment's
+// own groundwater agrees with the aquifer's built-in seepage rate.
+BOOST_AUTO_TEST_CASE(test_flow_expression) {
+    vector<char> ref = run_model("gwater_no", make_input(1, false));
+    vector<char> test = run_model("gwater_yes", make_input(4, true));
+    BOOST_CHECK_EQUAL(count_subcatch_diffs(ref, test, NUM_SUBCATCH, 1.0e-4), 0);
+
+    // --- the aquifers do exchange groundwater with the nodes
+    int nVars;
+    vector<float> y = read_subcatch_results(ref, NUM_SUBCATCH, &nVars);
+    double gwFlow = 0.0;
+    for (size_t k = 5; k < y.size(); k += nVars) gwFlow += fabs(y[k]);
+    BOOST_CHECK(gwFlow > 0.0);
+}
+
+// A subcatchment's results do not depend on which subcatchments were
+// analyzed before it, so the unsaturated conductivity (K) used in its
+// lateral flow expression is not carried over from another subcatchment.
+// (The node depths seen by the aquifers are held fixed since otherwise
+// the order in which runoff reaches the nodes changes them by round-off.)
+BOOST_AUTO_TEST_CASE(test_analysis_order) {
+    vector<char> ref = run_model("gwater_fwd", make_input(1, true, true));
+    vector<char> test = run_model("gwater_rev",
+                                  make_input(1, true, true, true));
+    BOOST_REQUIRE(test.size() == ref.size());
+
+    int nVars;
+    vector<float> x = read_subcatch_results(test, NUM_SUBCATCH, &nVars);
+    vector<float> y = read_subcatch_results(ref, NUM_SUBCATCH, &nVars);
+
+    // --- compare each subcatchment's results in its two positions
+    int    nDiffs = 0;
+    size_t periodSize = NUM_SUBCATCH * nVars;
+    for (size_t k = 0; k < y.size(); k++) {
+        size_t p = k / periodSize;
+        size_t i = k % periodSize / nVars;
+        size_t kx = p * periodSize + (NUM_SUBCATCH - 1 - i) * nVars
+                  + k % nVars;
+        if (x[kx] != y[k]) nDiffs++;
+    }
+    BOOST_CHECK_EQUAL(nDiffs, 0);
+}
+
+// Results are the same for any number of threads.
+BOOST_AUTO_TEST_CASE(test_threads) {
+    check_threads("gwater", [](int threads) {
+        return make_input(threads, true);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+/*
+ *   test_inlet.cpp
+ *
+ *   Created: 07/23/2023
+ *
+ *   Regression test for on-sag street inlets using Boost Test. Two
+ *   separate systems, one with a 2-sided street and one with a 1-sided
+ *   street, each drain through an on-sag grate inlet into a sewer pipe.
+ *   Each system's results must be the same whether it is routed on its
+ *   own or together with the other one, i.e. an inlet's capture must not
+ *   depend on the street of an inlet evaluated before it.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "swmm5.h"
+#include "test_solver.hpp"
+
+#define NUM_LINKS 3        // links in each system
+
+using namespace std;
+
+// Writes the street junctions and sewer junction of a system.
+static void write_nodes(ostream& f, const string& id)
+{
+    f << "J" << id << "1 10 4 0 0 0\nJ" << id << "2 9 4 0 0 0\n"
+      << "S" << id << " 2 8 0 0 0\n";
+}
+
+// Writes the two streets and the sewer pipe of a system.
+static void write_links(ostream& f, const string& id)
+{
+    f << "ST" << id << "1 J" << id << "1 J" << id << "2 200 0.016 0 0 0 0\n"
+      << "ST" << id << "2 J" << id << "2 O" << id << " 200 0.016 0 0 0 0\n"
+      << "P" << id << " S" << id << " P" << id << "O 200 0.013 0 0 0 0\n";
+}
+
+// Returns an input file for the systems whose ids are listed in ids
+// (A for the 2-sided street, B for the 1-sided one).
+static string make_input(const string& ids)
+{
+    ostringstream f;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING DYNWAVE\nINLET_CURVES NO\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 03:00:00\n"
+      << "REPORT_STEP 00:15:00\nROUTING_STEP 5\nVARIABLE_STEP 0\n\n";
+    f << "[JUNCTIONS]\n";
+    for (size_t i = 0; i < ids.size(); i++) write_nodes(f, ids.substr(i, 1));
+    f << "\n[OUTFALLS]\n";
+    for (size_t i = 0; i < ids.size(); i++)
+        f << "O" << ids[i] << " 8 FREE NO\nP" << ids[i] << "O 0 FREE NO\n";
+    f << "\n[CONDUITS]\n";
+    for (size_t i = 0; i < ids.size(); i++)
+        write_links(f, ids.substr(i, 1));
+    f << "\n[XSECTIONS]\n";
+    for (size_t i = 0; i < ids.size(); i++) {
+        f << "ST" << ids[i] << "1 STREET " << ids[i] << "\n"
+          << "ST" << ids[i] << "2 STREET " << ids[i] << "\n"
+          << "P" << ids[i] << " CIRCULAR 2 0 0 0 1\n";
+    }
+    f << "\n[STREETS]\n";
+    for (size_t i = 0; i < ids.size(); i++)
+        f << ids[i] << " 20 0.5 4 0.016 0 0 " << (ids[i] == 'A' ? 2 : 1)
+          << " 0 0 0\n";
+    f << "\n[INLETS]\nG1 GRATE 2 2 P_BAR-50\n\n[INLET_USAGE]\n";
+    for (size_t i = 0; i < ids.size(); i++)
+        f << "ST" << ids[i] << "1 G1 S" << ids[i] << " 1 0 0 0 0 ON_SAG\n";
+    f << "\n[INFLOWS]\n";
+    for (size_t i = 0; i < ids.size(); i++)
+        f << "J" << ids[i] << "1 FLOW TS1\n";
+    f << "\n[TIMESERIES]\nTS1 0:00 0.0\nTS1 1:00 6\nTS1 2:00 0.0\n"
+      << "\n[REPORT]\nLINKS ALL\n";
+    return f.str();
+}
+
+// Runs the systems listed in ids and returns the flow in the links of
+// system k of them at each time step.
+static vector<double> get_flows(const string& ids, int k)
+{
+    vector<int> props(1, swmm_LINK_FLOW);
+    vector<double> values = get_link_values("inlet_" + ids, make_input(ids),
+                                            props, NULL);
+    vector<double> flows;
+    size_t nLinks = ids.size() * NUM_LINKS;
+
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i % nLinks / NUM_LINKS == (size_t)k) flows.push_back(values[i]);
+    }
+    return flows;
+}
+
+BOOST_AUTO_TEST_SUITE(test_inlet)
+
+BOOST_AUTO_TEST_CASE(test_on_sag_sides) {
+    const string ids = "AB";
+
+    for (int k = 0; k < 2; k++) {
+        vector<double> ref = get_flows(ids.substr(k, 1), 0);
+        vector<double> test = get_flows(ids, k);
+        double diff = get_max_diff(ref, test, 0, 1);
+        BOOST_CHECK_MESSAGE(diff <= 1.0e-3, ids[k] << ": max. flow "
+            "difference of " << diff << " exceeds 0.1% of max. flow");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/*
+ *   test_runon.cpp
+ *
+ *   Created: 07/17/2023
+ *
+ *   Regression test for parallel subcatchment runon using Boost Test.
+ *   Subcatchments cascade onto one another and send LID drain flow to
+ *   other subcatchments. Runoff and the pollutants it carries must be
+ *   conserved along the cascades, and the model is run with 1, 2, 4 and
+ *   8 threads whose binary output files must match bit for bit.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_solver.hpp"
+
+// NOTE: the drainage network must have at least 4 links per thread
+//       for the solver to use the requested number of threads.
+#define NUM_NODES    40
+#define NUM_SUBCATCH 240
+
+using namespace std;
+
+// Returns an input file for a chain of junctions fed by subcatchments
+// that cascade onto other subcatchments before reaching a junction.
+static string make_input(int threads)
+{
+    unsigned int seed = 12345;
+    vector<int>  rank(NUM_SUBCATCH);
+    vector<int>  order(NUM_SUBCATCH);
+    ostringstream f;
+
+    // --- subcatchments only cascade onto ones of lower rank
+    //     so that the cascades never form a loop
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        rank[i] = (i * 7) % NUM_SUBCATCH;
+        order[rank[i]] = i;
+    }
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING KINWAVE\nINFILTRATION HORTON\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 06:00:00\n"
+      << "REPORT_STEP 00:05:00\nWET_STEP 00:01:00\nDRY_STEP 00:15:00\n"
+      << "ROUTING_STEP 30\nTHREADS " << threads << "\n\n";
+    f << "[RAINGAGES]\nRG1 INTENSITY 0:30 1.0 TIMESERIES TS1\n\n";
+    f << "[SUBCATCHMENTS]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        seed = seed * 1103515245 + 12345;
+        f << "S" << i << " RG1 ";
+        if (rank[i] < 4 || (seed >> 16) % 4 == 0)
+            f << "J" << i % NUM_NODES;
+        else
+            f << "S" << order[(seed >> 8) % rank[i]];
+        f << " " << 1 + i % 5 << " " << 20 + i % 60 << " 400 1 0\n";
+    }
+    f << "\n[SUBAREAS]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++) {
+        f << "S" << i << " 0.012 0.15 0.05 0.1 25 ";
+        if (i % 3 == 1) f << "PERVIOUS 50\n";
+        else if (i % 3 == 2) f << "IMPERVIOUS 50\n";
+        else f << "OUTLET\n";
+    }
+    f << "\n[INFILTRATION]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " 3.0 0.5 4 7 0\n";
+    f << "\n[LID_CONTROLS]\nBC1 BC\nBC1 SURFACE 6 0.0 0.1 1.0 5\n"
+      << "BC1 SOIL 12 0.5 0.2 0.1 0.5 10 3.5\n"
+      << "BC1 STORAGE 12 0.75 0.5 0\nBC1 DRAIN 0 0.5 6 6 0 0\n\n";
+    f << "[LID_USAGE]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i += 3) {
+        f << "S" << i << " BC1 2 400 10 0 25 10";
+        if (i % 2 == 0) f << " * S" << (i + 37) % NUM_SUBCATCH;
+        f << "\n";
+    }
+    f << "\n[POLLUTANTS]\nTSS MG/L 0 0 0 0 NO * 0 0 0\n\n"
+      << "[LANDUSES]\nRES 0 0 0\n\n[COVERAGES]\n";
+    for (int i = 0; i < NUM_SUBCATCH; i++)
+        f << "S" << i << " RES 100\n";
+    f << "\n[BUILDUP]\nRES TSS SAT 50 0 2 AREA\n\n"
+      << "[WASHOFF]\nRES TSS EXP 0.1 1.5 0 0\n\n";
+    write_chain(f, NUM_NODES, 1.0, 0.1);
+    f << "[TIMESERIES]\nTS1 0:00 0.5\nTS1 0:30 2.0\nTS1 1:00 1.0\n"
+      << "TS1 2:00 0\n\n[REPORT]\nSUBCATCHMENTS ALL\nNODES ALL\nLINKS ALL\n";
+    return f.str();
+}
+
+BOOST_AUTO_TEST_SUITE(test_runon)
+
+// Runon found in parallel is neither lost nor counted twice, so the
+// runoff continuity error stays at round-off level, as does that of the
+// washoff that the cascades carry into the drainage system.
+BOOST_AUTO_TEST_CASE(test_continuity) {
+    float massBalErr[3];
+    run_model("runon_4", make_input(4), massBalErr);
+    BOOST_CHECK_SMALL(massBalErr[0], 0.1f);
+    BOOST_CHECK_SMALL(massBalErr[2], 0.1f);
+}
+
+BOOST_AUTO_TEST_CASE(test_cascade) {
+    check_threads("runon", make_input);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+/*
+ *   test_solver.cpp
+ *
+ *   Created: 07/22/2023
+ *
+ *   Test module for the SWMM solver using Boost Test. The test suites
+ *   are in the other test_*.cpp files of this directory; this file holds
+ *   the helper functions they share.
+ */
+
+#define BOOST_TEST_MODULE "solver"
+#include <boost/test/included/unit_test.hpp>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+
+#include "swmm5.h"
+#include "test_solver.hpp"
+
+using namespace std;
+
+void write_chain(ostream& f, int nNodes, double d0, double dIncr)
+{
+    f << "[JUNCTIONS]\n";
+    for (int i = 0; i < nNodes; i++)
+        f << "J" << i << " " << 100.0 + 0.5 * (nNodes - i) << " 8 0 0 0\n";
+    f << "\n[OUTFALLS]\nO1 99 FREE NO\n\n[CONDUITS]\n";
+    for (int i = 0; i < nNodes; i++) {
+        f << "C" << i << " J" << i << " ";
+        if (i == nNodes - 1) f << "O1";
+        else f << "J" << i + 1;
+        f << " 400 0.013 0 0 0 0\n";
+    }
+    f << "\n[XSECTIONS]\n";
+    for (int i = 0; i < nNodes; i++)
+        f << "C" << i << " CIRCULAR " << d0 + dIncr * i << " 0 0 0 1\n";
+    f << "\n";
+}
+
+vector<char> read_file(const string& path)
+{
+    ifstream f(path.c_str(), ios::binary);
+    return vector<char>((istreambuf_iterator<char>(f)),
+                         istreambuf_iterator<char>());
+}
+
+int read_int(const vector<char>& data, size_t pos)
+{
+    int value;
+    memcpy(&value, &data[pos], sizeof(int));
+    return value;
+}
+
+vector<float> read_subcatch_results(const vector<char>& data, int nSubcatch,
+                                    int* nVars)
+{
+    vector<float> results;
+
+    // --- locate the computed results using the file's epilogue
+    size_t end = data.size() - 6 * sizeof(int);
+    size_t resultsPos = read_int(data, end + 2 * sizeof(int));
+    int    nPeriods = read_int(data, end + 3 * sizeof(int));
+    *nVars = 8 + read_int(data, 6 * sizeof(int));
+    BOOST_REQUIRE(nPeriods > 0);
+    size_t periodSize = (end - resultsPos) / nPeriods;
+
+    // --- subcatchment results follow each period's date
+    results.resize((size_t)nPeriods * nSubcatch * *nVars);
+    for (int p = 0; p < nPeriods; p++) {
+        size_t pos = resultsPos + p * periodSize + sizeof(double);
+        size_t n = (size_t)nSubcatch * *nVars;
+        memcpy(&results[p * n], &data[pos], n * sizeof(float));
+    }
+    return results;
+}
+
+vector<float> read_link_results(const vector<char>& data, int* nLinks,
+                                int* nVars)
+{
+    vector<float> results;
+
+    // --- locate the computed results using the file's epilogue
+    size_t end = data.size() - 6 * sizeof(int);
+    size_t resultsPos = read_int(data, end + 2 * sizeof(int));
+    int    nPeriods = read_int(data, end + 3 * sizeof(int));
+    int    nSubcatch = read_int(data, 3 * sizeof(int));
+    int    nNodes = read_int(data, 4 * sizeof(int));
+    int    nPollut = read_int(data, 6 * sizeof(int));
+    *nLinks = read_int(data, 5 * sizeof(int));
+    *nVars = 5 + nPollut;
+    BOOST_REQUIRE(nPeriods > 0);
+    size_t periodSize = (end - resultsPos) / nPeriods;
+
+    // --- link results follow each period's subcatchment & node results
+    size_t offset = sizeof(double) + ((size_t)nSubcatch * (8 + nPollut) +
+                    (size_t)nNodes * (6 + nPollut)) * sizeof(float);
+    size_t n = (size_t)*nLinks * *nVars;
+    results.resize((size_t)nPeriods * n);
+    for (int p = 0; p < nPeriods; p++) {
+        size_t pos = resultsPos + p * periodSize + offset;
+        memcpy(&results[p * n], &data[pos], n * sizeof(float));
+    }
+    return results;
+}
+
+// Checks that the runoff and flow routing continuity errors of a run that
+// just ended are within MAX_CONTINUITY_ERROR, and returns them along with
+// the quality routing continuity error in massBalErr if it isn't NULL.
+static void check_continuity(const string& name, float* massBalErr)
+{
+    float err[3];
+
+    swmm_getMassBalErr(&err[0], &err[1], &err[2]);
+    BOOST_CHECK_MESSAGE(fabs(err[0]) <= MAX_CONTINUITY_ERROR, name
+        << ": runoff continuity error of " << err[0] << "%");
+    BOOST_CHECK_MESSAGE(fabs(err[1]) <= MAX_CONTINUITY_ERROR, name
+        << ": flow routing continuity error of " << err[1] << "%");
+    if (massBalErr) memcpy(massBalErr, err, sizeof(err));
+}
+
+vector<char> run_model(const string& name, const string& input,
+                       float* massBalErr)
+{
+    string inp = name + ".inp";
+    string rpt = name + ".rpt";
+    string out = name + ".out";
+    double elapsedTime = 0.0;
+
+    ofstream(inp.c_str()) << input;
+    int error = swmm_open(inp.c_str(), rpt.c_str(), out.c_str());
+    BOOST_REQUIRE(error == 0);
+    error = swmm_start(1);
+    BOOST_REQUIRE(error == 0);
+    do {
+        error = swmm_step(&elapsedTime);
+    } while (elapsedTime > 0.0 && error == 0);
+    BOOST_REQUIRE(error == 0);
+    swmm_end();
+    check_continuity(name, massBalErr);
+    swmm_report();
+    swmm_close();
+
+    vector<char> data = read_file(out);
+    BOOST_REQUIRE(data.size() > 0);
+    remove(inp.c_str());
+    remove(rpt.c_str());
+    remove(out.c_str());
+    return data;
+}
+
+vector<double> get_link_values(const string& name, const string& input,
+                               const vector<int>& props, string* report)
+{
+    string inp = name + ".inp";
+    string rpt = name + ".rpt";
+    string out = name + ".out";
+    vector<double> values;
+    double elapsedTime = 0.0;
+
+    ofstream(inp.c_str()) << input;
+    int error = swmm_open(inp.c_str(), rpt.c_str(), out.c_str());
+    BOOST_REQUIRE(error == 0);
+    error = swmm_start(0);
+    BOOST_REQUIRE(error == 0);
+
+    int nLinks = swmm_getCount(swmm_LINK);
+    do {
+        error = swmm_step(&elapsedTime);
+        for (int j = 0; j < nLinks; j++) {
+            for (size_t k = 0; k < props.size(); k++)
+                values.push_back(swmm_getValue(props[k], j));
+        }
+    } while (elapsedTime > 0.0 && error == 0);
+    BOOST_REQUIRE(error == 0);
+
+    swmm_end();
+    check_continuity(name, NULL);
+    swmm_report();
+    swmm_close();
+    if (report) {
+        vector<char> text = read_file(rpt);
+        report->assign(text.begin(), text.end());
+    }
+    remove(inp.c_str());
+    remove(rpt.c_str());
+    remove(out.c_str());
+    return values;
+}
+
+double get_max_diff(const vector<double>& ref, const vector<double>& test,
+                    size_t first, size_t stride)
+{
+    double maxValue = 0.0, maxDiff = 0.0;
+
+    BOOST_REQUIRE(ref.size() > first);
+    BOOST_REQUIRE(test.size() == ref.size());
+    for (size_t i = first; i < ref.size(); i += stride) {
+        maxValue = fmax(maxValue, fabs(ref[i]));
+        maxDiff = fmax(maxDiff, fabs(test[i] - ref[i]));
+    }
+    BOOST_REQUIRE(maxValue > 0.0);
+    return maxDiff / maxValue;
+}
+
+int count_subcatch_diffs(const vector<char>& ref, const vector<char>& test,
+                         int nSubcatch, double tol)
+{
+    int nVars, nDiffs = 0;
+
+    BOOST_REQUIRE(test.size() == ref.size());
+    vector<float> x = read_subcatch_results(test, nSubcatch, &nVars);
+    vector<float> y = read_subcatch_results(ref, nSubcatch, &nVars);
+    for (size_t k = 0; k < y.size(); k++) {
+        if (fabs(x[k] - y[k]) > tol * (fabs(y[k]) + 1.0e-3)) nDiffs++;
+    }
+    return nDiffs;
+}
@@ -0,0 +1,98 @@
+/*
+ *   test_solver.hpp
+ *
+ *   Created: 07/22/2023
+ *
+ *   Helper functions shared by the test suites of the SWMM solver. Each
+ *   suite writes its own input file, runs it through the swmm5 API and
+ *   compares results found with and without an option, or with different
+ *   numbers of threads. Every run made through these helpers must also
+ *   meet SWMM's continuity (mass balance) checks.
+ */
+
+#ifndef TEST_SOLVER_HPP
+#define TEST_SOLVER_HPP
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+// Largest runoff or flow routing continuity error (%) allowed in a test run
+#define MAX_CONTINUITY_ERROR 5.0
+
+// Writes the junctions, outfall, conduits and cross sections of a chain
+// of nNodes junctions that drains to outfall O1 through circular conduits
+// whose diameters grow by dIncr from d0 in the downstream direction.
+void write_chain(std::ostream& f, int nNodes, double d0, double dIncr);
+
+// Reads the contents of a binary file.
+std::vector<char> read_file(const std::string& path);
+
+// Reads a 4-byte integer from a binary output file's contents.
+int read_int(const std::vector<char>& data, size_t pos);
+
+// Returns the values saved for the first nSubcatch subcatchments in every
+// reporting period of a binary output file's contents, along with the
+// number of values (nVars) saved for each subcatchment.
+std::vector<float> read_subcatch_results(const std::vector<char>& data,
+                                         int nSubcatch, int* nVars);
+
+// Returns the values saved for every link in every reporting period of a
+// binary output file's contents, along with the number of links (nLinks)
+// and of values (nVars) saved for each link.
+std::vector<float> read_link_results(const std::vector<char>& data,
+                                     int* nLinks, int* nVars);
+
+// Saves an input file under the given name, runs it, checks its
+// continuity errors and returns the contents of its binary output file.
+// The run's runoff, flow routing and quality routing continuity errors
+// (%) are also returned in massBalErr[0..2] if it isn't NULL.
+std::vector<char> run_model(const std::string& name,
+                            const std::string& input,
+                            float* massBalErr = NULL);
+
+// Saves an input file under the given name, runs it one routing step at
+// a time, checks its continuity errors and returns the value of each of
+// the given link properties for every link after each step. The contents
+// of the report file are also returned if report isn't NULL.
+std::vector<double> get_link_values(const std::string& name,
+                                    const std::string& input,
+                                    const std::vector<int>& props,
+                                    std::string* report);
+
+// Returns the largest difference between the items first, first + stride,
+// ... of two sets of results, relative to the largest of those items in
+// the reference results.
+double get_max_diff(const std::vector<double>& ref,
+                    const std::vector<double>& test,
+                    size_t first, size_t stride);
+
+// Returns the number of subcatchment results in two binary output files'
+// contents that differ by more than a fraction tol of the reference value.
+int count_subcatch_diffs(const std::vector<char>& ref,
+                         const std::vector<char>& test,
+                         int nSubcatch, double tol);
+
+// Runs the input file returned by make_input(threads) with 1, 2, 4 and 8
+// threads and checks that the binary output files match bit for bit.
+template <class MakeInput>
+void check_threads(const std::string& name, MakeInput make_input)
+{
+    const int         nThreads[] = {1, 2, 4, 8};
+    std::vector<char> ref;
+
+    for (int k = 0; k < 4; k++) {
+        std::ostringstream base;
+        base << name << "_" << nThreads[k];
+        std::vector<char> test = run_model(base.str(),
+                                           make_input(nThreads[k]));
+        if (k == 0) ref = test;
+        else BOOST_CHECK_MESSAGE(test == ref, name << ": output with "
+            << nThreads[k] << " threads differs from 1 thread");
+    }
+}
+
+#endif // TEST_SOLVER_HPP
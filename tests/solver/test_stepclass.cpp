@@ -0,0 +1,96 @@
+/*
+ *   test_stepclass.cpp
+ *
+ *   Created: 07/23/2023
+ *
+ *   Validation test for SWMM's STEP_CLASSES option using Boost Test. A
+ *   chain of long conduits with a short one every few links is routed
+ *   with a single time step for all conduits and with the short ones
+ *   taking sub-steps within a longer routing step. The sub-stepped runs
+ *   must conserve mass as well as the single-rate run does and their
+ *   link flows and depths must stay close to it, without oscillating.
+ */
+
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_solver.hpp"
+
+#define NUM_NODES 20
+
+using namespace std;
+
+// Returns an input file for a chain of conduits, every fourth of which
+// is short enough to limit the routing step, for a number of step classes.
+static string make_input(int classes)
+{
+    ostringstream f;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING DYNWAVE\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 06:00:00\n"
+      << "REPORT_STEP 00:05:00\nROUTING_STEP 30\nVARIABLE_STEP 0.75\n"
+      << "STEP_CLASSES " << classes << "\n\n";
+    f << "[JUNCTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++)
+        f << "J" << i << " " << 100 + NUM_NODES - i << " 8 0 0 0\n";
+    f << "\n[OUTFALLS]\nO1 99 FREE NO\n\n[CONDUITS]\n";
+    for (int i = 0; i < NUM_NODES; i++) {
+        f << "C" << i << " J" << i << " ";
+        if (i == NUM_NODES - 1) f << "O1";
+        else f << "J" << i + 1;
+        f << " " << (i % 4 == 1 ? 30 : 600) << " 0.013 0 0 0 0\n";
+    }
+    f << "\n[XSECTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++)
+        f << "C" << i << " CIRCULAR " << 3.0 + 0.05 * i << " 0 0 0 1\n";
+    f << "\n[INFLOWS]\nJ0 FLOW TS1\nJ5 FLOW TS1\n\n[TIMESERIES]\n"
+      << "TS1 0:00 0.1\nTS1 1:00 15\nTS1 2:00 25\nTS1 3:00 3\n"
+      << "TS1 6:00 0.1\n\n[REPORT]\nLINKS ALL\n";
+    return f.str();
+}
+
+// Returns the largest difference between the values of link property
+// var in two runs' binary output files, relative to its largest value
+// in the reference run.
+static double get_max_link_diff(const vector<char>& ref,
+                                const vector<char>& test, int var)
+{
+    int nLinks, nVars;
+    vector<float> x = read_link_results(ref, &nLinks, &nVars);
+    vector<float> y = read_link_results(test, &nLinks, &nVars);
+    return get_max_diff(vector<double>(x.begin(), x.end()),
+                        vector<double>(y.begin(), y.end()), var, nVars);
+}
+
+BOOST_AUTO_TEST_SUITE(test_stepclass)
+
+BOOST_AUTO_TEST_CASE(test_single_rate) {
+    float refErr[3];
+    vector<char> ref = run_model("stepclass_1", make_input(1), refErr);
+
+    for (int classes = 3; classes <= 5; classes += 2) {
+        ostringstream name;
+        float err[3];
+        name << "stepclass_" << classes;
+        vector<char> test = run_model(name.str(), make_input(classes), err);
+
+        // --- sub-stepping adds little to the flow continuity error
+        BOOST_CHECK_MESSAGE(fabs(err[1] - refErr[1]) <= 0.25, name.str()
+            << ": flow routing continuity error of " << err[1]
+            << "% vs. " << refErr[1] << "% with a single step class");
+
+        // --- flows & depths stay close to the single-rate ones
+        double diff = get_max_link_diff(ref, test, 0);
+        BOOST_CHECK_MESSAGE(diff <= 0.1, name.str() << ": max. flow "
+            "difference of " << diff << " exceeds 10% of max. flow");
+        diff = get_max_link_diff(ref, test, 1);
+        BOOST_CHECK_MESSAGE(diff <= 0.05, name.str() << ": max. depth "
+            "difference of " << diff << " exceeds 5% of max. depth");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
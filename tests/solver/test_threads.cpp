@@ -0,0 +1,186 @@
+/*
+ *   test_threads.cpp
+ *
+ *   Created: 07/13/2023
+ *
+ *   Regression test for SWMM's DETERMINISTIC routing option using Boost
+ *   Test. A synthetic drainage network is routed with 1, 2, 4 and 8
+ *   threads and the binary output files must match bit for bit. In one
+ *   version of the network some conduits are replaced by orifices, weirs
+ *   and outlets, whose flows are found serially with 1 thread and in
+ *   parallel otherwise.
+ */
+
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_solver.hpp"
+
+// NOTE: the network must have more nodes than the block size used by
+//       the fixed-order reductions for the thread count to matter.
+#define NUM_NODES 600
+
+using namespace std;
+
+// Link types used in the network
+enum LinkType {CONDUIT, ORIFICE, WEIR, OUTLET};
+
+// Returns the type of link i of the network, which is always a conduit
+// unless regulators are used.
+static LinkType get_type(int i, bool regulators)
+{
+    if (!regulators || i == 0) return CONDUIT;
+    switch (i % 7) {
+    case 3:  return ORIFICE;
+    case 5:  return WEIR;
+    case 6:  return OUTLET;
+    default: return CONDUIT;
+    }
+}
+
+// Returns an input file for a tree network of junctions and conduits
+// draining to a single outfall, with the given dynamic wave options.
+// Some of the conduits are replaced by regulators if regulators is true.
+static string make_input(int threads, const string& options,
+                         bool regulators = false)
+{
+    unsigned int seed = 12345;
+    vector<int>    parent(NUM_NODES, -1);
+    vector<int>    size(NUM_NODES, 1);
+    vector<double> invert(NUM_NODES, 0.0);
+    vector<double> length(NUM_NODES, 0.0);
+    ostringstream f;
+
+    for (int i = 1; i < NUM_NODES; i++) {
+        seed = seed * 1103515245 + 12345;
+        int lo = i > 8 ? i - 8 : 0;
+        parent[i] = lo + (int)((seed >> 16) % (unsigned)(i - lo));
+        length[i] = 200.0 + (double)((seed >> 8) % 300);
+    }
+    for (int i = NUM_NODES - 1; i > 0; i--) size[parent[i]] += size[i];
+    for (int i = 1; i < NUM_NODES; i++)
+        invert[i] = invert[parent[i]] + 0.005 * length[i] + 0.2;
+
+    f << "[OPTIONS]\n"
+      << "FLOW_UNITS CFS\nFLOW_ROUTING DYNWAVE\nINFILTRATION HORTON\n"
+      << "START_DATE 01/01/2020\nSTART_TIME 00:00:00\n"
+      << "END_DATE 01/01/2020\nEND_TIME 02:00:00\n"
+      << "REPORT_STEP 00:05:00\nWET_STEP 00:05:00\nDRY_STEP 01:00:00\n"
+      << "ROUTING_STEP 10\nVARIABLE_STEP 0.75\nMINIMUM_STEP 0.5\n"
+      << "THREADS " << threads << "\nDETERMINISTIC YES\n"
+      << "PARALLEL_NODE_FLOWS YES\n" << options << "\n\n";
+    f << "[RAINGAGES]\nRG1 INTENSITY 0:15 1.0 TIMESERIES TS1\n\n";
+    f << "[SUBCATCHMENTS]\n";
+    for (int i = 0; i < NUM_NODES; i += 2)
+        f << "S" << i << " RG1 J" << i << " " << 1 + i % 4 << " 50 400 1 0\n";
+    f << "\n[SUBAREAS]\n";
+    for (int i = 0; i < NUM_NODES; i += 2)
+        f << "S" << i << " 0.012 0.15 0.05 0.1 25 OUTLET\n";
+    f << "\n[INFILTRATION]\n";
+    for (int i = 0; i < NUM_NODES; i += 2)
+        f << "S" << i << " 3.0 0.5 4 7 0\n";
+    f << "\n[JUNCTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++)
+        f << "J" << i << " " << invert[i] + (i ? 0.0 : 1.0) << " 12 0 0 0\n";
+    f << "\n[OUTFALLS]\nO1 0 FREE NO\n\n[CONDUITS]\n";
+    for (int i = 1; i < NUM_NODES; i++) {
+        if (get_type(i, regulators) != CONDUIT) continue;
+        f << "C" << i << " J" << i << " J" << parent[i] << " "
+          << length[i] << " 0.013 0 0 0 0\n";
+    }
+    f << "C0 J0 O1 200 0.013 0 0 0 0\n";
+    if (regulators) {
+        f << "\n[ORIFICES]\n";
+        for (int i = 1; i < NUM_NODES; i++) {
+            if (get_type(i, regulators) == ORIFICE)
+                f << "C" << i << " J" << i << " J" << parent[i]
+                  << " SIDE 0 0.65 NO 0\n";
+        }
+        f << "\n[WEIRS]\n";
+        for (int i = 1; i < NUM_NODES; i++) {
+            if (get_type(i, regulators) == WEIR)
+                f << "C" << i << " J" << i << " J" << parent[i]
+                  << " TRANSVERSE 0.5 3.33 NO 0 0 YES\n";
+        }
+        f << "\n[OUTLETS]\n";
+        for (int i = 1; i < NUM_NODES; i++) {
+            if (get_type(i, regulators) == OUTLET)
+                f << "C" << i << " J" << i << " J" << parent[i]
+                  << " 0 FUNCTIONAL/DEPTH 5 0.5 NO\n";
+        }
+    }
+    f << "\n[XSECTIONS]\n";
+    for (int i = 0; i < NUM_NODES; i++) {
+        double d = 1.0 + 0.3 * sqrt((double)size[i]);
+        if (d > 8.0) d = 8.0;
+        switch (get_type(i, regulators)) {
+        case CONDUIT:
+            f << "C" << i << " CIRCULAR " << d << " 0 0 0 1\n"; break;
+        case ORIFICE:
+            f << "C" << i << " CIRCULAR " << d << " 0 0 0\n"; break;
+        case WEIR:
+            f << "C" << i << " RECT_OPEN 4 " << 2.0 * d << " 0 0\n"; break;
+        default: break;
+        }
+    }
+    f << "\n[TIMESERIES]\nTS1 0:00 1.0\nTS1 0:30 2.0\nTS1 1:00 0.5\n"
+      << "TS1 1:30 0\n\n[REPORT]\nNODES ALL\nLINKS ALL\n";
+    return f.str();
+}
+
+// Runs the network with each thread count and compares the output files.
+static void check_options(const string& name, const string& options,
+                          bool regulators = false)
+{
+    check_threads(name, [&](int threads) {
+        return make_input(threads, options, regulators);
+    });
+}
+
+BOOST_AUTO_TEST_SUITE(test_threads)
+
+BOOST_AUTO_TEST_CASE(test_picard) {
+    check_options("picard", "STEP_CLASSES 3\nSKIP_DORMANT YES");
+}
+
+BOOST_AUTO_TEST_CASE(test_aitken) {
+    check_options("aitken", "RELAXATION AITKEN");
+}
+
+// Orifice, weir and outlet flows found in parallel match the serial ones.
+BOOST_AUTO_TEST_CASE(test_regulators) {
+    check_options("regulators", "", true);
+}
+
+// Conduit flows found by chunks that are re-balanced from timings as the
+// run proceeds match those found with the static schedule, with each
+// number of threads.
+BOOST_AUTO_TEST_CASE(test_load_balancing) {
+    const int nThreads[] = {2, 4, 8};
+
+    for (int k = 0; k < 3; k++) {
+        ostringstream name;
+        name << "balanced_" << nThreads[k];
+        vector<char> ref = run_model(name.str() + "_static",
+            make_input(nThreads[k], "LOAD_BALANCING NO"));
+        vector<char> test = run_model(name.str(),
+            make_input(nThreads[k], "LOAD_BALANCING YES"));
+        BOOST_CHECK_MESSAGE(test == ref, "balanced output with "
+            << nThreads[k] << " threads differs from static schedule");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_newton) {
+    check_options("newton", "SOLVER_METHOD NEWTON");
+}
+
+// Without DETERMINISTIC the inner products are serial sums, so Aitken and
+// Newton results still do not depend on the number of threads.
+BOOST_AUTO_TEST_CASE(test_default_sums) {
+    check_options("aitken_default", "DETERMINISTIC NO\nRELAXATION AITKEN");
+    check_options("newton_default", "DETERMINISTIC NO\nSOLVER_METHOD NEWTON");
+}
+
+BOOST_AUTO_TEST_SUITE_END()